@@ -19,6 +19,8 @@
  *
  * Modification history: Merence Sibomana <sibomana@gmail.com> 
  * 10-FEB-2010: Added function ecat_AIR_load_probr
+ * 19-OCT-2026: Added multi-threaded cost function ecat_AIR_uvderivsN12
+ *              and reslicer ecat_AIR_r_affine_lin
 */
 
 // ahc 11/15/17 This was including hrrt_open_2011/include/AIR/AIR.h
@@ -59,6 +61,10 @@ AIR_Error ecat_AIR_do_alignlinear(const char *, const unsigned int, const char *
                                   const unsigned int, const unsigned int, const AIR_Boolean, const AIR_Boolean,
                                   const AIR_Boolean, const unsigned int, const AIR_Boolean);
 AIR_Error ecat_AIR_load_probr(const char *specs, const AIR_Boolean decompressable_read);
+void ecat_AIR_set_threads(const unsigned int);
+unsigned int ecat_AIR_threads(void);
+double ecat_AIR_uvderivsN12(const unsigned int, double **, double ***, double ****, const unsigned int, AIR_Pixels ***, const struct AIR_Key_info *, AIR_Pixels ***, const struct AIR_Key_info *, const AIR_Pixels, double *, double **, unsigned int *, double *, double *, double **, double **, double ***, double ***, const unsigned int, AIR_Pixels, double, const AIR_Boolean, unsigned int *);
+AIR_Pixels ***ecat_AIR_r_affine_lin(AIR_Pixels ***, const struct AIR_Key_info *, struct AIR_Key_info *, double **, const double, AIR_Error *);
 #if defined(__cplusplus)
 }
 #endif
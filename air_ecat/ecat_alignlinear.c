@@ -92,6 +92,7 @@ int main(int argc, char *argv[])
 		printf("\t[-gs scaling_termination_file [overwrite?(y/n)]\n");
 		printf("\t[-h halt_after_(%u)_iterations_without_improvement]\n",noprogtries);
 		printf("\t[-j] use non-positive definite Hessian matrices (not validated, use at your own risk)\n");
+		printf("\t[-n threads_for_cost_function(number of processors)]\n");
 		printf("\t[-p1 segment_standard_file_into_(%u)_partitions]\n",partitions1);
 		printf("\t[-p2 segment_reslice_file_into_(%u)_partitions]\n",partitions2);		
 		printf("\t[-q] assume non-interaction of spatial parameter derivatives\n");
@@ -516,6 +517,25 @@ int main(int argc, char *argv[])
 						posdefreq=FALSE;
 						break;
 						
+					case 'n':
+						if(current_arg>=end_of_args){
+							printf("%s: %d: ",__FILE__,__LINE__);
+							printf("-n must be followed by a positive integer\n");
+							exit(EXIT_FAILURE);
+						}
+						{
+							AIR_Error errcode;
+							unsigned int threads=AIR_parse_uint(*current_arg, &errcode);
+							current_arg++;
+							if(errcode!=0 || threads==0){
+								printf("%s: %d: ",__FILE__,__LINE__);
+								printf("-n must be followed by a positive integer\n");
+								exit(EXIT_FAILURE);
+							}
+							ecat_AIR_set_threads(threads);
+						}
+						break;
+						
 					case 'q':
 						interaction=FALSE;
 						break;
@@ -524,7 +524,7 @@ AIR_Error AIR_do_alignlinear(const char *program, const unsigned int model, cons
 						uvderivsN=AIR_uvderivsN15;
 						break;
 					case 12:
-						uvderivsN=AIR_uvderivsN12;
+						uvderivsN=ecat_AIR_uvderivsN12;	/* multi-threaded */
 						break;
 					case 8:
 						uvderivsN=AIR_uvderivsN8;
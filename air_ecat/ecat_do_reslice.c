@@ -216,7 +216,7 @@ AIR_Error AIR_do_reslice(const char *program, const char *airfile, const char *o
 					reslicerN=AIR_r_persp_nn;
 					break;
 				case 1:
-					if(affine) reslicerN=AIR_r_affine_lin;
+					if(affine) reslicerN=ecat_AIR_r_affine_lin;	/* multi-threaded */
 					else reslicerN=AIR_r_persp_lin;
 					break;
 				case 2:
@@ -0,0 +1,255 @@
+/* Created 19-oct-2026 from AIR 5.3.0 r_affine_lin.c (Roger P. Woods, M.D.) */
+
+/* AIR_Pixels ***ecat_AIR_r_affine_lin()
+ *
+ * Multi-threaded version of AIR_r_affine_lin, the default trilinear
+ *  reslicer of ecat_reslice.
+ *
+ * Planes of the new volume are distributed over threads. Each row is
+ *  clipped to the reslice volume analytically: voxels well inside are
+ *  interpolated without bounds checks, only the voxels near the row ends
+ *  are tested as in AIR_r_affine_lin. Coordinates are accumulated in the
+ *  same order, so the output is identical to AIR_r_affine_lin.
+ *
+ * returns:
+ *	pointer to resliced data if successful
+ *	NULL pointer if unsuccessful
+ *	error code in *errcode
+ */
+
+#include "ecat2air.h"
+#include <pthread.h>
+
+#define MAX_THREADS 64
+#define FLAT_STEP 1e-9	/* coordinate step below which a row is parallel to an axis */
+
+struct reslice_params {
+	AIR_Pixels ***volume;
+	const struct AIR_Key_info *stats;
+	AIR_Pixels ***new_volume;
+	const struct AIR_Key_info *new_stats;
+	double **es;
+	double scale;
+	unsigned int first_plane;
+	unsigned int plane_step;
+};
+
+/* Interpolate one voxel; a, b, c are zero when the upper neighbour is not read */
+#define INTERPOLATE(checked) \
+	{ \
+		unsigned int x_down=x_i; \
+		unsigned int y_down=y_i; \
+		unsigned int z_down=z_i; \
+		double a=x_i-x_down; \
+		double b=y_i-y_down; \
+		double c=z_i-z_down; \
+		double d=1.0-a; \
+		double e=1.0-b; \
+		double f=1.0-c; \
+		AIR_Pixels **j2=volume[z_down]+y_down; \
+		AIR_Pixels **j2c=volume[z_down+(c!=0.0 || !checked)]+y_down; \
+		const AIR_Pixels *i2=*j2+x_down; \
+		const AIR_Pixels *i2b=j2[b!=0.0 || !checked]+x_down; \
+		const AIR_Pixels *i2c=*j2c+x_down; \
+		const AIR_Pixels *i2bc=j2c[b!=0.0 || !checked]+x_down; \
+		unsigned int ia=(a!=0.0 || !checked); \
+		double total=*i2*d*e*f; \
+		\
+		if(!checked || a!=0.0) total+=i2[ia]*a*e*f; \
+		if(!checked || b!=0.0){ \
+			total+=*i2b*d*b*f; \
+			if(!checked || a!=0.0) total+=i2b[ia]*a*b*f; \
+		} \
+		if(!checked || c!=0.0){ \
+			total+=*i2c*d*e*c; \
+			if(!checked || a!=0.0) total+=i2c[ia]*a*e*c; \
+			if(!checked || b!=0.0){ \
+				total+=*i2bc*d*b*c; \
+				if(!checked || a!=0.0) total+=i2bc[ia]*a*b*c; \
+			} \
+		} \
+		total*=scale; \
+		total+=.5; \
+		if(total>(double)AIR_CONFIG_MAX_POSS_VALUE) *i3=AIR_CONFIG_MAX_POSS_VALUE; \
+		else *i3=(AIR_Pixels)total; \
+	}
+
+/*
+ * Narrows [*first,*last] to the voxels t of a row whose coordinate
+ *  start+t*step lies in [1, max1-1], with one voxel of slack at each end
+ */
+static void clip_row(const double start, const double step, const double max1, long int *first, long int *last)
+{
+	double t0, t1;
+
+	if(fabs(step)<FLAT_STEP){
+		if(start<1.0 || start>max1-1.0) *last=*first-1;
+		return;
+	}
+	t0=(1.0-start)/step;
+	t1=(max1-1.0-start)/step;
+	if(t0>t1){
+		double t=t0;
+
+		t0=t1;
+		t1=t;
+	}
+	t0=ceil(t0)+1.0;
+	t1=floor(t1)-1.0;
+	if(t0>(double)*first) *first=(t0>(double)*last) ? *last+1 : (long int)t0;
+	if(t1<(double)*last) *last=(t1<(double)*first) ? *first-1 : (long int)t1;
+}
+
+static void reslice_planes(const struct reslice_params *p)
+{
+	AIR_Pixels ***volume=p->volume;
+	double
+		x_max1=(p->stats->x_dim-1),
+		y_max1=(p->stats->y_dim-1),
+		z_max1=(p->stats->z_dim-1);
+
+	const unsigned int
+		x_dim2=p->new_stats->x_dim,
+		y_dim2=p->new_stats->y_dim,
+		z_dim2=p->new_stats->z_dim;
+
+	const double
+		e00=p->es[0][0],
+		e01=p->es[0][1],
+		e02=p->es[0][2],
+		e10=p->es[1][0],
+		e11=p->es[1][1],
+		e12=p->es[1][2],
+		e20=p->es[2][0],
+		e21=p->es[2][1],
+		e22=p->es[2][2];
+	const double scale=p->scale;
+
+	double
+		x_k=p->es[3][0],
+		y_k=p->es[3][1],
+		z_k=p->es[3][2];
+	unsigned int k;
+
+	for (k=0; k<z_dim2; k++,x_k+=e20,y_k+=e21,z_k+=e22){
+
+		AIR_Pixels **j3;
+		AIR_Pixels **j3_end;
+		double x_j, y_j, z_j;
+
+		if(k<p->first_plane || (k-p->first_plane)%p->plane_step!=0) continue;
+
+		j3=p->new_volume[k];
+		j3_end=j3+y_dim2;
+		x_j=x_k;
+		y_j=y_k;
+		z_j=z_k;
+
+		for (; j3<j3_end; j3++,x_j+=e10,y_j+=e11,z_j+=e12){
+
+			AIR_Boolean x_in=FALSE;
+			AIR_Pixels *i3=*j3;
+			AIR_Pixels *i3_end=i3+x_dim2;
+			AIR_Pixels *interior_begin, *interior_end;
+			long int first=0, last=(long int)x_dim2-1;
+
+			double
+				x_i=x_j,
+				y_i=y_j,
+				z_i=z_j;
+
+			clip_row(x_j, e00, x_max1, &first, &last);
+			clip_row(y_j, e01, y_max1, &first, &last);
+			clip_row(z_j, e02, z_max1, &first, &last);
+			if(first>last) first=last=(long int)x_dim2;
+			else last++;
+			interior_begin=*j3+first;
+			interior_end=*j3+last;
+
+			for (; i3<i3_end; i3++,x_i+=e00,y_i+=e01,z_i+=e02){
+
+				if(i3==interior_begin){
+					/* Inside the reslice volume with a neighbour on each side */
+					for (; i3<interior_end; i3++,x_i+=e00,y_i+=e01,z_i+=e02) INTERPOLATE(0)
+					x_in=TRUE;
+					if(i3==i3_end) break;
+				}
+				if(x_i>=0.0 && x_i<=x_max1){
+					if(y_i>=0.0 && y_i<=y_max1){
+						if(z_i>=0.0 && z_i<=z_max1){
+							x_in=TRUE;
+							INTERPOLATE(1)
+						}
+						else if(x_in) break;
+					}
+					else if(x_in) break;
+				}
+				else if(x_in) break;
+			}
+		}
+	}
+}
+
+static void *reslice_thread(void *ptr)
+{
+	reslice_planes((const struct reslice_params *)ptr);
+	return NULL;
+}
+
+AIR_Pixels ***ecat_AIR_r_affine_lin(AIR_Pixels ***volume, const struct AIR_Key_info *stats, struct AIR_Key_info *new_stats, double **es, const double scale, AIR_Error *errcode)
+
+{
+	if(es[0][3]!=0.0||es[1][3]!=0.0||es[2][3]!=0.0||es[3][3]!=1.0){
+		printf("%s: %d: ",__FILE__,__LINE__);
+		printf("Routine r_affine_lin() inappropriately called to perform perspective transformation\n");
+		*errcode=AIR_NO_PERSPECTIVE_ERROR;
+		return NULL;
+	}
+	if(stats->x_dim==0 || stats->y_dim==0 || stats->z_dim==0 || new_stats->x_dim==0 || new_stats->y_dim==0 || new_stats->z_dim==0){
+		printf("%s: %d: ",__FILE__,__LINE__);
+		printf("Invalid volume dimension\n");
+		*errcode=AIR_VOLUME_ZERO_DIM_ERROR;
+		return NULL;
+	}
+	{
+		AIR_Pixels ***new_volume=AIR_create_vol3(new_stats->x_dim, new_stats->y_dim, new_stats->z_dim);
+		struct reslice_params params[MAX_THREADS];
+		pthread_t thread_id[MAX_THREADS];
+		unsigned int threads=ecat_AIR_threads();
+		unsigned int n;
+
+		if(!new_volume){
+			printf("%s: %d: ",__FILE__,__LINE__);
+			printf("unable to allocate memory to reslice file\n");
+			*errcode=AIR_MEMORY_ALLOCATION_ERROR;
+			return NULL;
+		}
+		AIR_zeros(new_volume,new_stats);	/*This must be called to use the breaks associated with x_in*/
+
+		if(threads>MAX_THREADS) threads=MAX_THREADS;
+		if(threads>new_stats->z_dim) threads=new_stats->z_dim;
+		for(n=0; n<threads; n++){
+			params[n].volume=volume;
+			params[n].stats=stats;
+			params[n].new_volume=new_volume;
+			params[n].new_stats=new_stats;
+			params[n].es=es;
+			params[n].scale=scale;
+			params[n].first_plane=n;
+			params[n].plane_step=threads;
+		}
+		for(n=1; n<threads; n++){
+			if(pthread_create(&thread_id[n], NULL, reslice_thread, &params[n])!=0){
+				/* run it in this thread */
+				reslice_planes(&params[n]);
+				thread_id[n]=pthread_self();
+			}
+		}
+		reslice_planes(&params[0]);
+		for(n=1; n<threads; n++){
+			if(!pthread_equal(thread_id[n], pthread_self())) pthread_join(thread_id[n], NULL);
+		}
+		*errcode=0;
+		return new_volume;
+	}
+}
@@ -60,6 +60,7 @@ int main(int argc, char *argv[])
 		printf("\t[-n model {x_half-window_width y_half-window_width z_half-window_width}]\n");
 		printf("\t[-o] (grants overwrite permission)\n");
 		printf("\t[-s multiplicative_intensity_scale_factor]\n");
+		printf("\t[-t threads_for_trilinear_reslicing(number of processors)]\n");
 		printf("\t[-sf multiplicative_intensity_scale_factor_file]\n");
 		printf("\t[-x x_dim x_size [x_shift]]\n");
 		printf("\t[-y y_dim y_size [y_shift]]\n");
@@ -142,6 +143,25 @@ int main(int argc, char *argv[])
 					cubic=FALSE;
 					break;
 					
+				case 't':
+					if(current_arg>=end_of_args){
+						printf("%s: %d: ",__FILE__,__LINE__);
+						printf("-t must be followed by a positive integer\n");
+						exit(EXIT_FAILURE);
+					}
+					{
+						AIR_Error errcode;
+						unsigned int threads=AIR_parse_uint(*current_arg, &errcode);
+						current_arg++;
+						if(errcode!=0 || threads==0){
+							printf("%s: %d: ",__FILE__,__LINE__);
+							printf("-t must be followed by a positive integer\n");
+							exit(EXIT_FAILURE);
+						}
+						ecat_AIR_set_threads(threads);
+					}
+					break;
+					
 				case 's':
 					switch(*current_char++){
 						case '\0':
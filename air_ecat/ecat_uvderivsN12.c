@@ -0,0 +1,396 @@
+/* Created 19-oct-2026 from AIR 5.3.0 uvderivsN12.c (Roger P. Woods, M.D.) */
+
+/*
+ * Multi-threaded version of AIR_uvderivsN12, the ratio image uniformity
+ *  cost function with interacting spatial parameters used by
+ *  ecat_alignlinear for the 6, 7, 9 and 12 parameter models.
+ *
+ * The sampled pixels of the standard file are split into a fixed number
+ *  of contiguous chunks (slabs of planes at full sampling). Each chunk
+ *  accumulates its own partition sums, the chunks are added in order and
+ *  the normalized standard deviation and its derivatives are computed as
+ *  in AIR_uvderivsN12. The result does not depend on the number of threads.
+ *
+ * Returns the normalized standard deviation
+ */
+
+#include "ecat2air.h"
+#include <pthread.h>
+#include <unistd.h>
+
+#define PARAM_INT 12
+#define PARAM_INT_H PARAM_INT*(PARAM_INT+1)/2
+
+#define BLOCK0 0	/* x domain */
+#define BLOCK1 4	/* y domain */
+#define BLOCK2 8	/* z domain */
+#define BLOCK3 12	/* end of z domain */
+
+#define CHUNKS 32	/* number of chunks of sampled pixels */
+
+/* Sums of one partition: mean, square, dmean, dsquare, emean, esquare */
+#define SUM_MEAN 0
+#define SUM_SQUARE 1
+#define SUM_DMEAN 2
+#define SUM_DSQUARE (SUM_DMEAN+PARAM_INT)
+#define SUM_EMEAN (SUM_DSQUARE+PARAM_INT)
+#define SUM_ESQUARE (SUM_EMEAN+PARAM_INT_H)
+#define SUM_SIZE (SUM_ESQUARE+PARAM_INT_H)
+
+static unsigned int ecat_threads=0;	/* 0: number of online processors */
+
+struct chunk_params {
+	double **es;
+	unsigned int samplefactor;
+	AIR_Pixels ***pixel2;
+	const struct AIR_Key_info *stats2;
+	AIR_Pixels ***pixel5;
+	const struct AIR_Key_info *stats5;
+	AIR_Pixels threshold5;
+	unsigned int partitions;
+	AIR_Pixels max_actual_value;
+	unsigned long int samples;	/* number of sampled pixels */
+	unsigned int *counts;		/* CHUNKS x partitions */
+	double *sums;			/* CHUNKS x partitions x SUM_SIZE */
+	unsigned int first_chunk;
+	unsigned int chunk_step;
+};
+
+void ecat_AIR_set_threads(const unsigned int threads)
+{
+	ecat_threads=threads;
+}
+
+/* Number of threads for the ecat_AIR cost function and reslicer */
+unsigned int ecat_AIR_threads(void)
+{
+	long int cpus;
+
+	if(ecat_threads!=0) return ecat_threads;
+	cpus=sysconf(_SC_NPROCESSORS_ONLN);
+	return (cpus>0) ? (unsigned int)cpus : 1;
+}
+
+static void accumulate_chunk(const struct chunk_params *p, const unsigned int chunk)
+{
+	unsigned int x_max1u=p->stats2->x_dim-1;
+	unsigned int y_max1u=p->stats2->y_dim-1;
+	unsigned int z_max1u=p->stats2->z_dim-1;
+
+	double x_max1=x_max1u;
+	double y_max1=y_max1u;
+	double z_max1=z_max1u;
+
+	unsigned int x_dim2=p->stats5->x_dim;
+	unsigned int y_dim2=p->stats5->y_dim;
+	unsigned long int tempplane=(unsigned long int)x_dim2*y_dim2;
+
+	double e00=p->es[0][0], e01=p->es[0][1], e02=p->es[0][2];
+	double e10=p->es[1][0], e11=p->es[1][1], e12=p->es[1][2];
+	double e20=p->es[2][0], e21=p->es[2][1], e22=p->es[2][2];
+	double e30=p->es[3][0], e31=p->es[3][1], e32=p->es[3][2];
+
+	AIR_Pixels ***pixel2=p->pixel2;
+	unsigned int *counts=p->counts+(unsigned long int)chunk*p->partitions;
+	double *sums=p->sums+(unsigned long int)chunk*p->partitions*SUM_SIZE;
+
+	unsigned long int first=p->samples*chunk/CHUNKS;
+	unsigned long int last=p->samples*(chunk+1)/CHUNKS;
+	unsigned long int r;
+
+	/*ARRAY STRUCTURE ASSUMPTIONS MADE HERE (see AIR_uvderivsN12)*/
+	for(r=first*p->samplefactor; r<last*p->samplefactor; r+=p->samplefactor){
+
+		double pix3=(double)(**p->pixel5)[r];
+		double x_i, y_i, z_i;
+		double dxyz[BLOCK1];
+		double a,b,c,d,e,f;
+		signed int n0,n1,n2,n3,n4,n5,n6,n7;
+		unsigned int i,j,k;
+
+		/*Verify that pixel5>threshold*/
+		if((**p->pixel5)[r]<=p->threshold5) continue;
+
+		/*Calculate coordinates (i,j,k) of pixel r in standard file*/
+		{
+			unsigned long int tempremainder=r%tempplane;
+
+			k=(unsigned int)(r/tempplane);
+			j=(unsigned int)tempremainder/x_dim2;
+			i=(unsigned int)tempremainder%x_dim2;
+		}
+
+		/*Calculate coordinates (x_i,y_i,z_i) of corresponding pixel in reslice file*/
+		x_i=i*e00+j*e10+k*e20+e30;
+		if (x_i<0.0 || x_i>x_max1) continue;
+		y_i=i*e01+j*e11+k*e21+e31;
+		if (y_i<0.0 || y_i>y_max1) continue;
+		z_i=i*e02+j*e12+k*e22+e32;
+		if (z_i<0.0 || z_i>z_max1) continue;
+
+		dxyz[0]=(double)i;
+		dxyz[1]=(double)j;
+		dxyz[2]=(double)k;
+		dxyz[3]=1.0;
+
+		/*Get the 8 voxels surrounding the designated pixel in the reslice file*/
+		{
+			unsigned int x_up=x_i;
+			unsigned int y_up=y_i;
+			unsigned int z_up=z_i;
+
+			unsigned int x_down=x_up++;
+			unsigned int y_down=y_up++;
+			unsigned int z_down=z_up++;
+
+			if(x_up>x_max1u){
+				x_up--;
+				x_down--;
+			}
+			a=x_i-x_down;
+			d=x_up-x_i;
+
+			if(y_up>y_max1u){
+				y_up--;
+				y_down--;
+			}
+			b=y_i-y_down;
+			e=y_up-y_i;
+
+			if(z_up>z_max1u){
+				z_up--;
+				z_down--;
+			}
+			c=z_i-z_down;
+			f=z_up-z_i;
+
+			n0=(int)pixel2[z_down][y_down][x_down];
+			n1=(int)pixel2[z_down][y_down][x_up];
+			n2=(int)pixel2[z_down][y_up][x_down];
+			n3=(int)pixel2[z_down][y_up][x_up];
+			n4=(int)pixel2[z_up][y_down][x_down];
+			n5=(int)pixel2[z_up][y_down][x_up];
+			n6=(int)pixel2[z_up][y_up][x_down];
+			n7=(int)pixel2[z_up][y_up][x_up];
+		}
+		{
+			unsigned int pix1=(p->partitions-1)*(unsigned int)pix3/(unsigned int)p->max_actual_value;
+			double *sum=sums+(unsigned long int)pix1*SUM_SIZE;
+			double ratio, dratio[PARAM_INT];
+			double pix4, dpix4[3], expix4, eypix4, ezpix4;
+			unsigned int t, s;
+
+			/*Trilinear interpolated voxel value and intermediate values for derivatives*/
+			pix4=n0*d*e*f+n1*a*e*f+n2*d*b*f+n3*a*b*f+n4*d*e*c+n5*a*e*c+n6*d*b*c+n7*a*b*c;
+
+			dpix4[0]=((e*f)*(n1-n0)+(b*f)*(n3-n2)+(c*e)*(n5-n4)+(b*c)*(n7-n6));
+			dpix4[1]=((d*f)*(n2-n0)+(a*f)*(n3-n1)+(c*d)*(n6-n4)+(a*c)*(n7-n5));
+			dpix4[2]=((d*e)*(n4-n0)+(a*e)*(n5-n1)+(b*d)*(n6-n2)+(a*b)*(n7-n3));
+
+			expix4=((n7+n1-n5-n3)*a+(n6+n0-n4-n2)*d);
+			eypix4=((n7+n2-n6-n3)*b+(n5+n0-n4-n1)*e);
+			ezpix4=((n7+n4-n6-n5)*c+(n3+n0-n2-n1)*f);
+
+			ratio=pix4/pix3;
+			sum[SUM_MEAN]+=ratio;
+			sum[SUM_SQUARE]+=ratio*ratio;
+			counts[pix1]++;
+
+			/* First derivatives */
+			for(t=BLOCK0; t<BLOCK1; t++){
+				dratio[t]=dpix4[0]*dxyz[t]/pix3;
+				dratio[t+BLOCK1]=dpix4[1]*dxyz[t]/pix3;
+				dratio[t+BLOCK2]=dpix4[2]*dxyz[t]/pix3;
+			}
+			for(t=BLOCK0; t<BLOCK3; t++){
+				sum[SUM_DMEAN+t]+=dratio[t];
+				sum[SUM_DSQUARE+t]+=2.0*ratio*dratio[t];
+			}
+
+			/* Second derivatives, lower triangle s<=t stored row by row */
+			{
+				double *emean=sum+SUM_EMEAN+BLOCK1*(BLOCK1+1)/2;
+				double *esquare=sum+SUM_ESQUARE;
+
+				for(t=BLOCK0; t<BLOCK1; t++){
+					for(s=BLOCK0; s<=t; s++, esquare++) *esquare+=2.0*(dratio[s]*dratio[t]);
+				}
+				for(; t<BLOCK2; t++){
+					double dyt=ezpix4*dxyz[t-BLOCK1]/pix3;
+
+					for(s=BLOCK0; s<BLOCK1; s++, emean++, esquare++){
+						/* eratio[t][s]=ezpix4*dy[t]*dx[s]/pix3 */
+						double eratio=dyt*dxyz[s];
+
+						*emean+=eratio;
+						*esquare+=2.0*(dratio[s]*dratio[t]+ratio*eratio);
+					}
+					for(; s<=t; s++, emean++, esquare++) *esquare+=2.0*(dratio[s]*dratio[t]);
+				}
+				for(; t<BLOCK3; t++){
+					double dzt_y=eypix4*dxyz[t-BLOCK2]/pix3;
+					double dzt_x=expix4*dxyz[t-BLOCK2]/pix3;
+
+					for(s=BLOCK0; s<BLOCK1; s++, emean++, esquare++){
+						/* eratio[t][s]=eypix4*dz[t]*dx[s]/pix3 */
+						double eratio=dzt_y*dxyz[s];
+
+						*emean+=eratio;
+						*esquare+=2.0*(dratio[s]*dratio[t]+ratio*eratio);
+					}
+					for(; s<BLOCK2; s++, emean++, esquare++){
+						/* eratio[t][s]=expix4*dz[t]*dy[s]/pix3 */
+						double eratio=dzt_x*dxyz[s-BLOCK1];
+
+						*emean+=eratio;
+						*esquare+=2.0*(dratio[s]*dratio[t]+ratio*eratio);
+					}
+					for(; s<=t; s++, emean++, esquare++) *esquare+=2.0*(dratio[s]*dratio[t]);
+				}
+			}
+		}
+	}
+}
+
+static void *chunk_thread(void *ptr)
+{
+	const struct chunk_params *p=(const struct chunk_params *)ptr;
+	unsigned int chunk;
+
+	for(chunk=p->first_chunk; chunk<CHUNKS; chunk+=p->chunk_step) accumulate_chunk(p, chunk);
+	return NULL;
+}
+
+double ecat_AIR_uvderivsN12(const unsigned int spatial_parameters, double **es, double ***des, double ****ees, const unsigned int samplefactor, AIR_Pixels ***pixel2, const struct AIR_Key_info *stats2, AIR_Pixels ***pixel5, const struct AIR_Key_info *stats5, const AIR_Pixels threshold5, double *dcff, double **ecff, unsigned int *count, double *mean, double *square, double **dmean, double **dsquare, double ***emean, double ***esquare, const unsigned int partitions, AIR_Pixels max_actual_value, double scale, const AIR_Boolean forward, unsigned int *error)
+
+{
+	double 		cf=0.0;
+
+	double		dcf[PARAM_INT];
+	double 		ecfitems[PARAM_INT_H];
+
+	unsigned int threads=ecat_AIR_threads();
+	struct chunk_params params[CHUNKS];
+	pthread_t thread_id[CHUNKS];
+	unsigned int *counts;
+	double *sums;
+
+	if(threads>CHUNKS) threads=CHUNKS;
+	if(threads==1) return AIR_uvderivsN12(spatial_parameters, es, des, ees, samplefactor, pixel2, stats2, pixel5, stats5, threshold5, dcff, ecff, count, mean, square, dmean, dsquare, emean, esquare, partitions, max_actual_value, scale, forward, error);
+
+	counts=(unsigned int *)calloc((size_t)CHUNKS*partitions, sizeof(unsigned int));
+	sums=(double *)calloc((size_t)CHUNKS*partitions*SUM_SIZE, sizeof(double));
+	if(counts==NULL || sums==NULL){
+		if(counts) free(counts);
+		if(sums) free(sums);
+		return AIR_uvderivsN12(spatial_parameters, es, des, ees, samplefactor, pixel2, stats2, pixel5, stats5, threshold5, dcff, ecff, count, mean, square, dmean, dsquare, emean, esquare, partitions, max_actual_value, scale, forward, error);
+	}
+
+	if(partitions-1>(unsigned int)max_actual_value && partitions-1<(unsigned int)AIR_CONFIG_MAX_POSS_VALUE) max_actual_value=partitions-1;
+
+	/*Accumulate the chunks*/
+	{
+		unsigned long int r_term=(unsigned long int)stats5->x_dim*stats5->y_dim*stats5->z_dim;
+		unsigned int n;
+
+		for(n=0; n<threads; n++){
+			params[n].es=es;
+			params[n].samplefactor=samplefactor;
+			params[n].pixel2=pixel2;
+			params[n].stats2=stats2;
+			params[n].pixel5=pixel5;
+			params[n].stats5=stats5;
+			params[n].threshold5=threshold5;
+			params[n].partitions=partitions;
+			params[n].max_actual_value=max_actual_value;
+			params[n].samples=(r_term+samplefactor-1)/samplefactor;
+			params[n].counts=counts;
+			params[n].sums=sums;
+			params[n].first_chunk=n;
+			params[n].chunk_step=threads;
+		}
+		for(n=1; n<threads; n++){
+			if(pthread_create(&thread_id[n], NULL, chunk_thread, &params[n])!=0){
+				/* run it in this thread */
+				(void)chunk_thread(&params[n]);
+				thread_id[n]=pthread_self();
+			}
+		}
+		(void)chunk_thread(&params[0]);
+		for(n=1; n<threads; n++){
+			if(!pthread_equal(thread_id[n], pthread_self())) pthread_join(thread_id[n], NULL);
+		}
+	}
+
+	/*Add the chunks in order*/
+	{
+		unsigned int jj;
+
+		for(jj=0; jj<partitions; jj++){
+			unsigned int chunk;
+			unsigned int t, s, ts;
+
+			count[jj]=0;
+			mean[jj]=square[jj]=0.0;
+			for(t=0; t<PARAM_INT; t++){
+				dmean[jj][t]=dsquare[jj][t]=0.0;
+				for(s=0; s<=t; s++) emean[jj][t][s]=esquare[jj][t][s]=0.0;
+			}
+			for(chunk=0; chunk<CHUNKS; chunk++){
+				const double *sum=sums+((unsigned long int)chunk*partitions+jj)*SUM_SIZE;
+
+				count[jj]+=counts[(unsigned long int)chunk*partitions+jj];
+				mean[jj]+=sum[SUM_MEAN];
+				square[jj]+=sum[SUM_SQUARE];
+				for(t=0, ts=0; t<PARAM_INT; t++){
+					dmean[jj][t]+=sum[SUM_DMEAN+t];
+					dsquare[jj][t]+=sum[SUM_DSQUARE+t];
+					for(s=0; s<=t; s++, ts++){
+						emean[jj][t][s]+=sum[SUM_EMEAN+ts];
+						esquare[jj][t][s]+=sum[SUM_ESQUARE+ts];
+					}
+				}
+			}
+		}
+	}
+	free(counts);
+	free(sums);
+
+	#include "norm_std_dev.cf"
+
+	{
+		double **ep[PARAM_INT];
+		double *dp[PARAM_INT];
+		{
+			unsigned int t;
+
+			for(t=0;t<BLOCK1;t++){
+
+				dp[t]=des[t][0];
+				ep[t]=ees[t][0];
+			}
+			{
+				{
+					unsigned int r;
+
+					for(r=0;t<BLOCK2;t++,r++){
+						dp[t]=des[r][1];
+						ep[t]=ees[r][1];
+					}
+				}
+				{
+					unsigned int r;
+
+					for(r=0;t<BLOCK3;t++,r++){
+						dp[t]=des[r][2];
+						ep[t]=ees[r][2];
+					}
+				}
+			}
+		}
+
+		#include "param_chain_rule.cf"
+
+	}
+	return cf;
+}
@@ -9,6 +9,7 @@
   \date 2008/07/18 added --txsc for scatter correction
   \date 2008/10/23 added --txblr for TX/BL ratio
   \date 2009/08/28 Port to Linux (peter.bloomfield@camhpet.ca)
+  \date 2026/10/19 added --tv and --tvpd for TV regularization of u-map
 
   Calculate a u-map and an acf from a transmission and blank scan.
 */
@@ -332,6 +333,10 @@ void calculate3DAttenuation(Parser::tparam * const v)
                                       v->quality_path, num, v->blank_db_path,
                                       v->blank_db_frames, &fov_diameter, 1,
                                       num_log_cpus);
+          if (v->tv_lambda > 0.0f)                // TV regularization of u-map
+            CONVERT::tvRegularize(umap_image, v->tv_lambda,
+                                  v->tv_fp_iterations, v->tv_relax_iterations,
+                                  v->tv_pd_iterations, 2, num_log_cpus);
           if (v->iwidth > 0)
             umap_image->resampleXY(v->iwidth,                      // resize u-map
                                    umap_image->DeltaXY()*
@@ -484,7 +489,7 @@ bool validate(Parser::tparam * const v) {
   (--ualgo 20|21|30|31|(40|41 alpha,beta,beta_ip,iter_ip)
   [-p segments,mean,std,mean,std,...,b,b,...]) [--gxy fwhm]
   [--gz fwhm]] [--asv �-value] [--aus] [--uf factor]
-  [--uzoom xy_zoom,z_zoom]
+  [--uzoom xy_zoom,z_zoom] [--tv lambda[,fpi,ri] [--tvpd iterations]]
   [--model model|a,b,c,d,e,f,g,h,i,j,k,l,m,n,o,p,q,r,s,t,u,v,w,x,y,
   z1,z2,z3,z4,z1,z2,z3,z4,...] [--is iterations,subsets]
   [-R r,t] [-k a,b,...,n] [--rs] [--dttx path,frames] [--mrd mrd]
@@ -617,6 +622,18 @@ bool validate(Parser::tparam * const v) {
   Example: --uzoom 2,3 (reconstructs an 80x80x80 �-map if the blank and
   transmission sinograms are 160 bins wide and
   have 239 planes)
+  --tv    total variation regularization of the u-map (TX_TV3DReg). Voxels
+  between 0.07 and 0.099 1/cm are set to 0.099 1/cm before the
+  regularization. The parameters are the smoothing weight and the number of
+  fixed point and relaxation iterations. The default is not to regularize. If
+  only the smoothing weight is specified, 2 fixed point and 3 relaxation
+  iterations are used.
+  Example: --tv 0.5,2,3
+  --tvpd  use the primal-dual algorithm of Chambolle and Pock with the given
+  number of iterations for the TV regularization of the u-map, instead of
+  the fixed point and relaxation iterations. This switch needs the "--tv"
+  switch.
+  Example: --tvpd 100
   --model gantry model specification (only for flat files)
   model   gantry model number
   a       number of bins in a projection
@@ -782,12 +799,13 @@ int main(int argc, char **argv)
                       "2002-2005",
                       "t tarc tnarc b barc bnarc ucut oa oaarc ou w ualgo gxy "
                       "gz p asv aus uf uzoom model is R k rs dttx mrd span mat "
-                      "prj view ntilt force q swap mem d l resrv txsc txblr v h ?",
+                      "prj view ntilt force q swap mem d l resrv txsc txblr tv tvpd "
+                      "v h ?",
                       "(t$ b$ [ucut]$ [oa]|$ [ou [w]]$ [(ualgo) [gxy]$  [gz]$]$"
                       " [asv]$ [aus]$ [uf]$ [uzoom]$ [model]$ [is]$ [R]$ [k]$ "
                       "[rs]$ [dttx]$ [mrd]$ [span]$ [mat]$ [prj]$ [view]$ "
                       "[ntilt]$ [force]$ [q]$ [swap]$ [mem]$ [d]$ [l]$ [resrv]$ "
-                      "[txsc] [txblr])"
+                      "[txsc] [txblr] [tv [tvpd]])"
                       "|$v|$h|$?",
                       iterations, subsets, reg_key+"\\"+logging_path,
                       logging_path, "@-map", "acf", "acf/@-map");
@@ -4,6 +4,7 @@
     \date 2004/02/06 initial version
     \date 2005/01/20 added Doxygen style comments
     \date 2005/01/23 cleanup handling of unknown exceptions
+    \date 2026/10/19 added --lazy to load input data on first access
 
     Calculate a 2d or 3d sinogram from an image or u-map.
  */
@@ -235,7 +236,7 @@ Usage:
          [--scan a,b,c,d,e,f] [--span span] [--mrd mrd]
          [--prj ifore|issrb|fwdpj] [--view] [--ntilt] [--tofp b,w,f]
          [--noise trues,randoms] [--force] [--swap path] [--mem fraction]
-         [-d path] [-l a[,path]] [--resrv port])|-v|-h|-?
+         [--lazy] [-d path] [-l a[,path]] [--resrv port])|-v|-h|-?
 
   -i      name of image input file. Supported formats are ECAT7, Interfile and
           flat (IEEE-float, little endian). In case of a flat-file, the geometry
@@ -397,6 +398,11 @@ Usage:
           for this "uncontrolled" use. The default value is 0.8. In case of
           "memory exhausted" errors a smaller value should help.
            Example: --mem 0.7   (use 70% of the physical memory)
+  --lazy  load input data on first access. Sinograms and images from ECAT7
+          and Interfile files are not read when the file is opened. Each
+          sinogram axis or image is read when it is used for the first time
+          and is dropped instead of swapped out as long as it isn't modified.
+          The input files must not be modified while the program is running.
   -d      serveral files with intermediate results are stored in the specified
           directory during reconstruction. The files that may be created are:
            acf2d_00             2d-ACF
@@ -465,11 +471,11 @@ int main(int argc, char **argv)
                      "calculate a 2d or 3d sinogram from an image",
                      "2004-2005",
                      "i u w a aarc anarc oe oearc oa oaarc ou model scan R "
-                     "span mrd prj view ntilt tofp noise force swap mem d l "
+                     "span mrd prj view ntilt tofp noise force swap mem lazy d l "
                      "resrv v h ?",
                      "((i$|u$ [w])$|a$ oe|oa|$ ou$ [model]$ [R]$ [scan]$ "
                      "[span]$ [mrd]$ [prj]$ [view]$ [ntilt]$ [tofp]$ [noise]$ "
-                     "[force]$ [swap]$ [mem]$ [d]$ [l]$ [resrv])$|v|h|?",
+                     "[force]$ [swap]$ [mem]$ [lazy]$ [d]$ [l]$ [resrv])$|v|h|?",
                      0, 0, reg_key+"\\"+logging_path,
                      logging_path, std::string(), "sinogram",
                      std::string());
@@ -518,6 +524,7 @@ int main(int argc, char **argv)
      MemCtrl::mc()->setSwappingPath(cpar->params()->swap_path);
      MemCtrl::mc()->searchForPattern(cpar->patternKey(), 0);
      MemCtrl::mc()->setMemLimit(cpar->params()->memory_limit);
+     MemCtrl::mc()->setLazyLoading(cpar->params()->lazy_loading);
      sw.start();                                             // start stopwatch
      calculate3DSinogram(cpar->params());      // calculate sinogram from image
                                                               // stop stopwatch
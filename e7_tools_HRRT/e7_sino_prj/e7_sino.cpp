@@ -10,6 +10,12 @@
     \date 2008/05/23 added --os2d to output unscaled 2D scatter and factors
     \date 2008/07/23 added --lber to override scatter BG from gmini 
     \date 2010/02/16 added --athr value[,margin] to override scatter BG from gmini 
+    \date 2026/10/19 added --lazy to load input data on first access
+    \date 2026/10/19 keep norm, u-map and acf of dynamic studies in memory,
+                     load next frame while the current frame is processed
+    \date 2026/10/19 reuse component norm while the deadtime correction of
+                     the frames differs by less than norm_deadtime_tolerance
+    \date 2026/10/19 added --sthr to reuse scatter simulation of previous frame
 
     Calculate fully corrected 2d or 3d sinogram or calculate 3d scatter
     sinogram.
@@ -33,6 +39,7 @@
 #include "progress.h"
 #include "sinogram_conversion.h"
 #include "stopwatch.h"
+#include "thread_wrapper.h"
 #include "types.h"
 
 /*- constants ---------------------------------------------------------------*/
@@ -41,6 +48,179 @@
 const unsigned short int default_iterations_scatter_osem=3,
                           /*! default subsets for OSEM in scatter estimation */
                          default_subsets_scatter=8;
+         /*! largest relative change of the crystal deadtime factors for which
+             the norm of the previous frame is reused (the norm changes by at
+             most about twice this value)                                   */
+const float norm_deadtime_tolerance=0.001f;
+
+/*- type declarations -------------------------------------------------------*/
+
+                      /*! parameters for thread that loads the next emission */
+typedef struct { SinogramConversion *sino;          /*!< emission sinogram */
+                 std::string filename;         /*!< name of emission file */
+                 bool arc_corrected;         /*!< is emission arc-corrected ? */
+                 unsigned short int mnr;          /*!< matrix number in file */
+               } tthread_load_params;
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Start thread to load an emission sinogram.
+    \param[in] param   pointer to thread parameters
+    \return NULL or pointer to Exception object
+    \exception REC_UNKNOWN_EXCEPTION unknown exception generated
+
+    Start thread to load an emission sinogram.
+    The thread API is a C-API so C linkage and calling conventions have to be
+    used, when creating a thread. To use a method as thread, a helper function
+    in C is needed, that calls the method.
+ */
+/*---------------------------------------------------------------------------*/
+void *executeThread_loadEmission(void *param)
+ { try
+   { tthread_load_params *tp;
+
+     tp=(tthread_load_params *)param;
+     tp->sino->load(tp->filename, false, tp->arc_corrected, tp->mnr, "emis",
+                    2);
+     return(NULL);
+   }
+   catch (const Exception r)
+    { return(new Exception(r.errCode(), r.errStr()));
+    }
+   catch (...)
+    { return(new Exception(REC_UNKNOWN_EXCEPTION,
+                           "Unknown exception generated."));
+    }
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Create an empty emission sinogram object.
+    \param[in] v          command line parameters
+    \param[in] flat_gm    use geometry of gantry model (for flat files) ?
+    \return emission sinogram object
+
+    Create an empty emission sinogram object.
+ */
+/*---------------------------------------------------------------------------*/
+SinogramConversion *newEmissionSinogram(Parser::tparam * const v,
+                                        const bool flat_gm)
+ {                                            // init geometry (for flat files)
+   if (flat_gm)
+    { unsigned short int rs, ts;
+      float bsr;
+
+      if (v->mrd == 0) v->mrd=GM::gm()->mrd();
+      if (v->span == 0) v->span=GM::gm()->span();
+      if (v->si.lld == 0) v->si.lld=GM::gm()->lld();
+      if (v->si.uld == 0) v->si.uld=GM::gm()->uld();
+      rs=GM::gm()->RhoSamples();
+      ts=GM::gm()->ThetaSamples();
+      bsr=GM::gm()->BinSizeRho();
+      if (v->eRhoSamples > 0)
+       { rs=v->eRhoSamples;
+         bsr*=(float)rs/(float)v->eRhoSamples;
+       }
+      if (v->eThetaSamples > 0) ts=v->eThetaSamples;
+      return(new SinogramConversion(rs, bsr, ts, v->span, v->mrd,
+                                    GM::gm()->planeSeparation(),
+                                    GM::gm()->rings(),
+                                    GM::gm()->intrinsicTilt(), true,
+                                    v->si.lld, v->si.uld, v->si.start_time,
+                                    v->si.frame_duration,
+                                    v->si.gate_duration, v->si.halflife,
+                                    v->si.bedpos, 0, v->edim));
+    }
+   unsigned short int rs=0, ts=0;
+
+   if (v->eRhoSamples > 0) rs=v->eRhoSamples;
+   if (v->eThetaSamples > 0) ts=v->eThetaSamples;
+   return(new SinogramConversion(rs, 0.0f, ts, v->span, v->mrd, 0.0f, 0, 0.0f,
+                                 true, v->si.lld, v->si.uld, v->si.start_time,
+                                 v->si.frame_duration, v->si.gate_duration,
+                                 v->si.halflife, v->si.bedpos, 0, v->edim));
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Calculate the 3d normalization sinogram for an emission frame.
+    \param[in] v          command line parameters
+    \param[in] emi_sino   emission sinogram
+    \param[in] mnr        matrix number
+    \param[in] nr         matrix number for names of debug files
+    \return normalization sinogram
+
+    Calculate the 3d normalization sinogram for an emission frame. The
+    deadtime correction of the norm depends on the singles rates of the
+    emission.
+ */
+/*---------------------------------------------------------------------------*/
+SinogramConversion *calculateNorm(Parser::tparam * const v,
+                                  SinogramConversion * const emi_sino,
+                                  const unsigned short int mnr,
+                                  const std::string nr)
+ { SinogramConversion *norm_sino=NULL;
+
+   try
+   {                                         // init geometry (for flat files)
+     if (GM::gm()->initialized())
+      { unsigned short int rs, ts;
+        float bsr;
+
+        if (v->mrd == 0) v->mrd=GM::gm()->mrd();
+        if (v->span == 0) v->span=GM::gm()->span();
+        rs=GM::gm()->RhoSamples();
+        ts=GM::gm()->ThetaSamples();
+        bsr=GM::gm()->BinSizeRho();
+        if (v->nRhoSamples > 0)
+         { rs=v->nRhoSamples;
+           bsr*=(float)rs/(float)v->nRhoSamples;
+         }
+        if (v->nThetaSamples > 0) ts=v->nThetaSamples;
+                                                               // init sinogram
+        norm_sino=new SinogramConversion(rs, bsr, ts, v->span, v->mrd,
+                                         GM::gm()->planeSeparation(),
+                                         GM::gm()->rings(),
+                                         GM::gm()->intrinsicTilt(), true,
+                                         v->si.lld, v->si.uld,
+                                         v->si.start_time,
+                                         v->si.frame_duration,
+                                         v->si.gate_duration,
+                                         v->si.halflife, v->si.bedpos,
+                                         mnr, false);
+     }
+     else { unsigned short int rs=0, ts=0;
+
+            if (v->nRhoSamples > 0) rs=v->nRhoSamples;
+            if (v->nThetaSamples > 0) ts=v->nThetaSamples;
+                                                               // init sinogram
+            norm_sino=new SinogramConversion(rs, 0.0f, ts, v->span,
+                                             v->mrd, 0.0f, 0, 0.0f, true,
+                                             v->si.lld, v->si.uld,
+                                             v->si.start_time,
+                                             v->si.frame_duration,
+                                             v->si.gate_duration,
+                                             v->si.halflife,
+                                             v->si.bedpos,
+                                             mnr, v->adim);
+          }
+                                                        // load and expand norm
+     norm_sino->loadNorm(v->norm_filename, norm_sino->RhoSamples(),
+                         norm_sino->ThetaSamples(),
+                         emi_sino->axisSlices(), 1.0f,
+                         emi_sino->singles(), v->p39_patient_norm, 2);
+                                                     // kill blocks in sinogram
+     norm_sino->maskOutBlocks(v->kill_blocks, 1);
+     norm_sino->untilt(true, 1);                                 // untilt norm
+                                                    // mask border bins of norm
+     norm_sino->maskBorders(v->norm_mask_bins, 1);
+  // norm_sino->trim(v->trim, "norm", 1);                      // trim sinogram
+     if (v->debug)                                           // save debug file
+      norm_sino->saveFlat(v->debug_path+"/norm3d_"+nr, false, 2);
+     return(norm_sino);
+   }
+   catch (...)
+    { if (norm_sino != NULL) delete norm_sino;
+      throw;
+    }
+ }
 
 /*---------------------------------------------------------------------------*/
 /*! \brief Calculate a fully corrected 2d or 3d sinogram or calculate a scatter
@@ -77,6 +257,17 @@ const unsigned short int default_iterations_scatter_osem=3,
     - rebin 3d -> 2d
     - save fully corrected emission sinogram
     - save scatter sinogram
+
+    For dynamic studies the frame-invariant data is kept in memory: a norm
+    that doesn't depend on the singles (flat 3d norm, P39 patient norm) is
+    calculated once. The deadtime correction of a component norm depends on
+    the singles of the frame; its norm sinogram is reused as long as no
+    crystal deadtime factor differs by more than norm_deadtime_tolerance from
+    the frame it was calculated for, and recalculated otherwise. The u-map
+    and acf (already rebinned to the size of the emission and, for the u-map,
+    of the scatter simulation) are reused as long as the same bed is used and
+    no u-map or acf file is written. The emission of the next frame is loaded
+    by a background thread while the current frame is processed.
  */
 /*---------------------------------------------------------------------------*/
 void calculateSinogram(Parser::tparam * const v)
@@ -85,53 +276,24 @@ void calculateSinogram(Parser::tparam * const v)
                       *scatter_sino=NULL;
    ImageConversion *umap_image=NULL;
    DIFT *dift=NULL;
+   Scatter *scatter=NULL;
+   SinogramConversion *next_emi_sino=NULL;
+   tthread_id load_tid;
+   tthread_load_params load_tp;
+   bool load_running=false;
 
    try
-   { unsigned short int num_log_cpus, i, number_of_matrices, mat_offset;
+   { unsigned short int num_log_cpus, i, number_of_matrices, mat_offset,
+                        atten_a_mnr=0, atten_u_mnr=0, scatter_a_mnr=0,
+                        scatter_u_mnr=0;
      std::string str, mu('mu');
      std::vector <unsigned short int> matrices;
+     std::vector <unsigned short int> norm_axis_slices;
+     bool atten_calc_acf=false, atten_calc_umap=false, flat_gm;
 
      num_log_cpus=logicalCPUs();
-                                              // init geometry (for flat files)
-     if (GM::gm()->initialized())
-      { unsigned short int rs, ts;
-        float bsr;
-
-        if (v->mrd == 0) v->mrd=GM::gm()->mrd();
-        if (v->span == 0) v->span=GM::gm()->span();
-        if (v->si.lld == 0) v->si.lld=GM::gm()->lld();
-        if (v->si.uld == 0) v->si.uld=GM::gm()->uld();
-        rs=GM::gm()->RhoSamples();
-        ts=GM::gm()->ThetaSamples();
-        bsr=GM::gm()->BinSizeRho();
-        if (v->eRhoSamples > 0)
-         { rs=v->eRhoSamples;
-           bsr*=(float)rs/(float)v->eRhoSamples;
-         }
-        if (v->eThetaSamples > 0) ts=v->eThetaSamples;
-                                                               // init sinogram
-        emi_sino=new SinogramConversion(rs, bsr, ts, v->span, v->mrd,
-                                        GM::gm()->planeSeparation(),
-                                        GM::gm()->rings(),
-                                        GM::gm()->intrinsicTilt(), true,
-                                        v->si.lld, v->si.uld, v->si.start_time,
-                                        v->si.frame_duration,
-                                        v->si.gate_duration, v->si.halflife,
-                                        v->si.bedpos, 0, v->edim);
-      }
-      else { unsigned short int rs=0, ts=0;
-
-             if (v->eRhoSamples > 0) rs=v->eRhoSamples;
-             if (v->eThetaSamples > 0) ts=v->eThetaSamples;
-                                                               // init sinogram
-             emi_sino=new SinogramConversion(rs, 0.0f, ts, v->span, v->mrd,
-                                             0.0f, 0, 0.0f, true, v->si.lld,
-                                             v->si.uld, v->si.start_time,
-                                             v->si.frame_duration,
-                                             v->si.gate_duration,
-                                             v->si.halflife, v->si.bedpos, 0,
-                                             v->edim);
-          }
+     flat_gm=GM::gm()->initialized();
+     emi_sino=newEmissionSinogram(v, flat_gm);                 // init sinogram
                                                // get number of emission frames
      number_of_matrices=numberOfMatrices(v->emission_filename);
      matrices.clear();
@@ -170,15 +332,50 @@ void calculateSinogram(Parser::tparam * const v)
             arg(matrices.size());
      for (unsigned short int num=mat_offset; num < matrices.size(); num++)
       { std::string nr;
-        bool simulate_scatter=false, attenuation_corrected;
+        bool simulate_scatter=false, attenuation_corrected, more_frames,
+             new_atten=false, keep_atten;
 
         nr=toStringZero(matrices[num], 2);
+        more_frames=(num+1 < matrices.size());
                                                        // load 3d emission scan
         Logging::flog()->logMsg("loading the 3d emission scan (matrix #1)",
                                 1)->arg(matrices[num]);
-                                                               // load emission
-        emi_sino->load(v->emission_filename, false, v->emission_arc_corrected,
-                       matrices[num], "emis", 2);
+        if (load_running)         // wait for thread that loads emission frame
+         { void *thread_result;
+
+           ThreadJoin(load_tid, &thread_result);
+           load_running=false;
+           if (thread_result != NULL)
+            { Exception *r;
+              unsigned long int err_code;
+              std::string err_str;
+                                    // move exception object from heap to stack
+              r=(Exception *)thread_result;
+              err_code=r->errCode();
+              err_str=r->errStr();
+              delete r;
+              throw Exception(err_code, err_str);
+            }
+           delete emi_sino;
+           emi_sino=next_emi_sino;
+           next_emi_sino=NULL;
+         }                                                     // load emission
+         else emi_sino->load(v->emission_filename, false,
+                             v->emission_arc_corrected, matrices[num], "emis",
+                             2);
+        if (more_frames)        // load next frame while this one is processed
+         {      // GM was initialized by the first load on this thread, so the
+                // GM::init() of the loader thread doesn't change the geometry
+           Logging::flog()->logMsg("start thread to load the 3d emission scan "
+                                   "(matrix #1)", 1)->arg(matrices[num+1]);
+           next_emi_sino=newEmissionSinogram(v, flat_gm);
+           load_tp.sino=next_emi_sino;
+           load_tp.filename=v->emission_filename;
+           load_tp.arc_corrected=v->emission_arc_corrected;
+           load_tp.mnr=matrices[num+1];
+           ThreadCreate(&load_tid, &executeThread_loadEmission, &load_tp);
+           load_running=true;
+         }
         if (v->emission_arc_corrected_overwrite)
          if (v->emission_arc_corrected)
           emi_sino->correctionsApplied(emi_sino->correctionsApplied() |
@@ -214,71 +411,29 @@ void calculateSinogram(Parser::tparam * const v)
          { Progress::pro()->sendMsg(COM_EVENT::PROCESSING, 2,
                                    "calculate normalization data (frame #1)")->
             arg(matrices[num]);
-           Logging::flog()->logMsg("calculating the 3d normalisation scan "
-                                   "(matrix #1)", 1)->arg(matrices[num]);
-                                              // init geometry (for flat files)
-           if (GM::gm()->initialized())
-            { unsigned short int rs, ts;
-              float bsr;
-
-              if (v->mrd == 0) v->mrd=GM::gm()->mrd();
-              if (v->span == 0) v->span=GM::gm()->span();
-              rs=GM::gm()->RhoSamples();
-              ts=GM::gm()->ThetaSamples();
-              bsr=GM::gm()->BinSizeRho();
-              if (v->nRhoSamples > 0)
-               { rs=v->nRhoSamples;
-                 bsr*=(float)rs/(float)v->nRhoSamples;
-               }
-              if (v->nThetaSamples > 0) ts=v->nThetaSamples;
-                                                               // init sinogram
-              norm_sino=new SinogramConversion(rs, bsr, ts, v->span, v->mrd,
-                                               GM::gm()->planeSeparation(),
-                                               GM::gm()->rings(),
-                                               GM::gm()->intrinsicTilt(), true,
-                                               v->si.lld, v->si.uld,
-                                               v->si.start_time,
-                                               v->si.frame_duration,
-                                               v->si.gate_duration,
-                                               v->si.halflife, v->si.bedpos,
-                                               num, false);
-           }
-           else { unsigned short int rs=0, ts=0;
-
-                  if (v->nRhoSamples > 0) rs=v->nRhoSamples;
-                  if (v->nThetaSamples > 0) ts=v->nThetaSamples;
-                                                               // init sinogram
-                  norm_sino=new SinogramConversion(rs, 0.0f, ts, v->span,
-                                                   v->mrd, 0.0f, 0, 0.0f, true,
-                                                   v->si.lld, v->si.uld,
-                                                   v->si.start_time,
-                                                   v->si.frame_duration,
-                                                   v->si.gate_duration,
-                                                   v->si.halflife,
-                                                   v->si.bedpos,
-                                                   num, v->adim);
-                }
-                                                        // load and expand norm
-           norm_sino->loadNorm(v->norm_filename, norm_sino->RhoSamples(),
-                               norm_sino->ThetaSamples(),
-                               emi_sino->axisSlices(), 1.0f,
-                               emi_sino->singles(), v->p39_patient_norm, 2);
-                                                     // kill blocks in sinogram
-           norm_sino->maskOutBlocks(v->kill_blocks, 1);
-           norm_sino->untilt(true, 1);                           // untilt norm
-                                                    // mask border bins of norm
-           norm_sino->maskBorders(v->norm_mask_bins, 1);
-        // norm_sino->trim(v->trim, "norm", 1);                // trim sinogram
-           if (v->debug)                                     // save debug file
-            norm_sino->saveFlat(v->debug_path+"/norm3d_"+nr, false, 2);
+           if ((norm_sino != NULL) &&
+               ((norm_sino->normDeadtimeChange(emi_sino->singles()) >
+                 norm_deadtime_tolerance) ||
+                (norm_axis_slices != emi_sino->axisSlices())))
+            { delete norm_sino;
+              norm_sino=NULL;
+            }
+           if (norm_sino == NULL)
+            { Logging::flog()->logMsg("calculating the 3d normalisation scan "
+                                      "(matrix #1)", 1)->arg(matrices[num]);
+              norm_sino=calculateNorm(v, emi_sino, num, nr);
+              norm_axis_slices=emi_sino->axisSlices();
+            }
+            else Logging::flog()->logMsg("use 3d normalisation scan of "
+                                         "previous frame", 2);
            if ((emi_sino->correctionsApplied() & CORR_Normalized) == 0)
             {                                          // normalize 3d emission
               Logging::flog()->logMsg("normalize 3d emission", 1);
               emi_sino->setECF(norm_sino->ECF());
               emi_sino->setDeadTimeFactor(norm_sino->deadTimeFactor());
               emi_sino->setCalibrationTime(norm_sino->calibrationTime());
-              emi_sino->multiply(norm_sino, !v->gap_filling, CORR_Normalized,
-                                 2, num_log_cpus);
+              emi_sino->multiply(norm_sino, !v->gap_filling && !more_frames,
+                                 CORR_Normalized, 2, num_log_cpus);
             }
            if (v->gap_filling)                         // fill Gaps in emission
             { Progress::pro()->sendMsg(COM_EVENT::PROCESSING, 2,
@@ -286,12 +441,13 @@ void calculateSinogram(Parser::tparam * const v)
                arg(matrices[num]);
               if ((GM::gm()->modelNumber() != "1080") &&
                   (GM::gm()->modelNumber() != "1090"))
-               emi_sino->fillGaps(norm_sino, v->norm_mask_bins, true, 1,
-                                  num_log_cpus);
+               emi_sino->fillGaps(norm_sino, v->norm_mask_bins, !more_frames,
+                                  1, num_log_cpus);
                else emi_sino->fillGaps(1, num_log_cpus);
             }
-           delete norm_sino;
-           norm_sino=NULL;
+           if (!more_frames) { delete norm_sino;
+                               norm_sino=NULL;
+                             }
          }
          else if (v->gap_filling)                      // fill Gaps in emission
                emi_sino->fillGaps(1, num_log_cpus);
@@ -332,11 +488,32 @@ void calculateSinogram(Parser::tparam * const v)
                arg(acf_pos);
             }
            if (v->iwidth == 0) v->iwidth=GM::gm()->RhoSamples();
-           CONVERT::get_umap_acf(v, &umap_image, &acf_sino,
-                                 simulate_scatter || !attenuation_corrected,
-                                 simulate_scatter, emi_sino->span(),
-                                 emi_sino->mrd(), a_mnr, u_mnr, num,//matrices[num],
-                                 1, num_log_cpus);
+                                   // u-map and acf of previous frame usable ?
+           if (((acf_sino != NULL) || (umap_image != NULL)) &&
+               (a_mnr == atten_a_mnr) && (u_mnr == atten_u_mnr) &&
+               (atten_calc_acf == (simulate_scatter ||
+                                   !attenuation_corrected)) &&
+               (atten_calc_umap == simulate_scatter))
+            Logging::flog()->logMsg("use #1-map and acf of previous frame",
+                                    1)->arg(mu);
+            else { if (acf_sino != NULL) { delete acf_sino;
+                                           acf_sino=NULL;
+                                         }
+                   if (umap_image != NULL) { delete umap_image;
+                                             umap_image=NULL;
+                                           }
+                   CONVERT::get_umap_acf(v, &umap_image, &acf_sino,
+                                       simulate_scatter ||
+                                       !attenuation_corrected,
+                                       simulate_scatter, emi_sino->span(),
+                                       emi_sino->mrd(), a_mnr, u_mnr, num,//matrices[num],
+                                       1, num_log_cpus);
+                   atten_a_mnr=a_mnr;
+                   atten_u_mnr=u_mnr;
+                   atten_calc_acf=simulate_scatter || !attenuation_corrected;
+                   atten_calc_umap=simulate_scatter;
+                   new_atten=true;
+                 }
            if (!v->umap_filename.empty())
             if (!v->oacf_filename.empty() && v->acf_filename.empty() &&
                 (numberOfMatrices(v->umap_filename) == 1))
@@ -344,8 +521,19 @@ void calculateSinogram(Parser::tparam * const v)
                v->oacf_filename=std::string();
              }
          }
+         else { if (acf_sino != NULL) { delete acf_sino;
+                                        acf_sino=NULL;
+                                      }
+                if (umap_image != NULL) { delete umap_image;
+                                          umap_image=NULL;
+                                        }
+              }
+               // keep u-map and acf for next frame if they are not stored in
+               // a file for every frame
+        keep_atten=more_frames && v->oumap_filename.empty() &&
+                   v->oacf_filename.empty();
                                                // rebin acf to size of emission
-        if (acf_sino != NULL)
+        if ((acf_sino != NULL) && new_atten)
          { acf_sino->resampleRT(emi_sino->RhoSamples()/v->rebin_r-2*v->trim,
                                 emi_sino->ThetaSamples()/v->rebin_t, 1,
                                 num_log_cpus);
@@ -369,25 +557,39 @@ void calculateSinogram(Parser::tparam * const v)
             !v->oscatter_filename.empty())
          if ((acf_sino != NULL) && v->scatter_corr &&
              (emi_sino->correctionsApplied() & CORR_Normalized))
-          scatter_sino=CONVERT::eau2scatter(emi_sino, acf_sino, umap_image,
-                                            v->trim, v->iterations, v->subsets,
-                                            v->boxcar_width, v->scatter_skip,
-                                            v->scatter_scale_min,
-                                            v->scatter_scale_max,
-                                            v->acf_threshold, 
-                                            v->acf_threshold_margin, 
-                                            v->rebin_r,
-                                            v->quality_control,
-                                            v->quality_path, v->debug,
-                                            v->debug_path, matrices[num],
-                                            v->new_scatter_code, 
+          {                      // scatter of previous frame from other bed ?
+            if ((scatter != NULL) &&
+                ((atten_a_mnr != scatter_a_mnr) ||
+                 (atten_u_mnr != scatter_u_mnr)))
+             { delete scatter;
+               scatter=NULL;
+             }
+            scatter_a_mnr=atten_a_mnr;
+            scatter_u_mnr=atten_u_mnr;
+            scatter_sino=CONVERT::eau2scatter(emi_sino, acf_sino, umap_image,
+                                              v->trim, v->iterations,
+                                              v->subsets,
+                                              v->boxcar_width, v->scatter_skip,
+                                              v->scatter_scale_min,
+                                              v->scatter_scale_max,
+                                              v->acf_threshold, 
+                                              v->acf_threshold_margin, 
+                                              v->rebin_r,
+                                              v->quality_control,
+                                              v->quality_path, v->debug,
+                                              v->debug_path, matrices[num],
+                                              v->new_scatter_code, 
 #ifndef USE_OLD_SCATTER_CODE
-                                           scale_factors,
+                                              scale_factors,
 #endif
-                                            1, num_log_cpus);
-        if (umap_image != NULL) { delete umap_image;
-                                  umap_image=NULL;
-                                }
+                                              (v->scatter_reuse_threshold >
+                                               0.0f) ? &scatter : NULL,
+                                              v->scatter_reuse_threshold,
+                                              1, num_log_cpus);
+          }
+        if ((umap_image != NULL) && !keep_atten) { delete umap_image;
+                                                   umap_image=NULL;
+                                                 }
         if (!v->oemission_filename.empty())
          { if (acf_sino != NULL)
             { double total_trues=0.0f, total_scatter=0.0f;
@@ -433,11 +635,12 @@ void calculateSinogram(Parser::tparam * const v)
                                                       total_trues));
                }
               Logging::flog()->logMsg("correct for attenuation", 2);
-              emi_sino->multiply(acf_sino, true,
+              emi_sino->multiply(acf_sino, !keep_atten,
                                  CORR_Measured_Attenuation_Correction, 3,
                                  num_log_cpus);
-              delete acf_sino;
-              acf_sino=NULL;
+              if (!keep_atten) { delete acf_sino;
+                                 acf_sino=NULL;
+                               }
             }
                                            // frame-length and decay correction
            if (v->decay_corr || v->framelen_corr)
@@ -468,9 +671,9 @@ void calculateSinogram(Parser::tparam * const v)
                           emi_sino->matrixBed(), v->view_mode,
                           emi_sino->bedPos(), num/*matrices[num]*/, 2);
          }
-        if (acf_sino != NULL) { delete acf_sino;
-                                acf_sino=NULL;
-                              }
+        if ((acf_sino != NULL) && !keep_atten) { delete acf_sino;
+                                                 acf_sino=NULL;
+                                               }
 
         if (!v->oscatter_filename.empty())
          {                             // un-arc correction of scatter sinogram
@@ -548,14 +751,34 @@ void calculateSinogram(Parser::tparam * const v)
      GM::gm()->printUsedGMvalues();
      delete emi_sino;
      emi_sino=NULL;
+     if (norm_sino != NULL) { delete norm_sino;
+                              norm_sino=NULL;
+                            }
+     if (acf_sino != NULL) { delete acf_sino;
+                             acf_sino=NULL;
+                           }
+     if (umap_image != NULL) { delete umap_image;
+                               umap_image=NULL;
+                             }
+     if (scatter != NULL) { delete scatter;
+                            scatter=NULL;
+                          }
    }
    catch (...)
-    { if (acf3d != NULL) delete[] acf3d;
+    { if (load_running)          // wait for thread that loads emission frame
+       { void *thread_result;
+                        // we throw the exception we are currently dealing with
+         ThreadJoin(load_tid, &thread_result);
+         if (thread_result != NULL) delete (Exception *)thread_result;
+       }
+      if (next_emi_sino != NULL) delete next_emi_sino;
+      if (acf3d != NULL) delete[] acf3d;
       if (emi_sino != NULL) delete emi_sino;
       if (acf_sino != NULL) delete acf_sino;
       if (norm_sino != NULL) delete norm_sino;
       if (umap_image != NULL) delete umap_image;
       if (scatter_sino != NULL) delete scatter_sino;
+      if (scatter != NULL) delete scatter;
       if (dift != NULL) delete dift;
       if (umap != NULL) delete[] umap;
       throw;
@@ -624,9 +847,11 @@ Usage:
           [--trim bins] [--nbm bins] [-R r,t] [-k a,b,...,n] [--rs]
           [--is iterations,subsets] [--newsc|--nosc] [--bc width] [--skip n]
           [--os2d] [--ssf min,max] [--athr acf-value[,margin]] [--lber value]
+          [--sthr threshold]
           [-r fore[,alim,wlim,klim]|ssrb|seg0] [--gf] [--tof] [--view] [--ntilt]
           [--fl] [--dc] [--nrarc] [--naarc] [--force] [-q path] [--swap path]
-          [--mem fraction] [-d path] [-l a[,path]] [--resrv port] [--app])|-v|
+          [--mem fraction] [--lazy] [-d path] [-l a[,path]] [--resrv port]
+          [--app])|-v|
          -h|-?
 
   -e      name of the emission input file. Supported formats are ECAT7,
@@ -846,6 +1071,16 @@ Usage:
            Example: --ssf 0.3,1.9
                     --ssf 1.0,1.0 (switch off scatter scaling)
                     --ssf 0.0,0.0 (switch off thresholds)
+  --sthr  threshold for the reuse of the scatter simulation of the previous
+          frame of a dynamic study. The emission image of each frame is
+          reconstructed with one iteration, starting from the image of the
+          previous frame. If the relative change of the emission image since
+          the last scatter simulation is below the threshold, the simulation is
+          reused and only the scaling factors are calculated again. If "-q" is
+          used, the simulation is always calculated and the difference to the
+          reused simulation is logged. The default is 0 (calculate scatter for
+          every frame).
+           Example: --sthr 0.02
   --athr  acf threshold for scatter scaling. Only the sinogram parts where the
           acf value is equal or below the threshold are used to calculate the
           scaling factors, excluded radial margin bins. The default value is 1.03,0.
@@ -890,6 +1125,11 @@ Usage:
           for this "uncontrolled" use. The default value is 0.8. In case of
           "memory exhausted" errors a smaller value should help.
            Example: --mem 0.7   (use 70% of the physical memory)
+  --lazy  load input data on first access. Sinograms and images from ECAT7
+          and Interfile files are not read when the file is opened. Each
+          sinogram axis or image is read when it is used for the first time
+          and is dropped instead of swapped out as long as it isn't modified.
+          The input files must not be modified while the program is running.
   -d      serveral files with intermediate results are stored in the specified
           directory during reconstruction. The files that may be created are:
            acf2d_00             2d-ACF
@@ -958,15 +1198,17 @@ int main(int argc, char **argv)
                      "  calculate 3d scatter sinogram", "2002-2005",
                      "e earc enarc oe oearc os os2d osarc n np a aarc anarc "
                      "oa u ou w prj mrd span mat model scan trim nbm R k rs "
-                     "is newsc nosc bc skip ssf athr r gf tof view ntilt fl "
-                     "lber dc nrarc naarc force q swap mem d l resrv app "
+                     "is newsc nosc bc skip ssf sthr athr r gf tof view ntilt "
+                     "fl lber dc nrarc naarc force q swap mem lazy d l resrv "
+                     "app "
                      "v h ?",
                      "(e$ (oe|os) [n|np [gf]]$ [[a|oa]|$[u|ou [w]]$  [prj]]$ "
                      "[mrd]$ [span]$ [mat]$ [model]$ [scan]$ [trim]$ [nbm]$ "
                      "[R]$ [k] [rs]$ [is]$ [newsc|nosc]$ [bc]$ [skip]$ [ssf]$ "
-                     "[os2d]$ [athr]$ [r]$ [gf]$ [tof]$ [view]$ [ntilt]$ [fl]$ "
+                     "[sthr]$ [os2d]$ [athr]$ [r]$ [gf]$ [tof]$ [view]$ "
+                     "[ntilt]$ [fl]$ "
                      "[lber]$ [dc]$ [nrarc]$ [naarc]$ [force]$ [q]$ [swap]$ "
-                     "[mem]$ [d]$ [l]$ [resrv]$ [app])$|$v|$h|$?",
+                     "[mem]$ [lazy]$ [d]$ [l]$ [resrv]$ [app])$|$v|$h|$?",
                      default_iterations_scatter_osem, default_subsets_scatter,
                      reg_key+"\\"+logging_path, logging_path, "scatter image",
                      "sinogram", "acf/@-map");
@@ -1021,6 +1263,7 @@ int main(int argc, char **argv)
      MemCtrl::mc()->setSwappingPath(cpar->params()->swap_path);
      MemCtrl::mc()->searchForPattern(cpar->patternKey(), 0);
      MemCtrl::mc()->setMemLimit(cpar->params()->memory_limit);
+     MemCtrl::mc()->setLazyLoading(cpar->params()->lazy_loading);
      sw.start();                                             // start stopwatch
 
 #ifndef USE_GANTRY_MODEL
@@ -4,6 +4,7 @@
 #include <fstream>
 #include "e7_tools_const.h"
 #include "PB_3D.h"
+#include "vecmath.h"
 #include <string.h>
 /*****************************************************************************
                            Declarations of
@@ -17,29 +18,33 @@ PB_3D::PB_3D(const int size, const int size_z, const int nang, const int bins,
  {
  }
 
+// The line integrals are calculated for the slices z_start..z_end-1 only.
+// The slices are stored consecutively, which allows vector code for the
+// inner loops.
 void PB_3D::blf(float *p, const int, const float sintheta,
-                const float costheta, float * const b) const
- { int i, j, k, ki, kj, ii, jj, iout, jout, k_z;
+                const float costheta, float * const b, const int z_start,
+                const int z_end) const
+ { int i, j, k, ki, kj, ii, jj, iout, jout, z_len;
    float xl, yl, dxl, dyl, z, *p_b;
                                   // Start from the lowest position of detector
    z=-AXIS*bwid;
+   z_len=z_end-z_start;
+   p+=z_start;
    for (k=0; k < bins; k++)
     { z+=bwid; 
       entry_point(costheta, sintheta, z, &xl, &yl, &dxl, &dyl, &ki, &kj, &i,
                   &j, &ii, &jj, &iout, &jout);
                                               // superimpose all the pixel data
       if (((ii >= 1) && (ii <= msize)) || ((jj >= 1) && (jj <= msize)))
-       { p_b=&b[(i-1)*slice+(j-1)*i_msize_offset];
+       { p_b=&b[(i-1)*slice+(j-1)*i_msize_offset+z_start];
          while ((i != iout) && (j != jout))
-          if (xl < yl) { for (k_z=0; k_z < slice; k_z++)
-                          p_b[k_z]+=xl*p[k_z];
+          if (xl < yl) { vecMulScalarAdd(p, xl, p_b, z_len);
                          i+=ki;
                          p_b+=ki*slice;
                          yl-=xl;
                          xl=dxl;
                        }
-           else { for (k_z=0; k_z < slice; k_z++)
-                   p_b[k_z]+=yl*p[k_z];
+           else { vecMulScalarAdd(p, yl, p_b, z_len);
                   j+=kj;
                   p_b+=kj*i_msize_offset;
                   xl-=yl;
@@ -57,29 +62,29 @@ void PB_3D::change_COR(const float offset)
 
 /****************************************************************************/
 void PB_3D::plf(float *p, const int, const float sintheta,
-                const float costheta) const
- { int i, j, k, ki, kj, ii, jj, iout, jout, k_z;
+                const float costheta, const int z_start, const int z_end) const
+ { int i, j, k, ki, kj, ii, jj, iout, jout, z_len;
    float xl, yl, dxl, dyl, z, *p_img;
                                   // Start from the lowest position of detector
    z=-AXIS*bwid;
+   z_len=z_end-z_start;
+   p+=z_start;
    for (k=0; k < bins; k++)
-    { memset(p, 0, slice*sizeof(float));
+    { memset(p, 0, z_len*sizeof(float));
       z+=bwid;
       entry_point(costheta, sintheta, z, &xl, &yl, &dxl, &dyl, &ki, &kj, &i,
                   &j, &ii, &jj, &iout, &jout);
                                               // superimpose all the pixel data
       if (((ii >= 1) && (ii <= msize)) || ((jj>=1) && (jj<=msize)))
-       { p_img=&img[(i-1)*slice+(j-1)*i_msize_offset];
+       { p_img=&img[(i-1)*slice+(j-1)*i_msize_offset+z_start];
          while ((i != iout) && (j != jout))
-          if (xl < yl) { for (k_z=0; k_z < slice; k_z++)
-                          p[k_z]+=xl*p_img[k_z];
+          if (xl < yl) { vecMulScalarAdd(p_img, xl, p, z_len);
                          i+=ki;
                          p_img+=ki*slice;
                          yl-=xl;
                          xl=dxl;
                        }
-           else { for (k_z=0; k_z < slice; k_z++)
-                   p[k_z]+=yl*p_img[k_z];
+           else { vecMulScalarAdd(p_img, yl, p, z_len);
                   j+=kj;
                   p_img+=kj*i_msize_offset;
                   xl-=yl;
@@ -91,29 +96,30 @@ void PB_3D::plf(float *p, const int, const float sintheta,
  }
 
 void PB_3D::plf(float *p, const int, const float sintheta,
-                const float costheta, float * const b) const
- { int i, j, k, ki, kj, ii, jj, iout, jout, k_z;
+                const float costheta, float * const b, const int z_start,
+                const int z_end) const
+ { int i, j, k, ki, kj, ii, jj, iout, jout, z_len;
    float xl, yl, dxl, dyl, z, *p_b;
                                   // Start from the lowest position of detector
    z=-AXIS*bwid;
+   z_len=z_end-z_start;
+   p+=z_start;
    for (k=0; k < bins; k++)
-    { memset(p, 0, slice*sizeof(float));
+    { memset(p, 0, z_len*sizeof(float));
       z+=bwid;
       entry_point(costheta, sintheta, z, &xl, &yl, &dxl, &dyl, &ki, &kj, &i,
                   &j, &ii, &jj, &iout, &jout);
                                               // superimpose all the pixel data
       if (((ii >= 1) && (ii <= msize)) || ((jj >= 1) && (jj <= msize)))
-       { p_b=&b[(i-1)*slice+(j-1)*i_msize_offset];
+       { p_b=&b[(i-1)*slice+(j-1)*i_msize_offset+z_start];
          while ((i != iout) && (j != jout))
-          if (xl < yl) { for (k_z=0; k_z < slice; k_z++)
-                          p[k_z]+=xl*p_b[k_z];
+          if (xl < yl) { vecMulScalarAdd(p_b, xl, p, z_len);
                          i+=ki;
                          p_b+=ki*slice;
                          yl-=xl;
                          xl=dxl;
                        }
-           else { for (k_z=0; k_z < slice; k_z++)
-                   p[k_z]+=yl*p_b[k_z];
+           else { vecMulScalarAdd(p_b, yl, p, z_len);
                   j+=kj;
                   p_b+=kj*i_msize_offset;
                   xl-=yl;
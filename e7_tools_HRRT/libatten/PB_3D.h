@@ -10,10 +10,11 @@
 class PB_3D:public Projected_Image_3D
  { protected:
     void blf(float *, const int, const float, const float,
-             float * const) const;
-    void plf(float *, const int, const float, const float) const;
+             float * const, const int, const int) const;
+    void plf(float *, const int, const float, const float, const int,
+             const int) const;
     void plf(float *, const int, const float, const float,
-             float * const) const;
+             float * const, const int, const int) const;
    public:
     PB_3D(const int, const int, const int, const int, const float);
     void change_COR(const float);
@@ -3,16 +3,51 @@ Modification History
     \author Merence Sibomana  - HRRT users community (sibomana@gmail.com)
     \author Peter M. Bloomfield - HRRT users community (peter.bloomfield@camhpet.ca)
     \date 2009/08/28 Port to Linux (peter.bloomfield@camhpet.ca)
+    \date 2026/10/19 projections, backprojections and priors are calculated
+                     by worker threads
 */
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <vector>
 #include "Projected_Image_3D.h"
 #include "e7_tools_const.h"
 #include "exception.h"
+#include "logging.h"
+#include "thread_wrapper.h"
 #include <string.h>
+
+/*- constants ---------------------------------------------------------------*/
+
+const unsigned short int Projected_Image_3D::TASK_PROJECTION=0,
+                         Projected_Image_3D::TASK_BACKPROJECTION=1,
+                         Projected_Image_3D::TASK_OSEM_SUBSET=2,
+                         Projected_Image_3D::TASK_OSEM_UPDATE=3,
+                         Projected_Image_3D::TASK_PRIOR=4;
+
+/*- local functions ---------------------------------------------------------*/
+
+// Start thread to execute part of a task. The thread API is a C-API, so a
+// helper function in C is needed that calls the method.
+void *executeThread_Projected_Image_3D(void *param)
+ { try
+   { Projected_Image_3D::tthread_params *tp;
+
+     tp=(Projected_Image_3D::tthread_params *)param;
+     tp->object->threadTask(tp->task, tp->start, tp->end, tp->data);
+     return(NULL);
+   }
+   catch (const Exception r)
+    { return(new Exception(r.errCode(), r.errStr()));
+    }
+   catch (...)
+    { return(new Exception(REC_UNKNOWN_EXCEPTION,
+                           "Unknown exception generated."));
+    }
+ }
+
 /*****************************************************************************
                               Methods of
                     Abstract Projected_Image_3D class
@@ -217,52 +252,34 @@ void Projected_Image_3D::generate_subsets(int ** const subsets,
  }
 
 void Projected_Image_3D::make_backprojection(const int rotation,
-                                             const int div_twopi,
-                                             const float angle_shift) const
- { float *p=NULL;
+                                      const int div_twopi,
+                                      const float angle_shift,
+                                      const unsigned short int max_threads) const
+ { ttask_params tp;
 
-   try
-   { int m;
-     float theta;
-  
-     p=new float[p_nang_offset];
-     memset(img, 0, isize*sizeof(float));
-     for (m=0; m < nang; m++)
-      { memcpy(p, proj+m*p_nang_offset, p_nang_offset*sizeof(float));
-        theta=(float)(m*rotation*2)*M_PI/(float)(div_twopi*nang)+angle_shift;
-        blf(p, m, sin(theta), cos(theta), img);
-      }
-     delete[] p;
-   }
-   catch (...)
-    { if (p != NULL) delete[] p;
-      throw;
-    }
+   memset(img, 0, isize*sizeof(float));
+   tp.angle=NULL;
+   tp.angles=nang;
+   tp.rotation=rotation;
+   tp.div_twopi=div_twopi;
+   tp.angle_shift=angle_shift;
+   runThreads(TASK_BACKPROJECTION, slice, &tp, max_threads);
  }
 
 /****************************************************************************/
 // Projection
 void Projected_Image_3D::make_projection(const int rotation,
-                                         const int div_twopi,
-                                         const float angle_shift) const
- { float *p=NULL;
+                                      const int div_twopi,
+                                      const float angle_shift,
+                                      const unsigned short int max_threads) const
+ { ttask_params tp;
 
-   try
-   { int m; 
-     float theta, *p;
-
-     p=new float[p_nang_offset];
-     for (m=0; m < nang; m++)
-      { theta=(float)(m*rotation*2)*M_PI/(float)(div_twopi*nang)+angle_shift;
-        plf(p, m, sin(theta), cos(theta), img);
-        memcpy(proj+m*p_nang_offset, p, p_nang_offset*sizeof(float));
-      }  
-     delete[] p;
-   }
-   catch (...)
-    { if (p != NULL) delete[] p;
-      throw;
-    }
+   tp.angle=NULL;
+   tp.angles=nang;
+   tp.rotation=rotation;
+   tp.div_twopi=div_twopi;
+   tp.angle_shift=angle_shift;
+   runThreads(TASK_PROJECTION, slice, &tp, max_threads);
  }
 
 void Projected_Image_3D::max_min_ML_EM() const
@@ -283,78 +300,58 @@ void Projected_Image_3D::max_min_ML_EM() const
 // Code contains redundancy:
 // Backprojection of mask/one is performed for each iteration
 // It is slower, but it saves memory
+// The slices of the image are distributed over worker threads. The
+// derivatives of the prior are calculated for the image of the previous
+// subset, before the image is updated.
 void Projected_Image_3D::OS_EM(const int niter, const int subs,
                                const int rotation, const int div_twopi,
                                const float angle_shift, const float beta,
                                const unsigned short int *mask,
                                const bool initial,
-                               const unsigned short int loglevel) const
- { float *p1=NULL, *cdel=NULL, *del=NULL;
+                               const unsigned short int loglevel,
+                               const unsigned short int max_threads) const
+ { float *cdel=NULL, *del=NULL, *der=NULL;
    int **subsets=NULL;
 
    try
-   { int i, j, ms, m, iter, subset_size;
-     float ang, sinphi, cosphi, back_Gibbs;
-     bool mask_enforced=false;
-
-     p1=new float[p_nang_offset];
+   { int i, ms, iter, subset_size;
+     ttask_params tp;
                                      // Backprojections of one for each subsets
      del=new float[isize];
      cdel=new float[isize];
+     if (beta != 0.0f) der=new float[isize];
      if (!initial)
       for (i=0; i < isize; i++) 
        img[i]=0.01f;
-     if (mask != NULL) mask_enforced=true;
                                                             // Generate subsets
      subset_size=nang/subs;
      subsets=new int *[subs];
      for (ms=0; ms < subs; ms++)
       subsets[ms]=new int[subset_size];
      generate_subsets(subsets, nang, subset_size);
+     tp.angles=subset_size;
+     tp.rotation=rotation;
+     tp.div_twopi=div_twopi;
+     tp.angle_shift=angle_shift;
+     tp.beta=beta;
+     tp.back[0]=del;
+     tp.back[1]=cdel;
+     tp.der=der;
+     tp.mask=mask;
                                        // OS-EM algorithm starts iterating here
      for (iter=0; iter < niter; iter++)
       { Logging::flog()->logMsg("iteration: #1", loglevel)->arg(iter+1);
         for (ms = 0; ms < subs; ms++)
          { memset(del, 0, isize*sizeof(float));
            memset(cdel, 0, isize*sizeof(float));
-           for (j=0; j < subset_size; j++)
-            { int offset;
-
-              m=subsets[ms][j];
-              offset=m*p_nang_offset;
-              ang=(float)(m*rotation*2)*M_PI/(float)(div_twopi*nang)+
-                  angle_shift;
-              sinphi=sin(ang);
-              cosphi=cos(ang);
-                                        // project img[] onto p1[] at angle ang
-              plf(p1, m, sinphi, cosphi);
-              for (i=0; i < p_nang_offset; i++)
-               { if (p1[i] == 0.0f) p1[i]=1.0f;
-                  else p1[i]=proj[offset+i]/p1[i];
-                 if (mask_enforced) p1[i]*=mask[offset+i];
-               }
-                                                 // backproject p1[] into del[]
-              blf(p1, m, sinphi, cosphi, del);
-              for (i=0; i < p_nang_offset; i++)
-               if (mask_enforced) p1[i]=mask[offset+i];
-                else p1[i]=1.0f;
-              blf(p1, m, sinphi, cosphi, cdel);
-            }
+           tp.angle=subsets[ms];
+           runThreads(TASK_OSEM_SUBSET, slice, &tp, max_threads);
                                                                 // Update image
-           if (beta != 0.0f)
-            for (i=0; i < isize; i++)
-             if ((back_Gibbs=cdel[i]+beta*der_U(i, img)) < 0.0f)
-              throw Exception(REC_NONNEG_CONSTRAINT,
-                              "Violation of nonnegativity constraint in OSEM "
-                              "reconstruction.");
-              else img[i]*=del[i]/back_Gibbs;
-            else for (i=0; i < isize; i++) 
-                  if (cdel[i] != 0.0f) img[i]*=del[i]/cdel[i];
+           if (beta != 0.0f) runThreads(TASK_PRIOR, isize, &tp, max_threads);
+           runThreads(TASK_OSEM_UPDATE, isize, &tp, max_threads);
            max_min_ML_EM();
          }
       }
-     delete[] p1;
-     p1=NULL;
      delete[] cdel;
      cdel=NULL;
      for (ms=0; ms < subs; ms++)
@@ -365,11 +362,14 @@ void Projected_Image_3D::OS_EM(const int niter, const int subs,
      subsets=NULL;
      delete[] del;
      del=NULL;
+     if (der != NULL) { delete[] der;
+                        der=NULL;
+                      }
    }
    catch (...)
-    { if (p1 != NULL) delete[] p1;
-      if (cdel != NULL) delete[] cdel;
+    { if (cdel != NULL) delete[] cdel;
       if (del != NULL) delete[] del;
+      if (der != NULL) delete[] der;
       if (subsets != NULL)
        { for (unsigned short int ms=0; ms < subs; ms++)
           if (subsets[ms] != NULL) delete[] subsets[ms];
@@ -406,6 +406,163 @@ void Projected_Image_3D::read_proj(const float * const external) const
       *pp++=external[k*p_input_offset+m*bins+j];
  }
 
+// Split a task into ranges of slices or voxels and execute the ranges in
+// worker threads. Each thread works on its own part of the image and
+// projections, so no locking is needed and the result doesn't depend on the
+// number of threads.
+void Projected_Image_3D::runThreads(const unsigned short int task,
+                                    const int size, void * const data,
+                                    const unsigned short int max_threads) const
+ { std::vector <tthread_id> tid;
+   std::vector <bool> thread_running;
+   void *thread_result;
+
+   try
+   { std::vector <tthread_params> tp;
+     unsigned short int threads, t;
+     int start, rest;
+
+     threads=(unsigned short int)std::max(std::min((int)max_threads, size), 1);
+     if (threads == 1) { threadTask(task, 0, size, data);
+                         return;
+                       }
+     tid.resize(threads);
+     tp.resize(threads);
+     thread_running.assign(threads, false);
+     for (start=0, rest=size, t=0; t < threads; t++)
+      { tp[t].object=this;
+        tp[t].task=task;
+        tp[t].start=start;
+        tp[t].end=start+rest/(threads-t);
+        tp[t].data=data;
+        rest-=tp[t].end-tp[t].start;
+        start=tp[t].end;
+        thread_running[t]=true;
+        ThreadCreate(&tid[t], &executeThread_Projected_Image_3D, &tp[t]);
+      }
+                                              // wait for all threads to finish
+     for (t=0; t < threads; t++)
+      { ThreadJoin(tid[t], &thread_result);
+        thread_running[t]=false;
+        if (thread_result != NULL) throw (Exception *)thread_result;
+      }
+   }
+   catch (const Exception *r)                 // handle exceptions from threads
+    { std::string err_str;
+      unsigned long int err_code;
+                                      // wait for the other threads to finish
+      for (unsigned short int t=0; t < thread_running.size(); t++)
+       if (thread_running[t])
+        { ThreadJoin(tid[t], &thread_result);
+          if (thread_result != NULL) delete (Exception *)thread_result;
+        }
+                                    // move exception object from heap to stack
+      err_code=r->errCode();
+      err_str=r->errStr();
+      delete r;
+      throw Exception(err_code, err_str);                    // and throw again
+    }
+   catch (...)
+    { for (unsigned short int t=0; t < thread_running.size(); t++)
+       if (thread_running[t])
+        { ThreadJoin(tid[t], &thread_result);
+          if (thread_result != NULL) delete (Exception *)thread_result;
+        }
+      throw;
+    }
+ }
+
 float Projected_Image_3D::term_U(const int, const float * const) const
  { return(0.0f);
  }
+
+// Execute part of a task. For projections and backprojections start and end
+// are slices, otherwise they are voxel indices.
+void Projected_Image_3D::threadTask(const unsigned short int task,
+                                    const int start, const int end,
+                                    void * const data) const
+ { ttask_params *tp;
+   float *p=NULL;
+
+   tp=(ttask_params *)data;
+   try
+   { int i, j, k, z, m;
+     float ang;
+
+     if ((task == TASK_PROJECTION) || (task == TASK_BACKPROJECTION) ||
+         (task == TASK_OSEM_SUBSET))
+      p=new float[p_nang_offset];
+     if (task == TASK_PROJECTION)
+      for (m=0; m < nang; m++)
+       { ang=(float)(m*tp->rotation*2)*M_PI/(float)(tp->div_twopi*nang)+
+             tp->angle_shift;
+         plf(p, m, sin(ang), cos(ang), img, start, end);
+         for (k=0; k < bins; k++)
+          memcpy(proj+m*p_nang_offset+k*slice+start, p+k*slice+start,
+                 (end-start)*sizeof(float));
+       }
+      else if (task == TASK_BACKPROJECTION)
+      for (m=0; m < nang; m++)
+       { ang=(float)(m*tp->rotation*2)*M_PI/(float)(tp->div_twopi*nang)+
+             tp->angle_shift;
+         for (k=0; k < bins; k++)
+          memcpy(p+k*slice+start, proj+m*p_nang_offset+k*slice+start,
+                 (end-start)*sizeof(float));
+         blf(p, m, sin(ang), cos(ang), img, start, end);
+       }
+      else if (task == TASK_OSEM_SUBSET)
+      for (j=0; j < tp->angles; j++)
+       { float sinphi, cosphi;
+         int offset;
+
+         m=tp->angle[j];
+         offset=m*p_nang_offset;
+         ang=(float)(m*tp->rotation*2)*M_PI/(float)(tp->div_twopi*nang)+
+             tp->angle_shift;
+         sinphi=sin(ang);
+         cosphi=cos(ang);
+                                        // project img[] onto p[] at angle ang
+         plf(p, m, sinphi, cosphi, start, end);
+         for (k=0; k < bins; k++)
+          for (z=start, i=k*slice+start; z < end; z++,
+               i++)
+           { if (p[i] == 0.0f) p[i]=1.0f;
+              else p[i]=proj[offset+i]/p[i];
+             if (tp->mask != NULL) p[i]*=tp->mask[offset+i];
+           }
+                                              // backproject p[] into del[]
+         blf(p, m, sinphi, cosphi, tp->back[0], start, end);
+         for (k=0; k < bins; k++)
+          for (z=start, i=k*slice+start; z < end; z++,
+               i++)
+           if (tp->mask != NULL) p[i]=tp->mask[offset+i];
+            else p[i]=1.0f;
+         blf(p, m, sinphi, cosphi, tp->back[1], start, end);
+       }
+      else if (task == TASK_PRIOR)
+      for (i=start; i < end; i++)
+       tp->der[i]=der_U(i, img+i);
+      else if (task == TASK_OSEM_UPDATE)
+      { float back_Gibbs;
+
+        if (tp->beta != 0.0f)
+         { for (i=start; i < end; i++)
+            if ((back_Gibbs=tp->back[1][i]+tp->beta*tp->der[i]) < 0.0f)
+             throw Exception(REC_NONNEG_CONSTRAINT,
+                             "Violation of nonnegativity constraint in OSEM "
+                             "reconstruction.");
+             else img[i]*=tp->back[0][i]/back_Gibbs;
+         }
+         else for (i=start; i < end; i++)
+               if (tp->back[1][i] != 0.0f) img[i]*=tp->back[0][i]/
+                                                   tp->back[1][i];
+      }
+     if (p != NULL) { delete[] p;
+                      p=NULL;
+                    }
+   }
+   catch (...)
+    { if (p != NULL) delete[] p;
+      throw;
+    }
+ }
@@ -18,7 +18,32 @@
 #include <cstdlib>
 
 class Projected_Image_3D
- { protected:
+ { public:
+                                              // parameters for worker threads
+    typedef struct { const Projected_Image_3D *object;                // object
+                     unsigned short int task;                 // task of thread
+                     int start,                         // first slice or voxel
+                         end;                        // last slice or voxel + 1
+                     void *data;                            // data of the task
+                   } tthread_params;
+                                        // parameters for tasks of the threads
+    typedef struct { const int *angle;                // numbers of projections
+                     int angles,                       // number of projections
+                         rotation,                     // direction of rotation
+                         div_twopi;                // fraction of 2pi of a scan
+                     float angle_shift,                      // offset of angle
+                           beta,                         // weight of the prior
+                           *back[2],              // results of backprojections
+                           *der;                    // derivatives of the prior
+                     const unsigned short int *mask;         // projection mask
+                   } ttask_params;
+   protected:
+                                                     // tasks of worker threads
+    static const unsigned short int TASK_PROJECTION,
+                                    TASK_BACKPROJECTION,
+                                    TASK_OSEM_SUBSET,
+                                    TASK_OSEM_UPDATE,
+                                    TASK_PRIOR;
                                                                // Basic members
     int msize,
         slice,
@@ -43,15 +68,20 @@ class Projected_Image_3D
                      int * const, int * const) const;
     void generate_subsets(int ** const, const int, const int) const;
     void max_min_ML_EM() const;
+                                        // split task into slices or voxels and
+                                        // execute it in worker threads
+    void runThreads(const unsigned short int, const int, void * const,
+                    const unsigned short int) const;
                                                        // Derivatives of Priors
     virtual float der_U(const int, const float * const) const;
     virtual float term_U(const int, const float * const) const;
                                                      // Projector/Backprojector
-    virtual void plf(float *, const int, const float, const float) const=0;
+    virtual void plf(float *, const int, const float, const float, const int,
+                     const int) const=0;
     virtual void plf(float *, const int, const float, const float,
-                     float * const) const=0;
+                     float * const, const int, const int) const=0;
     virtual void blf(float *, const int, const float, const float,
-                     float * const) const=0;
+                     float * const, const int, const int) const=0;
    public:
     Projected_Image_3D(int, int, int, int, float);
     virtual ~Projected_Image_3D();
@@ -59,13 +89,18 @@ class Projected_Image_3D
     void copy_image(float * const) const;
     void copy_proj(float * const) const;
                                                                   // Projection
-    void make_projection(const int, const int, const float) const;
-    void make_backprojection(const int, const int, const float) const;
+    void make_projection(const int, const int, const float,
+                         const unsigned short int) const;
+    void make_backprojection(const int, const int, const float,
+                             const unsigned short int) const;
                                                               // Reconstruction
                                                              // OS-EM algorithm
     void OS_EM(const int, const int, const int, const int, const float,
                const float, const unsigned short int *, const bool,
-               const unsigned short int) const;
+               const unsigned short int, const unsigned short int) const;
+                                          // execute part of task in a thread
+    virtual void threadTask(const unsigned short int, const int, const int,
+                            void * const) const;
                                                               // Read operators
     void read_image(const float * const) const; 
     void read_proj(const float * const) const;
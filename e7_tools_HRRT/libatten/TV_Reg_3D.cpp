@@ -0,0 +1,481 @@
+/*
+Modification History
+    \date 2026/10/19 native version of the TV regularization of TX_TV3DReg
+                     (Sune H. Keller, Merence Sibomana), tiled and calculated
+                     by worker threads
+    \date 2026/10/19 lexicographic relaxation of TX_TV3DReg is the default
+                     again, red-black relaxation is optional
+*/
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include "TV_Reg_3D.h"
+#include "exception.h"
+#include "thread_wrapper.h"
+
+/*- constants ---------------------------------------------------------------*/
+
+const unsigned short int TV_Reg_3D::TASK_COEFFICIENTS=0,
+                         TV_Reg_3D::TASK_RELAX_RED=1,
+                         TV_Reg_3D::TASK_RELAX_BLACK=2,
+                         TV_Reg_3D::TASK_DUAL=3,
+                         TV_Reg_3D::TASK_PRIMAL=4;
+
+const float TV_Reg_3D::EPS2=0.0001f,
+            TV_Reg_3D::CONVERGENCE=1e-7f;
+
+const int TV_Reg_3D::TILE_BYTES=256*1024,
+          TV_Reg_3D::TILE_PLANES=4;
+
+/*- local functions ---------------------------------------------------------*/
+
+// Thread wrapper for the tasks of the TV regularization. Returns NULL or a
+// pointer to an exception object.
+void *executeThread_TV_Reg_3D(void *param)
+ { try
+   { TV_Reg_3D::tthread_params *tp;
+
+     tp=(TV_Reg_3D::tthread_params *)param;
+     tp->object->threadTask(tp->task, tp->start, tp->end);
+     return(NULL);
+   }
+   catch (const Exception r)
+    { return(new Exception(r.errCode(), r.errStr()));
+    }
+   catch (...)
+    { return(new Exception(REC_UNKNOWN_EXCEPTION,
+                           "Unknown exception generated."));
+    }
+ }
+
+/*****************************************************************************
+                              Methods of
+                           TV_Reg_3D class
+
+*****************************************************************************/
+
+// The volume is split into blocks of full rows that fit into the cache
+// together with their halo. The blocks are the units of work for the threads.
+TV_Reg_3D::TV_Reg_3D(const int nx_, const int ny_, const int nz_)
+ { int tz, ty, y, z;
+
+   nx=nx_;
+   ny=ny_;
+   nz=nz_;
+   plane=nx*ny;
+   size=plane*nz;
+   u=NULL;
+   tz=std::min(TILE_PLANES, nz);
+                        // u, u0 and three arrays of coefficients or dual values
+   ty=std::max(std::min(TILE_BYTES/(nx*tz*5*(int)sizeof(float)), ny), 1);
+   for (z=0; z < nz; z+=tz)
+    for (y=0; y < ny; y+=ty)
+     { ttile tile;
+
+       tile.y_start=y;
+       tile.y_end=std::min(y+ty, ny);
+       tile.z_start=z;
+       tile.z_end=std::min(z+tz, nz);
+       tiles.push_back(tile);
+     }
+   tile_residual.assign(tiles.size(), 0.0);
+ }
+
+// Coefficient of the face between voxel a[0] and a[ob]. o1p/o1m and o2p/o2m
+// are the offsets to the neighbours in the two other directions. Offsets are
+// 0 at the border of the volume (Neumann boundary condition).
+inline float TV_Reg_3D::face(const float * const a, const int ob,
+                             const int o1p, const int o1m, const int o2p,
+                             const int o2m) const
+ { float d, g1, g2;
+
+   d=a[ob]-a[0];
+   g1=a[o1p]-a[o1m]+a[ob+o1p]-a[ob+o1m];
+   g2=a[o2p]-a[o2m]+a[ob+o2p]-a[ob+o2m];
+   return(1.0f/sqrtf(d*d+0.0625f*(g1*g1+g2*g2)+EPS2));
+ }
+
+// Calculate the fixed nonlinear coefficients of all faces that belong to a
+// tile. Faces are stored once for both voxels, the faces at the border of
+// the volume have index 0 and nx, ny or nz.
+void TV_Reg_3D::coefficients(const ttile &tile)
+ { for (int z=tile.z_start; z < tile.z_end; z++)
+    { int ozp, ozm;
+
+      ozp=(z < nz-1 ? plane : 0);
+      ozm=(z > 0 ? -plane : 0);
+      for (int y=tile.y_start; y < tile.y_end; y++)
+       { const float *row;
+         float *bp;
+         int oyp, oym, x;
+
+         row=u+z*plane+y*nx;
+         oyp=(y < ny-1 ? nx : 0);
+         oym=(y > 0 ? -nx : 0);
+                                                         // x-direction faces
+         bp=&bx[(z*ny+y)*(nx+1)];
+         bp[0]=face(row, 0, oyp, oym, ozp, ozm);
+         for (x=1; x < nx; x++)
+          bp[x]=face(row+x-1, 1, oyp, oym, ozp, ozm);
+         bp[nx]=face(row+nx-1, 0, oyp, oym, ozp, ozm);
+                                                         // y-direction faces
+         bp=&by[(z*(ny+1)+y)*nx];
+         for (x=0; x < nx; x++)
+          bp[x]=face(row+x+oym, (y > 0 ? nx : 0), (x < nx-1 ? 1 : 0),
+                     (x > 0 ? -1 : 0), ozp, ozm);
+         if (y == ny-1)
+          for (bp+=nx, x=0; x < nx; x++)
+           bp[x]=face(row+x, 0, (x < nx-1 ? 1 : 0), (x > 0 ? -1 : 0), ozp,
+                      ozm);
+                                                         // z-direction faces
+         bp=&bz[(z*ny+y)*nx];
+         for (x=0; x < nx; x++)
+          bp[x]=face(row+x+ozm, (z > 0 ? plane : 0), (x < nx-1 ? 1 : 0),
+                     (x > 0 ? -1 : 0), oyp, oym);
+         if (z == nz-1)
+          for (bp+=plane, x=0; x < nx; x++)
+           bp[x]=face(row+x, 0, (x < nx-1 ? 1 : 0), (x > 0 ? -1 : 0), oyp,
+                      oym);
+       }
+    }
+ }
+
+// Relaxation step for the voxels of one colour of the tile. Voxels with
+// even x+y+z are red, the others are black. The neighbours of a voxel have
+// the other colour, so all voxels of one colour can be updated in parallel.
+void TV_Reg_3D::relax(const ttile &tile, const int colour,
+                      double * const residual)
+ { double r=0.0;
+
+   for (int z=tile.z_start; z < tile.z_end; z++)
+    { int ozp, ozm;
+
+      ozp=(z < nz-1 ? plane : 0);
+      ozm=(z > 0 ? -plane : 0);
+      for (int y=tile.y_start; y < tile.y_end; y++)
+       { const float *bxp, *byp, *bzp, *u0p;
+         float *up;
+         int oyp, oym;
+
+         up=u+z*plane+y*nx;
+         u0p=&u0[z*plane+y*nx];
+         bxp=&bx[(z*ny+y)*(nx+1)];
+         byp=&by[(z*(ny+1)+y)*nx];
+         bzp=&bz[(z*ny+y)*nx];
+         oyp=(y < ny-1 ? nx : 0);
+         oym=(y > 0 ? -nx : 0);
+         for (int x=(y+z+colour) & 0x1; x < nx; x+=2)
+          { float *c, sum, unew;
+
+            c=up+x;
+            sum=bxp[x]+bxp[x+1]+byp[x]+byp[x+nx]+bzp[x]+bzp[x+plane];
+            unew=(lambda*(bxp[x]*c[x > 0 ? -1 : 0]+
+                          bxp[x+1]*c[x < nx-1 ? 1 : 0]+
+                          byp[x]*c[oym]+byp[x+nx]*c[oyp]+
+                          bzp[x]*c[ozm]+bzp[x+plane]*c[ozp])+u0p[x])/
+                 (1.0f+lambda*sum);
+            r+=(double)(c[0]-unew)*(double)(c[0]-unew);
+            c[0]=unew;
+          }
+       }
+    }
+   *residual+=r;
+ }
+
+// Relaxation sweep over the whole volume in the order of the original
+// TX_TV3DReg, x fastest, then y and z. The neighbours in the previous row and
+// plane are already updated, the neighbour at x-1 is used with its value
+// before the update, as in the 3x3x3 neighbourhood loop of CImg. The sweep is
+// sequential; returns the sum of the squared changes.
+double TV_Reg_3D::relax_lexicographic()
+ { double r=0.0;
+
+   for (int z=0; z < nz; z++)
+    { int ozp, ozm;
+
+      ozp=(z < nz-1 ? plane : 0);
+      ozm=(z > 0 ? -plane : 0);
+      for (int y=0; y < ny; y++)
+       { const float *bxp, *byp, *bzp, *u0p;
+         float *up, west;
+         int oyp, oym;
+
+         up=u+z*plane+y*nx;
+         u0p=&u0[z*plane+y*nx];
+         bxp=&bx[(z*ny+y)*(nx+1)];
+         byp=&by[(z*(ny+1)+y)*nx];
+         bzp=&bz[(z*ny+y)*nx];
+         oyp=(y < ny-1 ? nx : 0);
+         oym=(y > 0 ? -nx : 0);
+         west=up[0];
+         for (int x=0; x < nx; x++)
+          { float *c, sum, unew, old;
+
+            c=up+x;
+            old=c[0];
+            sum=bxp[x]+bxp[x+1]+byp[x]+byp[x+nx]+bzp[x]+bzp[x+plane];
+            unew=(lambda*(bxp[x]*west+
+                          bxp[x+1]*c[x < nx-1 ? 1 : 0]+
+                          byp[x]*c[oym]+byp[x+nx]*c[oyp]+
+                          bzp[x]*c[ozm]+bzp[x+plane]*c[ozp])+u0p[x])/
+                 (1.0f+lambda*sum);
+            r+=(double)(old-unew)*(double)(old-unew);
+            c[0]=unew;
+            west=old;
+          }
+       }
+    }
+   return(r);
+ }
+
+// Dual step of the primal-dual algorithm: gradient ascent with forward
+// differences of the extrapolated volume, followed by the proximal map of
+// the conjugate of the Huber-smoothed TV functional.
+void TV_Reg_3D::dual(const ttile &tile)
+ { float alpha_scale, eps;
+
+   eps=sqrtf(EPS2);
+   alpha_scale=1.0f/(1.0f+sigma*eps/lambda);
+   for (int z=tile.z_start; z < tile.z_end; z++)
+    for (int y=tile.y_start; y < tile.y_end; y++)
+     { int idx;
+
+       idx=z*plane+y*nx;
+       for (int x=0; x < nx; x++,
+            idx++)
+        { float qx, qy, qz, norm;
+
+          qx=px[idx];
+          qy=py[idx];
+          qz=pz[idx];
+          if (x < nx-1) qx+=sigma*(ubar[idx+1]-ubar[idx]);
+          if (y < ny-1) qy+=sigma*(ubar[idx+nx]-ubar[idx]);
+          if (z < nz-1) qz+=sigma*(ubar[idx+plane]-ubar[idx]);
+          qx*=alpha_scale;
+          qy*=alpha_scale;
+          qz*=alpha_scale;
+          norm=sqrtf(qx*qx+qy*qy+qz*qz);
+          if (norm > lambda) { norm=lambda/norm;
+                               qx*=norm;
+                               qy*=norm;
+                               qz*=norm;
+                             }
+          px[idx]=qx;
+          py[idx]=qy;
+          pz[idx]=qz;
+        }
+     }
+ }
+
+// Primal step of the primal-dual algorithm: proximal map of the quadratic
+// data term and extrapolation.
+void TV_Reg_3D::primal(const ttile &tile, double * const residual)
+ { double r=0.0;
+
+   for (int z=tile.z_start; z < tile.z_end; z++)
+    for (int y=tile.y_start; y < tile.y_end; y++)
+     { int idx;
+
+       idx=z*plane+y*nx;
+       for (int x=0; x < nx; x++,
+            idx++)
+        { float div, unew;
+                                          // divergence is adjoint of gradient
+          div=0.0f;
+          if (x < nx-1) div+=px[idx];
+          if (x > 0) div-=px[idx-1];
+          if (y < ny-1) div+=py[idx];
+          if (y > 0) div-=py[idx-nx];
+          if (z < nz-1) div+=pz[idx];
+          if (z > 0) div-=pz[idx-plane];
+          unew=(u[idx]+tau*(div+u0[idx]))/(1.0f+tau);
+          ubar[idx]=unew+theta*(unew-u[idx]);
+          r+=(double)(u[idx]-unew)*(double)(u[idx]-unew);
+          u[idx]=unew;
+        }
+     }
+   *residual+=r;
+ }
+
+// Execute a task for the tiles start to end-1.
+void TV_Reg_3D::threadTask(const unsigned short int task, const int start,
+                           const int end)
+ { for (int t=start; t < end; t++)
+    { tile_residual[t]=0.0;
+      switch (task)
+       { case TASK_COEFFICIENTS:
+          coefficients(tiles[t]);
+          break;
+         case TASK_RELAX_RED:
+          relax(tiles[t], 0, &tile_residual[t]);
+          break;
+         case TASK_RELAX_BLACK:
+          relax(tiles[t], 1, &tile_residual[t]);
+          break;
+         case TASK_DUAL:
+          dual(tiles[t]);
+          break;
+         case TASK_PRIMAL:
+          primal(tiles[t], &tile_residual[t]);
+          break;
+       }
+    }
+ }
+
+// Distribute the tiles of the volume onto worker threads and execute the
+// task. The sum of the residuals of all tiles is returned. It is summed in
+// the order of the tiles and doesn't depend on the number of threads.
+double TV_Reg_3D::runThreads(const unsigned short int task,
+                             const unsigned short int max_threads)
+ { std::vector <tthread_id> tid;
+   std::vector <bool> thread_running;
+   void *thread_result;
+
+   try
+   { std::vector <tthread_params> tp;
+     unsigned short int threads, t;
+     int start, rest;
+     double residual=0.0;
+
+     threads=(unsigned short int)std::max(std::min((int)max_threads,
+                                                   (int)tiles.size()), 1);
+     if (threads == 1) threadTask(task, 0, tiles.size());
+      else { tid.resize(threads);
+             tp.resize(threads);
+             thread_running.assign(threads, false);
+             for (start=0, rest=tiles.size(), t=0; t < threads; t++)
+              { tp[t].object=this;
+                tp[t].task=task;
+                tp[t].start=start;
+                tp[t].end=start+rest/(threads-t);
+                rest-=tp[t].end-tp[t].start;
+                start=tp[t].end;
+                thread_running[t]=true;
+                ThreadCreate(&tid[t], &executeThread_TV_Reg_3D, &tp[t]);
+              }
+                                              // wait for all threads to finish
+             for (t=0; t < threads; t++)
+              { ThreadJoin(tid[t], &thread_result);
+                thread_running[t]=false;
+                if (thread_result != NULL) throw (Exception *)thread_result;
+              }
+           }
+     for (unsigned int i=0; i < tile_residual.size(); i++)
+      residual+=tile_residual[i];
+     return(residual);
+   }
+   catch (const Exception *r)                 // handle exceptions from threads
+    { std::string err_str;
+      unsigned long int err_code;
+                                      // wait for the other threads to finish
+      for (unsigned short int t=0; t < thread_running.size(); t++)
+       if (thread_running[t])
+        { ThreadJoin(tid[t], &thread_result);
+          if (thread_result != NULL) delete (Exception *)thread_result;
+        }
+                                    // move exception object from heap to stack
+      err_code=r->errCode();
+      err_str=r->errStr();
+      delete r;
+      throw Exception(err_code, err_str);                    // and throw again
+    }
+   catch (...)
+    { for (unsigned short int t=0; t < thread_running.size(); t++)
+       if (thread_running[t])
+        { ThreadJoin(tid[t], &thread_result);
+          if (thread_result != NULL) delete (Exception *)thread_result;
+        }
+      throw;
+    }
+ }
+
+// Replace underestimated tissue voxels (between threshold and mu_tissue) by
+// the u-value of tissue.
+void TV_Reg_3D::replace_tissue(float * const img, const float threshold,
+                               const float mu_tissue) const
+ { for (int i=0; i < size; i++)
+    if ((img[i] > threshold) && (img[i] < mu_tissue)) img[i]=mu_tissue;
+ }
+
+// TV regularization by lagged diffusivity: the outer fixed point iterations
+// calculate the nonlinear coefficients, the inner relaxation iterations solve
+// the linear system by Gauss-Seidel sweeps. The default sweep is the
+// sequential sweep of the original TX_TV3DReg, so that results are
+// reproduced; the red-black sweep runs in parallel but converges to the
+// same solution along a different path (up to 6e-3 1/cm after the default
+// 2x3 iterations on a HRRT u-map). The relaxation stops early if the change
+// of the volume is below the convergence threshold. The volume is regularized
+// in place, the number of relaxation iterations is returned.
+int TV_Reg_3D::fixed_point(float * const img, const float lambda_,
+                           const int fp_iterations, const int relax_iterations,
+                           const unsigned short int max_threads,
+                           const bool red_black)
+ { int iter=0;
+
+   u=img;
+   lambda=lambda_;
+   u0.assign(img, img+size);
+   bx.resize((nx+1)*ny*nz);
+   by.resize(nx*(ny+1)*nz);
+   bz.resize(plane*(nz+1));
+   for (int i=0; i < fp_iterations; i++)
+    { runThreads(TASK_COEFFICIENTS, max_threads);
+      for (int j=0; j < relax_iterations; j++)
+       { double residual;
+
+         iter++;
+         if (red_black)
+          { residual=runThreads(TASK_RELAX_RED, max_threads);
+            residual+=runThreads(TASK_RELAX_BLACK, max_threads);
+          }
+          else residual=relax_lexicographic();
+         if (sqrt(residual)/(double)size < CONVERGENCE) break;
+       }
+    }
+   u0.clear();
+   bx.clear();
+   by.clear();
+   bz.clear();
+   u=NULL;
+   return(iter);
+ }
+
+// TV regularization by the accelerated primal-dual algorithm of Chambolle
+// and Pock for the TV-L2 model with Huber-smoothed TV functional. The data
+// term is uniformly convex, therefore the step widths are adapted in each
+// iteration. The volume is regularized in place, the number of iterations is
+// returned.
+int TV_Reg_3D::primal_dual(float * const img, const float lambda_,
+                           const int iterations,
+                           const unsigned short int max_threads)
+ { int iter=0;
+
+   u=img;
+   lambda=lambda_;
+   u0.assign(img, img+size);
+   ubar.assign(img, img+size);
+   px.assign(size, 0.0f);
+   py.assign(size, 0.0f);
+   pz.assign(size, 0.0f);
+                           // norm of 3d gradient operator is bounded by sqrt(12)
+   tau=1.0f/sqrtf(12.0f);
+   sigma=tau;
+   while (iter < iterations)
+    { double residual;
+
+      iter++;
+      runThreads(TASK_DUAL, max_threads);
+      theta=1.0f/sqrtf(1.0f+2.0f*tau);
+      residual=runThreads(TASK_PRIMAL, max_threads);
+      tau*=theta;
+      sigma/=theta;
+      if (sqrt(residual)/(double)size < CONVERGENCE) break;
+    }
+   u0.clear();
+   ubar.clear();
+   px.clear();
+   py.clear();
+   pz.clear();
+   u=NULL;
+   return(iter);
+ }
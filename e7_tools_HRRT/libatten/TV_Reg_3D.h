@@ -0,0 +1,74 @@
+/*****************************************************************************
+                           Declarations of
+                           TV_Reg_3D class
+
+    Total variation denoising of u-maps (TX_TV3DReg). The volume is stored
+    with x as first array index, followed by y and z.
+*****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+class TV_Reg_3D
+ { public:
+                                              // parameters for worker threads
+    typedef struct { TV_Reg_3D *object;                               // object
+                     unsigned short int task;                 // task of thread
+                     int start,                                   // first tile
+                         end;                                  // last tile + 1
+                   } tthread_params;
+   private:
+                                                       // block of the volume
+    typedef struct { int y_start,                                  // first row
+                         y_end,                                 // last row + 1
+                         z_start,                                // first plane
+                         z_end;                               // last plane + 1
+                   } ttile;
+                                                     // tasks of worker threads
+    static const unsigned short int TASK_COEFFICIENTS,
+                                    TASK_RELAX_RED,
+                                    TASK_RELAX_BLACK,
+                                    TASK_DUAL,
+                                    TASK_PRIMAL;
+    static const float EPS2,              // differentiability of TV functional
+                       CONVERGENCE;               // threshold for convergence
+    static const int TILE_BYTES,                  // cache budget for one tile
+                     TILE_PLANES;                 // number of planes per tile
+    int nx,                                                 // width of volume
+        ny,                                                // height of volume
+        nz,                                                 // depth of volume
+        plane,                                      // number of voxels in plane
+        size;                                      // number of voxels in volume
+    float lambda,                                         // smoothing weight
+          tau,                                          // primal step width
+          sigma,                                          // dual step width
+          theta,                                  // extrapolation parameter
+          *u;                                          // volume to regularize
+    std::vector <float> u0,                                     // input volume
+                        bx,             // coefficients of faces in x-direction
+                        by,             // coefficients of faces in y-direction
+                        bz,             // coefficients of faces in z-direction
+                        px,             // dual variable for x-direction
+                        py,             // dual variable for y-direction
+                        pz,             // dual variable for z-direction
+                        ubar;                         // extrapolated volume
+    std::vector <ttile> tiles;                          // blocks of the volume
+    std::vector <double> tile_residual;         // squared changes of the tiles
+    float face(const float * const, const int, const int, const int,
+               const int, const int) const;
+    void coefficients(const ttile &);
+    void relax(const ttile &, const int, double * const);
+    double relax_lexicographic();
+    void dual(const ttile &);
+    void primal(const ttile &, double * const);
+    double runThreads(const unsigned short int, const unsigned short int);
+   public:
+    TV_Reg_3D(const int, const int, const int);
+    void replace_tissue(float * const, const float, const float) const;
+    int fixed_point(float * const, const float, const int, const int,
+                    const unsigned short int, const bool);
+    int primal_dual(float * const, const float, const int,
+                    const unsigned short int);
+    void threadTask(const unsigned short int, const int, const int);
+ };
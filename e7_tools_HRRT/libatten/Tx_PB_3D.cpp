@@ -11,6 +11,8 @@
      Equation (7):ln(ACF)=a+b*ln(slab/tx) ==> ln(ACF)=a+b*ln(bl/tx)
      ==> p = a+b*ln(bl/tx) in MAP-TR method
      \date 2009/08/28 Port to Linux (peter.bloomfield@camhpet.ca)
+     \date 2026/10/19 use worker threads for projections, backprojections
+                      and image update
 
  */
 
@@ -29,6 +31,11 @@
                     Concrete  Tx_PB_Image class
 
 *****************************************************************************/
+template <typename T>
+const unsigned short int Tx_PB_3D <T>::TASK_MAPTR_SUBSET=10;
+template <typename T>
+const unsigned short int Tx_PB_3D <T>::TASK_MAPTR_UPDATE=11;
+
 template <typename T>
 Tx_PB_3D <T>::Tx_PB_3D(const int size, const int size_z, const int nang,
                        const int bins, const float bwid): 
@@ -179,14 +186,16 @@ void Tx_PB_3D <T>::MAPTR(const int niter, const int subs, const int rotation,
                          const float beta_ip, const int niter_ip,
                          const bool initial, const bool autoscale,
                          const float autoscalevalue,
-                         const unsigned short int loglevel)
- { float *mu_interval=NULL, *p=NULL, *back_up=NULL, *back_down=NULL,
+                         const unsigned short int loglevel,
+                         const unsigned short int max_threads)
+ { float *mu_interval=NULL, *back_up=NULL, *back_down=NULL, *der=NULL,
          *gauss_intersect=NULL, *mu_mean=NULL, *std=NULL;
    int **subsets=NULL;
 
    try
-   { int i, j, m, ms, iter, subset_size;
-     float ang, sinphi, cosphi, grprior_ip=0, g2prior_ip=0, sample=0.0f;
+   { int i, ms, iter, subset_size;
+     float sample=0.0f;
+     tmaptr_params mp;
      unsigned short int water_peak=0;
      float a_exp=1.0f, b=1.0f; 
      float peak=0.0f;
@@ -228,15 +237,34 @@ void Tx_PB_3D <T>::MAPTR(const int niter, const int subs, const int rotation,
       { mu_interval[2*i]=(mu_mean[i]+gauss_intersect[i])/2.0f;
         mu_interval[2*i+1]=(mu_mean[i+1]+gauss_intersect[i])/2.0f;
       }
-     p=new float[p_nang_offset];   
      back_up=new float[isize] ;
      back_down=new float[isize];
+     if (beta != 0.0f) der=new float[isize];
      if (!initial) memset(img, 0, isize*sizeof(float));
      subset_size=nang/subs;
      subsets=new int *[subs];
      for (ms=0; ms < subs; ms++)
       subsets[ms]=new int[subset_size];
      generate_subsets(subsets, nang, subset_size);
+     mp.tp.angles=subset_size;
+     mp.tp.rotation=rotation;
+     mp.tp.div_twopi=div_twopi;
+     mp.tp.angle_shift=angle_shift;
+     mp.tp.beta=beta;
+     mp.tp.back[0]=back_up;
+     mp.tp.back[1]=back_down;
+     mp.tp.der=der;
+     mp.tp.mask=NULL;
+     mp.a_exp=a_exp;
+     mp.b=b;
+     mp.sc_thres=sc_thres;
+     mp.alpha=alpha;
+     mp.beta_ip=beta_ip;
+     mp.mu_number=mu_number;
+     mp.mu_mean=mu_mean;
+     mp.std=std;
+     mp.gauss_intersect=gauss_intersect;
+     mp.mu_interval=mu_interval;
      for (iter=0; iter < niter; iter++)
       { Logging::flog()->logMsg("iteration: #1", loglevel)->arg(iter+1);
         if (((iter == niter_ip) && (beta_ip > 0.0f)) ||
@@ -273,52 +301,18 @@ void Tx_PB_3D <T>::MAPTR(const int niter, const int subs, const int rotation,
                mu_interval[i]*=peak;
             }
          }
+        mp.ip_grad=(beta_ip != 0.0f) && (iter >= niter_ip);
         for (ms=0; ms < subs; ms++)
          { memset(back_up, 0, isize*sizeof(float));
            memset(back_down, 0, isize*sizeof(float));
-           for (j=0; j < subset_size; j++ )
-            { int offset;
-
-              m=subsets[ms][j];
-              offset=m*p_nang_offset;
-              ang=(float)(m*rotation*2)*M_PI/(float)(div_twopi*nang)+
-                  angle_shift;
-              sinphi=sin(ang);
-              cosphi=cos(ang);
-                                     // Backprojection of Tx data:
-                                     // this is redundancy, however save memory
-              for (i=0; i < p_nang_offset; i++) 
-               p[i]=tx[offset+i];
-              blf(p, m, sinphi, cosphi, back_up);
-                                               // Projection of attenuation map
-              plf(p, m, sinphi, cosphi);
-                    // Backprojection of model: attenuation weighted blank data
-
-              for (i=0; i < p_nang_offset; i++)
-              {
-               if (p[i]<sc_thres)
-                 p[i] = blank[offset+i]*exp(-p[i]);
-               else  
-                 p[i] = a_exp*blank[offset+i]*exp(-p[i]/b);
-              }
-
-              blf(p, m, sinphi, cosphi, back_down);
-            }
+           mp.tp.angle=subsets[ms];
+                      // projections and backprojections are calculated by
+                      // threads which work on different slices of the image
+           runThreads(TASK_MAPTR_SUBSET, slice, &mp, max_threads);
                                                                 // update image
-           for (i=0; i < isize; i++)
-            { if ((beta_ip != 0.0f) && (iter >= niter_ip))
-               IP_grad(&grprior_ip, &g2prior_ip, img[i], mu_number, mu_mean,
-                       std, gauss_intersect, mu_interval);
-              img[i]+=alpha*(back_down[i]-back_up[i]-
-                             (beta == 0.0f ? 0.0f : beta*der_U(i, img+i))- 
-                             ((beta_ip == 0.0f) &&
-                              (iter >= niter_ip) ? 0.0f : beta_ip*grprior_ip))/
-                            (msize*back_down[i]+
-                             (beta == 0.0f ? 0.0f : beta*der_der_U(i, img+i))+
-                             (beta_ip == 0.0f ? 0.0f : beta_ip*g2prior_ip));
-                                                       // positivity constraint
-              if (img[i] < 0.0f) img[i]=0.0f;
-            }
+           if (beta != 0.0f) runThreads(TASK_PRIOR, isize, &mp.tp,
+                                        max_threads);
+           runThreads(TASK_MAPTR_UPDATE, isize, &mp, max_threads);
            max_min_ML_EM();
          }
       }
@@ -330,12 +324,13 @@ void Tx_PB_3D <T>::MAPTR(const int niter, const int subs, const int rotation,
       }
      delete[] subsets;
      subsets=NULL;
-     delete[] p;
-     p=NULL;
      delete[] back_up;
      back_up=NULL;
      delete[] back_down;
      back_down=NULL;
+     if (der != NULL) { delete[] der;
+                        der=NULL;
+                      }
      delete[] gauss_intersect;
      gauss_intersect=NULL;
      delete[] mu_mean;
@@ -374,9 +369,9 @@ void Tx_PB_3D <T>::MAPTR(const int niter, const int subs, const int rotation,
    }
    catch (...)
     { if (mu_interval != NULL) delete[] mu_interval;
-      if (p != NULL) delete[] p;
       if (back_up != NULL) delete[] back_up;
       if (back_down != NULL) delete[] back_down;
+      if (der != NULL) delete[] der;
       if (subsets != NULL)
        { for (unsigned short int ms=0; ms < subs; ms++)
           if (subsets[ms] != NULL) delete[] subsets[ms];
@@ -389,6 +384,81 @@ void Tx_PB_3D <T>::MAPTR(const int niter, const int subs, const int rotation,
     }
  }
 
+// Execute part of a task. Tasks that are not specific to MAP-TR are passed
+// to the base class.
+template <typename T>
+void Tx_PB_3D <T>::threadTask(const unsigned short int task, const int start,
+                              const int end, void * const data) const
+ { tmaptr_params *mp;
+   float *p=NULL;
+
+   if ((task != TASK_MAPTR_SUBSET) && (task != TASK_MAPTR_UPDATE))
+    { PB_3D::threadTask(task, start, end, data);
+      return;
+    }
+   mp=(tmaptr_params *)data;
+   try
+   { int i, j, k, z, m;
+
+     if (task == TASK_MAPTR_SUBSET)
+      { p=new float[p_nang_offset];
+        for (j=0; j < mp->tp.angles; j++)
+         { float ang, sinphi, cosphi;
+           int offset;
+
+           m=mp->tp.angle[j];
+           offset=m*p_nang_offset;
+           ang=(float)(m*mp->tp.rotation*2)*M_PI/
+               (float)(mp->tp.div_twopi*nang)+mp->tp.angle_shift;
+           sinphi=sin(ang);
+           cosphi=cos(ang);
+                                     // Backprojection of Tx data:
+                                     // this is redundancy, however save memory
+           for (k=0; k < bins; k++)
+            for (z=start, i=k*slice+start; z < end; z++,
+                 i++)
+             p[i]=tx[offset+i];
+           blf(p, m, sinphi, cosphi, mp->tp.back[0], start, end);
+                                               // Projection of attenuation map
+           plf(p, m, sinphi, cosphi, start, end);
+                    // Backprojection of model: attenuation weighted blank data
+           for (k=0; k < bins; k++)
+            for (z=start, i=k*slice+start; z < end; z++,
+                 i++)
+             if (p[i] < mp->sc_thres)
+              p[i]=blank[offset+i]*exp(-p[i]);
+              else p[i]=mp->a_exp*blank[offset+i]*exp(-p[i]/mp->b);
+           blf(p, m, sinphi, cosphi, mp->tp.back[1], start, end);
+         }
+        delete[] p;
+        p=NULL;
+        return;
+      }
+                                                                // update image
+     for (i=start; i < end; i++)
+      { float grprior_ip=0.0f, g2prior_ip=0.0f;
+
+        if (mp->ip_grad)
+         IP_grad(&grprior_ip, &g2prior_ip, img[i], mp->mu_number,
+                 mp->mu_mean, mp->std, mp->gauss_intersect, mp->mu_interval);
+        img[i]+=mp->alpha*(mp->tp.back[1][i]-mp->tp.back[0][i]-
+                           (mp->tp.beta == 0.0f ? 0.0f :
+                                                  mp->tp.beta*mp->tp.der[i])-
+                           mp->beta_ip*grprior_ip)/
+                (msize*mp->tp.back[1][i]+
+                 (mp->tp.beta == 0.0f ? 0.0f :
+                                        mp->tp.beta*der_der_U(i, img+i))+
+                 mp->beta_ip*g2prior_ip);
+                                                       // positivity constraint
+        if (img[i] < 0.0f) img[i]=0.0f;
+      }
+   }
+   catch (...)
+    { if (p != NULL) delete[] p;
+      throw;
+    }
+ }
+
 // Read projections and rearrange indexes
 template <typename T>
 void Tx_PB_3D <T>::read_projections(const T * const blank_external,
@@ -26,6 +26,23 @@ Modification History
 
 template <typename T> class Tx_PB_3D:public PB_3D
  { private:
+                                  // parameters for tasks of the MAP-TR threads
+    typedef struct { ttask_params tp;                      // common parameters
+                     float a_exp,                    // scatter model: exp(a/b)
+                           b,                               // scatter model: b
+                           sc_thres,             // threshold for scatter model
+                           alpha,                          // relaxation factor
+                           beta_ip;                // weight of intensity prior
+                     bool ip_grad;   // calculate gradient of intensity prior ?
+                     int mu_number;               // number of intensity priors
+                     const float *mu_mean,         // means of intensity priors
+                                 *std,        // deviations of intensity priors
+                                 *gauss_intersect,   // intersections of priors
+                                 *mu_interval;      // intervals between priors
+                   } tmaptr_params;
+                                               // tasks of the MAP-TR threads
+    static const unsigned short int TASK_MAPTR_SUBSET,
+                                    TASK_MAPTR_UPDATE;
     T *tx,
       *blank;
     float *norm;
@@ -51,8 +68,12 @@ template <typename T> class Tx_PB_3D:public PB_3D
                const float * const, const float * const, const float,
                std::vector <unsigned long int> *, const int, const float,
                const float, const float, const int, const bool, const bool,
-               const float, const unsigned short int);
+               const float, const unsigned short int,
+               const unsigned short int);
     void read_projections(const T * const, const T * const, const float);
+                                          // execute part of task in a thread
+    void threadTask(const unsigned short int, const int, const int,
+                    void * const) const;
  };
 
 /*
@@ -24,12 +24,15 @@
 using namespace HRRT;
 #endif
 #include "logging.h"
+#include "semaphore_al.h"
 #include <stdlib.h>
 
 /*- methods -----------------------------------------------------------------*/
 #ifndef _GM_TMPL_CPP
 
 GM *GM::instance=NULL;               /*!< pointer to only instance of object */
+                            /*! serializes initialization from model number */
+static Semaphore init_lock(1);
 
 /*---------------------------------------------------------------------------*/
 /*! \brief Initialize object.
@@ -329,11 +332,39 @@ GM *GM::gm()
                                       match to the already stored information
     \exception REC_UNKNOWN_CRYSTAL_MATERIAL material of crystal layer unknown
 
-    Initialize object from gantry model number.
+    Initialize object from gantry model number. A call with the model that
+    is already stored doesn't change the object, so that a thread loading
+    another file of the same gantry doesn't race with threads reading the
+    geometry.
  */
 /*---------------------------------------------------------------------------*/
-#ifdef USE_GANTRY_MODEL
 void GM::init(const std::string model_num)
+ { init_lock.wait();
+   try
+   {                   // already initialized with this model: nothing to write
+     if (!values_stored || (model_number != model_num)) initModel(model_num);
+   }
+   catch (...)
+    { init_lock.signal();
+      throw;
+    }
+   init_lock.signal();
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Initialize object from gantry model number.
+    \param[in] model_num   gantry model number
+    \exception REC_GANTRY_MODEL the gantry model number is unknown
+    \exception REC_GANTRY_MODEL_MATCH the gantry model information doesn't
+                                      match to the already stored information
+    \exception REC_UNKNOWN_CRYSTAL_MATERIAL material of crystal layer unknown
+
+    Load the gantry model and store its values. Called by init() with
+    init_lock held.
+ */
+/*---------------------------------------------------------------------------*/
+#ifdef USE_GANTRY_MODEL
+void GM::initModel(const std::string model_num)
  { CGantryModel model;
 
    if (!model.setModel((const char *)model_num.c_str()))
@@ -550,7 +581,7 @@ void GM::init(const std::string model_num)
          }
  }
 #else // USE_GANTRY_MODEL
-void GM::init(const std::string model_num)
+void GM::initModel(const std::string model_num)
 { 
   std::cerr << "GM::init XXX (" << model_num << ")" << std::endl;
   if (GantryInfo::load(atoi(model_num.c_str())) == 0)
@@ -74,6 +74,8 @@ class GM
                                      // is a unsigned short int value defined ?
     std::string def(unsigned short int) const;
     bool equal(const float, const float) const; // are two float values equal ?
+                                     // initialize from gantry model number
+    void initModel(const std::string);
    protected:
     GM();                                                      // create object
    public:
@@ -10,6 +10,7 @@
     \date 2004/11/09 added "setMemLimit" method
     \date 2005/03/29 write access mode to log file in swapIn()
     \date 2005/03/29 log swapping times
+    \date 2026/10/19 added blocks that are loaded lazily from data files
 
     This object maintains a list of 200 memory blocks. The blocks can have any
     size and contain float, char, signed short int or unsigned long int values.
@@ -75,6 +76,15 @@
     - If both previous methods fail, a LIFO scheme is used. Here the block
       which was accessed last, is swapped out first.
 
+    A block can also be created from a data file by createFromFile(). Such a
+    block is not loaded before it is checked out the first time. If the data
+    type and byte order in the file match the block, a read-only checkout maps
+    the data directly from the file, otherwise the data is read, byte-swapped,
+    converted and scaled on first access. As long as the block is not modified,
+    the data file plays the role of the swap file: the block can be released
+    without writing it to disk and is loaded again from the data file when it
+    is needed. A modified block is swapped to its own swap file as usual.
+
     The class is implemented as a singleton object. Only one instance of this
     class can exist in a given application. The class is thread safe.
  */
@@ -90,6 +100,11 @@
 #include <limits>
 #include <fstream>
 #include <vector>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #ifdef __MACOSX__
 #include <mach/mach.h>
 #include <mach/mach_init.h>
@@ -147,6 +162,7 @@ MemCtrl::MemCtrl()
      swap_path=std::string();
      swap_in_time=0.0f;                          // time used to swap from disk
      swap_out_time=0.0f;                           // time used to swap to disk
+     lazy_loading=false;           // load data files completely when creating
                                             // initialize list of memory blocks
      mem.resize(MemCtrl::MAX_BLOCK);
      for (std::vector <tmem>::iterator it=mem.begin(); it != mem.end(); ++it)
@@ -158,6 +174,8 @@ MemCtrl::MemCtrl()
         (*it).checked_out=0;
         (*it).block_lock=NULL;
         (*it).swap_filename=std::string();
+        (*it).src_filename=std::string();
+        (*it).map_base=NULL;
       }
                               // create filename for memory access pattern file
      pattern_filename=pattern_path;
@@ -189,7 +207,8 @@ MemCtrl::~MemCtrl()
    while (mem.size() > 0)
     { it=mem.begin();
                                                               // release memory
-      switch ((*it).dt)
+      if ((*it).map_base != NULL) munmap((*it).map_base, (*it).map_length);
+       else switch ((*it).dt)
        { case DT_FLT:
           if ((*it).fdata != NULL) delete[] (*it).fdata;
           break;
@@ -249,6 +268,79 @@ void MemCtrl::allocMemory(T **ptr, const unsigned long int size,
     }
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Read memory block from its data file.
+    \param[out] ptr        pointer to memory block
+    \param[in]  idx        index of memory block
+    \param[in]  loglevel   level for logging
+
+    Allocate memory for the block and read it from its data file. The data is
+    byte-swapped if the byte order of the file doesn't match.
+ */
+/*---------------------------------------------------------------------------*/
+template <typename T>
+void MemCtrl::readFromFile(T **ptr, const unsigned short int idx,
+                           const unsigned short int loglevel)
+ { RawIO <T> *rio=NULL;
+
+   try
+   { allocMemory(ptr, mem[idx].size, loglevel);
+     rio=new RawIO <T>(mem[idx].src_filename, false, mem[idx].src_swap);
+     rio->read(mem[idx].src_offset/sizeof(T), *ptr, mem[idx].size);
+     delete rio;
+     rio=NULL;
+     freeMem(-mem[idx].size*sizeof(T));        // decrease free memory counter
+   }
+   catch (...)
+    { if (rio != NULL) delete rio;
+      if (*ptr != NULL) { delete[] *ptr;
+                          *ptr=NULL;
+                        }
+      throw;
+    }
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Release data of memory block.
+    \param[in,out] ptr   pointer to data of memory block
+    \param[in]     idx   index of memory block
+
+    Release the data of a memory block. The data is either unmapped from its
+    data file or deleted. The counter of free memory is not updated.
+ */
+/*---------------------------------------------------------------------------*/
+template <typename T>
+void MemCtrl::releaseMemory(T **ptr, const unsigned short int idx)
+ { if (mem[idx].map_base != NULL)
+    { munmap(mem[idx].map_base, mem[idx].map_length);
+      mem[idx].map_base=NULL;
+    }
+    else delete[] *ptr;
+   *ptr=NULL;
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Copy memory mapped block into memory allocated with new.
+    \param[in,out] ptr        pointer to data of memory block
+    \param[in]     idx        index of memory block
+    \param[in]     loglevel   level for logging
+
+    Copy a memory block that is mapped from its data file into memory
+    allocated with new and remove the mapping.
+ */
+/*---------------------------------------------------------------------------*/
+template <typename T>
+void MemCtrl::unmapMemory(T **ptr, const unsigned short int idx,
+                          const unsigned short int loglevel)
+ { if (mem[idx].map_base == NULL) return;
+   T *copy=NULL;
+
+   allocMemory(&copy, mem[idx].size, loglevel);
+   memcpy(copy, *ptr, mem[idx].size*sizeof(T));
+   releaseMemory(ptr, idx);
+   *ptr=copy;
+ }
+
 #ifndef _MEM_CTRL_TMPL_CPP
 /*---------------------------------------------------------------------------*/
 /*! \brief Convert a memory block to float format.
@@ -288,22 +380,19 @@ void MemCtrl::convertToFloat(const unsigned short int idx,
       { case DT_UINT:                             // unsigned long int to float
          for (i=0; i < mem[idx].size; i++)
           mem[idx].fdata[i]=(float)mem[idx].uidata[i];
-         delete[] mem[idx].uidata;
-         mem[idx].uidata=NULL;
+         releaseMemory(&mem[idx].uidata, idx);
          freeMem(mem[idx].size*(sizeof(uint32)-sizeof(float)));
          break;
         case DT_SINT:                              // signed short int to float
          for (i=0; i < mem[idx].size; i++)
           mem[idx].fdata[i]=(float)mem[idx].sidata[i];
-         delete[] mem[idx].sidata;
-         mem[idx].sidata=NULL;
+         releaseMemory(&mem[idx].sidata, idx);
          freeMem(mem[idx].size*(sizeof(signed short int)-sizeof(float)));
          break;
         case DT_CHAR:                                          // char to float
          for (i=0; i < mem[idx].size; i++)
           mem[idx].fdata[i]=(float)mem[idx].cdata[i];
-         delete[] mem[idx].cdata;
-         mem[idx].cdata=NULL;
+         releaseMemory(&mem[idx].cdata, idx);
          freeMem(mem[idx].size*(sizeof(char)-sizeof(float)));
          break;
         case DT_FLT:                                            // can't happen
@@ -443,6 +532,92 @@ float *MemCtrl::createFloat(const unsigned long int size,
     }
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Create a memory block whose data is loaded from a file on demand.
+    \param[in]  size       number of data elements in block
+    \param[in]  dt         data type of block
+    \param[in]  filename   name of data file
+    \param[in]  offset     offset of data in file in bytes
+    \param[in]  file_dt    data type of data in file
+    \param[in]  swap       swap bytes when reading the file ?
+    \param[in]  factor     factor to scale data with after loading
+    \param[out] idx        index of memory block
+    \param[in]  name       first part of swap-filename
+    \param[in]  loglevel   level for logging
+    \exception REC_FILE_DOESNT_EXIST   the data file doesn't exist
+    \exception REC_FILE_TOO_SMALL      the data file is too small
+    \exception REC_MEMORY_BLOCK        no free memory block
+
+    Create a memory block whose data is stored in a data file. The block is
+    not checked out and uses no memory until it is accessed the first time.
+    The data type of the block is either the data type of the file or float.
+    The scale factor is only applied to float blocks.
+ */
+/*---------------------------------------------------------------------------*/
+void MemCtrl::createFromFile(const unsigned long int size,
+                             const tdatatype dt, const std::string filename,
+                             const uint64 offset, const tdatatype file_dt,
+                             const bool swap, const float factor,
+                             unsigned short int * const idx,
+                             const std::string name,
+                             const unsigned short int loglevel)
+ { struct stat st;
+
+   if (stat(filename.c_str(), &st) != 0)
+    throw Exception(REC_FILE_DOESNT_EXIST,
+                    "The file '#1' doesn't exist.").arg(filename);
+   if ((uint64)st.st_size < offset+(uint64)size*elementSize(file_dt))
+    throw Exception(REC_FILE_TOO_SMALL,
+                    "File '#1' doesn't contain enough data.").arg(filename);
+   try
+   { *idx=0;
+     lock->wait();                 // lock access to block list for this thread
+     for (std::vector <tmem>::iterator it=mem.begin(); it != mem.end(); ++it,
+          (*idx)++)
+      if (!(*it).block_allocated)                        // search unused block
+       {                                 // initialize data structure for block
+         try
+         { (*it).dt=dt;
+           (*it).size=size;
+           (*it).block_lock=new Semaphore(1);
+           (*it).checked_out=0;
+           (*it).checked_out_rw=false;
+           (*it).last_access=time(NULL);
+           (*it).block_allocated=true;
+           (*it).stored_in_file=true;    // data file works as swap file
+           (*it).swap_filename=swappingPath()+name+"_"+
+                               UniqueName::un()->getName();
+           (*it).src_filename=filename;
+           (*it).src_offset=offset;
+           (*it).src_dt=file_dt;
+           (*it).src_swap=swap;
+           if (dt == DT_FLT) (*it).src_factor=factor;
+            else (*it).src_factor=1.0f;
+           (*it).map_base=NULL;
+         }
+         catch (...)
+          { if ((*it).block_lock != NULL) { delete (*it).block_lock;
+                                            (*it).block_lock=NULL;
+                                          }
+            (*it).block_allocated=false;
+            (*it).src_filename=std::string();
+            lock->signal();
+            throw;
+          }
+         Logging::flog()->logMsg("block #1 refers to #2 at offset #3",
+                                 loglevel+1)->arg(*idx)->arg(filename)->
+          arg(offset);
+         lock->signal();
+         return;
+       }
+     throw Exception(REC_MEMORY_BLOCK, "No free memory block.");
+   }
+   catch (...)
+    { lock->signal();
+      throw;
+    }
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Create a memory block in signed short int format and get read/write
            access.
@@ -601,34 +776,31 @@ void MemCtrl::delete_block(unsigned short int * const idx, const bool force)
    switch (dataType(*idx))                                    // release memory
     { case DT_FLT:
        if (mem[*idx].fdata != NULL)
-        { delete[] mem[*idx].fdata;
-          mem[*idx].fdata=NULL;
+        { releaseMemory(&mem[*idx].fdata, *idx);
           freeMem(sizeof(float)*mem[*idx].size);
         }
        break;
       case DT_UINT:
        if (mem[*idx].uidata != NULL)
-        { delete[] mem[*idx].uidata;
-          mem[*idx].uidata=NULL;
+        { releaseMemory(&mem[*idx].uidata, *idx);
           freeMem(sizeof(uint32)*mem[*idx].size);
         }
        break;
       case DT_SINT:
        if (mem[*idx].sidata != NULL)
-        { delete[] mem[*idx].sidata;
-          mem[*idx].sidata=NULL;
+        { releaseMemory(&mem[*idx].sidata, *idx);
           freeMem(sizeof(signed short int)*mem[*idx].size);
         }
        break;
       case DT_CHAR:
        if (mem[*idx].cdata != NULL)
-        { delete[] mem[*idx].cdata;
-          mem[*idx].cdata=NULL;
+        { releaseMemory(&mem[*idx].cdata, *idx);
           freeMem(sizeof(char)*mem[*idx].size);
         }
        break;
     }
    mem[*idx].block_allocated=false;
+   mem[*idx].src_filename=std::string();
    unlink(mem[*idx].swap_filename.c_str());                 // remove swap file
    if (!force) signalBlock(*idx);
    delete mem[*idx].block_lock;
@@ -675,6 +847,24 @@ void MemCtrl::deleteMemoryController()
                          }
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Request size of a data element.
+    \param[in] dt   data type
+    \return number of bytes of a data element
+
+    Request the number of bytes of a data element of the given data type.
+ */
+/*---------------------------------------------------------------------------*/
+unsigned short int MemCtrl::elementSize(const tdatatype dt)
+ { switch (dt)
+    { case DT_FLT:  return(sizeof(float));
+      case DT_UINT: return(sizeof(uint32));
+      case DT_SINT: return(sizeof(signed short int));
+      case DT_CHAR: return(sizeof(char));
+    }
+   return(0);
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Modify counter of free memory.
     \param[in] amount   number of bytes to add
@@ -722,6 +912,10 @@ char *MemCtrl::getChar(const unsigned short int idx,
         mem[idx].stored_in_file=false;             // swap file will be invalid
         unlink(mem[idx].swap_filename.c_str());             // delete swap file
       }
+      else if (mem[idx].stored_in_file)   // swapped in read-only before, copy
+            { mem[idx].stored_in_file=false;     // on disk will become invalid
+              unlink(mem[idx].swap_filename.c_str());
+            }
                      // increase number of times block is currently checked out
                      // (result is always 1)
      mem[idx].checked_out++;
@@ -810,6 +1004,10 @@ float *MemCtrl::getFloat(const unsigned short int idx,
         mem[idx].stored_in_file=false;             // swap file will be invalid
         unlink(mem[idx].swap_filename.c_str());             // delete swap file
       }
+      else if (mem[idx].stored_in_file)   // swapped in read-only before, copy
+            { mem[idx].stored_in_file=false;     // on disk will become invalid
+              unlink(mem[idx].swap_filename.c_str());
+            }
                      // increase number of times block is currently checked out
                      // (result is always 1)
      mem[idx].checked_out++;
@@ -911,6 +1109,7 @@ char *MemCtrl::getRemoveChar(unsigned short int * const idx,
       }
      mem[*idx].stored_in_file=false;
      unlink(mem[*idx].swap_filename.c_str());               // delete swap file
+     unmapMemory(&mem[*idx].cdata, *idx, loglevel);   // caller will delete[]
      cp=mem[*idx].cdata;
      mem[*idx].cdata=NULL;
      freeMem(sizeof(char)*mem[*idx].size);      // increase free memory counter
@@ -919,6 +1118,7 @@ char *MemCtrl::getRemoveChar(unsigned short int * const idx,
      delete mem[*idx].block_lock;
      mem[*idx].block_lock=NULL;
      mem[*idx].block_allocated=false;
+     mem[*idx].src_filename=std::string();
      updatePattern(*idx, loglevel);             // update memory access pattern
      lock->signal();
      *idx=MemCtrl::MAX_BLOCK;
@@ -966,6 +1166,7 @@ float *MemCtrl::getRemoveFloat(unsigned short int * const idx,
      unlink(mem[*idx].swap_filename.c_str());               // delete swap file
                                                             // convert to float
      if (dataType(*idx) != DT_FLT) convertToFloat(*idx, loglevel);
+     unmapMemory(&mem[*idx].fdata, *idx, loglevel);   // caller will delete[]
      fp=mem[*idx].fdata;
      mem[*idx].fdata=NULL;
      freeMem(sizeof(float)*mem[*idx].size);     // increase free memoru counter
@@ -974,6 +1175,7 @@ float *MemCtrl::getRemoveFloat(unsigned short int * const idx,
      delete mem[*idx].block_lock;
      mem[*idx].block_lock=NULL;
      mem[*idx].block_allocated=false;
+     mem[*idx].src_filename=std::string();
      updatePattern(*idx, loglevel);             // update memory access pattern
      lock->signal();
      *idx=MemCtrl::MAX_BLOCK;
@@ -1021,6 +1223,7 @@ signed short int *MemCtrl::getRemoveSInt(unsigned short int * const idx,
       }
      mem[*idx].stored_in_file=false;
      unlink(mem[*idx].swap_filename.c_str());               // delete swap file
+     unmapMemory(&mem[*idx].sidata, *idx, loglevel);   // caller will delete[]
      sp=mem[*idx].sidata;
      mem[*idx].sidata=NULL;
                                                 // increase free memory counter
@@ -1030,6 +1233,7 @@ signed short int *MemCtrl::getRemoveSInt(unsigned short int * const idx,
      delete mem[*idx].block_lock;
      mem[*idx].block_lock=NULL;
      mem[*idx].block_allocated=false;
+     mem[*idx].src_filename=std::string();
      updatePattern(*idx, loglevel);             // update memory access pattern
      lock->signal();
      *idx=MemCtrl::MAX_BLOCK;
@@ -1077,6 +1281,7 @@ uint32 *MemCtrl::getRemoveUInt(unsigned short int * const idx,
       }
      mem[*idx].stored_in_file=false;
      unlink(mem[*idx].swap_filename.c_str());               // delete swap file
+     unmapMemory(&mem[*idx].uidata, *idx, loglevel);   // caller will delete[]
      sp=mem[*idx].uidata;
      mem[*idx].uidata=NULL;
                                                 // increase free memory counter
@@ -1086,6 +1291,7 @@ uint32 *MemCtrl::getRemoveUInt(unsigned short int * const idx,
      delete mem[*idx].block_lock;
      mem[*idx].block_lock=NULL;
      mem[*idx].block_allocated=false;
+     mem[*idx].src_filename=std::string();
      updatePattern(*idx, loglevel);             // update memory access pattern
      lock->signal();
      *idx=MemCtrl::MAX_BLOCK;
@@ -1128,6 +1334,10 @@ signed short int *MemCtrl::getSInt(const unsigned short int idx,
         mem[idx].stored_in_file=false;             // swap file will be invalid
         unlink(mem[idx].swap_filename.c_str());             // delete swap file
       }
+      else if (mem[idx].stored_in_file)   // swapped in read-only before, copy
+            { mem[idx].stored_in_file=false;     // on disk will become invalid
+              unlink(mem[idx].swap_filename.c_str());
+            }
                      // increase number of times block is currently checked out
                      // (result is always 1)
      mem[idx].checked_out++;
@@ -1218,6 +1428,10 @@ uint32 *MemCtrl::getUInt(const unsigned short int idx,
         mem[idx].stored_in_file=false;             // swap file will be invalid
         unlink(mem[idx].swap_filename.c_str());             // delete swap file
       }
+      else if (mem[idx].stored_in_file)   // swapped in read-only before, copy
+            { mem[idx].stored_in_file=false;     // on disk will become invalid
+              unlink(mem[idx].swap_filename.c_str());
+            }
                      // increase number of times block is currently checked out
                      // (result is always 1)
      mem[idx].checked_out++;
@@ -1291,6 +1505,144 @@ MemCtrl *MemCtrl::mc()
    return(instance);
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Request if blocks are created from data files by lazy loading.
+    \return blocks are created from data files ?
+
+    Request if input files are registered as memory blocks which are loaded
+    on demand (see createFromFile()) instead of being read completely.
+ */
+/*---------------------------------------------------------------------------*/
+bool MemCtrl::lazyLoading() const
+ { return(lazy_loading);
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Load memory block from its data file.
+    \param[in] idx        index of memory block
+    \param[in] mode       access mode
+    \param[in] loglevel   level for logging
+
+    Load a memory block from its data file. A block which is requested
+    read-only and matches the data file in data type and byte order is mapped
+    directly from the file. Otherwise the data is read from the file,
+    byte-swapped, converted into the data type of the block and scaled.
+ */
+/*---------------------------------------------------------------------------*/
+void MemCtrl::loadFromFile(const unsigned short int idx,
+                           const std::string mode,
+                           const unsigned short int loglevel)
+ { tdatatype dt;
+
+   dt=mem[idx].dt;
+   try
+   { StopWatch sw;
+
+     sw.start();
+     if ((mode == "r") && (mem[idx].src_dt == dt) && !mem[idx].src_swap &&
+         (mem[idx].src_factor == 1.0f) && mapFromFile(idx))
+      Logging::flog()->logMsg("map (#1): #2 (#3 MByte)", loglevel+1)->
+       arg(mode)->arg(mem[idx].src_filename)->
+       arg((double)(mem[idx].size*elementSize(dt))/1048576.0);
+      else { Logging::flog()->logMsg("load (#1): #2 (#3 MByte)", loglevel+1)->
+              arg(mode)->arg(mem[idx].src_filename)->
+              arg((double)(mem[idx].size*elementSize(mem[idx].src_dt))/
+                  1048576.0);
+                                       // read data in the format of the file
+             mem[idx].dt=mem[idx].src_dt;
+             switch (mem[idx].src_dt)
+              { case DT_FLT:
+                 readFromFile(&mem[idx].fdata, idx, loglevel);
+                 break;
+                case DT_UINT:
+                 readFromFile(&mem[idx].uidata, idx, loglevel);
+                 break;
+                case DT_SINT:
+                 readFromFile(&mem[idx].sidata, idx, loglevel);
+                 break;
+                case DT_CHAR:
+                 readFromFile(&mem[idx].cdata, idx, loglevel);
+                 break;
+              }
+             swapped_in+=mem[idx].size*elementSize(mem[idx].src_dt);
+             if (dt == DT_FLT)                     // convert and scale data
+              { convertToFloat(idx, loglevel);
+                if (mem[idx].src_factor != 1.0f)
+                 for (unsigned long int i=0; i < mem[idx].size; i++)
+                  mem[idx].fdata[i]*=mem[idx].src_factor;
+              }
+           }
+     swap_in_time+=sw.stop();
+   }
+   catch (...)
+    {                                      // release data in format of file
+      if (mem[idx].uidata != NULL)
+       { releaseMemory(&mem[idx].uidata, idx);
+         freeMem(sizeof(uint32)*mem[idx].size);
+       }
+      if (mem[idx].sidata != NULL)
+       { releaseMemory(&mem[idx].sidata, idx);
+         freeMem(sizeof(signed short int)*mem[idx].size);
+       }
+      if (mem[idx].cdata != NULL)
+       { releaseMemory(&mem[idx].cdata, idx);
+         freeMem(sizeof(char)*mem[idx].size);
+       }
+      mem[idx].dt=dt;
+      throw;
+    }
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Map memory block directly from its data file.
+    \param[in] idx   index of memory block
+    \return block is mapped ?
+
+    Map the data of a memory block directly from its data file. The mapping
+    is private, changes to the block are not written back into the file.
+ */
+/*---------------------------------------------------------------------------*/
+bool MemCtrl::mapFromFile(const unsigned short int idx)
+ { int fd;
+   uint64 bytes, page_offset;
+   void *base;
+   struct stat st;
+
+   bytes=(uint64)mem[idx].size*elementSize(mem[idx].dt);
+                              // mapping must start at page boundary of file
+   page_offset=mem[idx].src_offset % (uint64)sysconf(_SC_PAGESIZE);
+   if ((fd=open(mem[idx].src_filename.c_str(), O_RDONLY)) < 0) return(false);
+                                    // file truncated since block was created ?
+   if ((fstat(fd, &st) != 0) ||
+       ((uint64)st.st_size < mem[idx].src_offset+bytes))
+    { close(fd);
+      return(false);
+    }
+   base=mmap(NULL, (size_t)(page_offset+bytes), PROT_READ|PROT_WRITE,
+             MAP_PRIVATE, fd, (off_t)(mem[idx].src_offset-page_offset));
+   close(fd);
+   if (base == MAP_FAILED) return(false);
+   mem[idx].map_base=base;
+   mem[idx].map_length=page_offset+bytes;
+   base=(char *)base+page_offset;
+   switch (mem[idx].dt)
+    { case DT_FLT:
+       mem[idx].fdata=(float *)base;
+       break;
+      case DT_UINT:
+       mem[idx].uidata=(uint32 *)base;
+       break;
+      case DT_SINT:
+       mem[idx].sidata=(signed short int *)base;
+       break;
+      case DT_CHAR:
+       mem[idx].cdata=(char *)base;
+       break;
+    }
+   freeMem(-bytes);                            // decrease free memory counter
+   return(true);
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Write information about swapping activity to log.
     \param[in] loglevel   level for logging
@@ -1526,6 +1878,18 @@ void MemCtrl::searchForPattern(const std::string _pattern_key,
     }
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Switch lazy loading of blocks from data files.
+    \param[in] on   create blocks from data files ?
+
+    Switch lazy loading of input files on or off. Lazy loading must not be
+    used if an input file may be overwritten while its data is still in use.
+ */
+/*---------------------------------------------------------------------------*/
+void MemCtrl::setLazyLoading(const bool on)
+ { lazy_loading=on;
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Set the memory limit for the swapping.
     \param[in] factor   factor of physical memory that can be used
@@ -1611,6 +1975,10 @@ void MemCtrl::swapIn(const unsigned short int idx, const std::string mode,
    RawIO <char> *rio_c=NULL;
    RawIO <uint32> *rio_ui=NULL;
 
+   if (!mem[idx].src_filename.empty())     // block not modified since creation ?
+    { loadFromFile(idx, mode, loglevel);
+      return;
+    }
    try
    { StopWatch sw;
    
@@ -1687,18 +2055,10 @@ void MemCtrl::swapIn(const unsigned short int idx, const std::string mode,
       if (rio_si != NULL) delete rio_si;
       if (rio_ui != NULL) delete rio_ui;
       if (rio_c != NULL) delete rio_c;
-      if (mem[idx].fdata != NULL) { delete[] mem[idx].fdata;
-                                    mem[idx].fdata=NULL;
-                                  }
-      if (mem[idx].uidata != NULL) { delete[] mem[idx].uidata;
-                                     mem[idx].uidata=NULL;
-                                   }
-      if (mem[idx].sidata != NULL) { delete[] mem[idx].sidata;
-                                     mem[idx].sidata=NULL;
-                                   }
-      if (mem[idx].cdata != NULL) { delete[] mem[idx].cdata;
-                                    mem[idx].cdata=NULL;
-                                  }
+      if (mem[idx].fdata != NULL) releaseMemory(&mem[idx].fdata, idx);
+      if (mem[idx].uidata != NULL) releaseMemory(&mem[idx].uidata, idx);
+      if (mem[idx].sidata != NULL) releaseMemory(&mem[idx].sidata, idx);
+      if (mem[idx].cdata != NULL) releaseMemory(&mem[idx].cdata, idx);
       throw;
     }
  }
@@ -1810,8 +2170,7 @@ bool MemCtrl::swapOut(const unsigned short int loglevel)
           }
                                                      // delete data from memory
          Logging::flog()->logMsg("delete memory block #1 #2", loglevel+1)->arg(idx)->arg(mem[idx].swap_filename);
-         delete[] mem[idx].fdata;
-         mem[idx].fdata=NULL;
+         releaseMemory(&mem[idx].fdata, idx);
          freeMem(mem[idx].size*sizeof(float));  // increase free memory counter
          break;
         case DT_UINT:
@@ -1828,8 +2187,7 @@ bool MemCtrl::swapOut(const unsigned short int loglevel)
             swapped_out+=mem[idx].size*sizeof(uint32);
           }
                                                      // delete data from memory
-         delete[] mem[idx].uidata;
-         mem[idx].uidata=NULL;
+         releaseMemory(&mem[idx].uidata, idx);
                                                 // increase free memory counter
          freeMem(mem[idx].size*sizeof(uint32));
          break;
@@ -1848,8 +2206,7 @@ bool MemCtrl::swapOut(const unsigned short int loglevel)
             swapped_out+=mem[idx].size*sizeof(signed short int);
           }
                                                      // delete data from memory
-         delete[] mem[idx].sidata;
-         mem[idx].sidata=NULL;
+         releaseMemory(&mem[idx].sidata, idx);
                                                 // increase free memory counter
          freeMem(mem[idx].size*sizeof(signed short int));
          break;
@@ -1867,12 +2224,13 @@ bool MemCtrl::swapOut(const unsigned short int loglevel)
             swapped_out+=mem[idx].size*sizeof(char);
           }
                                                      // delete data from memory
-         delete[] mem[idx].cdata;
-         mem[idx].cdata=NULL;
+         releaseMemory(&mem[idx].cdata, idx);
                                                 // increase free memory counter
          freeMem(mem[idx].size*sizeof(char));
          break;
       }
+                       // modified block is stored in swap file from now on
+     if (!mem[idx].stored_in_file) mem[idx].src_filename=std::string();
      mem[idx].stored_in_file=true;
      signalBlock(idx);
      return(true);
@@ -10,6 +10,7 @@
     \date 2004/11/09 added "setMemLimit" method
     \date 2005/03/29 write access mode to log file in swapIn()
     \date 2005/03/29 log swapping times
+    \date 2026/10/19 added blocks that are loaded lazily from data files
  */
 
 #pragma once
@@ -59,6 +60,17 @@ class MemCtrl
                      time_t last_access;            /*!< time of last access */
                                              /*! name of swap file for block */
                      std::string swap_filename;
+                     /*! name of data file the block is loaded from or empty */
+                     std::string src_filename;
+                          /*! offset of block in data file in bytes */
+                     uint64 src_offset;
+                     tdatatype src_dt;     /*!< data type in data file */
+                                   /*! swap bytes when loading data file ? */
+                     bool src_swap;
+                         /*! factor to scale data with after loading */
+                     float src_factor;
+                     void *map_base;   /*!< start of memory mapping or NULL */
+                     uint64 map_length;   /*!< length of memory mapping */
                    } tmem;
     static MemCtrl *instance;    /*!< pointer to only instance of this class */
     signed long int free_mem;       /*!< amount of available memory in KByte */
@@ -79,6 +91,8 @@ class MemCtrl
     Semaphore *lock;  /*!< semaphore to lock access to list of memory blocks */
     float swap_out_time,                      /*!< time used to swap to disk */
           swap_in_time;                     /*!< time used to swap from disk */
+                       /*! create blocks from data files by lazy loading ? */
+    bool lazy_loading;
     template <typename T>                                    // allocate memory
      void allocMemory(T **, const unsigned long int,
                       const unsigned short int);
@@ -86,7 +100,19 @@ class MemCtrl
     void convertToFloat(const unsigned short int, const unsigned short int);
                                                          // delete memory block
     void delete_block(unsigned short int * const, const bool);
+                                 // number of bytes of an element of data type
+    static unsigned short int elementSize(const tdatatype);
     void freeMem(const signed long int);       // modify counter of free memory
+                                       // load block from its data file
+    void loadFromFile(const unsigned short int, const std::string,
+                      const unsigned short int);
+                                         // map block directly from data file
+    bool mapFromFile(const unsigned short int);
+    template <typename T>                        // read block from data file
+     void readFromFile(T **, const unsigned short int,
+                       const unsigned short int);
+    template <typename T>                            // release data of block
+     void releaseMemory(T **, const unsigned short int);
                                           // save current memory access pattern
     void savePattern(const unsigned short int) const;
                                                       // swap block into memory
@@ -94,6 +120,9 @@ class MemCtrl
                 const unsigned short int);
     bool swapOut(const unsigned short int);         // swap block out of memory
     void signalBlock(const unsigned short int) const;    // unlock memory block
+    template <typename T>         // copy memory mapped block into own memory
+     void unmapMemory(T **, const unsigned short int,
+                      const unsigned short int);
                                         // update current memory access pattern
     void updatePattern(const unsigned short int, const unsigned short int);
     void waitBlock(const unsigned short int) const;        // lock memory block
@@ -116,6 +145,11 @@ class MemCtrl
                  // create block of unsigned long int and get read/write access
     uint32 *createUInt(const unsigned long int, unsigned short int * const,
                        const std::string, const unsigned short int);
+                           // create block that is loaded from data file later
+    void createFromFile(const unsigned long int, const tdatatype,
+                        const std::string, const uint64, const tdatatype,
+                        const bool, const float, unsigned short int * const,
+                        const std::string, const unsigned short int);
                                                   // request data type of block
     tdatatype dataType(const unsigned short int) const;
     void deleteBlock(unsigned short int * const);      // delete a memory block
@@ -151,6 +185,8 @@ class MemCtrl
     uint32 *getUInt(const unsigned short int, const unsigned short int);
                              // get read-only access to unsigned long int block
     uint32 *getUIntRO(const unsigned short int, const unsigned short int);
+                          // create blocks from data files by lazy loading ?
+    bool lazyLoading() const;
     static MemCtrl *mc();       // get pointer to instance of memory controller
                                  // write information about memory usage to log
     void printPattern(const unsigned short int) const;
@@ -161,6 +197,8 @@ class MemCtrl
                   const unsigned short int);
                            // search for matching memory access pattern in file
     void searchForPattern(const std::string, const unsigned short int);
+                             // switch lazy loading of blocks from data files
+    void setLazyLoading(const bool);
     void setMemLimit(const float);             // set memory limit for swapping
     void setSwappingPath(const std::string);      // change path for swap files
     std::string swappingPath() const;            // request path for swap files
@@ -9,6 +9,7 @@
     \date 2004/10/01 added Doxygen style comments
     \date 2004/10/01 use memory controller object
     \date 2008/06/16 Add scatter correction for HRRT
+    \date 2026/10/19 u-map reconstruction uses multiple threads
 
     This blank and transmission scan are rebinned by a given factor to improve
     the statistics. The number of bins and number of angles in the sinograms
@@ -613,7 +614,7 @@ void AttenReco::reconstruct(float * const blank, float * const tx,
         Mu_recon->change_COR(0.5f/(float)sino_rt_zoom-0.0001f);
         Mu_recon->read_proj(sino+slice_first*sinoUMap_plane_size);
         Mu_recon->OS_EM(iterations, subsets, CLOCKWISE, 2, -M_PI_2, beta, NULL,
-                        false, loglevel+2);
+                        false, loglevel+2, max_threads);
         Mu_recon->copy_image(umap+slice_first*umap_plane_size);
         delete Mu_recon;
         Mu_recon=NULL;
@@ -682,7 +683,7 @@ void AttenReco::reconstruct(float * const blank, float * const tx,
                                          scaling_factor, histo, 2, -M_PI_2,
                                          beta, beta_ip, iterations_ip, false,
                                          autoscale, autoscalevalue,
-                                         loglevel+2);
+                                         loglevel+2, max_threads);
                 Mu_recon_gauss_tx->copy_image(umap+
                                               slice_first*umap_plane_size);
                 delete Mu_recon_gauss_tx;
@@ -706,7 +707,8 @@ void AttenReco::reconstruct(float * const blank, float * const tx,
                                           scaling_factor, histo, 2,
                                           -M_PI_2, beta, beta_ip,
                                           iterations_ip, false, autoscale,
-                                          autoscalevalue, loglevel+2);
+                                          autoscalevalue, loglevel+2,
+                                          max_threads);
                      Mu_recon_gm_tx->copy_image(umap+
                                                 slice_first*umap_plane_size);
                      delete Mu_recon_gm_tx;
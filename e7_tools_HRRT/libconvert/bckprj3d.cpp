@@ -12,6 +12,8 @@
     \date 2004/08/10 fix bug in calculation of positon along LOR for TOF
     \date 2004/10/28 add new lookup-table for radial, x/y- and image
                      coordinates and interpolation factors
+    \date 2026/10/19 mode 1 LUT projectors process four adjacent planes per
+                     LUT entry
 
     The back-projector uses a bilinear interpolation between the four LORs, of
     one view that may hit a voxel. In case of a 2d backprojection this
@@ -104,6 +106,7 @@
 #include "gm.h"
 #include "logging.h"
 #include "mem_ctrl.h"
+#include "prj_interp.h"
 #include "str_tmpl.h"
 #include "thread_wrapper.h"
 #include "vecmath.h"
@@ -836,7 +839,22 @@ void BckPrj3D::back_proj3d_seg0_table1(float * const img, float *sino,
                                     // follow view through volume and calculate
                                     // weights by linear interpolation
       ip=img+proc*image_plane_size;
-      for (unsigned short int z=z_start+proc; z < z_end; z+=num_procs,
+      unsigned short int z=z_start+proc;
+                                   // four planes per LUT entry if the planes
+                                   // are adjacent
+      if (num_procs == 1)
+       for (; z+PLANE_BATCH <= z_end; z+=PLANE_BATCH,
+            p2dp+=RhoSamples_padded*PLANE_BATCH,
+            ip+=image_plane_size*PLANE_BATCH)
+        for (unsigned long int xy=lut_pos[t]; xy < lut_pos[t+1]; xy++)
+         { float v[PLANE_BATCH], *vp;
+
+           planeInterp4(&p2dp[lr[xy]], RhoSamples_padded, 1, lf[xy], v);
+           vp=&ip[lxy[xy]];
+           for (unsigned short int k=0; k < PLANE_BATCH; k++)
+            vp[k*image_plane_size]+=v[k];
+         }
+      for (; z < z_end; z+=num_procs,
            p2dp+=RhoSamples_padded*num_procs,
            ip+=image_plane_size*(unsigned long int)num_procs)
        for (unsigned long int xy=lut_pos[t]; xy < lut_pos[t+1]; xy++)
@@ -1190,24 +1208,105 @@ void BckPrj3D::back_proj3d_oblique_table1(float * const img, float *sino,
        p00[xy-lut_pos[t]]=p000+tan_phi*lp[xy];
       for (unsigned short int z=z_start+proc; z < z_end; z+=num_procs,
            ip+=num_procs*image_plane_size)
-       for (unsigned long int xy=lut_pos[t]; xy < lut_pos[t+1]; xy++)
-        { float p;
+       {                                         // four adjacent image planes
+         if ((num_procs == 1) && (z+PLANE_BATCH <= z_end))
+          { back_proj3d_oblique_table1_batch(ip, sino, t, z, zb, zt, &p00[0],
+                                             lf, lr, lxy);
+            z+=PLANE_BATCH-1;
+            ip+=(PLANE_BATCH-1)*image_plane_size;
+            continue;
+          }
+         for (unsigned long int xy=lut_pos[t]; xy < lut_pos[t+1]; xy++)
+          { float p;
 
-          p=(float)z+p00[xy-lut_pos[t]];
-          if ((p >= zb) && (p < zt))
-           { signed short int pfloor;
-             float *p2dp;
+            p=(float)z+p00[xy-lut_pos[t]];
+            if ((p >= zb) && (p < zt))
+             { signed short int pfloor;
+               float *p2dp;
 
-             pfloor=(signed short int)(p+1.0f)-1;            // number of plane
-                       // the four LORs that hit the voxel image[x,y,z] are
+               pfloor=(signed short int)(p+1.0f)-1;          // number of plane
+                         // the four LORs that hit the voxel image[x,y,z] are
                        // view[p,r], view[p+1,r], view[p,r+1] and view[p+1,r+1]
                                 // calculate weights for bilinear interpolation
-             p2dp=&sino[(unsigned long int)(pfloor+1)*
-                        (unsigned long int)RhoSamples_padded+lr[xy]];
-             _bilinearInterpolation(ip[lxy[xy]], lf[xy], p-(float)pfloor,
-                                    p2dp[0], p2dp[1], p2dp[RhoSamples_padded],
-                                    p2dp[RhoSamples_padded+1]);
-           }
+               p2dp=&sino[(unsigned long int)(pfloor+1)*
+                          (unsigned long int)RhoSamples_padded+lr[xy]];
+               _bilinearInterpolation(ip[lxy[xy]], lf[xy], p-(float)pfloor,
+                                      p2dp[0], p2dp[1],
+                                      p2dp[RhoSamples_padded],
+                                      p2dp[RhoSamples_padded+1]);
+             }
+          }
+       }
+    }
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Calculate the backprojection of one view of an oblique segment into
+           four adjacent image planes with mode 1 LUTs.
+    \param[in,out] ip     first of the four image planes
+    \param[in]     sino   padded view of the sinogram
+    \param[in]     t      azimuthal angle of the view
+    \param[in]     z      number of first image plane
+    \param[in]     zb     first valid plane of the view - 1
+    \param[in]     zt     last valid plane of the view + 1
+    \param[in]     p00    sinogram plane offsets of the LUT entries of the view
+    \param[in]     lf     LUT for radial interpolation factors
+    \param[in]     lr     LUT for radial coordinates
+    \param[in]     lxy    LUT for x/y-coordinates of image
+
+    Calculate the bilinear interpolations of
+    BckPrj3D::back_proj3d_oblique_table1 for four adjacent image planes. The
+    LOR through a voxel in plane z+k hits the view k planes above the LOR
+    through the voxel in plane z, so the LUT entry is read once and the
+    interpolations inside of the sinogram planes are shared between the
+    image planes. LUT entries where some of the LORs are outside of the view
+    are interpolated for every image plane separately.
+ */
+/*---------------------------------------------------------------------------*/
+void BckPrj3D::back_proj3d_oblique_table1_batch(float * const ip,
+                                             float * const sino,
+                                             const unsigned short int t,
+                                             const unsigned short int z,
+                                             const float zb, const float zt,
+                                             const float * const p00,
+                                             const float * const lf,
+                                             const signed short int * const lr,
+                                             const uint32 * const lxy) const
+ { for (unsigned long int xy=lut_pos[t]; xy < lut_pos[t+1]; xy++)
+    { float p;
+
+      p=(float)z+p00[xy-lut_pos[t]];
+                                  // LORs of all four voxels inside of view ?
+      if ((p >= zb) && (p+(float)(PLANE_BATCH-1) < zt))
+       { signed short int pfloor;
+         float v[PLANE_BATCH], *vp;
+
+         pfloor=(signed short int)(p+1.0f)-1;                // number of plane
+                 // the LORs through voxel image[x,y,z+k] hit the view in the
+                 // planes pfloor+k and pfloor+k+1
+         planeBilinearInterp4(&sino[(unsigned long int)(pfloor+1)*
+                                    (unsigned long int)RhoSamples_padded+
+                                    lr[xy]],
+                              RhoSamples_padded, 1, lf[xy], p-(float)pfloor,
+                              v);
+         vp=&ip[lxy[xy]];
+         for (unsigned short int k=0; k < PLANE_BATCH; k++)
+          vp[k*image_plane_size]+=v[k];
+         continue;
+       }
+      for (unsigned short int k=0; k < PLANE_BATCH; k++,
+           p+=1.0f)
+       if ((p >= zb) && (p < zt))
+        { signed short int pfloor;
+          float *p2dp;
+
+          pfloor=(signed short int)(p+1.0f)-1;
+          p2dp=&sino[(unsigned long int)(pfloor+1)*
+                     (unsigned long int)RhoSamples_padded+lr[xy]];
+          _bilinearInterpolation(ip[k*image_plane_size+lxy[xy]], lf[xy],
+                                 p-(float)pfloor, p2dp[0], p2dp[1],
+                                 p2dp[RhoSamples_padded],
+                                 p2dp[RhoSamples_padded+1]);
         }
     }
  }
@@ -12,6 +12,8 @@
     \date 2004/08/10 fix bug in calculation of positon along LOR for TOF
     \date 2004/10/28 add new lookup-table for radial, x/y- and image
                      coordinates and interpolation factors
+    \date 2026/10/19 mode 1 LUT projectors process four adjacent planes per
+                     LUT entry
  */
 
 #pragma once
@@ -154,6 +156,16 @@ class BckPrj3D
                                     const uint32 * const, const float * const,
                                     const unsigned short int,
                                     const unsigned short int);
+                 // backproject one view of an oblique segment into four
+                 // adjacent image planes with mode 1 LUT
+    void back_proj3d_oblique_table1_batch(float * const, float * const,
+                                          const unsigned short int,
+                                          const unsigned short int,
+                                          const float, const float,
+                                          const float * const,
+                                          const float * const,
+                                          const signed short int * const,
+                                          const uint32 * const) const;
                 // backproject one subset of an oblique segment with mode 2 LUT
     void back_proj3d_oblique_table2(tmaskline * const, float * const,
                                     float *, const unsigned long int,
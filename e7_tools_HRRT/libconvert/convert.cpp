@@ -11,6 +11,10 @@
                      eau2scatter()
     \date 2005/03/08 fixed loading of u-map if GM is not initialized
     \date 2005/03/11 added PSF-AW-OSEM
+    \date 2026/10/19 eau2scatter() can keep the Scatter object for the next
+                     frame
+    \date 2026/10/19 added tvRegularize()
+    \date 2026/10/19 OSEM uses the fastest LUT mode of the projectors
 
     This module provides methods to convert sinograms into images and vice
     versa.
@@ -29,6 +33,7 @@
 #include "idl_interface.h"
 #endif // SUPPORT_NEW_SCATTER_CODE
 #include "logging.h"
+#include "lut_tuning.h"
 #include "mem_ctrl.h"
 #include "osem3d.h"
 #include "progress.h"
@@ -36,6 +41,7 @@
 #include "scatter.h"
 #include "stopwatch.h"
 #include "swap_tmpl.h"
+#include "TV_Reg_3D.h"
 #include "types.h"
 
 namespace CONVERT
@@ -260,6 +266,10 @@ ImageConversion *bt2umap(SinogramConversion * blank_sino,
     \param[in] debug_path          path for debug files
     \param[in] num                 matrix number
     \param[in] new_scatter_code    use IDL scatter code ?
+    \param[in,out] keep_scatter    Scatter object that is kept for the next
+                                   frame (NULL=create new object)
+    \param[in] reuse_threshold     threshold for reuse of scatter simulation
+                                   of previous frame
     \param[in] loglevel            level for logging
     \param[in] max_threads         number of threads to use
     \return scatter sinogram
@@ -268,6 +278,10 @@ ImageConversion *bt2umap(SinogramConversion * blank_sino,
     u-map. The calculation is either done by IDL code which creates a 2d
     sinogram with an iterative method or by C++ code which creates a 3d
     sinogram.
+    If keep_scatter is not NULL, the Scatter object of the C++ code is stored
+    there and reused by the next call, so that the next frame of a dynamic
+    study can start from the data of this frame. The caller has to delete the
+    object.
  */
 /*---------------------------------------------------------------------------*/
 SinogramConversion *eau2scatter(SinogramConversion *emi_sino,
@@ -292,6 +306,8 @@ SinogramConversion *eau2scatter(SinogramConversion *emi_sino,
 #ifndef USE_OLD_SCATTER_CODE
                                  std::vector<float> &scale_factors,
 #endif
+                                Scatter ** const keep_scatter,
+                                const float reuse_threshold,
                                 const unsigned short int loglevel,
                                 const unsigned short int max_threads)
  { Scatter *scatter=NULL;
@@ -528,12 +544,22 @@ SinogramConversion *eau2scatter(SinogramConversion *emi_sino,
 
 #endif //SUPPORT_NEW_SCATTER_CODE
                               // use C++ code top calculate 3d scatter sinogram
-     scatter=new Scatter(emi_sino->RhoSamples(), emi_sino->BinSizeRho(),
-                         emi_sino->ThetaSamples(), emi_sino->axisSlices(),
-                         emi_sino->RhoSamples()/scatter_img_zoom,
-                         GM::gm()->planeSeparation(), subsets, scatter_skip,
-                         rebin_r, quality_control, quality_path, loglevel+1);
-     scatter_sino=scatter->estimateScatter(acf_sino, umap_image, emi_sino,
+     { Scatter *sc;
+
+       if ((keep_scatter != NULL) && (*keep_scatter != NULL))
+        sc=*keep_scatter;                    // use object of previous frame
+        else { sc=new Scatter(emi_sino->RhoSamples(), emi_sino->BinSizeRho(),
+                              emi_sino->ThetaSamples(),
+                              emi_sino->axisSlices(),
+                              emi_sino->RhoSamples()/scatter_img_zoom,
+                              GM::gm()->planeSeparation(), subsets,
+                              scatter_skip, rebin_r, quality_control,
+                              quality_path, loglevel+1);
+               if (keep_scatter != NULL) *keep_scatter=sc;
+                else scatter=sc;
+               sc->reuseThreshold(reuse_threshold);
+             }
+       scatter_sino=sc->estimateScatter(acf_sino, umap_image, emi_sino,
                                      trim, step_size, scatter_z_step,
                                      sampling_grid_xy, sampling_grid_z,
                                      max_scatter_samps_xy, max_scatter_samps_z,
@@ -547,8 +573,10 @@ SinogramConversion *eau2scatter(SinogramConversion *emi_sino,
                                      scale_factors,
 #endif
                                      debug_path, max_threads);
-     delete scatter;
-     scatter=NULL;
+     }
+     if (scatter != NULL) { delete scatter;
+                            scatter=NULL;
+                          }
      return(scatter_sino);
    }
    catch (...)
@@ -970,6 +998,13 @@ ImageConversion *sinogram2image(SinogramConversion *sino,
       if (sino->RhoSamples() > 160) lut_level=0;
        else lut_level=2;
       else if ((sino->axes() > 1) && (sino->TOFbins() > 1)) lut_level=1;
+                       // use the fastest of the allowed LUT modes for OSEM
+     if ((algorithm != ALGO::FBP_Algo) && (algorithm != ALGO::DIFT_Algo))
+      lut_level=tunedLUTMode(width, DeltaXY, sino->RhoSamples(),
+                             sino->BinSizeRho(), sino->ThetaSamples(),
+                             sino->axisSlices(), sino->span(),
+                             sino->planeSeparation(), reb_factor, subsets,
+                             iterations, lut_level, loglevel+1, max_threads);
      switch (algorithm)
       { case ALGO::FBP_Algo:                             // FBP reconstruction
          if (acf_sino != NULL) { delete *acf_sino;
@@ -1224,4 +1259,62 @@ ImageConversion *sinogram2image(SinogramConversion *sino,
       throw;
     }
  }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief TV regularization of a u-map.
+    \param[in] umap_image            u-map
+    \param[in] lambda                smoothing weight
+    \param[in] fp_iterations         number of fixed point iterations
+    \param[in] relax_iterations      number of relaxation iterations
+    \param[in] pd_iterations         number of iterations of the primal-dual
+                                     algorithm (0=use fixed point iterations)
+    \param[in] loglevel              level for logging
+    \param[in] max_threads           maximum number of threads to use
+
+    Total variation regularization of a u-map in 1/cm, as done by TX_TV3DReg.
+    Underestimated tissue values are replaced by the u-value of tissue before
+    the regularization.
+ */
+/*---------------------------------------------------------------------------*/
+void tvRegularize(ImageConversion * const umap_image, const float lambda,
+                  const unsigned short int fp_iterations,
+                  const unsigned short int relax_iterations,
+                  const unsigned short int pd_iterations,
+                  const unsigned short int loglevel,
+                  const unsigned short int max_threads)
+ { const float threshold=0.07f,      // lower boundary of underestimated tissue
+               mu_tissue=0.099f;                // u-value of tissue in 1/cm
+   StopWatch sw;
+
+   sw.start();
+   try
+   { TV_Reg_3D tv(umap_image->XYSamples(), umap_image->XYSamples(),
+                  umap_image->ZSamples());
+     float *dp;
+     int iter;
+
+     dp=MemCtrl::mc()->getFloat(umap_image->index(), loglevel);
+     tv.replace_tissue(dp, threshold, mu_tissue);
+     if (pd_iterations > 0)
+      { Logging::flog()->logMsg("TV regularization of u-map (lambda=#1, "
+                                "primal-dual)", loglevel)->arg(lambda);
+        iter=tv.primal_dual(dp, lambda, pd_iterations, max_threads);
+      }
+      else { Logging::flog()->logMsg("TV regularization of u-map (lambda=#1, "
+                                     "#2 fixed point iterations)",
+                                     loglevel)->arg(lambda)->
+              arg(fp_iterations);
+             iter=tv.fixed_point(dp, lambda, fp_iterations, relax_iterations,
+                                 max_threads, false);
+           }
+     MemCtrl::mc()->put(umap_image->index());
+     Logging::flog()->logMsg("finished TV regularization after #1 iterations "
+                             "in #2 sec", loglevel+1)->arg(iter)->
+      arg(sw.stop());
+   }
+   catch (...)
+    { sw.stop();
+      throw;
+    }
+ }
 }
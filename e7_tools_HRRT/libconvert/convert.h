@@ -11,6 +11,9 @@
                      eau2scatter()
     \date 2005/03/08 fixed loading of u-map if GM is not initialized
     \date 2005/03/11 added PSF-AW-OSEM
+    \date 2026/10/19 eau2scatter() can keep the Scatter object for the next
+                     frame
+    \date 2026/10/19 added tvRegularize()
  */
 
 #pragma once
@@ -18,6 +21,7 @@
 #include <string>
 #include "image_conversion.h"
 #include "parser.h"
+#include "scatter.h"
 #include "sinogram_conversion.h"
 #include "types.h"
 
@@ -57,6 +61,7 @@ SinogramConversion *eau2scatter(SinogramConversion *, SinogramConversion *,
 #ifndef USE_OLD_SCATTER_CODE
                                 std::vector<float> &,
 #endif
+                                Scatter ** const, const float,
                                 const unsigned short int,
                                 const unsigned short int);
                                                  // get u-map and acf from file
@@ -82,5 +87,10 @@ ImageConversion *sinogram2image(SinogramConversion *, SinogramConversion **,
                                 const unsigned short int, float * const,
                                 std::string, const unsigned short int,
                                 const unsigned short int);
+                                                 // TV regularization of u-map
+void tvRegularize(ImageConversion * const, const float,
+                  const unsigned short int, const unsigned short int,
+                  const unsigned short int, const unsigned short int,
+                  const unsigned short int);
 }
 
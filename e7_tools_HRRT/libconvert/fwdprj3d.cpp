@@ -14,6 +14,8 @@
     \date 2004/10/28 add new lookup-tables for radial, x/y- and image
                      coordinates and interpolation factors
     \date 2005/03/29 LUT2 was using twice as much memory as required
+    \date 2026/10/19 mode 1 LUT projectors process four adjacent planes per
+                     LUT entry
 
     The forward-projector uses a bilinear interpolation between the four voxels
     in a x/z- or y/z-slice that may be hit by a LOR. In case of a 2d forward-
@@ -127,6 +129,7 @@
 #include "gm.h"
 #include "logging.h"
 #include "mem_ctrl.h"
+#include "prj_interp.h"
 #include "str_tmpl.h"
 #include "thread_wrapper.h"
 #include "vecmath.h"
@@ -1042,9 +1045,29 @@ void FwdPrj3D::forward_proj3d_seg0_table1(float * const img, float *sino,
             }
       view=sino+RhoSamples_padded*(1+proc);
       ip=img+(unsigned long int)(z_start+proc+1)*image_plane_size_padded;
+      unsigned short int p=z_start+proc;
+                                   // four planes per LUT entry if the planes
+                                   // are adjacent
+      if (num_procs == 1)
+       for (; p+PLANE_BATCH <= z_end; p+=PLANE_BATCH,
+            view+=RhoSamples_padded*PLANE_BATCH,
+            ip+=image_plane_size_padded*PLANE_BATCH)
+        { for (unsigned long int ry=lut_pos[t]; ry < lut_pos[t+1]; ry++)
+           { float v[PLANE_BATCH], *vp;
+
+             planeInterp4(&ip[lidx[ry]], image_plane_size_padded, offs,
+                          lf[ry], v);
+             vp=&view[lr[ry]];
+             for (unsigned short int k=0; k < PLANE_BATCH; k++)
+              vp[k*RhoSamples_padded]+=v[k];
+           }
+                                                // apply Jacobian to projection
+          vecMulScalar(view, factor, view,
+                       RhoSamples_padded*PLANE_BATCH);
+        }
                                // follow sinogram view through image volume and
                                // calculate weights by linear interpolation
-      for (unsigned short int p=z_start+proc; p < z_end; p+=num_procs,
+      for (; p < z_end; p+=num_procs,
            view+=RhoSamples_padded*num_procs,
            ip+=image_plane_size_padded*(unsigned long int)num_procs)
        { for (unsigned long int ry=lut_pos[t]; ry < lut_pos[t+1]; ry++)
@@ -1614,6 +1637,26 @@ void FwdPrj3D::forward_proj3d_oblique_table1(float * const img, float *sino,
          unsigned short int v_idx;
                                     // get angle of sinogram plane and Jacobian
          calculatePlaneAngle(segment, p, &sinphi, &tanphi, &v_idx);
+                                  // four adjacent planes with the same angle ?
+         if ((num_procs == 1) && (p+PLANE_BATCH <= z_end))
+          { unsigned short int k, v_idx_k;
+            float tmp_phi;
+
+            for (k=1; k < PLANE_BATCH; k++)
+             { calculatePlaneAngle(segment, p+k, &tmp_phi, &tmp_phi, &v_idx_k);
+               if (v_idx_k != v_idx) break;
+             }
+            if (k == PLANE_BATCH)
+             { forward_proj3d_oblique_table1_batch(img, view, t, p, offs,
+                                                   fact1, tmp, tanphi, lf,
+                                                   lidx, lr, lxy);
+               vecMulScalar(view, DeltaXY/fabsf(fact2*vcos_phi[v_idx]), view,
+                            RhoSamples_padded*PLANE_BATCH);
+               p+=PLANE_BATCH-1;
+               view+=RhoSamples_padded*(PLANE_BATCH-1);
+               continue;
+             }
+          }
                                          // calculate start point of projection
          incz=tanphi*fact1;
          delzz0=tanphi*tmp;
@@ -1642,6 +1685,67 @@ void FwdPrj3D::forward_proj3d_oblique_table1(float * const img, float *sino,
     }
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Calculate the forward-projection of image into four adjacent planes
+           of a view of an oblique segment with mode 1 LUTs.
+    \param[in]     img       image data
+    \param[in,out] view      first of the four planes of the view
+    \param[in]     t         azimuthal angle of the view
+    \param[in]     p         number of first plane relative to segment 0
+    \param[in]     offs      offset to next image voxel in x- or y-direction
+    \param[in]     fact1     radial increment of z without axial angle
+    \param[in]     tmp       x/y increment of z without axial angle
+    \param[in]     tanphi    tangent of axial angle of the planes
+    \param[in]     lf        LUT for interpolation factors
+    \param[in]     lidx      LUT for image coordinates
+    \param[in]     lr        LUT for r indices
+    \param[in]     lxy       LUT for x/y coordinate
+
+    Calculate the bilinear interpolations of
+    FwdPrj3D::forward_proj3d_oblique_table1 for four adjacent sinogram planes
+    with the same axial angle. The LOR of plane p+k hits the image k planes
+    above the LOR of plane p, so the LUT entry is read once and the
+    interpolations inside of the image planes are shared between the sinogram
+    planes. The Jacobian is not applied.
+ */
+/*---------------------------------------------------------------------------*/
+void FwdPrj3D::forward_proj3d_oblique_table1_batch(float * const img,
+                                        float * const view,
+                                        const unsigned short int t,
+                                        const unsigned short int p,
+                                        const unsigned short int offs,
+                                        const float fact1, const float tmp,
+                                        const float tanphi,
+                                        const float * const lf,
+                                        const uint32 * const lidx,
+                                        const signed short int * const lr,
+                                        const signed short int * const lxy)
+                                       const
+ { float incz, zz0, delzz0;
+                                         // calculate start point of projection
+   incz=tanphi*fact1;
+   delzz0=tanphi*tmp;
+   zz0=(float)p-rho_center*incz-image_center*delzz0;
+   for (unsigned long int ry=lut_pos[t]; ry < lut_pos[t+1]; ry++)
+    { signed short int zfloor;
+      float z, v[PLANE_BATCH], *vp;
+      unsigned short int rp1;
+
+      rp1=lr[ry];
+      z=zz0+(float)lxy[ry]*delzz0+(float)(rp1-1)*incz;
+      zfloor=(signed short int)(z+2.0f)-2;
+                     // the LOR of plane p+k hits the image planes zfloor+k and
+                     // zfloor+k+1
+      planeBilinearInterp4(&img[(unsigned long int)(zfloor+1)*
+                                image_plane_size_padded+lidx[ry]],
+                           image_plane_size_padded, offs, lf[ry],
+                           z-(float)zfloor, v);
+      vp=&view[rp1];
+      for (unsigned short int k=0; k < PLANE_BATCH; k++)
+       vp[k*RhoSamples_padded]+=v[k];
+    }
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Calculate the forward-projection of image into one subset of an
            oblique segment with mode 2 LUT.
@@ -14,6 +14,8 @@
     \date 2004/10/28 add new lookup-tables for radial, x/y- and image
                      coordinates and interpolation factors
     \date 2005/03/29 LUT2 was using twice as much memory as required
+    \date 2026/10/19 mode 1 LUT projectors process four adjacent planes per
+                     LUT entry
  */
 
 #pragma once
@@ -160,6 +162,18 @@ class FwdPrj3D
                                        const signed short int * const,
                                        const unsigned short int,
                                        const unsigned short int) const;
+                        // forward-project four adjacent planes of an oblique
+                        // segment with mode 1 LUT
+    void forward_proj3d_oblique_table1_batch(float * const, float * const,
+                                             const unsigned short int,
+                                             const unsigned short int,
+                                             const unsigned short int,
+                                             const float, const float,
+                                             const float, const float * const,
+                                             const uint32 * const,
+                                             const signed short int * const,
+                                             const signed short int * const)
+                                            const;
             // forward-project one subset of an oblique segment with mode 2 LUT
     void forward_proj3d_oblique_table2(tmaskline * const, float * const,
                                        float *, const unsigned short int,
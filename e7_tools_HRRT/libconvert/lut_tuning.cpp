@@ -0,0 +1,236 @@
+/*! \file lut_tuning.cpp
+    \brief This module selects the fastest LUT mode of the forward- and
+           back-projector for a reconstruction geometry.
+    \date 2026/10/19 initial version
+
+    The speed of the LUT modes of FwdPrj3D and BckPrj3D depends on the image
+    and sinogram size, the number of threads and the hardware. The first time
+    a geometry is reconstructed with a given number of threads, every allowed
+    LUT mode is timed for one subset of all segments. The time to create the
+    LUTs and the time for one subset are stored in the file
+    ~/.lut_tuning.dat, so that following reconstructions select the mode
+    without measuring again. The mode with the smallest
+    \f[
+        t_{init}+\mbox{iterations}\cdot\mbox{subsets}\cdot t_{subset}
+    \f]
+    is selected. Delete the file to measure again, e.g. after a hardware
+    change.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include "lut_tuning.h"
+#include "bckprj3d.h"
+#include "fwdprj3d.h"
+#include "logging.h"
+#include "stopwatch.h"
+
+/*- constants ---------------------------------------------------------------*/
+
+                                  /*! name of file with measured LUT timings */
+const std::string lut_tuning_filename=".lut_tuning.dat";
+
+/*- local functions ---------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Measure the speed of a LUT mode.
+    \param[in]  XYSamples          width/height of image
+    \param[in]  DeltaXY            with/height of voxels in mm
+    \param[in]  RhoSamples         number of bins in projections
+    \param[in]  BinSizeRho         width of bins in projections in mm
+    \param[in]  ThetaSamples       number of projections in sinogram plane
+    \param[in]  axis_slices        axes table of sinogram
+    \param[in]  span               span of sinogram
+    \param[in]  plane_separation   plane separation in sinogram in mm
+    \param[in]  reb_factor         sinogram rebinning factor
+    \param[in]  subsets            number of subsets for reconstruction
+    \param[in]  lut_mode           LUT mode to measure
+    \param[in]  loglevel           level for logging
+    \param[in]  max_threads        maximum number of threads to use
+    \param[out] t_init             time to initialize the projectors in sec
+    \param[out] t_subset           time for forward- and back-projection of
+                                   one subset in sec
+
+    Measure the time that is needed to initialize the forward- and
+    back-projector and to forward- and back-project one subset of all segments
+    of a uniform image.
+ */
+/*---------------------------------------------------------------------------*/
+void measureLUTMode(const unsigned short int XYSamples, const float DeltaXY,
+                    const unsigned short int RhoSamples,
+                    const float BinSizeRho,
+                    const unsigned short int ThetaSamples,
+                    const std::vector <unsigned short int> axis_slices,
+                    const unsigned short int span,
+                    const float plane_separation, const float reb_factor,
+                    const unsigned short int subsets,
+                    const unsigned short int lut_mode,
+                    const unsigned short int loglevel,
+                    const unsigned short int max_threads,
+                    float * const t_init, float * const t_subset)
+ { FwdPrj3D *fwd=NULL;
+   BckPrj3D *bp=NULL;
+
+   try
+   { std::vector <float> img, sino, bimg;
+     unsigned short int axes, segments;
+     StopWatch sw;
+
+     axes=axis_slices.size();
+     segments=2*axes-1;
+     sw.start();
+     fwd=new FwdPrj3D(XYSamples, DeltaXY, RhoSamples, BinSizeRho,
+                      ThetaSamples, axis_slices, axes, span, plane_separation,
+                      reb_factor, subsets, lut_mode, loglevel, max_threads);
+     bp=new BckPrj3D(XYSamples, DeltaXY, RhoSamples, BinSizeRho, ThetaSamples,
+                     axis_slices, axes, span, plane_separation, reb_factor,
+                     subsets, lut_mode, loglevel, max_threads);
+     *t_init=sw.stop();
+                           // padded image for forward-projector, padded subset
+                           // of sinogram and image for back-projector
+     img.assign((unsigned long int)(XYSamples+2)*
+                (unsigned long int)(XYSamples+2)*
+                (unsigned long int)(axis_slices[0]+2), 1.0f);
+     sino.resize((unsigned long int)(ThetaSamples/subsets)*
+                 (unsigned long int)(axis_slices[0]+2)*
+                 (unsigned long int)(RhoSamples+2));
+     bimg.assign((unsigned long int)XYSamples*(unsigned long int)XYSamples*
+                 (unsigned long int)axis_slices[0], 0.0f);
+     sw.start();
+     for (unsigned short int segment=0; segment < segments; segment++)
+      { fwd->forward_proj3d(&img[0], &sino[0], 0, segment, max_threads);
+        bp->back_proj3d(&sino[0], &bimg[0], 0, segment, false, max_threads);
+      }
+     *t_subset=sw.stop();
+     delete bp;
+     bp=NULL;
+     delete fwd;
+     fwd=NULL;
+   }
+   catch (...)
+    { if (bp != NULL) delete bp;
+      if (fwd != NULL) delete fwd;
+      throw;
+    }
+ }
+
+/*- exported functions ------------------------------------------------------*/
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Select the fastest LUT mode for a geometry and thread count.
+    \param[in] XYSamples          width/height of image
+    \param[in] DeltaXY            with/height of voxels in mm
+    \param[in] RhoSamples         number of bins in projections
+    \param[in] BinSizeRho         width of bins in projections in mm
+    \param[in] ThetaSamples       number of projections in sinogram plane
+    \param[in] axis_slices        axes table of sinogram
+    \param[in] span               span of sinogram
+    \param[in] plane_separation   plane separation in sinogram in mm
+    \param[in] reb_factor         sinogram rebinning factor
+    \param[in] subsets            number of subsets for reconstruction
+    \param[in] iterations         number of iterations for reconstruction
+    \param[in] max_lut_mode       highest LUT mode that may be used
+    \param[in] loglevel           level for logging
+    \param[in] max_threads        maximum number of threads to use
+    \return fastest LUT mode
+
+    Select the fastest LUT mode between 0 and max_lut_mode for a
+    reconstruction with the given geometry and number of threads. Modes that
+    were not measured before for this geometry are measured and the timings
+    are added to the file ~/.lut_tuning.dat. If HOME is not set, the timings
+    are not stored.
+ */
+/*---------------------------------------------------------------------------*/
+unsigned short int tunedLUTMode(const unsigned short int XYSamples,
+                                const float DeltaXY,
+                                const unsigned short int RhoSamples,
+                                const float BinSizeRho,
+                                const unsigned short int ThetaSamples,
+                                const std::vector <unsigned short int>
+                                 axis_slices,
+                                const unsigned short int span,
+                                const float plane_separation,
+                                const float reb_factor,
+                                unsigned short int subsets,
+                                const unsigned short int iterations,
+                                const unsigned short int max_lut_mode,
+                                const unsigned short int loglevel,
+                                const unsigned short int max_threads)
+ { std::vector <float> t_init, t_subset;
+   std::string key, filename;
+   unsigned short int mode, lut_mode=0;
+   float t_min;
+   char *ptr;
+
+   if (max_lut_mode == 0) return(0);
+                                // number of subsets is adjusted like in OSEM3D
+   while ((ThetaSamples % subsets) > 0) subsets++;
+                       // geometry and thread count identify a set of timings
+   { std::ostringstream os;
+
+     os << XYSamples << " " << DeltaXY << " " << RhoSamples << " "
+        << BinSizeRho << " " << ThetaSamples << " " << span << " "
+        << plane_separation << " " << reb_factor << " " << subsets << " "
+        << max_threads << " ";
+     for (unsigned short int i=0; i < axis_slices.size(); i++)
+      { if (i > 0) os << ",";
+        os << axis_slices[i];
+      }
+     os << " ";
+     key=os.str();
+   }
+   t_init.assign(max_lut_mode+1, -1.0f);
+   t_subset.assign(max_lut_mode+1, -1.0f);
+                                               // read timings of earlier runs
+   if ((ptr=getenv("HOME")) != NULL)
+    { std::ifstream file;
+      std::string line;
+
+      filename=std::string(ptr)+"/"+lut_tuning_filename;
+      file.open(filename.c_str());
+      while (std::getline(file, line))
+       if (line.compare(0, key.size(), key) == 0)
+        { std::istringstream is(line.substr(key.size()));
+          float ti, ts;
+
+          if (is >> mode >> ti >> ts)
+           if (mode <= max_lut_mode) { t_init[mode]=ti;
+                                       t_subset[mode]=ts;
+                                     }
+        }
+    }
+                                                  // measure missing LUT modes
+   for (mode=0; mode <= max_lut_mode; mode++)
+    if (t_subset[mode] < 0.0f)
+     { Logging::flog()->logMsg("measure speed of LUT mode #1", loglevel)->
+        arg(mode);
+       measureLUTMode(XYSamples, DeltaXY, RhoSamples, BinSizeRho,
+                      ThetaSamples, axis_slices, span, plane_separation,
+                      reb_factor, subsets, mode, loglevel+1, max_threads,
+                      &t_init[mode], &t_subset[mode]);
+       if (filename != std::string())
+        { std::ofstream file;
+
+          file.open(filename.c_str(), std::ios::out | std::ios::app);
+          file << key << mode << " " << t_init[mode] << " "
+               << t_subset[mode] << std::endl;
+        }
+     }
+                              // select mode with shortest reconstruction time
+   t_min=std::numeric_limits <float>::max();
+   for (mode=0; mode <= max_lut_mode; mode++)
+    { float t;
+
+      t=t_init[mode]+(float)iterations*(float)subsets*t_subset[mode];
+      Logging::flog()->logMsg("LUT mode #1: initialization #2 sec, subset #3 "
+                              "sec", loglevel)->arg(mode)->arg(t_init[mode])->
+       arg(t_subset[mode]);
+      if (t < t_min) { t_min=t;
+                       lut_mode=mode;
+                     }
+    }
+   return(lut_mode);
+ }
@@ -0,0 +1,23 @@
+/*! \file lut_tuning.h
+    \brief This module selects the fastest LUT mode of the forward- and
+           back-projector for a reconstruction geometry.
+    \date 2026/10/19 initial version
+ */
+
+#pragma once
+
+#include <vector>
+
+/*- exported functions ------------------------------------------------------*/
+
+                     // select fastest LUT mode for a geometry and thread count
+unsigned short int tunedLUTMode(const unsigned short int, const float,
+                                const unsigned short int, const float,
+                                const unsigned short int,
+                                const std::vector <unsigned short int>,
+                                const unsigned short int, const float,
+                                const float, unsigned short int,
+                                const unsigned short int,
+                                const unsigned short int,
+                                const unsigned short int,
+                                const unsigned short int);
@@ -22,6 +22,7 @@
     \date 2004/10/04 use faster backprojector
     \date 2004/11/11 NW- and ANW-OSEM fixed for scanners with gaps
     \date 2005/01/04 added progress reporting
+    \date 2026/10/19 reconstruction can start from a given image
 
     The OSEM reconstruction consists of 4 steps:
     - initialize object
@@ -1575,6 +1576,8 @@ void OSEM3D::init(const unsigned short int _XYSamples, const float _DeltaXY,
                   const unsigned short int _loglevel)
  { bp=NULL;
    fwd=NULL;
+   start_image=NULL;
+   start_scale=1.0f;
    wbuffer=NULL;
    rbuffer=NULL;
    os_slave.clear();
@@ -1847,30 +1850,82 @@ void OSEM3D::initFwdProjector(const unsigned short int max_threads)
                      subsets, lut_level, loglevel, max_threads);
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Set start image for reconstruction.
+    \param[in] image   start image (XYSamples x XYSamples x planes of segment
+                       0, scaled like a reconstructed image) or NULL
+    \param[in] scale   scaling factor for start image
+
+    Set the image that is used to initialize the following reconstructions
+    instead of a uniform image, e.g. the image of the previous frame of a
+    dynamic study. The scaling factor can be used to adapt the image to the
+    countrate of the new sinogram. The data is not copied and must stay valid
+    until the reconstruction is finished.
+ */
+/*---------------------------------------------------------------------------*/
+void OSEM3D::startImage(const float * const image, const float scale)
+ { start_image=image;
+   start_scale=scale;
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Initialize starting image.
     \param[out] image_index   memory controller index for image
     \param[in]  loglevel      level for logging
     \return pointer to image data
 
-    Initialize starting image with 1 and apply circular mask.
+    Initialize starting image with 1 and apply circular mask. If a start image
+    is set, it is used instead. Its values are converted from the scaling of
+    a reconstructed image into the internal scaling and limited to a small
+    fraction of the mean value, so that pixels which became 0 in an earlier
+    reconstruction can still be updated.
  */
 /*---------------------------------------------------------------------------*/
 float *OSEM3D::initImage(unsigned short int * const image_index,
                          const unsigned short int loglevel) const
- { float *ip, *image;
+ { float *ip, *image, sf=1.0f, floor_value=1.0f;
 
    image=MemCtrl::mc()->createFloat(image_volume_size_padded, image_index,
                                     "img", loglevel);
    memset(image, 0, image_volume_size_padded*sizeof(float));
+   if (start_image != NULL)
+    { double sum=0.0;
+      unsigned long int count=0;
+      const float *sp;
+                                           // mean value of start image in mask
+      sp=start_image;
+      for (unsigned short int z=0; z < axis_slices[0]; z++)
+       for (unsigned short int y=0; y < XYSamples; y++,
+            sp+=XYSamples)
+        for (unsigned short int x=mask[y].start; x <= mask[y].end; x++)
+         { sum+=(double)sp[x];
+           count++;
+         }
+                // undo scaling of reconstructed image and adapt to countrate
+      sf=start_scale/(BinSizeRho*((float)RhoSamples/(float)XYSamples)*
+                      ((float)RhoSamples/(float)XYSamples));
+      if (count > 0) floor_value=(float)(sum/(double)count)*sf*1.0e-3f;
+      if (floor_value <= 0.0f) floor_value=OSEM3D::epsilon;
+      flog->logMsg("initialize image from start image (scale #1)",
+                   loglevel)->arg(start_scale);
+    }
    ip=image+image_plane_size_padded;
                                             // init image with 1 and apply mask
    for (unsigned short int z=0; z < axis_slices[0]; z++)
     { ip+=XYSamples_padded;
       for (unsigned short int y=0; y < XYSamples; y++,
            ip+=XYSamples_padded)
-       for (unsigned short int x=mask[y].start+1; x <= mask[y].end+1; x++)
-        ip[x]=1.0f;
+       if (start_image != NULL)
+        { const float *sp;
+
+          sp=start_image+((unsigned long int)z*XYSamples+y)*XYSamples;
+          for (unsigned short int x=mask[y].start; x <= mask[y].end; x++)
+           ip[x+1]=std::min(std::max(sp[x]*sf, floor_value),
+                            OSEM3D::image_max);
+        }
+        else for (unsigned short int x=mask[y].start+1; x <= mask[y].end+1;
+                  x++)
+              ip[x]=1.0f;
       ip+=XYSamples_padded;
     }
    return(image);
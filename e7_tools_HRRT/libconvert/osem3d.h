@@ -118,7 +118,9 @@ class OSEM3D
           DeltaXY,                                      /*!< voxelsize in mm */
           reb_factor,                      /*!< rebinning factor of sinogram */
           fov_diameter,            /*!< diameter of FOV after reconstruction */
-          plane_separation;                      /*!< plane separation in mm */
+          plane_separation,                      /*!< plane separation in mm */
+          start_scale;                    /*!< scaling factor of start image */
+    const float *start_image;           /*!< start image for reconstruction */
     ALGO::talgorithm algorithm;                /*!< reconstruction algorithm */
     BckPrj3D *bp;                                         /*!< backprojector */
     FwdPrj3D *fwd;                                    /*!< forward-projector */
@@ -197,6 +199,8 @@ class OSEM3D
     SinogramConversion *fwd_proj3d(ImageConversion * const,
                                    const unsigned short int);
     float *fwd_proj3d(float *, const unsigned short int);
+                                        // set start image for reconstruction
+    void startImage(const float * const, const float);
                                     // initialize time-of-flight reconstruction
     void initTOF(const float, const float, const unsigned short int);
                                       // calculate maximum intensity projection
@@ -0,0 +1,108 @@
+/*! \file prj_interp.h
+    \brief Interpolation kernels for four adjacent planes of the forward- and
+           back-projectors.
+    \date 2026/10/19 initial version
+
+    A LUT entry of the mode 1 projectors describes the same interpolation in
+    every plane of a segment. The projectors process four adjacent planes per
+    LUT entry with these kernels: the LUT is read once instead of four times
+    and the interpolations of the four planes are calculated as one vector
+    operation. The rows of an oblique bilinear interpolation are shared
+    between neighbouring planes, so that five instead of eight linear
+    interpolations are needed for four planes.
+
+    The four planes of a batch use the axial interpolation factor of the
+    first plane, so that the results differ from a plane by plane calculation
+    only by the rounding of the axial coordinate.
+ */
+
+#pragma once
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+                       /*! number of planes that are processed per LUT entry */
+const unsigned short int PLANE_BATCH=4;
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Linear interpolation in four planes.
+    \param[in]  ptr      pointer to first value in first plane
+    \param[in]  stride   distance between planes
+    \param[in]  offs     distance between the two values of an interpolation
+    \param[in]  f        interpolation factor
+    \param[out] v        interpolated values of the four planes
+
+    Calculate
+    \f[
+        v_k=p_{k\cdot stride}+f\left(p_{k\cdot stride+offs}-
+                                     p_{k\cdot stride}\right)
+        \qquad\forall\quad 0\le k<4
+    \f]
+ */
+/*---------------------------------------------------------------------------*/
+inline void planeInterp4(const float * const ptr,
+                         const unsigned long int stride,
+                         const unsigned long int offs, const float f,
+                         float * const v)
+ {
+#ifdef __SSE__
+   __m128 a, b;
+
+   a=_mm_set_ps(ptr[3*stride], ptr[2*stride], ptr[stride], ptr[0]);
+   b=_mm_set_ps(ptr[3*stride+offs], ptr[2*stride+offs], ptr[stride+offs],
+                ptr[offs]);
+   _mm_storeu_ps(v, _mm_add_ps(a, _mm_mul_ps(_mm_set1_ps(f),
+                                              _mm_sub_ps(b, a))));
+#else
+   for (unsigned short int k=0; k < 4; k++)
+    v[k]=ptr[k*stride]+f*(ptr[k*stride+offs]-ptr[k*stride]);
+#endif
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Bilinear interpolation in four adjacent planes.
+    \param[in]  ptr      pointer to first value in first plane
+    \param[in]  stride   distance between planes
+    \param[in]  offs     distance between the two values of an interpolation
+                         inside of a plane
+    \param[in]  f        interpolation factor inside of a plane
+    \param[in]  fz       interpolation factor between plane k and k+1
+    \param[out] v        interpolated values of the four planes
+
+    Calculate the linear interpolations \f$a_k\f$ inside of the planes
+    \f$0\le k\le 4\f$ and
+    \f[
+        v_k=a_k+fz\left(a_{k+1}-a_k\right) \qquad\forall\quad 0\le k<4
+    \f]
+ */
+/*---------------------------------------------------------------------------*/
+inline void planeBilinearInterp4(const float * const ptr,
+                                 const unsigned long int stride,
+                                 const unsigned long int offs, const float f,
+                                 const float fz, float * const v)
+ { float a4;
+
+   a4=ptr[4*stride]+f*(ptr[4*stride+offs]-ptr[4*stride]);
+#ifdef __SSE__
+   __m128 a, b;
+
+   a=_mm_set_ps(ptr[3*stride], ptr[2*stride], ptr[stride], ptr[0]);
+   b=_mm_set_ps(ptr[3*stride+offs], ptr[2*stride+offs], ptr[stride+offs],
+                ptr[offs]);
+   a=_mm_add_ps(a, _mm_mul_ps(_mm_set1_ps(f), _mm_sub_ps(b, a)));
+                                             // b=(a[1], a[2], a[3], a4)
+   b=_mm_shuffle_ps(a, _mm_move_ss(a, _mm_set_ss(a4)),
+                    _MM_SHUFFLE(0, 3, 2, 1));
+   _mm_storeu_ps(v, _mm_add_ps(a, _mm_mul_ps(_mm_set1_ps(fz),
+                                              _mm_sub_ps(b, a))));
+#else
+   float a[5];
+
+   for (unsigned short int k=0; k < 4; k++)
+    a[k]=ptr[k*stride]+f*(ptr[k*stride+offs]-ptr[k*stride]);
+   a[4]=a4;
+   for (unsigned short int k=0; k < 4; k++)
+    v[k]=a[k]+fz*(a[k+1]-a[k]);
+#endif
+ }
@@ -5,6 +5,10 @@
     \date 2003/11/17 initial version
     \date 2005/02/08 added Doxygen style comments
     \date 2005/03/29 delete OSEM object after use to reduce swapping
+    \date 2026/10/19 don't rebin u-map that already has the size of the
+                     scatter images
+    \date 2026/10/19 warm-start from previous frame and reuse its scatter
+                     simulation if the emission image hasn't changed
 
     This class implements the calculation of a scatter sinogram based on an
     emission sinogram, normalization dataset and u-map. The 3d emission
@@ -16,6 +20,13 @@
     sinogram is rebinned by cubic b-splines to the original size. Scaling
     factors for the slices of the sinogram are calculated and applied to
     adapt the scatter sinogram to the countrate of the emission sinogram.
+
+    If the object is used for several frames of a dynamic study and a reuse
+    threshold is set, the OSEM reconstruction of a frame starts from the image
+    of the previous frame and uses only one iteration. If the relative change
+    of the emission image since the last scatter simulation is below the
+    threshold, the simulated scatter sinogram is reused and only the scale
+    factors are calculated again.
  */
 
 #include <iostream>
@@ -107,6 +118,11 @@ Scatter::Scatter(const unsigned short int _RhoSamples, const float _BinSizeRho,
      scatter_qc=_scatter_qc;
      scatter_qc_path=_scatter_qc_path;
      subsets=_subsets;
+     reuse_threshold=0.0f;
+     prev_ssr_counts=0.0;
+     prev_recon_idx=MemCtrl::MAX_BLOCK;
+     prev_image_idx=MemCtrl::MAX_BLOCK;
+     prev_sss_idx=MemCtrl::MAX_BLOCK;
      if ((ThetaSamples % subsets) > 0)
       { unsigned short int os;
 
@@ -143,6 +159,84 @@ Scatter::Scatter(const unsigned short int _RhoSamples, const float _BinSizeRho,
 /*---------------------------------------------------------------------------*/
 Scatter::~Scatter()
  { //if (osem != NULL) delete osem;
+   MemCtrl::mc()->deleteBlock(&prev_recon_idx);
+   MemCtrl::mc()->deleteBlock(&prev_image_idx);
+   MemCtrl::mc()->deleteBlock(&prev_sss_idx);
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Set threshold for reuse of the scatter simulation.
+    \param[in] threshold   maximum relative change of the emission image
+                           (0=don't reuse data of previous frames)
+
+    Set threshold for reuse of the scatter simulation of a previous frame.
+    If the threshold is larger than 0, the data of each frame is kept for the
+    next frame. The OSEM reconstruction of the next frame starts from the
+    image of this frame. The scatter simulation is reused, if the emission
+    image changed by less than the threshold (sum of absolute differences
+    after scaling to the same number of counts, relative to the sum of the
+    image).
+ */
+/*---------------------------------------------------------------------------*/
+void Scatter::reuseThreshold(const float threshold)
+ { reuse_threshold=threshold;
+   if (reuse_threshold > 0.0f) return;
+   MemCtrl::mc()->deleteBlock(&prev_recon_idx);
+   MemCtrl::mc()->deleteBlock(&prev_image_idx);
+   MemCtrl::mc()->deleteBlock(&prev_sss_idx);
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Calculate relative difference between two datasets.
+    \param[in] a      first dataset
+    \param[in] b      second dataset (reference)
+    \param[in] size   number of elements
+    \return relative difference
+
+    Calculate the relative difference between two datasets. The first dataset
+    is scaled to the sum of the second one:
+    \f[
+        d=\frac{\sum_i\left|a_i\frac{\sum_j b_j}{\sum_j a_j}-b_i\right|}
+                {\sum_i\left|b_i\right|}
+    \f]
+ */
+/*---------------------------------------------------------------------------*/
+float Scatter::relativeDifference(const float * const a,
+                                  const float * const b,
+                                  const unsigned long int size)
+ { double sum_a=0.0, sum_b=0.0, abs_b=0.0, diff=0.0, sf;
+
+   for (unsigned long int i=0; i < size; i++)
+    { sum_a+=(double)a[i];
+      sum_b+=(double)b[i];
+      abs_b+=fabs((double)b[i]);
+    }
+   if ((sum_a <= 0.0) || (abs_b <= 0.0)) return(1.0f);
+   sf=sum_b/sum_a;
+   for (unsigned long int i=0; i < size; i++)
+    diff+=fabs((double)a[i]*sf-(double)b[i]);
+   return((float)(diff/abs_b));
+ }
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Store a copy of a dataset in a memory block.
+    \param[in]     data       dataset
+    \param[in]     size       number of elements
+    \param[in,out] idx        index of memory block
+    \param[in]     name       prefix for swap filename
+    \param[in]     loglevel   level for logging
+
+    Store a copy of a dataset in a memory block. A block that is already
+    stored under this index is deleted.
+ */
+/*---------------------------------------------------------------------------*/
+void Scatter::storeCopy(const float * const data, const unsigned long int size,
+                        unsigned short int * const idx, const std::string name,
+                        const unsigned short int loglevel)
+ { MemCtrl::mc()->deleteBlock(idx);
+   memcpy(MemCtrl::mc()->createFloat(size, idx, name, loglevel), data,
+          size*sizeof(float));
+   MemCtrl::mc()->put(*idx);
  }
 
 /*---------------------------------------------------------------------------*/
@@ -326,7 +420,9 @@ SinogramConversion *Scatter::estimateScatter(SinogramConversion *acf_sino,
 
    try
    { std::string nr;
-     unsigned short int sss_idx, spl;
+     unsigned short int sss_idx=MemCtrl::MAX_BLOCK, spl;
+     unsigned long int sss_size;
+     bool reuse_sss=false;
 #ifdef USE_OLD_SCATTER_CODE
      std::vector <float> scale_factors;
 #endif
@@ -359,8 +455,39 @@ SinogramConversion *Scatter::estimateScatter(SinogramConversion *acf_sino,
                      loglevel+1);
      osem->calcNormFactorsAW(acf_sino, max_threads);
      osem->uncorrectEmissionAW(ssr_sino, acf_sino, false, max_threads);
-     ssr_image=osem->reconstruct(ssr_sino, false, iterations, mnr, NULL,
-                                 std::string(), false, max_threads);
+     { double ssr_counts=0.0;
+       bool warm_start;
+
+       for (unsigned short int axis=0; axis < ssr_sino->axes(); axis++)
+        { const float *sp;
+
+          sp=MemCtrl::mc()->getFloatRO(ssr_sino->index(axis, 0), loglevel);
+          for (unsigned long int i=0; i < ssr_sino->size(axis); i++)
+           ssr_counts+=(double)sp[i];
+          MemCtrl::mc()->put(ssr_sino->index(axis, 0));
+        }
+                                  // start from image of previous frame ?
+       warm_start=(reuse_threshold > 0.0f) &&
+                  (prev_recon_idx < MemCtrl::MAX_BLOCK) &&
+                  (prev_ssr_counts > 0.0);
+       if (warm_start)
+        { Logging::flog()->logMsg("start reconstruction from image of "
+                                  "previous frame (1 iteration)", loglevel);
+          osem->startImage(MemCtrl::mc()->getFloatRO(prev_recon_idx,
+                                                     loglevel),
+                           (float)(ssr_counts/prev_ssr_counts));
+        }
+       ssr_image=osem->reconstruct(ssr_sino, false,
+                                   warm_start ? 1 : iterations, mnr, NULL,
+                                   std::string(), false, max_threads);
+       if (warm_start) MemCtrl::mc()->put(prev_recon_idx);
+       if (reuse_threshold > 0.0f)    // keep image for next frame
+        { storeCopy(MemCtrl::mc()->getFloatRO(ssr_image->index(), loglevel),
+                    ssr_image->size(), &prev_recon_idx, "srec", loglevel);
+          MemCtrl::mc()->put(ssr_image->index());
+          prev_ssr_counts=ssr_counts;
+        }
+     }
      delete osem;
      osem=NULL;
 
@@ -405,10 +532,12 @@ SinogramConversion *Scatter::estimateScatter(SinogramConversion *acf_sino,
          umap_image->trim(trim, "umap", loglevel);
       }
                                        // rebin u-map to size of emission image
-     umap_image->resampleXY(XYSamplesScatter,
-                            umap_image->DeltaXY()*
-                            (float)umap_image->XYSamples()/
-                            (float)XYSamplesScatter, true, loglevel);
+                                      // (u-map of previous frame already is)
+     if (umap_image->XYSamples() != XYSamplesScatter)
+      umap_image->resampleXY(XYSamplesScatter,
+                             umap_image->DeltaXY()*
+                             (float)umap_image->XYSamples()/
+                             (float)XYSamplesScatter, true, loglevel);
      Logging::flog()->logMsg("size of emission image: #1x#2x#3 (#4mm x #5mm x "
                              "#6mm)", loglevel)->arg(ssr_image->XYSamples())->
       arg(ssr_image->XYSamples())->arg(ssr_image->ZSamples())->
@@ -420,9 +549,21 @@ SinogramConversion *Scatter::estimateScatter(SinogramConversion *acf_sino,
       arg(umap_image->DeltaXY())->arg(umap_image->DeltaXY())->
       arg(umap_image->DeltaZ());
 
-                                                   // simulate scatter sinogram
-     Logging::flog()->logMsg("start scatter estimation", loglevel);
-     sw.start();
+                 // compare emission image with image of last scatter simulation
+     if ((reuse_threshold > 0.0f) && (prev_image_idx < MemCtrl::MAX_BLOCK))
+      { float change;
+
+        change=relativeDifference(
+                       MemCtrl::mc()->getFloatRO(ssr_image->index(), loglevel),
+                       MemCtrl::mc()->getFloatRO(prev_image_idx, loglevel),
+                       ssr_image->size());
+        MemCtrl::mc()->put(prev_image_idx);
+        MemCtrl::mc()->put(ssr_image->index());
+        reuse_sss=(change < reuse_threshold);
+        Logging::flog()->logMsg("relative change of emission image since last "
+                                "scatter simulation: #1%", loglevel)->
+         arg(change*100.0f);
+      }
      scatter_sino=new SinogramConversion(emi_sino->RhoSamples(),
                                         emi_sino->BinSizeRho(),
                                         emi_sino->ThetaSamples(),
@@ -437,7 +578,27 @@ SinogramConversion *Scatter::estimateScatter(SinogramConversion *acf_sino,
                                         emi_sino->gateDuration(),
                                         emi_sino->halflife(),
                                         emi_sino->bedPos(), mnr, true);
-     sss_idx=ScatterEstimation(MemCtrl::mc()->getFloat(ssr_image->index(),
+     sss_size=scatter_sino->planeSize()*
+              (unsigned long int)scatter_sino->axesSlices();
+     if (reuse_sss && !scatter_qc)
+      { Logging::flog()->logMsg("reuse scatter simulation of previous frame",
+                                loglevel);
+        storeCopy(MemCtrl::mc()->getFloatRO(prev_sss_idx, loglevel+1),
+                  sss_size, &sss_idx, "sss", loglevel+1);
+        MemCtrl::mc()->put(prev_sss_idx);
+      }
+      else {                                       // simulate scatter sinogram
+             Logging::flog()->logMsg("start scatter estimation", loglevel);
+             sw.start();
+             if (reuse_threshold > 0.0f)    // keep image for next simulation
+              { storeCopy(MemCtrl::mc()->getFloatRO(ssr_image->index(),
+                                                    loglevel),
+                          ssr_image->size(), &prev_image_idx, "simg",
+                          loglevel);
+                MemCtrl::mc()->put(ssr_image->index());
+              }
+             sss_idx=ScatterEstimation(
+                               MemCtrl::mc()->getFloat(ssr_image->index(),
                                                        loglevel),
                                MemCtrl::mc()->getFloat(umap_image->index(),
                                                        loglevel),
@@ -453,18 +614,35 @@ SinogramConversion *Scatter::estimateScatter(SinogramConversion *acf_sino,
                                sampling_grid_z, max_scatter_samps_xy,
                                max_scatter_samps_z, lld, uld,
                                uniform_plane_sampling, max_threads);
-     MemCtrl::mc()->put(ssr_image->index());
-
+             MemCtrl::mc()->put(ssr_image->index());
+             MemCtrl::mc()->put(umap_image->index());
+             Logging::flog()->logMsg("finished scatter estimation in #1 sec",
+                                     loglevel)->arg(sw.stop());
+                                 // report accuracy of reused simulation (QC)
+             if (reuse_sss)
+              { Logging::flog()->logMsg("relative difference between scatter "
+                                        "simulation of previous frame and new "
+                                        "simulation: #1%", loglevel)->
+                 arg(relativeDifference(
+                         MemCtrl::mc()->getFloatRO(prev_sss_idx, loglevel+1),
+                         MemCtrl::mc()->getFloatRO(sss_idx, loglevel+1),
+                         sss_size)*100.0f);
+                MemCtrl::mc()->put(prev_sss_idx);
+                MemCtrl::mc()->put(sss_idx);
+              }
+             if (reuse_threshold > 0.0f)   // keep simulation for next frames
+              { storeCopy(MemCtrl::mc()->getFloatRO(sss_idx, loglevel+1),
+                          sss_size, &prev_sss_idx, "ssim", loglevel+1);
+                MemCtrl::mc()->put(sss_idx);
+              }
+           }
      delete ssr_image;
      ssr_image=NULL;
-     MemCtrl::mc()->put(umap_image->index());
      scatter_sino->copyData(MemCtrl::mc()->getFloatRO(sss_idx, loglevel+1), 0,
                             1, scatter_sino->axesSlices(), 1, false, false,
                             "scat", loglevel+1);
      MemCtrl::mc()->put(sss_idx);
      MemCtrl::mc()->deleteBlock(&sss_idx);
-     Logging::flog()->logMsg("finished scatter estimation in #1 sec",
-                             loglevel)->arg(sw.stop());
                                 // convert 2d scatter sinogram into 3d sinogram
      Logging::flog()->logMsg("convert 2d scatter sinogram into 3d sinogram",
                              loglevel);
@@ -5,6 +5,8 @@
     \date 2003/11/17 initial version
     \date 2005/02/08 added Doxygen style comments
     \date 2005/03/29 delete OSEM object after use to reduce swapping
+    \date 2026/10/19 warm-start from previous frame and reuse its scatter
+                     simulation if the emission image hasn't changed
  */
 
 #pragma once
@@ -41,6 +43,23 @@ private:
   float BinSizeRho,                        /*!< bin size of sinogram in mm */
         DeltaZ;                                /*!< plane separation in mm */
   std::vector <unsigned short int> axis_slices;            /*!< axis table */
+  /*! maximum relative change of emission image to reuse scatter simulation */
+  float reuse_threshold;
+  /*! number of counts in ssr sinogram of previous frame */
+  double prev_ssr_counts;
+  /*! OSEM image of previous frame */
+  unsigned short int prev_recon_idx,
+           /*! emission image used for last scatter simulation */
+           prev_image_idx,
+           /*! last simulated 2d scatter sinogram (unscaled) */
+           prev_sss_idx;
+  // relative difference between datasets after scaling to same sum
+  static float relativeDifference(const float * const, const float * const,
+                                  const unsigned long int);
+  // store copy of dataset in memory block
+  static void storeCopy(const float * const, const unsigned long int,
+                        unsigned short int * const, const std::string,
+                        const unsigned short int);
   // calculate cubic b-splines
   Matrix <float> *bspline(const unsigned short int, const unsigned short int,
                           const unsigned short int, const unsigned short int,
@@ -89,6 +108,8 @@ public:
           const unsigned short int, const bool, const std::string,
           const unsigned short int);
   ~Scatter();                                               // destroy object
+  // set threshold for reuse of scatter simulation of previous frame
+  void reuseThreshold(const float);
   // perform scatter estimation
   SinogramConversion *estimateScatter(SinogramConversion *,
                                       ImageConversion *,
@@ -522,6 +522,38 @@ void ECAT7::DataDeleted(const unsigned short int num) const
  { if (e7_matrix_.size() > num) e7_matrix_[num]->DataDeleted();
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Request position of data part of matrix in file.
+    \param[in] num   matrix number
+    \return offset of data part from start of file in bytes
+    \exception REC_ECAT7_MATRIXHEADER_MISSING ECAT7 matrix header is missing
+
+    Request position of the data part of a matrix in the ECAT7 file. The data
+    part follows the matrix header, which is two records long for 3d
+    sinograms and one record long for all other matrix types. This allows to
+    read the data part directly, without using LoadData().
+ */
+/*---------------------------------------------------------------------------*/
+unsigned long long int ECAT7::DataOffset(const unsigned short int num) const
+ { unsigned long long int records;
+
+   if ((e7_directory_ == NULL) || (e7_matrix_.size() <= num))
+    throw Exception(REC_ECAT7_MATRIXHEADER_MISSING,
+                    "ECAT7 matrix header is missing.");
+   records=e7_directory_->HeaderPtr()[num].first_record;
+   switch (Main_file_type())
+    { case E7_FILE_TYPE_3D_Sinogram8:
+      case E7_FILE_TYPE_3D_Sinogram16:
+      case E7_FILE_TYPE_3D_SinogramFloat:
+       records+=2;
+       break;
+      default:
+       records++;
+       break;
+    }
+   return(records*E7_RECLEN);
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Request data type of data part.
     \param[in] num   matrix number
@@ -45,6 +45,7 @@ public:
   void CreateScanMatrices(const unsigned short int);  // create Scan matrices
   void CreateScan3DMatrices(const unsigned short int);                  // remove data from object without deleting
   void DataDeleted(const unsigned short int) const;                                    // create Scan3D matrices
+  unsigned long long int DataOffset(const unsigned short int) const;  // request position of data part in file
   unsigned short int DataType(const unsigned short int) const;                                 // create Polar map matrices
   void DeleteData(const unsigned short int) const;                                    // create Norm3D matrices
   void DeleteMatrices();                 // delete matrices
@@ -53,6 +53,8 @@
 /*---------------------------------------------------------------------------*/
 ECAT7_DIRECTORY::ECAT7_DIRECTORY()
  { id_vals.clear();
+   tail_filename.clear();
+   tail_rec=0;
  }
 
 /*---------------------------------------------------------------------------*/
@@ -64,7 +66,9 @@ ECAT7_DIRECTORY::ECAT7_DIRECTORY()
  */
 /*---------------------------------------------------------------------------*/
 ECAT7_DIRECTORY& ECAT7_DIRECTORY::operator = (const ECAT7_DIRECTORY &e7)
- { if (this != &e7) id_vals=e7.id_vals;
+ { if (this != &e7) { id_vals=e7.id_vals;
+                      tail_filename.clear();
+                    }
    return(*this);
  }
 
@@ -92,82 +96,65 @@ void ECAT7_DIRECTORY::AddEntries(const unsigned short int num)
     Append directory entry for matrix with given number. If the last directory
     block in the chain is full, a new block is created and appended to the
     file. All changes are made directly to the file.
+    The last directory block is kept in memory, so appending n matrices
+    reads the directory chain once instead of n times.
  */
 /*---------------------------------------------------------------------------*/
 void ECAT7_DIRECTORY::AppendEntry(const std::string filename,
                                   const unsigned long int matrix_rec,
                                   const unsigned long int mat_nr)
- { unsigned long int recnr;
-   std::ifstream *file_in=NULL;
-   std::ofstream *file_out=NULL;
+ { std::ofstream *file_out=NULL;
 
-   recnr=2;
    try
-   { do { tdir_list dir_list;
-
-          file_in=new std::ifstream(filename.c_str(),
-                                    std::ios::in|std::ios::binary);
-          if (!*file_in)
-           throw Exception(REC_FILE_DOESNT_EXIST,
-                           "The file '#1' doesn't exist.").arg(filename);
-          LoadDirBlock(file_in, recnr, &dir_list);      // load directory block
-          file_in->close();
-          delete file_in;
-          file_in=NULL;
-          if (dir_list.num_avail_entries == 0)                  // block full ?
-           { if (dir_list.next_dir_rec == 2)       // last block of directory ?
-              {                              // connect full block to new block
-                dir_list.next_dir_rec=dir_list.entry[30][2];
-                file_out=new std::ofstream(filename.c_str(),
-                                           std::ios::out|std::ios::in|
-                                           std::ios::binary);
-                SaveDirBlock(file_out, recnr, &dir_list);    // save full block
+   { signed long int nr;
+
+     if (tail_filename != filename) LoadTailBlock(filename);
+     file_out=new std::ofstream(filename.c_str(),
+                                std::ios::out|std::ios::in|std::ios::binary);
+     if (tail_block.num_avail_entries == 0)                     // block full ?
+      {                                     // connect full block to new block
+        tail_block.next_dir_rec=tail_block.entry[30][2];
+        SaveDirBlock(file_out, tail_rec, &tail_block);       // save full block
                                           // create new (empty) directory block
-                CreateDirBlock(file_out, recnr, dir_list.next_dir_rec);
-                file_out->close();
-                delete file_out;
-                file_out=NULL;
-              }
-           }
-           else { signed long int nr;
-                                   // block not full -> insert entry for matrix
-                  nr=dir_list.num_alloc_entries;
+        CreateDirBlock(file_out, tail_rec, tail_block.next_dir_rec);
+        tail_block.last_dir_rec=tail_rec;
+        tail_rec=tail_block.next_dir_rec;
+        tail_block.num_avail_entries=31;
+        tail_block.next_dir_rec=2;
+        tail_block.num_alloc_entries=0;
+        memset(&tail_block.entry, 0, 31*4*sizeof(signed long int));
+        tail_filename=filename;
+      }
+                                              // insert entry for matrix
+     nr=tail_block.num_alloc_entries;
                                         // store matrix information as ID value
-                  dir_list.entry[nr][0]=MatrixID(id_vals[mat_nr].bed,
-                                                 id_vals[mat_nr].frame,
-                                                 id_vals[mat_nr].gate,
-                                                 id_vals[mat_nr].plane,
-                                                 id_vals[mat_nr].data);
+     tail_block.entry[nr][0]=MatrixID(id_vals[mat_nr].bed,
+                                      id_vals[mat_nr].frame,
+                                      id_vals[mat_nr].gate,
+                                      id_vals[mat_nr].plane,
+                                      id_vals[mat_nr].data);
                                            // record number of matrix subheader
-                  if (nr > 0) dir_list.entry[nr][1]=dir_list.entry[nr-1][2]+1;
-                   else dir_list.entry[nr][1]=recnr+1;
+     if (nr > 0) tail_block.entry[nr][1]=tail_block.entry[nr-1][2]+1;
+      else tail_block.entry[nr][1]=tail_rec+1;
                                                 // last record number of matrix
-                  dir_list.entry[nr][2]=dir_list.entry[nr][1]+matrix_rec;
-                  dir_list.entry[nr][3]=1;                     // matrix exists
-                  dir_list.num_avail_entries--;
-                  dir_list.num_alloc_entries++;
+     tail_block.entry[nr][2]=tail_block.entry[nr][1]+matrix_rec;
+     tail_block.entry[nr][3]=1;                                // matrix exists
+     tail_block.num_avail_entries--;
+     tail_block.num_alloc_entries++;
                                       // store numbers of first and last record
-                  id_vals[mat_nr].first_record=dir_list.entry[nr][1]-1;
-                  id_vals[mat_nr].last_record=dir_list.entry[nr][2]-1;
+     id_vals[mat_nr].first_record=tail_block.entry[nr][1]-1;
+     id_vals[mat_nr].last_record=tail_block.entry[nr][2]-1;
                                                 // save changed directory block
-                  file_out=new std::ofstream(filename.c_str(),
-                                             std::ios::out|std::ios::in|
-                                             std::ios::binary);
-                  SaveDirBlock(file_out, recnr, &dir_list);
-                  file_out->close();
-                  delete file_out;
-                  file_out=NULL;
-                }
-          recnr=dir_list.next_dir_rec;
-        } while (recnr != 2);                // loop to last block of directory
+     SaveDirBlock(file_out, tail_rec, &tail_block);
+     file_out->close();
+     delete file_out;
+     file_out=NULL;
    }
    catch (...)                                             // handle exceptions
-    { if (file_in != NULL) { file_in->close();
-                             delete file_in;
-                           }
-      if (file_out != NULL) { file_out->close();
+    { if (file_out != NULL) { file_out->close();
                               delete file_out;
                             }
+      tail_filename.clear();
       throw;
     }
  }
@@ -192,6 +179,7 @@ void ECAT7_DIRECTORY::CreateDirBlock(std::ofstream * const file,
    dir_list.num_alloc_entries=0;
    memset(&dir_list.entry, 0, 31*4*sizeof(signed long int));
    SaveDirBlock(file, this_dir_rec, &dir_list);                   // save block
+   tail_filename.clear();                    // directory changed behind cache
  }
 
 /*---------------------------------------------------------------------------*/
@@ -257,6 +245,44 @@ void ECAT7_DIRECTORY::LoadDirBlock(std::ifstream * const file,
     }
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Find and cache last block of directory.
+    \param[in] filename   name of ECAT7 file
+    \exception REC_FILE_DOESNT_EXIST the file doesn't exist
+
+    Follow the chain of directory blocks to the last one and keep a copy of
+    it for AppendEntry().
+ */
+/*---------------------------------------------------------------------------*/
+void ECAT7_DIRECTORY::LoadTailBlock(const std::string filename) const
+ { std::ifstream *file_in=NULL;
+
+   try
+   { signed long int recnr=2;
+
+     file_in=new std::ifstream(filename.c_str(),
+                               std::ios::in|std::ios::binary);
+     if (!*file_in)
+      throw Exception(REC_FILE_DOESNT_EXIST,
+                      "The file '#1' doesn't exist.").arg(filename);
+     do { tail_rec=recnr;
+          LoadDirBlock(file_in, recnr, &tail_block);    // load directory block
+          recnr=tail_block.next_dir_rec;
+        } while (recnr != 2);                // loop to last block of directory
+     file_in->close();
+     delete file_in;
+     file_in=NULL;
+     tail_filename=filename;
+   }
+   catch (...)                                             // handle exceptions
+    { if (file_in != NULL) { file_in->close();
+                             delete file_in;
+                           }
+      tail_filename.clear();
+      throw;
+    }
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Load complete directory and create array of matrix information.
     \param[in,out] file   handle of ECAT7 file
@@ -268,6 +294,7 @@ void ECAT7_DIRECTORY::LoadDirectory(std::ifstream * const file)
  { unsigned long int recnr=2;                    // pointer to directory record
 
    id_vals.clear();
+   tail_filename.clear();
    do { tdir_list dir_list;
 
         LoadDirBlock(file, recnr, &dir_list);           // load directory block
@@ -41,6 +41,14 @@ class ECAT7_DIRECTORY
                    } tdir_list;
                                  /*! array of information about the matrices */
     std::vector <ECAT7_DIRECTORY::tid_val7> id_vals;
+                 /*! name of file whose last directory block is cached */
+    mutable std::string tail_filename;
+                                  /*! record number of last directory block */
+    mutable signed long int tail_rec;
+                                        /*! copy of last directory block */
+    mutable tdir_list tail_block;
+                                  // find and cache last block of directory
+    void LoadTailBlock(const std::string) const;
                                                         // load directory block
     void LoadDirBlock(std::ifstream * const, const signed long int,
                       tdir_list * const) const;
@@ -18,6 +18,7 @@
     \date 2004/11/12 support series of u-maps from CT conversion
     \date 2004/11/24 added Float2Short() method with intercept
     \date 2005/03/11 added PSF-AW-OSEM
+    \date 2026/10/19 load ECAT7 and Interfile images lazily
 
     This class handles a PET image data structure and provides methods to load
     and save these images from and to files. The internal dataformat is always
@@ -37,6 +38,7 @@
 #include "mem_ctrl.h"
 #include "raw_io.h"
 #include "str_tmpl.h"
+#include "swap_tmpl.h"
 #include "types.h"
 #include "vecmath.h"
 #include "wholebody.h"
@@ -615,7 +617,21 @@ void ImageIO::loadECAT7(const std::string name,
    matrix_data=e7->Dir_data(mnr);
    matrix_bed=e7->Dir_bed(mnr);
    bedpos.assign(1, bedPosition(e7, mnr));
-   e7->LoadData(mnr);
+   MemCtrl::tdatatype file_dt=MemCtrl::DT_FLT;
+   bool lazy=false;
+                          // can the image data be loaded on first access ?
+   if (MemCtrl::mc()->lazyLoading())
+    switch (e7->Matrix(mnr)->DataTypeOrig())
+     { case E7_DATA_TYPE_SunShort:
+        file_dt=MemCtrl::DT_SINT;
+        lazy=true;
+        break;
+       case E7_DATA_TYPE_IeeeFloat:
+        file_dt=MemCtrl::DT_FLT;
+        lazy=true;
+        break;
+     }
+   if (!lazy) e7->LoadData(mnr);
    vXYSamples=e7->Image_x_dim(mnr);
    vZSamples=e7->Image_z_dim(mnr);
    vDeltaXY=e7->Image_x_pixel_size(mnr)*10.0f;
@@ -659,6 +675,22 @@ void ImageIO::loadECAT7(const std::string name,
       corrections_applied|=CORR_XYSmoothing;
      if (c & E7_APPLIED_PROC_Z_smoothing) corrections_applied|=CORR_ZSmoothing;
    }
+   if (lazy)
+    { for (unsigned short int i=0; i < data_idx.size(); i++)
+       MemCtrl::mc()->deleteBlock(&data_idx[i]);       // delete old image data
+      data_idx.clear();
+      image_size=(unsigned long int)XYSamples()*(unsigned long int)XYSamples()*
+                 (unsigned long int)ZSamples();
+                // image data is read, converted and scaled on first access
+      data_idx.resize(1);
+      MemCtrl::mc()->createFromFile(image_size, MemCtrl::DT_FLT, filename,
+                                    e7->DataOffset(mnr), file_dt,
+                                    !BigEndianMachine(),
+                                    file_dt == MemCtrl::DT_SINT ?
+                                     e7->Image_scale_factor(mnr) : 1.0f,
+                                    &data_idx[0], name, loglevel);
+      return;
+    }
    if (e7->DataType(mnr) == E7_DATATYPE_SHORT)       // convert data to float ?
     { e7->Short2Float(mnr);
       switch (e7->Main_file_type())
@@ -813,6 +845,19 @@ void ImageIO::loadInterfile(const std::string name,
      for (i=0; i < data_idx.size(); i++)
       MemCtrl::mc()->deleteBlock(&data_idx[i]);             // delete old image
      data_idx.clear();
+     if (MemCtrl::mc()->lazyLoading())
+      { MemCtrl::tdatatype dt;
+                        // image data is read or mapped on first access
+        if (inf->Sub_number_format() == KV::SIGNED_INT_NF)
+         dt=MemCtrl::DT_SINT;
+         else dt=MemCtrl::DT_FLT;
+        data_idx.resize(1);
+        MemCtrl::mc()->createFromFile(image_size, dt,
+                             inf->Sub_name_of_data_file(), 0, dt,
+                             inf->Sub_image_data_byte_order() == KV::BIG_END,
+                             1.0f, &data_idx[0], name, loglevel);
+        return;
+      }
                                                              // read image data
      switch (inf->Sub_number_format())
       { case KV::SIGNED_INT_NF:
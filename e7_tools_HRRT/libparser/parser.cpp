@@ -36,6 +36,9 @@
     \date 2005/02/24 allow float values for bed positions
     \date 2005/03/11 added "psf-aw-osem" reconstruction
     \date 2009/09/02 Bug fix (crash on computer without gantry model shared libs)
+    \date 2026/10/19 added switch "--lazy"
+    \date 2026/10/19 added switch "--sthr"
+    \date 2026/10/19 added switches "--tv" and "--tvpd"
  */
 
 #include <iostream>
@@ -469,7 +472,16 @@ const std::string Parser::os2d_str[2]={"save unscaled 2d scatter and scaling "
       "factors",
       "save unscaled 2d scatter and scaling factors instead of 3D sinogram "
       "to reduce file size"};
-                                         /*! description of "--lber" switch */
+                                          /*! description of "--lazy" switch */
+const std::string Parser::lazy_str[2]={"load input data on first access",
+      "load input data on first access. Sinograms and images from ECAT7 and "
+      "Interfile files are not read when the file is opened. Each sinogram "
+      "axis or image is read when it is used for the first time and is "
+      "dropped instead of swapped out as long as it isn't modified. Data that "
+      "is stored with the byte order of this computer is mapped into memory "
+      "instead of being read. The input files must not be modified while the "
+      "program is running."};
+                                          /*! description of "--lber" switch */
 const std::string Parser::lber_str[2]={"Specify back and front Layers "
       "Background Energy Ratio.",
       "Specify back and front Layers Background Energy ratio to override "
@@ -614,6 +626,19 @@ const std::string Parser::ssf_str[2]={"thresholds for scatter scaling factors",
       " Example: --ssf 0.3,1.9$"
       "          --ssf 1.0,1.0 (switch off scatter scaling)$"
       "          --ssf 0.0,0.0 (switch off thresholds)"};
+                                          /*! description of "--sthr" switch */
+const std::string Parser::sthr_str[2]={"threshold for reuse of scatter "
+      "simulation",
+      "threshold for the reuse of the scatter simulation of the previous frame "
+      "of a dynamic study. The emission image of each frame is reconstructed "
+      "with one iteration, starting from the image of the previous frame. If "
+      "the relative change of the emission image since the last scatter "
+      "simulation is below the threshold, the simulation is reused and only "
+      "the scaling factors are calculated again. If \"-q\" is used, the "
+      "simulation is always calculated and the difference to the reused "
+      "simulation is logged. The default is 0 (calculate scatter for every "
+      "frame).$"
+      " Example: --sthr 0.02"};
                                           /*! description of "--swap" switch */
 const std::string Parser::swap_str[2]={"path for swapping files",
       "path for swapping files. If the memory requirements are bigger than the"
@@ -668,6 +693,22 @@ const std::string Parser::trim_str[2]={"trim sinogram",
       "before the sinogram is reconstructed. If the \"-R\" switch is used at "
       "the same time, the \"--trim\" switch has precedence.$"
       " Example: --trim 20"};
+                                            /*! description of "--tv" switch */
+const std::string Parser::tv_str[2]={"TV regularization of the @-map",
+      "total variation regularization of the @-map (TX_TV3DReg). Voxels "
+      "between 0.07 and 0.099 1/cm are set to 0.099 1/cm before the "
+      "regularization. The parameters are the smoothing weight and the number "
+      "of fixed point and relaxation iterations. The default is not to "
+      "regularize. If only the smoothing weight is specified, 2 fixed point "
+      "and 3 relaxation iterations are used.$"
+      " Example: --tv 0.5,2,3"};
+                                          /*! description of "--tvpd" switch */
+const std::string Parser::tvpd_str[2]={"primal-dual TV regularization",
+      "use the primal-dual algorithm of Chambolle and Pock with the given "
+      "number of iterations for the TV regularization of the @-map, instead of"
+      " the fixed point and relaxation iterations. This switch needs the "
+      "\"--tv\" switch.$"
+      " Example: --tvpd 100"};
 
 const std::string Parser::txsc_str[2]={"Transmission scatter correction "
       "factors a,b",
@@ -937,6 +978,11 @@ Parser::Parser(const std::string _prgname, const std::string _descr,
      v.txscatter[0]=v.txscatter[1]=0.0f;
      v.lber=-1.0f;
      v.txblr = 0.0f;
+     v.scatter_reuse_threshold=0.0f;
+     v.tv_lambda=0.0f;
+     v.tv_fp_iterations=2;
+     v.tv_relax_iterations=3;
+     v.tv_pd_iterations=0;
      v.gibbs_prior=0.0f;
      v.zoom_factor=1.0f;
      v.overlap=false;
@@ -976,6 +1022,7 @@ Parser::Parser(const std::string _prgname, const std::string _descr,
      v.no_radial_arc=false;
      v.no_axial_arc=false;
      v.undo_attcor=false;
+     v.lazy_loading=false;
      v.memory_limit=0.8f;
      v.ct_filename=std::string();
      v.bed_position.clear();
@@ -1413,6 +1460,10 @@ bool Parser::parse(int argc, char **argv)
                                            { "txsc",  1, 0, 0 },
                                            { "lber",  1, 0, 0 },
                                            { "txblr",  1, 0, 0 },
+                                           {  "lazy", 0, 0, 0 },
+                                           {  "sthr", 1, 0, 0 },
+                                           {    "tv", 1, 0, 0 },
+                                           {  "tvpd", 1, 0, 0 },
                                            {       0, 0, 0, 0 }
                                          };
 
@@ -2717,6 +2768,46 @@ bool Parser::parse(int argc, char **argv)
                  if (no_param) std::cerr << "txblr value is missing";
                  else v.txblr=a2f("--txblr", optstr, &no_error);
                  break;
+                case 78:                  // lazy: load input data on access
+                 v.lazy_loading=true;
+                 break;
+                case 79:       // sthr: threshold for reuse of scatter
+                 if (no_param) std::cerr << "threshold is missing";
+                  else v.scatter_reuse_threshold=a2f("--sthr", optstr,
+                                                     &no_error);
+                 break;
+                case 80:            // tv: TV regularization of u-map
+                 if (no_param) std::cerr << "smoothing weight is missing";
+                  else { std::string::size_type p, p2;
+
+                         if ((p=optstr.find(',')) == std::string::npos)
+                          v.tv_lambda=a2f("--tv", optstr, &no_error);
+                          else if ((p2=optstr.find(',', p+1)) ==
+                                   std::string::npos)
+                                { std::cerr << "Error (--tv): wrong format";
+                                  no_error=false;
+                                }
+                                else { v.tv_lambda=a2f("--tv",
+                                                       optstr.substr(0, p),
+                                                       &no_error);
+                                       v.tv_fp_iterations=a2i("--tv",
+                                                    optstr.substr(p+1, p2-p-1),
+                                                    &no_error);
+                                       v.tv_relax_iterations=a2i("--tv",
+                                                        optstr.substr(p2+1),
+                                                        &no_error);
+                                     }
+                         if (no_error && (v.tv_lambda <= 0.0f))
+                          { std::cerr << "Error (--tv): smoothing weight needs "
+                                         "to be positive";
+                            no_error=false;
+                          }
+                       }
+                 break;
+                case 81:    // tvpd: primal-dual algorithm for TV regularization
+                 if (no_param) std::cerr << "number of iterations is missing";
+                  else v.tv_pd_iterations=a2i("--tvpd", optstr, &no_error);
+                 break;
 
             }
              break;
@@ -3294,11 +3385,14 @@ void Parser::usage(const bool extended) const
        else if (swi == "skip") lparam+=" n";
        else if (swi == "span") lparam+=" span";
        else if (swi == "ssf") lparam+=" min,max";
+       else if (swi == "sthr") lparam+=" threshold";
        else if (swi == "swap") lparam+=" path";
        else if (swi == "t") lparam+=" transmission[,r,t]";
        else if (swi == "thr") lparam+=" t,u";
        else if (swi == "tofp") lparam+=" b,w,f";
        else if (swi == "trim") lparam+=" bins";
+       else if (swi == "tv") lparam+=" lambda[,fpi,ri]";
+       else if (swi == "tvpd") lparam+=" iterations";
        else if (swi == "ualgo")
              lparam+=" 1)|$  (--ualgo 20|21|30|31|"
                      "(40|41 alpha,;,;_ip,iter_ip)$   [-p segments,mean,std,"
@@ -3378,6 +3472,7 @@ void Parser::usage(const bool extended) const
        else if (swi == "is") str=is_str[i];
        else if (swi == "k") str=k_str[i];
        else if (swi == "l") str=l_str[i];
+       else if (swi == "lazy") str=lazy_str[i];
        else if (swi == "lber") str=lber_str[i];
        else if (swi == "mat") str=mat_str[i];
        else if (swi == "mem") str=mem_str[i];
@@ -3419,6 +3514,7 @@ void Parser::usage(const bool extended) const
        else if (swi == "skip") str=skip_str[i];
        else if (swi == "span") str=span_str[i];
        else if (swi == "ssf") str=ssf_str[i];
+       else if (swi == "sthr") str=sthr_str[i];
        else if (swi == "swap") str=swap_str[i];
        else if (swi == "t") str=t_str[i];
        else if ((swi == "tarc") || (swi == "tnarc")) str=tarc_str[i];
@@ -3426,6 +3522,8 @@ void Parser::usage(const bool extended) const
        else if (swi == "tof") str=tof_str[i];
        else if (swi == "tofp") str=tofp_str[i];
        else if (swi == "trim") str=trim_str[i];
+       else if (swi == "tv") str=tv_str[i];
+       else if (swi == "tvpd") str=tvpd_str[i];
        else if (swi == "txsc") str=txsc_str[i];
        else if (swi == "txblr") str=txblr_str[i];
        else if (swi == "u") str=u_str[i];
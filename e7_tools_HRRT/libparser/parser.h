@@ -80,6 +80,8 @@ class Parser {
     txscatter[2],                   // Transmission scatter factor a and b
     lber,                           // Back and Front LBER
     txblr,                          // TX/BL Ratio
+    scatter_reuse_threshold,        //< threshold for reuse of scatter of previous frame
+    tv_lambda,                      //< smoothing weight for TV regularization of u-map
     memory_limit;
   std::vector <float> bed_position; // list of bed positions in mm
   tcoord3d ct2pet_offset;           // offset between CT and PET coordinate system in mm
@@ -116,6 +118,9 @@ class Parser {
     iwidth,                         //< width of image
     uzoom_xy_factor,                // zoom factor for \f$\mu\f$-map in x/y-direction
     uzoom_z_factor,                 // zoom factor for \f$\mu\f$-map in z-direction
+    tv_fp_iterations,               // fixed point iterations for TV regularization
+    tv_relax_iterations,            // relaxation iterations for TV regularization
+    tv_pd_iterations,               // primal-dual iterations for TV regularization
     boxcar_width,                   // width of boxcar filter for scatter scaling
     a_lim,                          // axis up to which single slice rebinning is used
     w_lim,                          //< radial limit for FORE
@@ -193,7 +198,8 @@ class Parser {
     append,                         // append output files to existing files ?
     no_radial_arc,                  // never calculate radial arc-corrections ?
     no_axial_arc,                   // never calculate axial arc-corrections ?
-    undo_attcor;                    // uncorrect for attenuation before reconstruction ?
+    undo_attcor,                    // uncorrect for attenuation before reconstruction ?
+    lazy_loading;                   //< load input data on first access ?
   double trues,                     //< number of trues for Poisson noise
     randoms;                        //< number of randoms for Poisson noise
   ALGO::talgorithm algorithm;       // reconstruction algorithm
@@ -230,14 +236,15 @@ static const std::string a_str[2], aarc_str[2], algo_str[2], app_str[2],
   np_str[2], nrarc_str[2], oa_str[2], oaarc_str[2],
   oe_str[2], oearc_str[2], offs_str[2], oi_str[2],
   ol_str[2], os_str[2], os2d_str[2], osarc_str[2],
-  ou_str[2], lber_str[2],
+  ou_str[2], lazy_str[2], lber_str[2],
   p_str[2], pguid_str[2], pn_str[2], prj_str[2],
   q_str[2], qm_str[2], r_str[2], R_str[2],
   resrv_str[2], rs_str[2], s_str[2], sarc_str[2],
   scan_str[2], sguid_str[2], skip_str[2],
-  span_str[2], ssf_str[2], swap_str[2], t_str[2],
+  span_str[2], ssf_str[2], sthr_str[2], swap_str[2], t_str[2],
   tarc_str[2], thr_str[2], tof_str[2], tofp_str[2],
-  trim_str[2], txsc_str[2], txblr_str[2],
+  trim_str[2], tv_str[2], tvpd_str[2], txsc_str[2],
+  txblr_str[2],
   u_str[2], ualgo_str[2], uac_str[2],
   ucut_str[2], uf_str[2], uzoom_str[2], v_str[2],
   view_str[2], w_str[2], zoom_str[2];
@@ -4,12 +4,16 @@
     \author Frank Kehren (frank.kehren@cpspet.com)
     \date 2003/11/17 initial version
     \date 2005/02/08 added Doxygen style comments
+    \date 2026/10/19 added deadtimeChange() to compare singles of frames
 
     This class implements the calculation of the normalization sinogram from
     a component norm.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include "norm_ecat.h"
 #include "e7_common.h"
 #include "exception.h"
@@ -103,6 +107,33 @@ NormECAT::~NormECAT()
  { if (dtime_efficiency != NULL) delete[] dtime_efficiency;
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Calculate deadtime factor of the crystals of a bucket in a ring.
+    \param[in] singles                        singles values from emission
+    \param[in] bucket                         number of bucket
+    \param[in] dtcor1                         deadtime parameter of ring
+    \param[in] dtcor2                         deadtime parameter of ring
+    \param[in] transaxial_blocks_per_bucket   number of blocks per bucket in
+                                              transaxial direction
+    \return deadtime factor
+
+    Calculate deadtime factor of the crystals of a bucket in a ring from the
+    singles rate of a transaxial block of the bucket.
+ */
+/*---------------------------------------------------------------------------*/
+float NormECAT::deadtimeFactor(const std::vector <float> singles,
+                               const unsigned short int bucket,
+                               const float dtcor1, const float dtcor2,
+                               const unsigned short int
+                                                  transaxial_blocks_per_bucket)
+ { float rate;
+                       // singles rate for each transaxial block in this bucket
+   if (singles.size() > bucket)
+    rate=singles[bucket]/(float)transaxial_blocks_per_bucket;
+    else rate=1.0f/(float)transaxial_blocks_per_bucket;
+   return(1.0f+dtcor1*rate+dtcor2*rate*rate);
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Calculate table for deadtime corrected crystal efficiencies.
     \param[in] singles       singles values from emission
@@ -133,17 +164,14 @@ float *NormECAT::calcDeadtimeEfficiency(const std::vector <float> singles,
            crystal++,
            gantry_crystal++)
        { unsigned short int bucket;
-         float rate;
                                                             // number of bucket
          bucket=crystal/crystals_per_bucket+
                 buckets_per_ring*(ring/axial_crystals_per_block);
-                       // singles rate for each transaxial block in this bucket
-         if (singles.size() > bucket)
-          rate=singles[bucket]/(float)transaxial_blocks_per_bucket;
-          else rate=1.0f/(float)transaxial_blocks_per_bucket;
          dte[gantry_crystal]=
                      crystalEfficiencyCorr[gantry_crystal]*
-                     (1.0f+ring_dtcor1[ring]*rate+ring_dtcor2[ring]*rate*rate);
+                     deadtimeFactor(singles, bucket, ring_dtcor1[ring],
+                                    ring_dtcor2[ring],
+                                    transaxial_blocks_per_bucket);
        }
      return(dte);
    }
@@ -241,6 +269,60 @@ unsigned short int NormECAT::calcNorm(const unsigned short int loglevel) const
    return(norm_idx);
  }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Largest relative change of crystal deadtime factors between two
+           sets of singles.
+    \param[in] singles0                       singles values of first scan
+    \param[in] singles1                       singles values of second scan
+    \param[in] ring_dtcor1                    data for deadtime correction of
+                                              crystals
+    \param[in] ring_dtcor2                    data for deadtime correction of
+                                              crystals
+    \param[in] number_of_rings                number of rings in scanner
+    \param[in] buckets_per_ring               number of buckets per ring
+    \param[in] axial_crystals_per_block       number of crystals per block in
+                                              axial direction
+    \param[in] transaxial_blocks_per_bucket   number of blocks per bucket in
+                                              transaxial direction
+    \return largest relative change
+
+    Largest relative change of the deadtime factor of a crystal, if the
+    singles of the second scan are used instead of the singles of the first
+    scan. The efficiency of a LOR is a sum of products of two crystal
+    efficiencies, so a change of the deadtime factors by at most x changes the
+    normalization by at most about 2x.
+ */
+/*---------------------------------------------------------------------------*/
+float NormECAT::deadtimeChange(const std::vector <float> singles0,
+                               const std::vector <float> singles1,
+                               float * const ring_dtcor1,
+                               float * const ring_dtcor2,
+                               const unsigned short int number_of_rings,
+                               const unsigned short int buckets_per_ring,
+                               const unsigned short int
+                                                      axial_crystals_per_block,
+                               const unsigned short int
+                                                  transaxial_blocks_per_bucket)
+ { float change=0.0f;
+
+   for (unsigned short int ring=0; ring < number_of_rings; ring++)
+    for (unsigned short int b=0; b < buckets_per_ring; b++)
+     { unsigned short int bucket;
+       float f0, f1;
+
+       bucket=b+buckets_per_ring*(ring/axial_crystals_per_block);
+       f0=deadtimeFactor(singles0, bucket, ring_dtcor1[ring],
+                         ring_dtcor2[ring], transaxial_blocks_per_bucket);
+       f1=deadtimeFactor(singles1, bucket, ring_dtcor1[ring],
+                         ring_dtcor2[ring], transaxial_blocks_per_bucket);
+       if (f0 == 0.0f)
+        { if (f1 != 0.0f) return(std::numeric_limits <float>::max());
+        }
+        else change=std::max(change, fabsf(f1/f0-1.0f));
+     }
+   return(change);
+ }
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Kill block by setting the dead-time-efficiency to zero.
     \param[in] block_num   number of block
@@ -46,6 +46,10 @@ class NormECAT
                                   /*! data for crystal efficiency correction */
            *crystalEfficiencyCorr;
      tnorm_type norm_type;                                 /*!< type of norm */
+                                     // deadtime factor of crystals in a bucket
+     static float deadtimeFactor(const std::vector <float>,
+                                 const unsigned short int, const float,
+                                 const float, const unsigned short int);
                  // calculate table for deadtime corrected crystal efficiencies
      float *calcDeadtimeEfficiency(const std::vector <float>, float * const,
                                    float * const) const;
@@ -66,5 +70,12 @@ class NormECAT
      ~NormECAT();                                             // destroy object
                                             // calculate normalization sinogram
      unsigned short int calcNorm(const unsigned short int) const;
+                      // largest relative change of crystal deadtime factors
+     static float deadtimeChange(const std::vector <float>,
+                                 const std::vector <float>, float * const,
+                                 float * const, const unsigned short int,
+                                 const unsigned short int,
+                                 const unsigned short int,
+                                 const unsigned short int);
  };
 
@@ -4,6 +4,8 @@
     \date 2003/12/22 initial version
     \date 2003/12/31 added multi-threading
     \date 2004/09/13 added Doxygen style comments
+    \date 2026/10/19 cache crystal pairs of sinogram bins, balance threads,
+                     smooth several frames in one call, AVX2 products
  */
 
 #pragma once
@@ -24,29 +26,20 @@ class RandomsSmoothing
     typedef struct {                  /*! pointer to RandomsSmoothing object */
                      RandomsSmoothing *object;
                      unsigned short int first_ring,/*!< number of first ring */
-                                        last_ring,  /*!< number of last ring */
-                                            /*! number of bins in projection */
-                                        RhoSamples,
-                               /*! number of projections in a sinogram plane */
-                                        ThetaSamples,
-                                        mash,   /*!< mash factor of sinogram */
-                                    /*! number of crystals per detector ring */
-                                        crystals_per_ring,
-                                     /*! number of crystal to skip in radial
-                                         and axial direction due to gaps     */
-                                        skipinterval;
-                             /*! number of LORs contributing to each crystal */
-                     std::vector <unsigned short int> *cnt;
+                                        last_ring;  /*!< number of last ring */
                      float *sinogram;                  /*!< randoms sinogram */
                      std::vector <float> *singles;        /*!< singles rates */
                      std::vector <float> *epsilon;        /*!< randoms sens  */
+                        /*! result: diamond groups of the rings have counts */
+                     bool diamond;
                      unsigned short int thread_number; /*!< number of thread */
 #ifdef XEON_HYPERTHREADING_BUG
                                  /*!< padding bytes to avoid cache conflicts */
                      char padding[2*CACHE_LINE_SIZE-
-                                  8*sizeof(unsigned short int)-
-                                  sizeof(unsigned short int *)-
-                                  2*sizeof(float *)-
+                                  3*sizeof(unsigned short int)-
+                                  sizeof(float *)-
+                                  2*sizeof(std::vector <float> *)-
+                                  sizeof(bool)-
                                   sizeof(RandomsSmoothing *)];
 #endif
                    } tthread_rs_params;
@@ -55,29 +48,49 @@ class RandomsSmoothing
                      RandomsSmoothing *object;
                                                    /*! number of first plane */
                      unsigned short int first_plane,
-                                        last_plane,/*!< number of last plane */
-                                            /*! number of bins in projection */
-                                        RhoSamples,
-                               /*! number of projections in a sinogram plane */
-                                        ThetaSamples,
-                                        mash,   /*!< mash factor of sinogram */
-                                    /*! number of crystals per detector ring */
-                                        crystals_per_ring,
-                                     /*! number of crystal to skip in radial
-                                         and axial direction due to gaps     */
-                                        skipinterval;
+                                        last_plane;/*!< number of last plane */
                      float *sinogram;                  /*!< randoms sinogram */
-                     std::vector <float> *singles;        /*!< singles rates */
-                     std::vector <float> *epsilon;        /*!< randoms sens  */
+                       /*! crystal efficiencies with a zero after each ring */
+                     float *efficiency;
                      unsigned short int thread_number; /*!< number of thread */
 #ifdef XEON_HYPERTHREADING_BUG
                                  /*!< padding bytes to avoid cache conflicts */
                      char padding[2*CACHE_LINE_SIZE-
-                                  8*sizeof(unsigned short int)-
+                                  3*sizeof(unsigned short int)-
                                   2*sizeof(float *)-
                                   sizeof(RandomsSmoothing *)];
 #endif
                    } tthread_cs_params;
+                                   /*! LOR between two crystal rings */
+    typedef struct { unsigned short int ring_a,     /*!< number of ring a */
+                                        ring_b;     /*!< number of ring b */
+                     signed short int plane;    /*!< number of sinogram plane */
+                   } tring_pair;
+                      /*! crystal pairs of the sinogram bins for one geometry */
+    typedef struct { unsigned short int RhoSamples,/*!< bins in projection */
+                                        ThetaSamples,/*!< angles in sinogram */
+                                        mash,   /*!< mash factor of sinogram */
+                                    /*! number of crystals per detector ring */
+                                        crystals_per_ring,
+                                          /*! number of crystals in a block */
+                                        skipinterval;
+                                    /*! sinogram bin of each crystal pair */
+                     std::vector <unsigned long int> bin;
+                                        /*! crystals a and b of each pair */
+                     std::vector <unsigned short int> crys_a, crys_b;
+                          /*! index of each pair in the diamond group sums */
+                     std::vector <unsigned long int> group_ab, group_ba;
+                  /*! crystals a and b for each bin and each mashed angle;
+                      gaps refer to crystal "crystals_per_ring"              */
+                     std::vector <unsigned short int> layer_a, layer_b;
+                          /*! number of pairs per crystal as crystal a and b */
+                     std::vector <unsigned long int> cnt_a, cnt_b;
+                   /*! ring pairs ordered by ring a, without gaps in rings */
+                     std::vector <std::vector <tring_pair> > ring_pairs;
+                                     /*! ring pairs ordered by sinogram plane */
+                     std::vector <std::vector <tring_pair> > plane_pairs;
+                     bool valid;                   /*!< is the map valid ? */
+                   } tfan_map;
 
 /*             Start Mu         */
     bool flag_diamond_method; // diamonds has few counts
@@ -90,29 +103,26 @@ class RandomsSmoothing
     std::vector <signed short int> plane_numbers;
                 /*! semaphore for parallel calculation of total randoms rate */
     Semaphore *total_sem;
+                       /*! crystal pairs of sinogram bins for last geometry */
+    tfan_map fan;
                                                 // calculate total randoms rate
     void calculateTotalRandomsRate(const unsigned short int,
                                    const unsigned short int, float * const,
-                                   const unsigned short int,
-                                   const unsigned short int,
-                                   const unsigned short int,
-                                   const unsigned short int,
-                                   const unsigned short int,
                                    std::vector <float> * const,
-                                   std::vector <float> * const,
-                                   std::vector <unsigned short int> * const,
+                                   std::vector <float> * const, bool * const,
                                    const unsigned short int, const bool);
                                                     // create smoothed sinogram
     void createSmoothedSinogram(const unsigned short int,
                                 const unsigned short int, float * const,
-                                const unsigned short int,
-                                const unsigned short int,
-                                const unsigned short int,
-                                const unsigned short int,
-                                const unsigned short int,
-                                std::vector <float> * const,
-                                std::vector <float> * const,
+                                const float * const,
                                 const unsigned short int, const bool) const;
+                         // calculate crystal pairs of sinogram bins and rings
+    void initFanMap(const unsigned short int, const unsigned short int,
+                    const unsigned short int, const unsigned short int,
+                    const unsigned short int, const unsigned short int);
+                                                // smooth one randoms sinogram
+    void smoothSinogram(float * const, const unsigned short int,
+                        const unsigned short int);
    public:
                                                            // initialize object
     RandomsSmoothing(const std::vector <unsigned short int>,
@@ -120,6 +130,11 @@ class RandomsSmoothing
     ~RandomsSmoothing();                                      // destroy object
                                                      // smooth randoms sinogram
     void smooth(float * const, const unsigned short int,
+                const unsigned short int, const unsigned short int,
+                const unsigned short int, const unsigned short int,
+                const unsigned short int, const unsigned short int);
+                                   // smooth randoms sinograms of many frames
+    void smooth(const std::vector <float *>, const unsigned short int,
                 const unsigned short int, const unsigned short int,
                 const unsigned short int, const unsigned short int,
                 const unsigned short int, const unsigned short int);
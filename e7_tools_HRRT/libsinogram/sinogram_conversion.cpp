@@ -452,9 +452,10 @@ void SinogramConversion::calculateTrues(const bool randoms_smoothing,
            rs=NULL;
            if (tof_bins > 1)
             { Logging::flog()->logMsg("scale randoms sinogram by #1",
-                                      loglevel+1)->arg(axis)->
+                                      loglevel+1)->
                arg(1.0f/(float)tof_bins);
-              vecMulScalar(rp, 1.0f/(float)tof_bins, rp, size());
+              vecMulScalar(rnd_buffer, 1.0f/(float)tof_bins, rnd_buffer,
+                           size());
             }
            for (unsigned short int s=0; s < numberOfSinograms()-1; s++)
             { rp=rnd_buffer;
@@ -14,6 +14,9 @@
     \date 2004/09/27 write correct number of beds into Interfile main header
     \date 2004/11/05 added "sumCounts" method
     \date 2009/09/26 add scatter fraction in flat sinogram header
+    \date 2026/10/19 load ECAT7 and Interfile sinograms lazily
+    \date 2026/10/19 load integer sinograms in sparse format
+    \date 2026/10/19 keep deadtime data of component norms for normDeadtimeChange
 
     This class handles a PET sinogram data structure and provides methods to
     load and save these datasets from and to files. Sinograms can consist of
@@ -37,10 +40,12 @@
 #include "exception.h"
 #include "gm.h"
 #include "logging.h"
+#include "hrrt_common/sparse_sino.hpp"
 #include "mem_ctrl.h"
 #include "norm_ecat.h"
 #include "raw_io.h"
 #include "str_tmpl.h"
+#include "swap_tmpl.h"
 #include "vecmath.h"
 
 /*- constants ---------------------------------------------------------------*/
@@ -875,6 +880,13 @@ void SinogramIO::loadComponentNorm(const std::vector <float> singles,
                              (float *)&paralyzing_ring_DT_param[0],
                              (float *)&non_paralyzing_ring_DT_param[0],
                              singles, 0, NULL);
+    setNormDeadtime(singles, (float *)&paralyzing_ring_DT_param[0],
+                    (float *)&non_paralyzing_ring_DT_param[0],
+                    GM::gm()->transaxialCrystalsPerBlock() +
+                    GM::gm()->transaxialBlockGaps(),
+                    GM::gm()->transaxialBlocksPerBucket(),
+                    GM::gm()->axialCrystalsPerBlock() +
+                    GM::gm()->axialBlockGaps());
     norm_idx = norm_ecat->calcNorm(loglevel + 1);
     delete norm_ecat;
     norm_ecat = NULL;
@@ -1075,6 +1087,54 @@ void SinogramIO::loadECAT7(const std::string name,
   for (unsigned short int s = mnr; s < mnr + ds; s++)
   { if (ds == 9)
       Logging::flog()->logMsg("load TOF frame #1", loglevel)->arg(s - mnr + 1);
+    if (MemCtrl::mc()->lazyLoading())
+    { signed short int storage_order;
+      float factor;
+      MemCtrl::tdatatype file_dt;
+      bool lazy = true;
+
+      if (e7->Main_file_type() == E7_FILE_TYPE_AttenuationCorrection)
+      { storage_order = e7->Attn_storage_order(s);
+        factor = e7->Attn_scale_factor(s);
+      }
+      else {
+        storage_order = e7->Scan3D_storage_order(s);
+        factor = e7->Scan3D_scale_factor(s);
+      }
+      switch (e7->Matrix(s)->DataTypeOrig())
+      {
+      case E7_DATA_TYPE_SunShort:
+        file_dt = MemCtrl::DT_SINT;
+        break;
+      case E7_DATA_TYPE_IeeeFloat:
+        file_dt = MemCtrl::DT_FLT;
+        break;
+      default:
+        lazy = false;
+        break;
+      }
+      // sinograms in view mode need to be reordered and are loaded completely
+      if (lazy && (storage_order == E7_STORAGE_ORDER_RTZD))
+      { MemCtrl::tdatatype dt;
+        uint64 offset;
+
+        // scaled data is converted to float when the axis is loaded
+        if (factor == 1.0f) dt = file_dt;
+        else dt = MemCtrl::DT_FLT;
+        offset = e7->DataOffset(s);
+        deleteData(s - mnr);
+        resizeIndexVec(s - mnr, axes());
+        for (axis = 0; axis < axes(); axis++)
+        { MemCtrl::mc()->createFromFile(axis_size[axis], dt, filename, offset,
+                                        file_dt, !BigEndianMachine(), factor,
+                                        &data[s - mnr][axis], name, loglevel);
+          if (file_dt == MemCtrl::DT_SINT)
+            offset += (uint64)axis_size[axis] * sizeof(signed short int);
+          else offset += (uint64)axis_size[axis] * sizeof(float);
+        }
+        continue;
+      }
+    }
     e7->LoadData(s);
     // convert from view mode to volume mode ?
     switch (e7->Main_file_type())
@@ -1207,6 +1267,10 @@ void SinogramIO::loadECAT7Norm(const unsigned short int _RhoSamples,
                              nsh->IntfCorrPtr(), nsh->CrystalEffPtr(),
                              &ring_dtcor1[0], &ring_dtcor2[0], singles, 0,
                              NULL);
+    setNormDeadtime(singles, &ring_dtcor1[0], &ring_dtcor2[0],
+                    GM::gm()->transaxialCrystalsPerBlock(),
+                    GM::gm()->transaxialBlocksPerBucket(),
+                    GM::gm()->axialCrystalsPerBlock());
     norm_idx = norm_ecat->calcNorm(loglevel + 1);
     delete norm_ecat;
     norm_ecat = NULL;
@@ -1475,6 +1539,36 @@ void SinogramIO::loadInterfile(const std::string name,
     }
     Logging::flog()->logMsg("load data file #1", loglevel)->
     arg(inf->Sub_name_of_data_file());
+    // sparse files can't be read lazily from file offsets
+    if ((inf->Sub_number_format() == KV::SIGNED_INT_NF) &&
+        sparse_sino::is_sparse(inf->Sub_name_of_data_file().c_str()))
+    { loadSparse(inf->Sub_name_of_data_file(), ds, name, loglevel);
+      return;
+    }
+    if (MemCtrl::mc()->lazyLoading())
+    { MemCtrl::tdatatype dt;
+      uint64 offset = 0;
+      // register axes as memory blocks that are read from the data file when
+      // they are used the first time
+      if (inf->Sub_number_format() == KV::SIGNED_INT_NF)
+        dt = MemCtrl::DT_SINT;
+      else dt = MemCtrl::DT_FLT;
+      for (unsigned short int s = mnr; s < mnr + ds; s++)
+      { resizeIndexVec(s - mnr, axes());
+        for (axis = 0; axis < axes(); axis++)
+        { MemCtrl::mc()->createFromFile(axis_size[axis], dt,
+                                        inf->Sub_name_of_data_file(), offset,
+                                        dt,
+                                        inf->Sub_image_data_byte_order() ==
+                                        KV::BIG_END, 1.0f,
+                                        &data[s - mnr][axis], name, loglevel);
+          if (dt == MemCtrl::DT_SINT)
+            offset += (uint64)axis_size[axis] * sizeof(signed short int);
+          else offset += (uint64)axis_size[axis] * sizeof(float);
+        }
+      }
+      return;
+    }
     // load dataset and transfer to memory controller
     switch (inf->Sub_number_format())
     {
@@ -1692,6 +1786,13 @@ void SinogramIO::loadInterfileNorm(const std::vector <float> singles,
                              (float *)&paralyzing_ring_DT_param[0],
                              (float *)&non_paralyzing_ring_DT_param[0],
                              singles, 0, NULL);
+    setNormDeadtime(singles, (float *)&paralyzing_ring_DT_param[0],
+                    (float *)&non_paralyzing_ring_DT_param[0],
+                    GM::gm()->transaxialCrystalsPerBlock() +
+                    GM::gm()->transaxialBlockGaps(),
+                    GM::gm()->transaxialBlocksPerBucket(),
+                    GM::gm()->axialCrystalsPerBlock() +
+                    GM::gm()->axialBlockGaps());
     norm_idx = norm_ecat->calcNorm(loglevel + 1);
     delete norm_ecat;
     norm_ecat = NULL;
@@ -1853,6 +1954,8 @@ void SinogramIO::loadNorm(const std::string _filename,
   mnr = 0;
   deleteData();
   ecf = _ecf;
+  norm_deadtime.dtcor1.clear();
+  norm_deadtime.dtcor2.clear();
   Logging::flog()->logMsg("load norm '#1'", loglevel)->arg(filename);
   if (isECAT7file(filename))
     loadECAT7Norm(_RhoSamples, _ThetaSamples, _axis_slices, singles, loglevel);
@@ -1876,6 +1979,64 @@ void SinogramIO::loadNorm(const std::string _filename,
   logGeometry(loglevel + 1);
 }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Store the deadtime data of a component norm.
+    \param[in] singles                         singles from emission scan
+    \param[in] dtcor1                          deadtime parameters of rings
+    \param[in] dtcor2                          deadtime parameters of rings
+    \param[in] transaxial_crystals_per_block   number of crystals per block in
+                                               transaxial direction
+    \param[in] transaxial_blocks_per_bucket    number of blocks per bucket in
+                                               transaxial direction
+    \param[in] axial_crystals_per_block        number of crystals per block in
+                                               axial direction
+
+    Store the deadtime data a component norm was expanded with, to compare
+    the singles of other frames (see normDeadtimeChange()).
+ */
+/*---------------------------------------------------------------------------*/
+void SinogramIO::setNormDeadtime(const std::vector <float> singles,
+                                 float * const dtcor1, float * const dtcor2,
+                                 const unsigned short int
+                                                 transaxial_crystals_per_block,
+                                 const unsigned short int
+                                                  transaxial_blocks_per_bucket,
+                                 const unsigned short int
+                                                      axial_crystals_per_block)
+{ norm_deadtime.singles = singles;
+  norm_deadtime.rings = (axis_slices[0] + 1) / 2;
+  norm_deadtime.dtcor1.assign(dtcor1, dtcor1 + norm_deadtime.rings);
+  norm_deadtime.dtcor2.assign(dtcor2, dtcor2 + norm_deadtime.rings);
+  norm_deadtime.buckets_per_ring = GM::gm()->crystalsPerRing() /
+                                   (transaxial_crystals_per_block *
+                                    transaxial_blocks_per_bucket);
+  norm_deadtime.axial_crystals_per_block = axial_crystals_per_block;
+  norm_deadtime.transaxial_blocks_per_bucket = transaxial_blocks_per_bucket;
+}
+
+/*---------------------------------------------------------------------------*/
+/*! \brief Change of the deadtime correction of the norm for other singles.
+    \param[in] singles   singles of another scan
+    \return largest relative change of a crystal deadtime factor
+
+    Largest relative change of the deadtime factor of a crystal if the norm
+    were expanded with the given singles instead of the singles it was
+    expanded with. The normalization changes by at most about twice this
+    value. Norms that don't depend on the singles (flat 3d norms, P39
+    patient norms) return 0.
+ */
+/*---------------------------------------------------------------------------*/
+float SinogramIO::normDeadtimeChange(const std::vector <float> singles) const
+{ if (norm_deadtime.dtcor1.empty()) return (0.0f);
+  return (NormECAT::deadtimeChange(norm_deadtime.singles, singles,
+                                   (float *)&norm_deadtime.dtcor1[0],
+                                   (float *)&norm_deadtime.dtcor2[0],
+                                   norm_deadtime.rings,
+                                   norm_deadtime.buckets_per_ring,
+                                   norm_deadtime.axial_crystals_per_block,
+                                   norm_deadtime.transaxial_blocks_per_bucket));
+}
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Load a sinogram from a flat file.
     \param[in] _prompts_and_randoms   does sinogram contain prompts and
@@ -1916,6 +2077,10 @@ void SinogramIO::loadRAW(const bool _prompts_and_randoms,
     else ds = tof_bins;
     fsize = (unsigned long int)axes_slices * planesize *
             (unsigned long int)ds * sizeof(float);
+    if (sparse_sino::is_sparse(filename.c_str()))
+    { loadSparse(filename, ds, name, loglevel);
+      return;
+    }
     // get size of file
     riof = new RawIO <float>(filename, false, false);
     real_size = riof->size();
@@ -1964,6 +2129,54 @@ void SinogramIO::loadRAW(const bool _prompts_and_randoms,
   }
 }
 
+/*---------------------------------------------------------------------------*/
+/*! \brief Load a sinogram from a file in sparse format.
+    \param[in] data_filename   name of data file
+    \param[in] ds              number of datasets in file
+    \param[in] name            prefix for swap filenames
+    \param[in] loglevel        level for logging
+
+    Load integer sinogram data that lmhistogram_mp stored in the sparse
+    format of hrrt_common/sparse_sino.hpp. The axes are decoded into signed
+    short integer blocks of the memory controller.
+ */
+/*---------------------------------------------------------------------------*/
+void SinogramIO::loadSparse(const std::string data_filename,
+                            const unsigned short int ds,
+                            const std::string name,
+                            const unsigned short int loglevel)
+{ FILE *fp;
+
+  if ((fp = fopen(data_filename.c_str(), "rb")) == NULL)
+    throw Exception(REC_FILE_DOESNT_EXIST,
+                    "The file '#1' doesn't exist.").arg(data_filename);
+  Logging::flog()->logMsg("sparse sinogram", loglevel);
+  try
+  { uint64 offset = 0;
+
+    for (unsigned short int s = 0; s < ds; s++)
+    { resizeIndexVec(s, axes());
+      for (unsigned short int axis = 0; axis < axes(); axis++)
+      { if (sparse_sino::read_bins(fp, offset, axis_size[axis],
+                                   MemCtrl::mc()->createSInt(axis_size[axis],
+                                                             &data[s][axis],
+                                                             name,
+                                                             loglevel)) != 0)
+          throw Exception(REC_FILE_READ,
+                          "The file '#1' doesn't contain enough data.").
+            arg(data_filename);
+        MemCtrl::mc()->put(data[s][axis]);
+        offset += axis_size[axis];
+      }
+    }
+    fclose(fp);
+  }
+  catch (...)
+  { fclose(fp);
+    throw;
+  }
+}
+
 /*---------------------------------------------------------------------------*/
 /*! \brief Write information about sinogram to logging mechanism.
     \param[in] loglevel   level for logging
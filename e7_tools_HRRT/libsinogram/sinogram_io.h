@@ -11,6 +11,7 @@
     \date 2004/09/16 handle "applied corrections" not in Interfile header
     \date 2004/09/27 write correct number of beds into Interfile main header
     \date 2004/11/05 added "sumCounts" method
+    \date 2026/10/19 load integer sinograms in sparse format
  */
 
 # pragma once
@@ -50,6 +51,19 @@ private:
         tof_fwhm;                          /*!< FWHM of TOF gaussian in ns */
   std::vector <float> deadtime_factor,     /*!< deadtime correction factor */
       vsingles;           /*!< number of singles from scan */
+  /*! deadtime data of an expanded component norm */
+  typedef struct { std::vector <float> singles,  /*!< singles of expansion */
+                                     dtcor1,  /*!< deadtime parameters of rings */
+                                     dtcor2;
+                   unsigned short int rings,          /*!< number of rings */
+                                      /*! number of buckets per ring */
+                                      buckets_per_ring,
+                            /*! number of crystals per block in axial direction */
+                                      axial_crystals_per_block,
+                         /*! number of blocks per bucket in transaxial direction */
+                                      transaxial_blocks_per_bucket;
+                 } tnorm_deadtime;
+  tnorm_deadtime norm_deadtime;     /*!< deadtime data of component norm */
   bool feet_first,                         /*!< was scan done feet first ? */
        bed_moves_in;           /*!< did bed move into gantry during scan ? */
   SCANTYPE::tscantype scantype;                          /*!< type of scan */
@@ -74,8 +88,15 @@ private:
   void loadInterfileNorm(const std::vector <float>,                         const unsigned short int);
   // load P39 patient normalization sinogram from Interfile file
   void loadInterfileNormP39pat(const unsigned short int);
+  // store deadtime data of component norm
+  void setNormDeadtime(const std::vector <float>, float * const, float * const,
+                       const unsigned short int, const unsigned short int,
+                       const unsigned short int);
   // load sinogram from flat file
   void loadRAW(const bool, const bool, const std::string,               const unsigned short int);
+  // load sinogram from file in sparse format
+  void loadSparse(const std::string, const unsigned short int,
+                  const std::string, const unsigned short int);
   // save sinogram in Interfile file
   void saveInterfile(const std::string, const unsigned short int,
                      const unsigned short int, const unsigned short int,
@@ -208,6 +229,8 @@ public:
                 const std::vector <float>, const bool,
                 const unsigned short int);
   unsigned short int mash() const;         // request mash factor of sinogram
+  // change of the deadtime correction of the norm for other singles
+  float normDeadtimeChange(const std::vector <float>) const;
   unsigned short int matrixBed() const;              // request number of bed
   unsigned short int matrixData() const;         // request number of dataset
   unsigned short int matrixFrame() const;          // request number of frame
@@ -34,6 +34,8 @@
 */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <strings.h>
 #include<limits.h>
 #include <math.h>
 #include <sys/types.h>
@@ -44,37 +46,21 @@
 #include <string>
 #include "my_spdlog.hpp"
 
+using std::map;
+using std::string;
+using std::make_pair;
+
 int sequence_number = 1;
 extern int verbose;
 
-static char *DICOM10MAGIC = "DICM";
+static const char *DICOM10MAGIC = "DICM";
 static int DICOM10OFFSET = 128;
 
-// static void swaw(short *from, short *to, int len) {
-//   for (int i = 0; i < len; i += 2) {
-//     to[i] = from[i + 1];
-//     to[i + 1] = from[i];
-//   }
-// }
-
+// DICOM files are little endian, like all supported hosts
 static void DICOM_data2host(void *buf, void *dest,
                             size_t size, size_t num_items)
 {
   memcpy(dest, buf, size * num_items);
-  return;
-  char *tmp = (char*)malloc(size * num_items);
-  switch (size)
-  {
-  case 2 :  /* short ==> swab */
-    _swab((char*)buf, tmp , num_items * 2);
-    memcpy((char*)dest, tmp, num_items * 2);
-    break;
-  case 4 :
-    _swab((char*)buf, tmp, num_items * 4);
-    hrrt_util::swaw((short*)tmp, (short*)dest, num_items * 2);
-    break;
-  }
-  free(tmp);
 }
 
 inline unsigned S2B2(const char *s)
@@ -233,7 +219,7 @@ int DICOM_open(const char *filename, unsigned char  *&buf, int &bufsize,
   if (!filename) return 0;
   if (strlen(filename) == 0) return 0;
   if (stat(filename, &st) == -1) {
-    LOG_ERROR(filename);
+    LOG_ERROR("{}: {}", filename, strerror(errno));
     return 0;
   }
   if (st.st_size == 0) {
@@ -242,27 +228,24 @@ int DICOM_open(const char *filename, unsigned char  *&buf, int &bufsize,
   }
   if (buf == NULL) {
     if ((buf = (unsigned char *)calloc(1, st.st_size)) == NULL) {
-      LOG_ERROR(filename);
+      LOG_ERROR("{}: {}", filename, strerror(errno));
       return 0;
     }
     bufsize = st.st_size;
   } else if (bufsize < st.st_size) {
     if ((buf = (unsigned char *)realloc(buf, st.st_size)) == NULL) {
-      LOG_ERROR(filename);
+      LOG_ERROR("{}: {}", filename, strerror(errno));
       return 0;
     }
     bufsize = st.st_size;
   }
   if ((fp = fopen(filename, "rb")) == NULL) {
-    LOG_ERROR(filename);
+    LOG_ERROR("{}: {}", filename, strerror(errno));
     return 0;
   }
-  if ((count = fread(buf, 1, st.st_size, fp)) != st.st_size) {
-    if (count < 0) LOG_ERROR(filename);
-    else
-      LOG_ERROR("Read fail : only {} of {}  bytes",
-                count, st.st_size);
-  }
+  if ((count = fread(buf, 1, st.st_size, fp)) != st.st_size)
+    LOG_ERROR("{}: read fail, only {} of {} bytes", filename, count,
+              st.st_size);
   fclose(fp);
   if (count != st.st_size) return 0;
   if (strncasecmp((char*)buf + DICOM10OFFSET, DICOM10MAGIC, strlen(DICOM10MAGIC))
@@ -278,7 +261,7 @@ void DICOM_dump(DICOMMap &dcm_map, const unsigned char *buf, const char *filenam
   FILE *fp = NULL;
   if (filename != NULL) {
     if ((fp = fopen(filename, "wt")) == NULL) {
-      LOG_ERROR(filename);
+      LOG_ERROR("{}: {}", filename, strerror(errno));
       return;
     }
   } else fp = stdout;
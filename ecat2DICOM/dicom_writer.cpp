@@ -0,0 +1,129 @@
+/*
+ * dicom_writer.cpp
+ *
+ * DICOM part 10 file template, see dicom_writer.hpp.
+ */
+
+#include "dicom_writer.hpp"
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <random>
+
+namespace {
+
+const size_t PREAMBLE_SIZE = 128;
+
+// VRs with a 2 byte reserved field and a 4 byte length
+bool long_vr(const char *t_vr) {
+  return !strcmp(t_vr, "OB") || !strcmp(t_vr, "OW") || !strcmp(t_vr, "OF") ||
+         !strcmp(t_vr, "SQ") || !strcmp(t_vr, "UT") || !strcmp(t_vr, "UN");
+}
+
+}  // namespace
+
+DICOMTemplate::DICOMTemplate() : buf_(PREAMBLE_SIZE, 0), pixel_bytes_(0) {
+  const char *magic = "DICM";
+  buf_.insert(buf_.end(), magic, magic + 4);
+  add_header(0x0002, 0x0000, "UL", 4);
+  meta_length_offset_ = buf_.size();
+  add_uint32(0);
+  // File meta information version
+  add_header(0x0002, 0x0001, "OB", 2);
+  buf_.push_back(0);
+  buf_.push_back(1);
+}
+
+void DICOMTemplate::add_uint16(unsigned t_value) {
+  buf_.push_back(t_value & 0xff);
+  buf_.push_back((t_value >> 8) & 0xff);
+}
+
+void DICOMTemplate::add_uint32(unsigned t_value) {
+  add_uint16(t_value & 0xffff);
+  add_uint16(t_value >> 16);
+}
+
+void DICOMTemplate::add_header(unsigned t_group, unsigned t_elem, const char *t_vr, size_t t_len) {
+  add_uint16(t_group);
+  add_uint16(t_elem);
+  buf_.push_back(t_vr[0]);
+  buf_.push_back(t_vr[1]);
+  if (long_vr(t_vr)) {
+    add_uint16(0);
+    add_uint32(t_len);
+  } else {
+    add_uint16(t_len);
+  }
+}
+
+void DICOMTemplate::add_string(unsigned t_group, unsigned t_elem, const char *t_vr, const std::string &t_value) {
+  Field field = reserve(t_group, t_elem, t_vr, t_value.size());
+  set(buf_.data(), field, t_value.c_str());
+}
+
+void DICOMTemplate::add_us(unsigned t_group, unsigned t_elem, unsigned short t_value) {
+  add_header(t_group, t_elem, "US", 2);
+  add_uint16(t_value);
+}
+
+DICOMTemplate::Field DICOMTemplate::reserve(unsigned t_group, unsigned t_elem, const char *t_vr, size_t t_width) {
+  Field field;
+  field.width = (t_width + 1) / 2 * 2;  // values have even length
+  field.pad = strcmp(t_vr, "UI") ? ' ' : '\0';
+  add_header(t_group, t_elem, t_vr, field.width);
+  field.offset = buf_.size();
+  buf_.resize(buf_.size() + field.width, field.pad);
+  return field;
+}
+
+DICOMTemplate::Field DICOMTemplate::reserve_us(unsigned t_group, unsigned t_elem) {
+  Field field;
+  add_us(t_group, t_elem, 0);
+  field.offset = buf_.size() - 2;
+  field.width = 2;
+  field.pad = 0;
+  return field;
+}
+
+void DICOMTemplate::end_meta() {
+  unsigned length = buf_.size() - meta_length_offset_ - 4;
+  for (int i = 0; i < 4; i++)
+    buf_[meta_length_offset_ + i] = (length >> (8 * i)) & 0xff;
+}
+
+DICOMTemplate::Field DICOMTemplate::add_pixel_data(size_t t_bytes) {
+  Field field;
+  field.width = (t_bytes + 1) / 2 * 2;
+  field.pad = 0;
+  add_header(0x7FE0, 0x0010, "OW", field.width);
+  field.offset = buf_.size();
+  pixel_bytes_ = field.width;
+  return field;
+}
+
+void DICOMTemplate::copy_to(unsigned char *t_dest) const {
+  memcpy(t_dest, buf_.data(), buf_.size());
+  memset(t_dest + buf_.size(), 0, pixel_bytes_);
+}
+
+void DICOMTemplate::set(unsigned char *t_buf, const Field &t_field, const char *t_value) {
+  size_t len = strlen(t_value);
+  if (len > t_field.width)
+    len = t_field.width;
+  memcpy(t_buf + t_field.offset, t_value, len);
+  memset(t_buf + t_field.offset + len, t_field.pad, t_field.width - len);
+}
+
+void DICOMTemplate::set_us(unsigned char *t_buf, const Field &t_field, unsigned short t_value) {
+  t_buf[t_field.offset] = t_value & 0xff;
+  t_buf[t_field.offset + 1] = (t_value >> 8) & 0xff;
+}
+
+std::string DICOM_uid_root() {
+  std::random_device rd;
+  unsigned long long id = ((unsigned long long)rd() << 32) ^ rd();
+  id ^= (unsigned long long)time(NULL) * 1000003ULL + (unsigned long long)getpid();
+  return "2.25." + std::to_string(id);
+}
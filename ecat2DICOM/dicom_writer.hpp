@@ -0,0 +1,64 @@
+/*
+ * dicom_writer.hpp
+ *
+ * Layout of the DICOM part 10 files (explicit VR little endian) of an image
+ * series.
+ *
+ * The elements shared by all slices of a series are encoded once.  Elements
+ * which change per frame or per slice are reserved with a fixed width, so
+ * that all slice files have the same layout: a writer copies the template
+ * into its own buffer once, then patches only the reserved fields and the
+ * pixel data of each slice before writing the buffer out.
+ *
+ * Elements must be added in ascending tag order, the meta information
+ * (group 0002) first and the pixel data last.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+class DICOMTemplate {
+public:
+  // Position of a reserved value in the file buffer
+  struct Field {
+    size_t offset;
+    size_t width;
+    char pad;      // '\0' for UI, ' ' for other string VRs
+  };
+
+  DICOMTemplate();  // preamble, "DICM" and the meta group length
+
+  void add_string(unsigned t_group, unsigned t_elem, const char *t_vr, const std::string &t_value);
+  void add_us(unsigned t_group, unsigned t_elem, unsigned short t_value);
+  // Reserves t_width characters (rounded up to even) for a string value
+  Field reserve(unsigned t_group, unsigned t_elem, const char *t_vr, size_t t_width);
+  Field reserve_us(unsigned t_group, unsigned t_elem);
+  // Closes the meta information group; call after the last 0002 element
+  void end_meta();
+  // Pixel data element (OW) of t_bytes bytes; must be the last element
+  Field add_pixel_data(size_t t_bytes);
+
+  // Size of a slice file
+  size_t size() const { return buf_.size() + pixel_bytes_; }
+  // Copies the template into t_dest, which must hold size() bytes
+  void copy_to(unsigned char *t_dest) const;
+
+  // Set a reserved value in a slice buffer
+  static void set(unsigned char *t_buf, const Field &t_field, const char *t_value);
+  static void set_us(unsigned char *t_buf, const Field &t_field, unsigned short t_value);
+
+private:
+  void add_header(unsigned t_group, unsigned t_elem, const char *t_vr, size_t t_len);
+  void add_uint16(unsigned t_value);
+  void add_uint32(unsigned t_value);
+
+  std::vector<unsigned char> buf_;
+  size_t meta_length_offset_;  // value of (0002,0000)
+  size_t pixel_bytes_;
+};
+
+// Unique identifier root "2.25.<random>" for the UIDs of one export
+std::string DICOM_uid_root();
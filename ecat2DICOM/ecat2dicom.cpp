@@ -32,27 +32,44 @@
    Modification History:
    27-JUN-2008: Add sming in the series decription
    22-JAN-2009: Use same series id for all slices
+   19-OCT-2026: Add -e: export any ECAT image file as a DICOM PET series,
+                frames are read ahead and slices written in parallel (-j)
 */
 
 #include "DICOM.h"
+#include "dicom_writer.hpp"
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <ctype.h>
+#include <errno.h>
+#include <arpa/inet.h>
 #include <ecatx/ecat_matrix.hpp>
+#include <ecatx/frame_stream.hpp>
 #include <sys/stat.h>
 
 #include <dirent.h>
 #include <unistd.h>
 #include <cstring>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 #include "my_spdlog.hpp"
 
 
 static void usage(const char *pgm) {
-  LOG_ERROR( "%s Build %s %s\n", pgm,  __DATE__, __TIME__);
-  LOG_ERROR(          "usage: %s -i matspec [-o|-u] DICOM_dir [-m DICOM_Transfer_dir]\n", pgm);
-  LOG_ERROR(          "\t-o convert an ECAT file in DICOM files in the specified directory.\n");
-  LOG_ERROR(          "\t   It is limited to ECAT files converted from DICOM using DICOM2ecat\n");
-  LOG_ERROR(          "\t-u Use an ECAT file to update DICOM files in the specified directory.\n");
-  LOG_ERROR(          "\t-m Move updated DICOM files in the specified directory.\n");
+  LOG_ERROR( "{} Build {} {}", pgm,  __DATE__, __TIME__);
+  LOG_ERROR(          "usage: {} -i matspec [-e|-o|-u] DICOM_dir [-m DICOM_Transfer_dir] [-j threads]", pgm);
+  LOG_ERROR(          "\t-e export an ECAT image file as a DICOM PET series in the specified directory.");
+  LOG_ERROR(          "\t-j number of threads writing slices with -e (default: number of processors)");
+  LOG_ERROR(          "\t-o convert an ECAT file in DICOM files in the specified directory.");
+  LOG_ERROR(          "\t   It is limited to ECAT files converted from DICOM using DICOM2ecat");
+  LOG_ERROR(          "\t-u Use an ECAT file to update DICOM files in the specified directory.");
+  LOG_ERROR(          "\t-m Move updated DICOM files in the specified directory.");
   exit(1);
 }
 #define Z_MAX 9e+10
@@ -79,14 +96,13 @@ typedef struct _Tslice {
   short bits_allocated;
 } Tslice;
 
-typedef map<int, Tslice> Tslices;
+typedef std::map<int, Tslice> Tslices;
 
 static int compress = 0;
 static int do_reverse = 0;
 static int fmri = 0;
 int verbose = 0;
 static int not_execute = 0;
-static ecat_matrix::MatrixData matrix;
 static int is_bigendian = 0;
 static DICOMMap dcm_map;
 static DICOMElem dcm_elem;
@@ -101,16 +117,22 @@ static int is_dir(const char *path)
 {
   struct stat st;
   if (stat(path, &st) < 0) {
-    LOG_ERROR(path);
+    LOG_ERROR("{}: {}", path, strerror(errno));
     return 0;
   }
-#ifdef unix
-  if (S_ISDIR(st.st_mode)) return 0;
-  return 1;
-#else
-  if (st.st_mode & _S_IFDIR) return 1;
-  return 0;
-#endif
+  return S_ISDIR(st.st_mode) ? 1 : 0;
+}
+
+// Splits path into directory (with trailing '/'), file name and extension (with '.')
+static void split_path(const char *path, std::string &dir, std::string &name, std::string &ext)
+{
+  std::string p(path);
+  size_t slash = p.find_last_of('/');
+  dir = (slash == std::string::npos) ? "" : p.substr(0, slash + 1);
+  name = (slash == std::string::npos) ? p : p.substr(slash + 1);
+  size_t dot = name.find_last_of('.');
+  ext = (dot == std::string::npos) ? "" : name.substr(dot);
+  if (dot != std::string::npos) name.erase(dot);
 }
 
 static void DICOM_blank(char *data)
@@ -125,12 +147,12 @@ static int get_string(int a, int b, char* data, unsigned data_len)
     unsigned len = (data_len - 1) > dcm_elem.len ? dcm_elem.len : (data_len - 1);
     memcpy(data, dcm_buf + dcm_elem.offset, data_len);
     if (len > 0) data[len] = '\0';
-    if (verbose) LOG_ERROR( "Element (%x,%x) %s\n", a, b, data);
+    if (verbose) LOG_ERROR( "Element ({:x},{:x}) {}", a, b, data);
     DICOM_blank(data);
-    if (verbose) LOG_ERROR( "Element (%x,%x) %s\n", a, b, data);
+    if (verbose) LOG_ERROR( "Element ({:x},{:x}) {}", a, b, data);
     return 1;
   }
-  if (verbose) LOG_ERROR( "Element (%x,%x) not found\n", a, b);
+  if (verbose) LOG_ERROR( "Element ({:x},{:x}) not found", a, b);
   return 0;
 }
 
@@ -141,30 +163,30 @@ static int set_string(int a, int b, const char* data, unsigned data_len)
     memset(dcm_buf + dcm_elem.offset, 0, dcm_elem.len);
     unsigned len = (data_len > dcm_elem.len) ? dcm_elem.len : data_len;
     if (len > 0) memcpy(dcm_buf + dcm_elem.offset, data, len);
-    if (verbose) LOG_ERROR( "Element (%x,%x) %s\n", a, b, data);
+    if (verbose) LOG_ERROR( "Element ({:x},{:x}) {}", a, b, data);
     return 1;
   }
-  if (verbose) LOG_ERROR( "Element (%x,%x) not found\n", a, b);
+  if (verbose) LOG_ERROR( "Element ({:x},{:x}) not found", a, b);
   return 0;
 }
 
 static int get_int32(int a, int b, int* value)
 {
   if (DICOM_get_elem(a, b, dcm_map, dcm_elem)) {
-    *value = *((int*)dcm_buf + dcm_elem.offset);
+    *value = *(int*)(dcm_buf + dcm_elem.offset);
     return 1;
   }
-  if (verbose) LOG_ERROR( "Element (%x,%x)not found\n", a, b);
+  if (verbose) LOG_ERROR( "Element ({:x},{:x})not found", a, b);
   return 0;
 }
 
 static int set_int32(int a, int b, int value)
 {
   if (DICOM_get_elem(a, b, dcm_map, dcm_elem)) {
-    *((int*)dcm_buf + dcm_elem.offset) = value;
+    *(int*)(dcm_buf + dcm_elem.offset) = value;
     return 1;
   }
-  if (verbose) LOG_ERROR( "Element (%x,%x)not found\n", a, b);
+  if (verbose) LOG_ERROR( "Element ({:x},{:x})not found", a, b);
   return 0;
 }
 
@@ -172,20 +194,20 @@ static int set_int32(int a, int b, int value)
 static int get_int16(int a, int b, short* value)
 {
   if (DICOM_get_elem(a, b, dcm_map, dcm_elem)) {
-    *value = *((short*)dcm_buf + dcm_elem.offset);
+    *value = *(short*)(dcm_buf + dcm_elem.offset);
     return 1;
   }
-  if (verbose) LOG_ERROR( "Element (%x,%x)not found\n", a, b);
+  if (verbose) LOG_ERROR( "Element ({:x},{:x})not found", a, b);
   return 0;
 }
 
 static int set_int16(int a, int b, short value)
 {
   if (DICOM_get_elem(a, b, dcm_map, dcm_elem)) {
-    *((short*)dcm_buf + dcm_elem.offset) = value;
+    *(short*)(dcm_buf + dcm_elem.offset) = value;
     return 1;
   }
-  if (verbose) LOG_ERROR( "Element (%x,%x)not found\n", a, b);
+  if (verbose) LOG_ERROR( "Element ({:x},{:x})not found", a, b);
   return 0;
 }
 
@@ -204,13 +226,13 @@ static int get_imagedata(Tslice* slice, void *data)
   image_size = pixel_bytes * slice->columns * slice->rows;
   if (DICOM_get_elem(0x7FE0, 0x0010, dcm_map, dcm_elem)) {
     if (dcm_elem.len < image_size) {
-      LOG_ERROR( "Truncated data\n");
+      LOG_ERROR( "Truncated data");
       return 0;
     }
     memcpy(data, dcm_buf + dcm_elem.offset, image_size);
     return dcm_elem.offset;
   }
-  if (verbose) LOG_ERROR( "Image element (0x7FE0,0x0010)not found\n");
+  if (verbose) LOG_ERROR( "Image element (0x7FE0,0x0010)not found");
   return 0;
 }
 
@@ -236,7 +258,7 @@ static int add_slice(const char * fname, int serie_id, Tslices &slices)
   {
     if (verbose)
       LOG_ERROR(
-              "%s Error:unsupported number of bits per pixel %d\n",
+              "{} Error:unsupported number of bits per pixel {}",
               fname, slice.bits_allocated);
     return 0;
   }
@@ -245,7 +267,7 @@ static int add_slice(const char * fname, int serie_id, Tslices &slices)
   {
     if (verbose)
       LOG_ERROR(
-              "%s Error:unsupported number of bits per pixel %d\n",
+              "{} Error:unsupported number of bits per pixel {}",
               fname, slice.bits_stored);
     return 0;
   }
@@ -268,7 +290,7 @@ static int add_slice(const char * fname, int serie_id, Tslices &slices)
   if (sscanf(str, "%g", &slice.thickness) != 1)
     if (verbose)
       LOG_ERROR(
-              "%s Warning:can't find slice thickness\n", fname);
+              "{} Warning:can't find slice thickness", fname);
   if (get_string(0x0020, 0x1041, str, sizeof(str)) &&
       sscanf(str, "%g", &slice.location) == 1)
   {
@@ -287,12 +309,12 @@ static int add_slice(const char * fname, int serie_id, Tslices &slices)
     {
       if (verbose)
         LOG_ERROR(
-                "%s Warning:can't find slice location (%s)\n", fname, str);
+                "{} Warning:can't find slice location ({})", fname, str);
     }
   }
   slice.sequence_id = sequence_number;
   strcpy(slice.fname, fname);
-  slices.insert(make_pair(slice.number, slice));
+  slices.insert(std::make_pair(slice.number, slice));
   return 1;
 }
 
@@ -300,21 +322,24 @@ static int split_dir(const char *path, int serie_id, Tslices &slices) {
   DIR *dir;
   char fname[256];
   struct dirent *item;
+  int num_slices = 0;
 
   if (!is_dir(path)) {
     return add_slice(path, serie_id, slices);
   }
   dir = opendir(path);
   if (dir == NULL) {
-    LOG_ERROR(path);
+    LOG_ERROR("{}: {}", path, strerror(errno));
     return 0;
   }
   while ( (item = readdir(dir)) != NULL) {
     sprintf(fname, "%s/%s", path, item->d_name);
     if (!is_dir(fname)) {
-      num_slices += add_slice(fname, serie_id);
+      num_slices += add_slice(fname, serie_id, slices);
     }
   }
+  closedir(dir);
+  return num_slices;
 }
 
 static const char *def_study_descr = "HRRT";
@@ -328,12 +353,7 @@ static int  update_dicom_slice(ecat_matrix::Main_header *mh, ecat_matrix::Image_
   char str[40];
   FILE *fp = NULL;
   int count = 0;
-  char drive[_MAX_DRIVE];
-  char dir[_MAX_DIR];
-  char fname[_MAX_FNAME];
-  char new_fname[_MAX_FNAME];
-  char new_full_path[_MAX_PATH];
-  char ext[_MAX_EXT];
+  std::string dir, fname, ext, new_fname, new_full_path;
   char series_id[8];
 
   time_t t = (time_t) mh->scan_start_time;
@@ -429,49 +449,43 @@ static int  update_dicom_slice(ecat_matrix::Main_header *mh, ecat_matrix::Image_
   y_location = -0.5f * imh->y_dimension * imh->y_pixel_size * 10.0f;
   z_location =  slice.number * imh->z_pixel_size * 10.0f;
   sprintf(str, "%g", z_location);
-  set_string(0x0020, 0x1041, str, sizeof(str));        /* slice location */
+  set_string(0x0020, 0x1041, str, strlen(str));        /* slice location */
   sprintf(str, "%g\\%g\\%g", x_location, y_location, z_location);
-  set_string(0x0020, 0x0032, str, sizeof(str));       /* image location */
+  set_string(0x0020, 0x0032, str, strlen(str));       /* image location */
 
-  _splitpath(slice.fname, drive, dir, fname, ext);
-  if (strstr(fname, "IM_00") == fname) {
-    sprintf(new_fname, "%s.%s.IMA", prefix, fname);
-  } else strcpy(new_fname, fname);
+  split_path(slice.fname, dir, fname, ext);
+  if (fname.find("IM_00") == 0) {
+    new_fname = std::string(prefix) + "." + fname + ".IMA";
+  } else new_fname = fname;
   if (transfer_dir != NULL)  {
-    sprintf(new_full_path, "%s\\%s%s", transfer_dir, new_fname, ext);
-    if ((fp = fopen(new_full_path, "wb")) == NULL) {
-      LOG_ERROR(new_full_path);
+    new_full_path = std::string(transfer_dir) + "/" + new_fname + ext;
+    if ((fp = fopen(new_full_path.c_str(), "wb")) == NULL) {
+      LOG_ERROR("{}: {}", new_full_path, strerror(errno));
       return 0;
     }
     count = fwrite(dcm_buf, 1, dcm_buf_size, fp);
-    if (count != dcm_buf_size) {
-      if (count < 0) 
-        LOG_ERROR(new_full_path);
-      else 
-        LOG_ERROR( "Write fail : only %d of %d  bytes\n",                     count, dcm_buf_size);
-    }
+    if (count != dcm_buf_size)
+      LOG_ERROR("{}: write fail, only {} of {} bytes", new_full_path, count,
+                dcm_buf_size);
     fclose(fp);
     unlink(slice.fname);
-    strncpy(slice.fname, new_full_path, sizeof(slice.fname) - 1);
+    strncpy(slice.fname, new_full_path.c_str(), sizeof(slice.fname) - 1);
   }  else  {
     if ((fp = fopen(slice.fname, "wb")) == NULL) {
-      LOG_ERROR(slice.fname);
+      LOG_ERROR("{}: {}", slice.fname, strerror(errno));
       return 0;
     }
     count = fwrite(dcm_buf, 1, dcm_buf_size, fp);
-    if (count != dcm_buf_size) {
-      if (count < 0) LOG_ERROR(slice.fname);
-      else LOG_ERROR( "Write fail : only %d of %d  bytes\n",
-                     count, dcm_buf_size);
-    }
+    if (count != dcm_buf_size)
+      LOG_ERROR("{}: write fail, only {} of {} bytes", slice.fname, count,
+                dcm_buf_size);
     fclose(fp);
 
     // Rename file name to create unique file names if necessary
-    if (strstr(fname, "IM_00") == fname) {
-      sprintf(new_fname, "%s.%s.IMA", prefix, fname);
-      _makepath(new_full_path, drive, dir, new_fname, ext);
-      rename(slice.fname, new_full_path);
-      strncpy(slice.fname, new_full_path, sizeof(slice.fname) - 1);
+    if (fname.find("IM_00") == 0) {
+      new_full_path = dir + new_fname + ext;
+      rename(slice.fname, new_full_path.c_str());
+      strncpy(slice.fname, new_full_path.c_str(), sizeof(slice.fname) - 1);
     }
   }
   return 1;
@@ -482,7 +496,8 @@ static int ecat2DICOM(ecat_matrix::MatrixData *matrix, char *out_dir, const char
   FILE *fp = NULL;
   ecat_matrix::Image_subheader *imh = NULL;
   int nblks, data_size, header_size;
-  void * header, buf = NULL;
+  unsigned char *header;
+  void *buf = NULL;
   unsigned char *p;
   unsigned short g = 0x7fe0, no = 0x0010;
   char image_id[80];
@@ -497,8 +512,8 @@ static int ecat2DICOM(ecat_matrix::MatrixData *matrix, char *out_dir, const char
   sprintf(image_id, "%d.%d", frame, plane);
   sprintf(fname, "%s/%s_%s", out_dir, prefix, image_id);
   LOG_INFO("image_id {}, fname {}", image_id, fname);
-  if ((fp = fopen(fname, W_MODE)) == NULL)  {
-    LOG_ERROR(fname);
+  if ((fp = fopen(fname, "wb")) == NULL)  {
+    LOG_ERROR("{}: {}", fname, strerror(errno));
     return 0;
   }
   data_size = matrix->xdim * matrix->ydim;
@@ -510,25 +525,25 @@ static int ecat2DICOM(ecat_matrix::MatrixData *matrix, char *out_dir, const char
     data_size *= 2;
     break;
   default :
-    LOG_EXIT("unsupported matrix type : {}", matrix->data_type);
+    LOG_EXIT("unsupported matrix type : {}", (int)matrix->data_type);
     break;
   }
 
   nblks = (data_size + 511) / 512;
-  header = matrix->data_ptr + nblks * 512;
+  header = (unsigned char *)matrix->data_ptr + nblks * 512;
   header_size = matrix->data_size - nblks * 512;
   p = (unsigned char *)(header + header_size - 1);
   for (; header_size > 0; header_size--, p--)
     if (*p == 0xff) 
       break;
   if (header_size == 0) 
-    LOG_EXIT("no DICOM header found\n");
+    LOG_EXIT("no DICOM header found");
   header_size--;
   fwrite(header, 1, header_size, fp);
   if (ntohs(1) == 1 && matrix->data_type != MatrixData::DataType::ByteData)  {
     buf = (void *)malloc(data_size);
     swab(matrix->data_ptr, buf, data_size);
-    fwrite(matrix->data_ptr, data_size, 1, fp);
+    fwrite(buf, data_size, 1, fp);
     free(buf);
   } else fwrite(matrix->data_ptr, data_size, 1, fp);
   fclose(fp);
@@ -565,7 +580,7 @@ static int updateDICOM(ecat_matrix::Main_header *mh, ecat_matrix::Image_subheade
     strcpy(series_descr, txt);
 
   for (i = slices.begin(); i != slices.end(); i++)
-    LOG_INFO("%s %d %g\n", i->second.fname, i->second.number, i->second.location);
+    LOG_INFO("{} {} {}", i->second.fname, i->second.number, i->second.location);
   if (slices.size() != imh->z_dimension)  {
     LOG_EXIT("ECAT slices {} and dicom files {} are different", imh->z_dimension, slices.size());
   }
@@ -576,15 +591,326 @@ static int updateDICOM(ecat_matrix::Main_header *mh, ecat_matrix::Image_subheade
   return (int)(slices.size());
 }
 
-void main(int argc, char **argv) {
+/*
+ * DICOM export (-e)
+ *
+ * The header template of the series is built once; per frame only the
+ * timing and the rescale slope change, per slice the UID, position and pixel
+ * data.  Each writer thread owns a preallocated slice file buffer and writes
+ * every n-th slice of the frame while the next frame is read ahead.
+ */
+
+#define PET_IMAGE_STORAGE "1.2.840.10008.5.1.4.1.1.128"
+#define EXPLICIT_VR_LITTLE_ENDIAN "1.2.840.10008.1.2.1"
+#define MAX_SHORT 32767
+
+typedef struct _TexportLayout {
+  DICOMTemplate tmpl;
+  std::string uid_root;
+  int num_slices;          /* planes per frame; >zdim for one plane per matrix */
+  // per frame
+  DICOMTemplate::Field acquisition_time, frame_duration, rescale_slope, frame_reference_time;
+  // per slice
+  DICOMTemplate::Field media_sop_uid, sop_uid, instance_number, image_position,
+        slice_location, image_index, pixel_data;
+} TexportLayout;
+
+typedef struct _TexportFrame {
+  const ecat_matrix::MatrixData *matrix;
+  int frame;
+  int first_plane;                   /* plane of the first matrix plane */
+  float inv_slope;                   /* float data: short = value*inv_slope */
+  char acquisition_time[8], frame_duration[16], rescale_slope[20], frame_reference_time[20];
+} TexportFrame;
+
+static std::string DICOM_date(time_t t, const char *format)
+{
+  char str[16] = "";
+  struct tm *tm = localtime(&t);
+  if (tm != NULL) strftime(str, sizeof(str), format, tm);
+  return str;
+}
+
+static std::string DICOM_ds(double value)
+{
+  char str[20];
+  sprintf(str, "%.8g", value);
+  return str;
+}
+
+// Calibration factor applied to the pixel values, 1 if uncalibrated
+static float export_calibration(const ecat_matrix::Main_header *mh)
+{
+  if (mh->calibration_units == ecat_matrix::CalibrationStatus::Uncalibrated ||
+      mh->calibration_factor <= 1.0f)
+    return 1.0f;
+  return mh->calibration_factor;
+}
+
+static void export_layout(TexportLayout &layout, const ecat_matrix::Main_header *mh,
+                          const ecat_matrix::MatrixData *matrix, int num_frames,
+                          const char *series_descr, unsigned series_id)
+{
+  DICOMTemplate &t = layout.tmpl;
+  const ecat_matrix::Image_subheader *imh = (const ecat_matrix::Image_subheader*)matrix->shptr;
+  std::string study_date = DICOM_date(mh->scan_start_time, "%Y%m%d");
+  std::string study_time = DICOM_date(mh->scan_start_time, "%H%M%S");
+  // slice UIDs are <root>.4.<7 digits>, see export_slices()
+  size_t sop_uid_len = layout.uid_root.size() + 10;
+
+  t.add_string(0x0002, 0x0002, "UI", PET_IMAGE_STORAGE);
+  layout.media_sop_uid = t.reserve(0x0002, 0x0003, "UI", sop_uid_len);
+  t.add_string(0x0002, 0x0010, "UI", EXPLICIT_VR_LITTLE_ENDIAN);
+  t.add_string(0x0002, 0x0012, "UI", layout.uid_root + ".0");
+  t.end_meta();
+
+  t.add_string(0x0008, 0x0008, "CS", "ORIGINAL\\PRIMARY");
+  t.add_string(0x0008, 0x0016, "UI", PET_IMAGE_STORAGE);
+  layout.sop_uid = t.reserve(0x0008, 0x0018, "UI", sop_uid_len);
+  t.add_string(0x0008, 0x0020, "DA", study_date);                   /* study date */
+  t.add_string(0x0008, 0x0021, "DA", study_date);                  /* series date */
+  t.add_string(0x0008, 0x0022, "DA", study_date);             /* acquisition date */
+  t.add_string(0x0008, 0x0030, "TM", study_time);                   /* study time */
+  t.add_string(0x0008, 0x0031, "TM", study_time);                  /* series time */
+  layout.acquisition_time = t.reserve(0x0008, 0x0032, "TM", 6);
+  t.add_string(0x0008, 0x0060, "CS", "PT");                     /* Modality PET */
+  t.add_string(0x0008, 0x0080, "LO", std::string(mh->facility_name, strnlen(mh->facility_name, sizeof(mh->facility_name))));
+  if (strlen(mh->study_description) > 0)
+    t.add_string(0x0008, 0x1030, "LO", std::string(mh->study_description, strnlen(mh->study_description, sizeof(mh->study_description))));
+  else t.add_string(0x0008, 0x1030, "LO", def_study_descr);
+  t.add_string(0x0008, 0x103E, "LO", std::string(series_descr).substr(0, 64));
+  t.add_string(0x0008, 0x1090, "LO", "HRRT");            /* Manufacturer Model Name */
+
+  t.add_string(0x0010, 0x0010, "PN", std::string(mh->patient_name, strnlen(mh->patient_name, sizeof(mh->patient_name))));
+  t.add_string(0x0010, 0x0020, "LO", std::string(mh->patient_id, strnlen(mh->patient_id, sizeof(mh->patient_id))));
+  t.add_string(0x0010, 0x0030, "DA", mh->patient_birth_date != 0 ? DICOM_date(mh->patient_birth_date, "%Y%m%d") : "");
+  t.add_string(0x0010, 0x0040, "CS", (mh->patient_sex[0] == 'M' || mh->patient_sex[0] == 'F') ? std::string(1, mh->patient_sex[0]) : "O");
+  if (mh->patient_weight > 0.0f)
+    t.add_string(0x0010, 0x1030, "DS", DICOM_ds(mh->patient_weight));
+
+  t.add_string(0x0018, 0x0050, "DS", DICOM_ds(matrix->z_size * 10.0f));  /* slice thickness */
+  layout.frame_duration = t.reserve(0x0018, 0x1242, "IS", 10);             /* in ms */
+
+  t.add_string(0x0020, 0x000D, "UI", layout.uid_root + ".1");          /* study UID */
+  t.add_string(0x0020, 0x000E, "UI", layout.uid_root + ".2");         /* series UID */
+  t.add_string(0x0020, 0x0011, "IS", std::to_string(series_id));
+  layout.instance_number = t.reserve(0x0020, 0x0013, "IS", 8);
+  layout.image_position = t.reserve(0x0020, 0x0032, "DS", 3 * 16 + 2);
+  t.add_string(0x0020, 0x0037, "DS", "1\\0\\0\\0\\1\\0");            /* orientation */
+  t.add_string(0x0020, 0x0052, "UI", layout.uid_root + ".3");   /* frame of reference */
+  layout.slice_location = t.reserve(0x0020, 0x1041, "DS", 16);
+
+  t.add_us(0x0028, 0x0002, 1);                                 /* samples per pixel */
+  t.add_string(0x0028, 0x0004, "CS", "MONOCHROME2");
+  t.add_us(0x0028, 0x0010, matrix->ydim);                                    /* rows */
+  t.add_us(0x0028, 0x0011, matrix->xdim);                                 /* columns */
+  t.add_string(0x0028, 0x0030, "DS", DICOM_ds(matrix->y_size * 10.0f) + "\\" + DICOM_ds(matrix->pixel_size * 10.0f));
+  t.add_us(0x0028, 0x0100, 16);                                   /* bits allocated */
+  t.add_us(0x0028, 0x0101, 16);                                      /* bits stored */
+  t.add_us(0x0028, 0x0102, 15);                                         /* high bit */
+  t.add_us(0x0028, 0x0103, 1);                                     /* signed short */
+  t.add_string(0x0028, 0x1052, "DS", "0");                    /* rescale intercept */
+  layout.rescale_slope = t.reserve(0x0028, 0x1053, "DS", 16);
+
+  t.add_us(0x0054, 0x0081, layout.num_slices);                  /* number of slices */
+  t.add_us(0x0054, 0x0101, num_frames);                     /* number of time slices */
+  t.add_string(0x0054, 0x1001, "CS", export_calibration(mh) != 1.0f ? "BQML" : "CNTS");
+  t.add_string(0x0054, 0x1102, "CS", (imh->processing_code & (int)ecat_matrix::ProcessingCode::DecayPrc) ? "START" : "NONE");
+  layout.frame_reference_time = t.reserve(0x0054, 0x1300, "DS", 16);      /* in ms */
+  layout.image_index = t.reserve_us(0x0054, 0x1330);
+
+  layout.pixel_data = t.add_pixel_data((size_t)matrix->xdim * matrix->ydim * sizeof(short));
+}
+
+/*
+ * Per frame values; the rescale slope is computed once per frame.
+ * returns 0 for unsupported data types
+ */
+static int export_frame(TexportFrame &f, const ecat_matrix::Main_header *mh,
+                        const ecat_matrix::MatrixData *matrix, const ecat_matrix::MatVal &mat)
+{
+  const ecat_matrix::Image_subheader *imh = (const ecat_matrix::Image_subheader*)matrix->shptr;
+  float slope = matrix->scale_factor * export_calibration(mh);
+  long nvoxels = (long)matrix->xdim * matrix->ydim * matrix->zdim;
+
+  f.matrix = matrix;
+  f.frame = mat.frame;
+  f.first_plane = std::max(0, mat.plane - 1);
+  f.inv_slope = 1.0f;
+  switch (matrix->data_type) {
+  case MatrixData::DataType::SunShort :
+  case MatrixData::DataType::VAX_Ix2 :
+  case MatrixData::DataType::ByteData :
+    break;                                       /* pixel values are copied */
+  case MatrixData::DataType::IeeeFloat : {
+    const float *fdata = (const float*)matrix->data_ptr;
+    float fmax = 0.0f;
+    for (long i = 0; i < nvoxels; i++)
+      fmax = std::max(fmax, fabsf(fdata[i]));
+    if (fmax > 0.0f) {
+      f.inv_slope = MAX_SHORT / fmax;
+      slope *= fmax / MAX_SHORT;
+    }
+    break;
+  }
+  default :
+    return 0;
+  }
+  sprintf(f.rescale_slope, "%.8g", slope);
+  sprintf(f.frame_duration, "%u", imh->frame_duration);
+  sprintf(f.frame_reference_time, "%u", imh->frame_start_time);
+  strcpy(f.acquisition_time, DICOM_date(mh->scan_start_time + imh->frame_start_time / 1000, "%H%M%S").c_str());
+  return 1;
+}
+
+// Single pass conversion of a plane to signed short
+static void slice_to_short(const TexportFrame &f, int plane, short *dest)
+{
+  const ecat_matrix::MatrixData *matrix = f.matrix;
+  long npixels = (long)matrix->xdim * matrix->ydim;
+  long offset = plane * npixels;
+
+  switch (matrix->data_type) {
+  case MatrixData::DataType::SunShort :
+  case MatrixData::DataType::VAX_Ix2 :
+    memcpy(dest, (const short*)matrix->data_ptr + offset, npixels * sizeof(short));
+    break;
+  case MatrixData::DataType::ByteData : {
+    const unsigned char *bdata = (const unsigned char*)matrix->data_ptr + offset;
+    for (long i = 0; i < npixels; i++) dest[i] = bdata[i];
+    break;
+  }
+  default : {                                                    /* IeeeFloat */
+    const float *fdata = (const float*)matrix->data_ptr + offset;
+    for (long i = 0; i < npixels; i++) dest[i] = (short)lrintf(fdata[i] * f.inv_slope);
+    break;
+  }
+  }
+}
+
+// Writes planes first, first+step, ... of a frame; returns the number of failures
+static int export_slices(const TexportLayout &layout, const TexportFrame &f, unsigned char *buf,
+                         const char *out_dir, const char *prefix, int first, int step)
+{
+  const ecat_matrix::MatrixData *matrix = f.matrix;
+  int errors = 0;
+  char fname[FILENAME_MAX], str[64];
+  std::string uid;
+  FILE *fp;
+
+  DICOMTemplate::set(buf, layout.acquisition_time, f.acquisition_time);
+  DICOMTemplate::set(buf, layout.frame_duration, f.frame_duration);
+  DICOMTemplate::set(buf, layout.rescale_slope, f.rescale_slope);
+  DICOMTemplate::set(buf, layout.frame_reference_time, f.frame_reference_time);
+  for (int plane = first; plane < matrix->zdim; plane += step) {
+    int slice = f.first_plane + plane;
+    int index = (f.frame - 1) * layout.num_slices + slice + 1;
+    float x_location = -0.5f * matrix->xdim * matrix->pixel_size * 10.0f;
+    float y_location = -0.5f * matrix->ydim * matrix->y_size * 10.0f;
+    float z_location =  slice * matrix->z_size * 10.0f;
+
+    // fixed length slice UID: frames and planes are below 1000
+    uid = layout.uid_root + ".4." + std::to_string(1000000 + f.frame * 1000 + slice + 1);
+    DICOMTemplate::set(buf, layout.media_sop_uid, uid.c_str());
+    DICOMTemplate::set(buf, layout.sop_uid, uid.c_str());
+    sprintf(str, "%d", index);
+    DICOMTemplate::set(buf, layout.instance_number, str);
+    sprintf(str, "%.8g\\%.8g\\%.8g", x_location, y_location, z_location);
+    DICOMTemplate::set(buf, layout.image_position, str);
+    sprintf(str, "%.8g", z_location);
+    DICOMTemplate::set(buf, layout.slice_location, str);
+    DICOMTemplate::set_us(buf, layout.image_index, index);
+    slice_to_short(f, plane, (short*)(buf + layout.pixel_data.offset));
+
+    sprintf(fname, "%s/%s_%d.%d.dcm", out_dir, prefix, f.frame, slice + 1);
+    if ((fp = fopen(fname, "wb")) == NULL)  {
+      LOG_ERROR("Error creating {}", fname);
+      errors++;
+      continue;
+    }
+    if (fwrite(buf, 1, layout.tmpl.size(), fp) != layout.tmpl.size()) {
+      LOG_ERROR("Error writing {}", fname);
+      errors++;
+    }
+    fclose(fp);
+  }
+  return errors;
+}
+
+static int exportDICOM(ecat_matrix::MatrixFile *mptr, const std::vector<int> &matnums,
+                       const char *out_dir, const char *prefix, unsigned series_id, int num_threads)
+{
+  ecat_matrix::Main_header *mh = mptr->mhptr;
+  ecat_matrix::MatrixData *matrix;
+  ecat_matrix::MatVal mat;
+  std::unique_ptr<TexportLayout> layout;
+  std::vector<std::vector<unsigned char> > buffers;
+  std::vector<int> frames;
+  int errors = 0;
+
+  if (ntohs(1) == 1)
+    LOG_EXIT("DICOM export is only supported on little endian hosts");
+  if (!is_dir(out_dir))
+    LOG_EXIT("First create {} directory", out_dir);
+  for (int matnum : matnums) {
+    mat_numdoc(matnum, &mat);
+    if (std::find(frames.begin(), frames.end(), mat.frame) == frames.end())
+      frames.push_back(mat.frame);
+    if (mat.frame >= 1000)
+      LOG_EXIT("Too many frames: {}", mat.frame);
+  }
+  if (num_threads <= 0) num_threads = ecat_matrix::frame_threads();
+
+  ecat_matrix::FrameStream stream(mptr, matnums);
+  while ((matrix = stream.next()) != NULL) {
+    TexportFrame f;
+    mat_numdoc(matrix->matnum, &mat);
+    LOG_INFO("exporting {},{},{},{},{}", mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
+    if (layout == NULL) {
+      layout.reset(new TexportLayout);
+      layout->num_slices = std::max((int)matrix->zdim, (int)mh->num_planes);
+      if (layout->num_slices >= 1000)
+        LOG_EXIT("Too many planes: {}", layout->num_slices);
+      layout->uid_root = DICOM_uid_root();
+      export_layout(*layout, mh, matrix, (int)frames.size(), prefix, series_id);
+      num_threads = std::max(1, std::min(num_threads, (int)matrix->zdim));
+      buffers.resize(num_threads);
+      for (std::vector<unsigned char> &buf : buffers) {
+        buf.resize(layout->tmpl.size());
+        layout->tmpl.copy_to(buf.data());
+      }
+    } else if (layout->pixel_data.width != (size_t)matrix->xdim * matrix->ydim * sizeof(short)) {
+      LOG_EXIT("{},{},{},{},{}: matrix size differs from first frame", mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
+    }
+    if (!export_frame(f, mh, matrix, mat))
+      LOG_EXIT("unsupported matrix type : {}", (int)matrix->data_type);
+
+    std::vector<std::thread> threads;
+    std::vector<int> thread_errors(num_threads, 0);
+    for (int t = 1; t < num_threads; t++)
+      threads.push_back(std::thread([&, t] {
+        thread_errors[t] = export_slices(*layout, f, buffers[t].data(), out_dir, prefix, t, num_threads);
+      }));
+    thread_errors[0] = export_slices(*layout, f, buffers[0].data(), out_dir, prefix, 0, num_threads);
+    for (std::thread &thread : threads)
+      thread.join();
+    for (int e : thread_errors)
+      errors += e;
+    free_matrix_data(matrix);
+  }
+  if (stream.error_matnum() != 0) {
+    mat_numdoc(stream.error_matnum(), &mat);
+    LOG_EXIT("{},{},{},{},{} not found", mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
+  }
+  return errors == 0;
+}
+
+int main(int argc, char **argv) {
   char in_fname[FILENAME_MAX];
-  char drive[_MAX_DRIVE];
-  char dir[_MAX_DIR];
-  char prefix[_MAX_FNAME];
-  char ext[_MAX_EXT];
-  int frame = -1, matnum = 0, c = 0;
-  vector<int> matnums;
-  char *in_spec = NULL, *out_dir = NULL, *update_dir = NULL;
+  std::string dir, prefix, ext;
+  int frame = -1, matnum = 0, c = 0, num_threads = 0;
+  std::vector<int> matnums;
+  char *in_spec = NULL, *out_dir = NULL, *update_dir = NULL, *export_dir = NULL;
   char *dest_dir = NULL;   // move dicom files to dest_dir
   time_t t;
   struct tm *tm;
@@ -593,7 +919,7 @@ void main(int argc, char **argv) {
 
   my_spdlog::init_logging(argv[0]);
 
-  while ((c = getopt (argc, argv, "i:o:u:m:v")) != EOF)
+  while ((c = getopt (argc, argv, "i:o:u:m:e:j:v")) != EOF)
   {
     switch (c)
     {
@@ -609,18 +935,24 @@ void main(int argc, char **argv) {
     case 'm' :
       dest_dir    = optarg;
       break;
+    case 'e' :
+      export_dir    = optarg;
+      break;
+    case 'j' :
+      num_threads = atoi(optarg);
+      break;
     case 'v' :
       verbose = 1;
     }
   }
-  if (in_spec == NULL || (out_dir == NULL && update_dir == NULL)) usage(argv[0]);
+  if (in_spec == NULL || (out_dir == NULL && update_dir == NULL && export_dir == NULL)) usage(argv[0]);
   matspec( in_spec, in_fname, &matnum);
     ecat_matrix::MatrixFile *mptr = matrix_open(in_fname, ecat_matrix::MatrixFileAccessMode::READ_ONLY, ecat_matrix::MatrixFileType_64::UNKNOWN_FTYPE);
   if (mptr == NULL)  {
     LOG_EXIT(in_fname);
   }
   MatrixData::DataSetType ftype = mptr->mhptr->file_type;
-  LOG_INFO("ftype is {}", ftype);
+  LOG_INFO("ftype is {}", (int)ftype);
   if (ftype != MatrixData::DataSetType::PetImage && ftype != MatrixData::DataSetType::PetVolume) {
     LOG_EXIT("{} : is not a MatrixData::DataSetType::PetImage file", in_fname);
   }
@@ -635,33 +967,43 @@ void main(int argc, char **argv) {
     }
   }
 
+  split_path(in_fname, dir, prefix, ext);
+  time(&t);
+  tm = localtime(&t);
+  // Try making series id unique in case of different reconstructions
+  // or filtering using time minutes and seconds
+  series_id = tm->tm_min * 60 + tm->tm_sec + 1; // make sure it is positive
+
+  if (export_dir != NULL) {
+    if (!exportDICOM(mptr, matnums, export_dir, prefix.c_str(), series_id, num_threads))
+      LOG_EXIT("{} has not been completely exported to {}", in_fname, export_dir);
+    matrix_close(mptr);
+    return 0;
+  }
+
   ecat_matrix::MatrixData *matrix;
   ecat_matrix::MatVal mat;
   for (unsigned i = 0; i < matnums.size(); i++) {
     mat_numdoc(matnums[i], &mat);
-    matrix = matrix_read(mptr, matnums[i], UnknownMatDataType);
+    matrix = matrix_read(mptr, matnums[i], MatrixData::DataType::UnknownMatDataType);
     if (matrix == NULL) {
       LOG_EXIT("{},{},{},{},{} not found", mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
     } else {
       LOG_INFO("processing {},{},{},{},{}", mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
     }
-    _splitpath(in_fname, drive, dir, prefix, ext);
-    time(&t);
-    tm = localtime(&t);
-    // Try making series id unique in case of different reconstructions
-    // or filtering using time minutes and seconds
-    series_id = tm->tm_sec * 60 + tm->tm_sec + 1; // make sure it is positive
     if (update_dir != NULL) {
       if (!updateDICOM(mptr->mhptr, (ecat_matrix::Image_subheader*)matrix->shptr, update_dir,
-                       dest_dir, prefix, series_id))
+                       dest_dir, prefix.c_str(), series_id))
         LOG_EXIT("{}, {}, {} has not been generated by {}", in_fname, mat.frame, mat.plane, argv[0]);
       // delete directory if files moved to dest dir
       if (dest_dir != NULL)
         unlink(update_dir);
     } else {
-      if (!ecat2DICOM(matrix, out_dir, prefix, mat.frame, mat.plane))
+      if (!ecat2DICOM(matrix, out_dir, prefix.c_str(), mat.frame, mat.plane))
         LOG_EXIT("{},{},{} has not been generated by {}", in_fname, mat.frame, mat.plane, argv[0]);
     }
+    free_matrix_data(matrix);
   }
   matrix_close(mptr);
+  return 0;
 }
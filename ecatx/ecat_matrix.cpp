@@ -35,6 +35,7 @@
 
 #include  "ecat_matrix.hpp"
 #include  "machine_indep.h"
+#include  "mat_dir_cache.hpp"
 
 #include    <string>
 #include    <malloc.h>
@@ -93,6 +94,8 @@ FILE *mat_open( char *fname, char *fmode) {
   matrix_errno = MatrixError::OK;
   ecat_matrix::matrix_errtxt.clear();
   mat_file_ptr = fopen(fname, fmode);
+  if (mat_file_ptr)
+    mat_dir_discard(mat_file_ptr);
   return (mat_file_ptr);
 
 }
@@ -100,7 +103,10 @@ FILE *mat_open( char *fname, char *fmode) {
 int mat_close(FILE *t_file_ptr) {
   matrix_errno = MatrixError::OK;
   ecat_matrix::matrix_errtxt.clear();
-  return fclose( t_file_ptr);
+  int status = mat_dir_release(t_file_ptr);
+  if (fclose(t_file_ptr) != 0)
+    status = ecat_matrix::ECATX_ERROR;
+  return status;
 }
 
 int mat_rblk(FILE *t_file_ptr,  int blkno, char *bufr, int nblks) {
@@ -147,40 +153,11 @@ int mat_numdoc( int matnum, MatVal *matval) {
   return 1;
 }
 
+// Directory is read once per file and indexed by matnum: see mat_dir_cache.hpp.
 int mat_lookup(FILE *t_file_ptr, Main_header *mhptr, int matnum, MatDir *entry) {
-
-  int blk, i;
-  int nfree, nxtblk, prvblk, nused, matnbr, strtblk, endblk, matstat;
-  int dirbufr[ MatBLKSIZE / 4];
-
   matrix_errno = MatrixError::OK;
   ecat_matrix::matrix_errtxt.clear();
-  blk = MatFirstDirBlk;
-  while (1) {
-    if ( read_matrix_data(t_file_ptr, blk, 1, (char*)dirbufr, SunLong) == ecat_matrix::ECATX_ERROR )
-      return ( ecat_matrix::ECATX_ERROR );
-    nfree  = dirbufr[0];
-    nxtblk = dirbufr[1];
-    prvblk = dirbufr[2];
-    nused  = dirbufr[3];
-    for (i = 4; i < MatBLKSIZE / 4; i += 4) {
-      matnbr  = dirbufr[i];
-      strtblk = dirbufr[i + 1];
-      endblk  = dirbufr[i + 2];
-      matstat = dirbufr[i + 3];
-      if (matnum == matnbr) {
-        entry->matnum  = matnbr;
-        entry->strtblk = strtblk;
-        entry->endblk  = endblk;
-        entry->matstat = matstat;
-        return (1);
-      }
-    }
-    blk = nxtblk;
-    if (blk == MatFirstDirBlk)
-      break;
-  }
-  return (0);
+  return mat_dir_lookup(t_file_ptr, matnum, entry);
 }
 
 int unmap_main_header( char *bufr, Main_header *header) {
@@ -502,34 +479,21 @@ int mat_read_image_subheader( FILE *t_file_ptr, Main_header *mhptr, int blknum,
 }
 
 struct matdir *mat_read_dir( FILE *t_file_ptr, Main_header *mhptr, char *selector) {
-  int i, n, blk, nxtblk, ndblks, bufr[128];
+  std::vector<MatDir> entries;
   struct matdir *dir;
 
   matrix_errno = MatrixError::OK;
   ecat_matrix::matrix_errtxt.clear();
-  blk = MatFirstDirBlk;
-  nxtblk = 0;
-  for (ndblks = 0; nxtblk != MatFirstDirBlk; ndblks++)  {
-    read_matrix_data(t_file_ptr, blk, 1, (char*)bufr, SunLong);
-    nxtblk = bufr[1];
-    blk = nxtblk;
-  }
+  if (mat_dir_entries(t_file_ptr, entries) == ecat_matrix::ECATX_ERROR)
+    return NULL;
   dir = (struct matdir*) malloc( sizeof(struct matdir));
   dir->nmats = 0;
-  dir->nmax = 31 * ndblks;
-  dir->entry = (MatDir *) malloc(31 * ndblks * sizeof(MatDir));
-  for (n = 0, nxtblk = 0, blk = MatFirstDirBlk; nxtblk != MatFirstDirBlk; blk = nxtblk) {
-    read_matrix_data(t_file_ptr, blk, 1, (char*)bufr, SunLong);
-
-    nxtblk = bufr[1];
-    for (i = 4; i < MatBLKSIZE / 4; n++)    {
-      dir->entry[n].matnum = bufr[i++];
-      dir->entry[n].strtblk = bufr[i++];
-      dir->entry[n].endblk = bufr[i++];
-      dir->entry[n].matstat = bufr[i++];
-      if (dir->entry[n].matnum != 0)
-        dir->nmats++;
-    }
+  dir->nmax = entries.size();
+  dir->entry = (MatDir *) malloc(entries.size() * sizeof(MatDir));
+  for (size_t n = 0; n < entries.size(); n++) {
+    dir->entry[n] = entries[n];
+    if (dir->entry[n].matnum != 0)
+      dir->nmats++;
   }
   return dir;
 }
@@ -582,71 +546,11 @@ FILE *mat_create( char *fname, Main_header *mhead) {
   return (mat_file_ptr);
 }
 
+// Directory blocks are updated in the cache and written through to the file by mat_dir_enter().
 int mat_enter(FILE *t_file_ptr, Main_header *mhptr, int matnum, int nblks) {
-  int             dirblk, dirbufr[128], i, nxtblk, busy, oldsize;
-  short           sw_version = mhptr->sw_version;
-
   matrix_errno = MatrixError::OK;
   ecat_matrix::matrix_errtxt.clear();
-  dirblk = MatFirstDirBlk;
-  if ( fseek(t_file_ptr, 0, 0) )
-    return ( ecat_matrix::ECATX_ERROR );
-  if (read_matrix_data(t_file_ptr, dirblk, 1, (char *) dirbufr, SunLong) == ecat_matrix::ECATX_ERROR)
-    return (ecat_matrix::ECATX_ERROR);
-  busy = 1;
-  while (busy) {
-    nxtblk = dirblk + 1;
-    for (i = 4; i < 128; i += 4) {
-      if (dirbufr[i] == 0) {
-        busy = 0;
-        break;
-      } else if (dirbufr[i] == matnum) {
-        oldsize = dirbufr[i + 2] - dirbufr[i + 1] + 1;
-        if (oldsize < nblks) {
-          dirbufr[i] = 0xFFFFFFFF;
-          write_matrix_data(t_file_ptr, dirblk, 1, (char*)dirbufr, SunLong);
-          nxtblk = dirbufr[i + 2] + 1;
-        } else {
-          nxtblk = dirbufr[i + 1];
-          dirbufr[0]++;
-          dirbufr[3]--;
-          busy = 0;
-          break;
-        }
-      } else {
-        nxtblk = dirbufr[i + 2] + 1;
-      }
-    }
-    if (!busy)
-      break;
-    if (dirbufr[1] != MatFirstDirBlk) {
-      dirblk = dirbufr[1];
-      if (read_matrix_data(t_file_ptr, dirblk, 1, (char *) dirbufr, SunLong) == ecat_matrix::ECATX_ERROR)
-        return (ecat_matrix::ECATX_ERROR);
-    } else {
-      dirbufr[1] = nxtblk;
-      if (write_matrix_data(t_file_ptr, dirblk, 1, (char *) dirbufr, SunLong) == ecat_matrix::ECATX_ERROR)
-        return (ecat_matrix::ECATX_ERROR);
-      dirbufr[0] = 31;
-      dirbufr[1] = MatFirstDirBlk;
-      dirbufr[2] = dirblk;
-      dirbufr[3] = 0;
-      dirblk = nxtblk;
-      for (i = 4; i < 128; i++)
-        dirbufr[i] = 0;
-    }
-  }
-  dirbufr[i] = matnum;
-  dirbufr[i + 1] = nxtblk;
-  dirbufr[i + 2] = nxtblk + nblks;
-  dirbufr[i + 3] = 1;
-  dirbufr[0]--;
-  dirbufr[3]++;
-  if (write_matrix_data(t_file_ptr, dirblk, 1, (char*)dirbufr, SunLong) == ecat_matrix::ECATX_ERROR)
-    return (ecat_matrix::ECATX_ERROR);
-  if ( fseek(t_file_ptr, 0, 0) ) 
-    return ( ecat_matrix::ECATX_ERROR );
-  return (nxtblk);
+  return mat_dir_enter(t_file_ptr, matnum, nblks);
 }
 
 int mat_write_data( FILE *t_file_ptr, int blk, int nbytes, char *data, int dtype) {
@@ -44,6 +44,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 
 #include "matrix_file.hpp"
 #include "matrix_data.hpp"
@@ -340,6 +341,7 @@ struct MatDirList {
   int nmats ;
   MatDirNode *first ;
   MatDirNode *last ;
+  std::unordered_map<int, MatDirNode *> *index ;  // matnum -> node, maintained by insert_mdir
 };
 
 struct MatDirBlk {
@@ -0,0 +1,166 @@
+/*
+ * frame_stream.cpp
+ *
+ * Read-ahead frame stream and threaded float conversion of image frames.
+ * See frame_stream.hpp.
+ */
+
+#include "frame_stream.hpp"
+
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace ecat_matrix {
+
+namespace {
+
+constexpr long MIN_BLOCK = 1 << 16;  // don't split volumes below 64K voxels per thread
+
+// t_dest[i] (+)= t_scale * t_src[i] for i in [first,last)
+template <bool ADD>
+void convert_short(const short *t_src, float t_scale, float *t_dest, long first, long last) {
+  long i = first;
+#ifdef __SSE2__
+  const __m128 scale = _mm_set1_ps(t_scale);
+  for (; i + 8 <= last; i += 8) {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(t_src + i));
+    // sign extend to 32 bits
+    __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+    __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+    lo = _mm_mul_ps(lo, scale);
+    hi = _mm_mul_ps(hi, scale);
+    if (ADD) {
+      lo = _mm_add_ps(lo, _mm_loadu_ps(t_dest + i));
+      hi = _mm_add_ps(hi, _mm_loadu_ps(t_dest + i + 4));
+    }
+    _mm_storeu_ps(t_dest + i, lo);
+    _mm_storeu_ps(t_dest + i + 4, hi);
+  }
+#endif
+  for (; i < last; i++) {
+    if (ADD) t_dest[i] += t_src[i] * t_scale;
+    else t_dest[i] = t_src[i] * t_scale;
+  }
+}
+
+template <bool ADD, typename T>
+void convert_scalar(const T *t_src, float t_scale, float *t_dest, long first, long last) {
+  for (long i = first; i < last; i++) {
+    if (ADD) t_dest[i] += t_src[i] * t_scale;
+    else t_dest[i] = t_src[i] * t_scale;
+  }
+}
+
+template <bool ADD>
+int convert(const MatrixData *t_matrix, float t_factor, float *t_dest, int t_threads) {
+  long nvoxels = (long)t_matrix->xdim * t_matrix->ydim * t_matrix->zdim;
+  float scale = t_matrix->scale_factor * t_factor;
+  const void *src = t_matrix->data_ptr;
+  void (*kernel)(const void *, float, float *, long, long) = NULL;
+
+  switch (t_matrix->data_type) {
+  case MatrixData::DataType::SunShort:
+  case MatrixData::DataType::VAX_Ix2:
+    kernel = [](const void *s, float f, float *d, long first, long last) {
+      convert_short<ADD>(static_cast<const short *>(s), f, d, first, last);
+    };
+    break;
+  case MatrixData::DataType::ByteData:
+    kernel = [](const void *s, float f, float *d, long first, long last) {
+      convert_scalar<ADD>(static_cast<const unsigned char *>(s), f, d, first, last);
+    };
+    break;
+  case MatrixData::DataType::IeeeFloat:
+    kernel = [](const void *s, float f, float *d, long first, long last) {
+      convert_scalar<ADD>(static_cast<const float *>(s), f, d, first, last);
+    };
+    break;
+  default:
+    return ECATX_ERROR;
+  }
+
+  if (t_threads <= 0) t_threads = frame_threads();
+  long nblocks = std::max(1L, std::min((long)t_threads, nvoxels / MIN_BLOCK));
+  // Blocks are multiples of 8 voxels so that only the last one has a scalar tail
+  long block = ((nvoxels + nblocks - 1) / nblocks + 7) / 8 * 8;
+  std::vector<std::thread> threads;
+  for (long b = 1; b < nblocks; b++) {
+    long first = std::min(nvoxels, b * block), last = std::min(nvoxels, (b + 1) * block);
+    threads.push_back(std::thread(kernel, src, scale, t_dest, first, last));
+  }
+  kernel(src, scale, t_dest, 0, std::min(nvoxels, block));
+  for (std::thread &thread : threads)
+    thread.join();
+  return 0;
+}
+
+}  // namespace
+
+int frame_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+int frame_to_float(const MatrixData *t_matrix, float t_factor, float *t_dest, int t_threads) {
+  return convert<false>(t_matrix, t_factor, t_dest, t_threads);
+}
+
+int frame_accumulate(const MatrixData *t_matrix, float t_factor, float *t_sum, int t_threads) {
+  return convert<true>(t_matrix, t_factor, t_sum, t_threads);
+}
+
+FrameStream::FrameStream(MatrixFile *t_mptr, const std::vector<int> &t_matnums,
+                         MatrixData::DataType t_type, int t_depth)
+  : mptr_(t_mptr), matnums_(t_matnums), type_(t_type), depth_(std::max(1, t_depth)),
+    read_(0), stop_(false), error_matnum_(0) {
+  thread_ = std::thread(&FrameStream::reader, this);
+}
+
+FrameStream::~FrameStream() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  thread_.join();
+  for (MatrixData *matrix : ready_)
+    free_matrix_data(matrix);
+}
+
+void FrameStream::reader() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (read_ < matnums_.size()) {
+    // Wait for room in the read-ahead queue
+    cond_.wait(lock, [this] { return stop_ || ready_.size() < depth_; });
+    if (stop_)
+      break;
+    int matnum = matnums_[read_];
+    lock.unlock();
+    MatrixData *matrix = matrix_read(mptr_, matnum, type_);
+    lock.lock();
+    if (matrix == NULL) {
+      error_matnum_ = matnum;
+      break;
+    }
+    ready_.push_back(matrix);
+    read_++;
+    cond_.notify_all();
+  }
+  stop_ = true;
+  cond_.notify_all();
+}
+
+MatrixData *FrameStream::next() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return !ready_.empty() || stop_; });
+  if (ready_.empty())
+    return NULL;
+  MatrixData *matrix = ready_.front();
+  ready_.pop_front();
+  cond_.notify_all();
+  return matrix;
+}
+
+}  // namespace ecat_matrix
@@ -0,0 +1,63 @@
+/*
+ * frame_stream.hpp
+ *
+ * Streaming access to the frames of a dynamic image file.
+ *
+ * FrameStream reads a list of matrices in a background thread and keeps up
+ * to `depth` frames ready, so that the consumer works on frame n while frame
+ * n+1 is read from disk.  The matrix file must not be used by other threads
+ * while a stream on it is open.
+ *
+ * frame_to_float() and frame_accumulate() convert short, byte or float image
+ * data to float with the matrix scale factor times a per-frame factor (decay
+ * correction, frame duration, ...).  The conversion uses SSE2 where
+ * available and splits the volume over threads.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ecat_matrix.hpp"
+
+namespace ecat_matrix {
+
+// t_dest[i] = t_factor * scale_factor * data[i].  0, or ECATX_ERROR for unsupported data types.
+int frame_to_float(const MatrixData *t_matrix, float t_factor, float *t_dest, int t_threads = 0);
+// t_sum[i] += t_factor * scale_factor * data[i].  0, or ECATX_ERROR for unsupported data types.
+int frame_accumulate(const MatrixData *t_matrix, float t_factor, float *t_sum, int t_threads = 0);
+// Number of threads used when t_threads is 0
+int frame_threads();
+
+class FrameStream {
+public:
+  FrameStream(MatrixFile *t_mptr, const std::vector<int> &t_matnums,
+              MatrixData::DataType t_type = MatrixData::DataType::UnknownMatDataType, int t_depth = 2);
+  ~FrameStream();  // stops the reader and frees frames not consumed
+  // Next matrix in list order, to be freed with free_matrix_data().
+  // NULL at the end of the list or after a read error.
+  MatrixData *next();
+  // Matnum of the matrix that could not be read, 0 if none.
+  int error_matnum() const { return error_matnum_; }
+
+private:
+  void reader();
+
+  MatrixFile *mptr_;
+  std::vector<int> matnums_;
+  MatrixData::DataType type_;
+  size_t depth_;
+  std::deque<MatrixData *> ready_;
+  size_t read_;       // matrices read so far
+  bool stop_;
+  int error_matnum_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread thread_;
+};
+
+}  // namespace ecat_matrix
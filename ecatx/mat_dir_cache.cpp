@@ -0,0 +1,255 @@
+/*
+ * mat_dir_cache.cpp
+ *
+ * Per-file cache of ECAT7 directory blocks with a matnum -> entry hash index.
+ * See mat_dir_cache.hpp.
+ */
+
+#include "mat_dir_cache.hpp"
+#include "machine_indep.hpp"
+
+#include <sys/stat.h>
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
+namespace ecat_matrix {
+
+namespace {
+
+constexpr int DIR_WORDS     = MatBLKSIZE / 4;  // 128 ints per directory block
+constexpr int DIR_FIRST     = 4;               // words 0-3 are the block header
+constexpr int MAX_DIR_BLOCKS = 1 << 16;        // guard against corrupt (non-circular) chains
+
+class MatDirCache {
+public:
+  struct Block {
+    int blknum;
+    bool dirty;
+    std::array<int, DIR_WORDS> words;
+  };
+
+  // Position of a directory entry: index into blocks_ and first word of the entry.
+  struct Slot {
+    int block;
+    int word;
+  };
+
+  dev_t st_dev = 0;
+  ino_t st_ino = 0;
+
+  int load(FILE *t_file_ptr) {
+    blocks_.clear();
+    index_.clear();
+    int blk = MatFirstDirBlk;
+    do {
+      Block block;
+      block.blknum = blk;
+      block.dirty = false;
+      if (read_matrix_data(t_file_ptr, blk, 1, (char *)block.words.data(), MatrixData::DataType::SunLong) == ECATX_ERROR)
+        return ECATX_ERROR;
+      blocks_.push_back(block);
+      blk = block.words[1];
+      if (blocks_.size() > MAX_DIR_BLOCKS || blk <= 0) {
+        matrix_errno = MatrixError::INVALID_DIRBLK;
+        return ECATX_ERROR;
+      }
+    } while (blk != MatFirstDirBlk);
+
+    tail_ = {static_cast<int>(blocks_.size()) - 1, DIR_WORDS};
+    bool found_tail = false;
+    for (int b = 0; b < static_cast<int>(blocks_.size()); b++) {
+      for (int i = DIR_FIRST; i < DIR_WORDS; i += 4) {
+        int matnum = blocks_[b].words[i];
+        if (matnum == 0) {
+          if (!found_tail) {
+            tail_ = {b, i};
+            found_tail = true;
+          }
+          continue;
+        }
+        // First occurrence wins, as in the original linear search.
+        index_.emplace(matnum, Slot{b, i});
+      }
+    }
+    return ECATX_OK;
+  }
+
+  int lookup(int matnum, MatDir *entry) const {
+    auto it = index_.find(matnum);
+    if (it == index_.end())
+      return 0;
+    const int *w = &blocks_[it->second.block].words[it->second.word];
+    entry->matnum  = w[0];
+    entry->strtblk = w[1];
+    entry->endblk  = w[2];
+    entry->matstat = w[3];
+    return 1;
+  }
+
+  // Mirrors the allocation rules of the original mat_enter(): an existing entry is
+  // reused if large enough, otherwise marked deleted; new entries are appended after
+  // the last used entry, chaining a new directory block when the last one is full.
+  int enter(int matnum, int nblks) {
+    auto it = index_.find(matnum);
+    if (it != index_.end()) {
+      Block &block = blocks_[it->second.block];
+      int *w = &block.words[it->second.word];
+      int oldsize = w[2] - w[1] + 1;
+      block.dirty = true;
+      if (oldsize >= nblks) {
+        int strtblk = w[1];
+        w[2] = strtblk + nblks;
+        w[3] = 1;
+        return strtblk;
+      }
+      w[0] = static_cast<int>(0xFFFFFFFF);
+      index_.erase(it);
+    }
+
+    if (tail_.word >= DIR_WORDS) {
+      // Last block full: new directory block goes right after the last matrix.
+      Block &last = blocks_[tail_.block];
+      int new_blknum = next_free_blk(tail_.block, DIR_WORDS);
+      last.words[1] = new_blknum;
+      last.dirty = true;
+      Block block;
+      block.blknum = new_blknum;
+      block.dirty = true;
+      block.words.fill(0);
+      block.words[0] = 31;
+      block.words[1] = MatFirstDirBlk;
+      block.words[2] = last.blknum;
+      block.words[3] = 0;
+      blocks_.push_back(block);
+      tail_ = {static_cast<int>(blocks_.size()) - 1, DIR_FIRST};
+    }
+
+    Block &block = blocks_[tail_.block];
+    int strtblk = next_free_blk(tail_.block, tail_.word);
+    int *w = &block.words[tail_.word];
+    w[0] = matnum;
+    w[1] = strtblk;
+    w[2] = strtblk + nblks;
+    w[3] = 1;
+    block.words[0]--;
+    block.words[3]++;
+    block.dirty = true;
+    index_.emplace(matnum, tail_);
+    tail_.word += 4;
+    return strtblk;
+  }
+
+  int flush(FILE *t_file_ptr) {
+    for (auto &block : blocks_) {
+      if (!block.dirty)
+        continue;
+      if (write_matrix_data(t_file_ptr, block.blknum, 1, (char *)block.words.data(), MatrixData::DataType::SunLong) == ECATX_ERROR)
+        return ECATX_ERROR;
+      block.dirty = false;
+    }
+    return ECATX_OK;
+  }
+
+  void entries(std::vector<MatDir> &dir) const {
+    dir.clear();
+    for (auto const &block : blocks_) {
+      for (int i = DIR_FIRST; i < DIR_WORDS; i += 4) {
+        const int *w = &block.words[i];
+        dir.push_back({w[0], w[1], w[2], w[3]});
+      }
+    }
+  }
+
+private:
+  std::vector<Block> blocks_;
+  std::unordered_map<int, Slot> index_;
+  // First empty slot of the directory; word == DIR_WORDS when the last block is full.
+  Slot tail_ = {0, DIR_FIRST};
+
+  // First data block after the entries preceding 'word' in block 'b'.
+  int next_free_blk(int b, int word) const {
+    if (word == DIR_FIRST)
+      return blocks_[b].blknum + 1;
+    return blocks_[b].words[word - 2] + 1;
+  }
+};
+
+std::mutex g_cache_mutex;
+std::unordered_map<FILE *, MatDirCache> g_caches;
+
+// Return the cache for this file, (re)building it if absent or stale.  Caller holds g_cache_mutex.
+MatDirCache *get_cache(FILE *t_file_ptr) {
+  struct stat st;
+  if (fstat(fileno(t_file_ptr), &st) != 0)
+    return NULL;
+  auto it = g_caches.find(t_file_ptr);
+  if (it != g_caches.end()) {
+    if (it->second.st_dev == st.st_dev && it->second.st_ino == st.st_ino)
+      return &it->second;
+    g_caches.erase(it);
+  }
+  MatDirCache cache;
+  if (cache.load(t_file_ptr) == ECATX_ERROR)
+    return NULL;
+  cache.st_dev = st.st_dev;
+  cache.st_ino = st.st_ino;
+  return &(g_caches[t_file_ptr] = std::move(cache));
+}
+
+}  // namespace
+
+int mat_dir_lookup(FILE *t_file_ptr, int matnum, MatDir *entry) {
+  std::lock_guard<std::mutex> lock(g_cache_mutex);
+  MatDirCache *cache = get_cache(t_file_ptr);
+  if (cache == NULL)
+    return ECATX_ERROR;
+  return cache->lookup(matnum, entry);
+}
+
+int mat_dir_enter(FILE *t_file_ptr, int matnum, int nblks) {
+  std::lock_guard<std::mutex> lock(g_cache_mutex);
+  MatDirCache *cache = get_cache(t_file_ptr);
+  if (cache == NULL)
+    return ECATX_ERROR;
+  int strtblk = cache->enter(matnum, nblks);
+  // Write through, as the original mat_enter(): the directory on disk never lags the cache
+  if (strtblk != ECATX_ERROR && cache->flush(t_file_ptr) == ECATX_ERROR)
+    return ECATX_ERROR;
+  return strtblk;
+}
+
+int mat_dir_entries(FILE *t_file_ptr, std::vector<MatDir> &entries) {
+  std::lock_guard<std::mutex> lock(g_cache_mutex);
+  MatDirCache *cache = get_cache(t_file_ptr);
+  if (cache == NULL)
+    return ECATX_ERROR;
+  cache->entries(entries);
+  return ECATX_OK;
+}
+
+int mat_dir_flush(FILE *t_file_ptr) {
+  std::lock_guard<std::mutex> lock(g_cache_mutex);
+  auto it = g_caches.find(t_file_ptr);
+  if (it == g_caches.end())
+    return ECATX_OK;
+  return it->second.flush(t_file_ptr);
+}
+
+int mat_dir_release(FILE *t_file_ptr) {
+  std::lock_guard<std::mutex> lock(g_cache_mutex);
+  auto it = g_caches.find(t_file_ptr);
+  if (it == g_caches.end())
+    return ECATX_OK;
+  int status = it->second.flush(t_file_ptr);
+  g_caches.erase(it);
+  return status;
+}
+
+void mat_dir_discard(FILE *t_file_ptr) {
+  std::lock_guard<std::mutex> lock(g_cache_mutex);
+  g_caches.erase(t_file_ptr);
+}
+
+}  // namespace ecat_matrix
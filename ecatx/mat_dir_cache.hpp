@@ -0,0 +1,42 @@
+/*
+ * mat_dir_cache.hpp
+ *
+ * In-memory index of an ECAT7 matrix directory, kept per open FILE*.
+ *
+ * The on-disk directory is a circular list of 512-byte blocks starting at
+ * MatFirstDirBlk.  mat_lookup() and mat_enter() used to walk that list from
+ * disk on every call, so reading or writing n matrices cost O(n^2) block
+ * reads.  The cache reads the chain once and answers lookups from a hash map.
+ * mat_dir_enter() writes the modified directory blocks (at most two) through
+ * to the file, so the directory on disk is as current as with the original
+ * mat_enter(), also if the file is closed with a direct fclose().
+ *
+ * The cache is revalidated against the file's device and inode, so a FILE*
+ * address reused after fclose() never sees a stale directory.
+ * All functions are thread safe.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "ecat_matrix.hpp"
+
+namespace ecat_matrix {
+
+// Same contract as mat_lookup(): 1 if found, 0 if not, ECATX_ERROR on read error.
+int mat_dir_lookup(FILE *t_file_ptr, int matnum, MatDir *entry);
+// Same contract as mat_enter(): first block of the matrix, or ECATX_ERROR.
+int mat_dir_enter(FILE *t_file_ptr, int matnum, int nblks);
+// All entries (including deleted ones, matnum == -1) in directory order.
+int mat_dir_entries(FILE *t_file_ptr, std::vector<MatDir> &entries);
+// Write modified directory blocks back to the file (a no-op after mat_dir_enter()).
+int mat_dir_flush(FILE *t_file_ptr);
+// Flush and forget the cache for this file.  Call before fclose().
+int mat_dir_release(FILE *t_file_ptr);
+// Forget the cache without writing it.  Call after fopen(), whose FILE* may reuse an old address.
+void mat_dir_discard(FILE *t_file_ptr);
+
+}  // namespace ecat_matrix
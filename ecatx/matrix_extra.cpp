@@ -40,6 +40,7 @@
 #include	"machine_indep.h"
 #include	"ecat_matrix.hpp"
 #include	"num_sort.h"
+#include	"mat_dir_cache.hpp"
 #include	<unistd.h>
 
 // ahc
@@ -95,6 +96,7 @@ static int matrix_freelist(ecat_matrix::MatDirList *matdirlist) {
         }
 	  while(next != NULL) ;
 	}
+  delete matdirlist->index;
   free(matdirlist) ;
   return ecat_matrix::ECATX_OK;
 }
@@ -106,8 +108,10 @@ static void free_matrix_file(ecat_matrix::MatrixFile *mptr) {
     free(mptr->mhptr) ;
   if (mptr->dirlist != NULL)
     matrix_freelist(mptr->dirlist) ;
-  if (mptr->fptr)
+  if (mptr->fptr) {
+    ecat_matrix::mat_dir_discard(mptr->fptr);
     fclose(mptr->fptr);
+  }
   if (mptr->fname)
     free(mptr->fname);
   free(mptr);
@@ -629,22 +633,17 @@ int matrix_find(ecat_matrix::MatrixFile *matfile, int matnum, ecat_matrix::MatDi
   set_matrix_no_error();
   if (matfile == NULL)
     return(ecat_matrix::ECATX_ERROR) ;
-  if (matfile->dirlist == NULL)
+  if (matfile->dirlist == NULL || matfile->dirlist->index == NULL)
     return(ecat_matrix::ECATX_ERROR) ;	
-  node = matfile->dirlist->first ;
-  while (node != NULL)	{
-      if (node->matnum == matnum)        {
-          matdir->matnum = node->matnum ;
-          matdir->strtblk = node->strtblk ;
-          matdir->endblk = node->endblk ;
-          matdir->matstat = node->matstat ;
-          break ;
-        }
-      node = node->next ;
-	}
-  if (node != NULL)
-    return(ecat_matrix::ECATX_OK) ;
-  else return(ecat_matrix::ECATX_ERROR) ;
+  auto it = matfile->dirlist->index->find(matnum);
+  if (it == matfile->dirlist->index->end())
+    return(ecat_matrix::ECATX_ERROR) ;
+  node = it->second;
+  matdir->matnum = node->matnum ;
+  matdir->strtblk = node->strtblk ;
+  matdir->endblk = node->endblk ;
+  matdir->matstat = node->matstat ;
+  return(ecat_matrix::ECATX_OK) ;
 }
 	
 
@@ -658,6 +657,7 @@ int insert_mdir(ecat_matrix::MatDir	*matdir, ecat_matrix::MatDirList	*dirlist) {
       dirlist->nmats = 0 ;
       dirlist->first = NULL ;
       dirlist->last = NULL ;
+      dirlist->index = NULL ;
 	}
     ecat_matrix::MatDirNode  *node = (ecat_matrix::MatDirNode *) malloc(sizeof(ecat_matrix::MatDirNode)) ;
   if (node == NULL)
@@ -669,6 +669,11 @@ int insert_mdir(ecat_matrix::MatDir	*matdir, ecat_matrix::MatDirList	*dirlist) {
   node->matstat = matdir->matstat;
   node->next = NULL ;
 
+  /* first entry for a matnum wins, as with the former linear search in matrix_find */
+  if (dirlist->index == NULL)
+    dirlist->index = new std::unordered_map<int, ecat_matrix::MatDirNode *>;
+  dirlist->index->emplace(node->matnum, node);
+
   if (dirlist->first == NULL)	{ /* if list was empty, add first node */
       dirlist->first = node ;
       dirlist->last = node ;
@@ -1041,34 +1046,21 @@ MatDirBlk *mat_rdirblk(ecat_matrix::MatrixFile *t_infile, int blknum) {
 ecat_matrix::MatDirList *
 mat_read_directory(ecat_matrix::MatrixFile *mptr)
 {
-  ecat_matrix::MatDir   matdir;
+  std::vector<ecat_matrix::MatDir> entries;
   ecat_matrix::MatDirList     *dirlist;
-  MatDirBlk      *matdirblk;
-  int             i, blknum;
 
   set_matrix_no_error();
+  /* the directory chain is read once into the per-file cache, which later
+     serves mat_lookup() and mat_enter() without touching the disk */
+  if (ecat_matrix::mat_dir_entries(mptr->fptr, entries) == ecat_matrix::ECATX_ERROR)
+    return (NULL);
   dirlist = (ecat_matrix::MatDirList *) calloc(1, sizeof(ecat_matrix::MatDirList));
   if (dirlist == NULL)
     return (NULL);
-
-  blknum = MatFirstDirBlk;
-  do {
-    matdirblk = mat_rdirblk(mptr, blknum);
-    if (matdirblk == NULL) {
-      free(dirlist);
-      return (NULL);
-    }
-    for (i = 0; i < matdirblk->nused; i++) {
-      matdir.matnum  = matdirblk->matdir[i].matnum;
-      matdir.strtblk = matdirblk->matdir[i].strtblk;
-      matdir.endblk  = matdirblk->matdir[i].endblk;
-      matdir.matstat = matdirblk->matdir[i].matstat;
+  for (auto &matdir : entries) {
+    if (matdir.matnum != 0)
       insert_mdir(&matdir, dirlist);
-    }
-    blknum = matdirblk->nextblk;
-    free(matdirblk);
   }
-  while (blknum != MatFirstDirBlk);
   return (dirlist);
 }
 
@@ -1117,6 +1109,7 @@ ecat_matrix::MatrixFile *matrix_open(const char* fname, ecat_matrix::MatrixFileA
     free_matrix_file(mptr);
     return (NULL);
   }
+  ecat_matrix::mat_dir_discard(mptr->fptr);
   mptr->fname = strdup(fname);
   if (mat_read_main_header(mptr->fptr, mptr->mhptr) == ecat_matrix::ECATX_ERROR) {
     // g_matrix_error = ecat_matrix::MatrixError::NOMHD_FILE_OBJECT ;
@@ -1228,8 +1221,11 @@ int matrix_close(ecat_matrix::MatrixFile *mptr) {
     free(mptr->mhptr) ;
   if (mptr->dirlist != NULL) 
     matrix_freelist(mptr->dirlist) ;
-  if (mptr->fptr) 
-    status = fclose(mptr->fptr);
+  if (mptr->fptr) {
+    status = ecat_matrix::mat_dir_release(mptr->fptr);
+    if (fclose(mptr->fptr) != 0)
+      status = ecat_matrix::ECATX_ERROR;
+  }
   if (mptr->fname) 
     free(mptr->fname);
   free(mptr);
@@ -14,10 +14,12 @@ static char sccsid[]="@(#)imagemath.c	1.1 4/26/91 Copyright 1990 CTI Pet Systems
  *       add bin as op2 operation to binarize image
  *
  * 27-Apr-2010: Added to HRRT Users software by sibomana@gmail.com
+ * 19-Oct-2026: Use ecatx frame_to_float for slice conversion
  */
    
 
 #include "ecat_matrix.hpp"
+#include "frame_stream.hpp"
 #include <math.h>
 #include <string.h>
 #include "my_spdlog.hpp"
@@ -125,28 +127,14 @@ main( argc, argv)
 	}
 	for (plane=0; plane< image1->zdim; plane++) {
 		slice1 = matrix_read_slice(file1,image1,plane,segment);
-		if (slice1->data_type==MatrixData::DataType::SunShort || slice1->data_type==MatrixData::DataType::VAX_Ix2) {
-			sdata = (short*)slice1->data_ptr;
-			for (i=0; i<npixels; i++)
-	  			imagea[i] = slice1->scale_factor*sdata[i];
-		} else {	/* assume byte data */
-			bdata = (unsigned char *)slice1->data_ptr;
-			for (i=0; i<npixels; i++)
-				imagea[i] = slice1->scale_factor*bdata[i];
-		}
+		if (ecat_matrix::frame_to_float(slice1, 1.0f, imagea, 1) != 0)
+			LOG_EXIT("{}: unsupported data type", argv[1]);
 		free_matrix_data(slice1);
 
 		if (file2) {
 			slice2 = matrix_read_slice(file2,image2,plane,segment);
-			if (slice2->data_type==MatrixData::DataType::SunShort || slice2->data_type==MatrixData::DataType::VAX_Ix2) {
-				sdata = (short*)slice2->data_ptr;
-				for (i=0; i<npixels; i++)
-	  				imageb[i] = slice2->scale_factor*sdata[i];
-			} else {    /* assume byte data */
-				bdata = (unsigned char *)slice2->data_ptr;
-				for (i=0; i<npixels; i++)
-					imageb[i] = slice2->scale_factor*bdata[i];
-			}
+			if (ecat_matrix::frame_to_float(slice2, 1.0f, imageb, 1) != 0)
+				LOG_EXIT("{}: unsupported data type", argv[2]);
 			free_matrix_data(slice2);
 		}
 
@@ -219,7 +207,8 @@ main( argc, argv)
 	  if (imagec[i]<minval) minval = imagec[i];
 	}
 
-	if (image1->data_type!=MatrixData::DataType::ByteData || image2->data_type!=MatrixData::DataType::ByteData || minval<0)
+	if (image1->data_type!=MatrixData::DataType::ByteData ||
+		(image2 != NULL && image2->data_type!=MatrixData::DataType::ByteData) || minval<0)
 	{
 		image3->shptr = (void *)imh;
 		nblks = (nvoxels*sizeof(short)+511)/512;
@@ -5,38 +5,26 @@
 #ifndef FILENAME_MAX /* SunOs 4.1.3 */
 #define FILENAME_MAX 256
 #endif
+#include <vector>
 #include "ecat_matrix.hpp"
+#include "frame_stream.hpp"
 #include "my_spdlog.hpp"
 
-void matrix_sum(ecat_matrix::MatrixData *matrix, ecat_matrix::MatrixData **sum)
+// Creates the float sum matrix from the header of the first frame
+static ecat_matrix::MatrixData *create_sum(ecat_matrix::MatrixData *matrix)
 {
-  ecat_matrix::MatVal mat;
-  int i, nvoxels, nblks;
-  short *sdata;
-  float *fdata;
-  
+  ecat_matrix::MatrixData *sum;
+  int nvoxels, nblks;
+
   nvoxels =  matrix->xdim*matrix->ydim*matrix->zdim;
-  mat_numdoc(matrix->matnum, &mat);
-  sdata = (short*)matrix->data_ptr;
-  if (*sum == NULL)
-  {
-    *sum = (ecat_matrix::MatrixData*)calloc(1, sizeof(ecat_matrix::MatrixData));
-    memcpy(*sum, matrix,sizeof(ecat_matrix::MatrixData));
-    (*sum)->data_size = nvoxels*sizeof(float);
-    nblks = ((*sum)->data_size + MatBLKSIZE-1)/MatBLKSIZE;
-    (*sum)->data_ptr = (void *)calloc(nblks,MatBLKSIZE);
-    (*sum)->shptr =(void *)calloc(1,MatBLKSIZE);
-    memcpy((*sum)->shptr,matrix->shptr,sizeof(ecat_matrix::Image_subheader));
-    fdata = (float*)(*sum)->data_ptr;
-    for (i=0; i<nvoxels; i++)
-      fdata[i] = sdata[i]*matrix->scale_factor;
-  }
-  else 
-  {
-    fdata = (float*)(*sum)->data_ptr;
-    for (i=0; i<nvoxels; i++)
-      fdata[i] += sdata[i]*matrix->scale_factor;
-  }
+  sum = (ecat_matrix::MatrixData*)calloc(1, sizeof(ecat_matrix::MatrixData));
+  memcpy(sum, matrix,sizeof(ecat_matrix::MatrixData));
+  sum->data_size = nvoxels*sizeof(float);
+  nblks = (sum->data_size + MatBLKSIZE-1)/MatBLKSIZE;
+  sum->data_ptr = (void *)calloc(nblks,MatBLKSIZE);
+  sum->shptr =(void *)calloc(1,MatBLKSIZE);
+  memcpy(sum->shptr,matrix->shptr,sizeof(ecat_matrix::Image_subheader));
+  return sum;
 }
 
 int main(int argc, char **argv)
@@ -75,44 +63,57 @@ int main(int argc, char **argv)
   LOG_INFO( "{} file type  : {}", argv[1], datasettype_.at(ftype).name);
   if (!mptr) 
     LOG_ERROR(fname);
+  // Select the frames, then sum them while the next ones are read
+  std::vector<int> matnums;
   node = mptr->dirlist->first;
   while (node)  {
     mat_numdoc(node->matnum, &mat);
     if ((start_frame==0 || mat.frame>=start_frame) &&
       (end_frame==0 || mat.frame<=end_frame))
-    {
-      matrix = matrix_read(mptr,node->matnum,UnknownMatDataType);
-      if (!matrix) LOG_EXIT("{},{},{},{},{} not found",        mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
-      LOG_INFO("Adding {},{},{},{},{}",mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
-      matrix_sum(matrix, &sum);
-      imh = (ecat_matrix::Image_subheader*)sum->shptr;
-      duration += imh->frame_duration;
-      frame_count++;
-      free_matrix_data(matrix);
-      last_frame = mat.frame;
-#ifdef _DEBUG
-      nvoxels =  matrix->xdim*matrix->ydim*matrix->zdim;
-      imh = (ecat_matrix::Image_subheader*)matrix->shptr;
-      LOG_INFO("{},{},{}", mat.frame, imh->frame_start_time/1000, imh->frame_duration/1000);
-      sprintf(dfname,"%s_frame%d.i", fname, mat.frame);
-      if ((fp=fopen(dfname,"wb")) != NULL)  {
-        if (fdata == NULL) fdata = (float*) calloc(nvoxels, sizeof(float));
-        sdata = (short*)matrix->data_ptr;
-        for (i=0; i<nvoxels; i++) fdata[i] = sdata[i];
-        fwrite(fdata, nvoxels, sizeof(float), fp);
-        fclose(fp);
-      }
-#endif
-    }     else    {
+      matnums.push_back(node->matnum);
+    else
       LOG_INFO("Skipping {},{},{},{},{}",mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
-    }
     node = node->next;
   }
+  ecat_matrix::FrameStream stream(mptr, matnums);
+  while ((matrix = stream.next()) != NULL)  {
+    mat_numdoc(matrix->matnum, &mat);
+    LOG_INFO("Adding {},{},{},{},{}",mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
+    if (sum == NULL) {
+      sum = create_sum(matrix);
+      i = ecat_matrix::frame_to_float(matrix, 1.0f, (float*)sum->data_ptr);
+    } else {
+      i = ecat_matrix::frame_accumulate(matrix, 1.0f, (float*)sum->data_ptr);
+    }
+    if (i != 0) LOG_EXIT("{},{},{},{},{}: unsupported data type", mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
+    imh = (ecat_matrix::Image_subheader*)matrix->shptr;
+    duration += imh->frame_duration;
+    frame_count++;
+    last_frame = mat.frame;
+#ifdef _DEBUG
+    nvoxels =  matrix->xdim*matrix->ydim*matrix->zdim;
+    imh = (ecat_matrix::Image_subheader*)matrix->shptr;
+    LOG_INFO("{},{},{}", mat.frame, imh->frame_start_time/1000, imh->frame_duration/1000);
+    sprintf(dfname,"%s_frame%d.i", fname, mat.frame);
+    if ((fp=fopen(dfname,"wb")) != NULL)  {
+      if (fdata == NULL) fdata = (float*) calloc(nvoxels, sizeof(float));
+      sdata = (short*)matrix->data_ptr;
+      for (i=0; i<nvoxels; i++) fdata[i] = sdata[i];
+      fwrite(fdata, nvoxels, sizeof(float), fp);
+      fclose(fp);
+    }
+#endif
+    free_matrix_data(matrix);
+  }
+  if (stream.error_matnum() != 0) {
+    mat_numdoc(stream.error_matnum(), &mat);
+    LOG_EXIT("{},{},{},{},{} not found",        mat.frame, mat.plane, mat.gate, mat.data, mat.bed);
+  }
   if (frame_count<2) return 0;
   if (start_frame==0 && end_frame==0) strcat(fname,"_sum.v");
   else sprintf(&fname[strlen(fname)],"_sum_%dto%d.v", start_frame, last_frame);
   if ((sum_mptr=matrix_create(fname,ecat_matrix::MatrixFileAccessMode::OPEN_EXISTING, mptr->mhptr)) != NULL) {
-    nvoxels =  matrix->xdim*matrix->ydim*matrix->zdim;
+    nvoxels =  sum->xdim*sum->ydim*sum->zdim;
     fdata = (float*)sum->data_ptr;
     sdata = (short*)sum->data_ptr;
     for (i=0; i<nvoxels; i++) fdata[i] /= frame_count;
@@ -125,6 +126,7 @@ int main(int argc, char **argv)
     for (i=0; i<nvoxels; i++) sdata[i] = (short)(fdata[i]*f);
     sum->data_size = nvoxels*sizeof(short);
     imh = (ecat_matrix::Image_subheader*)sum->shptr;
+    sum->data_type = imh->data_type = MatrixData::DataType::SunShort;
     imh->frame_duration = duration;
     imh->image_min = find_smin(sdata, nvoxels);
     imh->image_max = find_smax(sdata, nvoxels);
@@ -17,6 +17,8 @@ filtering in x/y- followed by a filtering in z-direction is not a correct
 /*
    Modification history: Merence Sibomana for HRRT Users Community
         25-may-2010: Use SIMD for gaussian smoothing 
+        19-oct-2026: Multi-threaded SIMD gaussian smoothing: x/y filter
+                     on z-slabs, z filter on blocks of columns
 */
 
 #include <cmath>
@@ -25,6 +27,11 @@ filtering in x/y- followed by a filtering in z-direction is not a correct
 #include "global_tmpl.h"
 #include <string.h>
 #include <xmmintrin.h>
+#ifdef GSMOOTH
+#include <algorithm>
+#include <thread>
+#include <vector>
+#endif
 /*- methods -----------------------------------------------------------------*/
 
 /*---------------------------------------------------------------------------*/
@@ -187,11 +194,52 @@ void ImageFilter::calcFilter(float * const image,
   if (xy_dir) filterXY_space(image);
   else filterZ_space(image);
 }
-void ImageFilter::calcFilter_ps(float * const image) const
+
+/*---------------------------------------------------------------------------*/
+/* parallel_blocks: split [0,count) into contiguous blocks of a multiple of  */
+/*                  granularity elements and process them concurrently       */
+/*  count         number of elements                                         */
+/*  granularity   block size must be a multiple of this                      */
+/*  max_threads   maximum number of threads to use                           */
+/*  fn            fn(first, last) processes elements [first,last)            */
+/*---------------------------------------------------------------------------*/
+template <typename F>
+static void parallel_blocks(const unsigned long int count,
+                            const unsigned long int granularity,
+                            unsigned short int max_threads, F fn)
+{ unsigned long int units=(count+granularity-1)/granularity;
+  std::vector<std::thread> threads;
+
+  if (max_threads < 1) max_threads=1;
+  if (units < max_threads) max_threads=(unsigned short int)units;
+  for (unsigned short int t=1; t < max_threads; t++)
+   threads.push_back(std::thread(fn,
+                     std::min(count, units*t/max_threads*granularity),
+                     std::min(count, units*(t+1)/max_threads*granularity)));
+  fn(0, std::min(count, units/max_threads*granularity));
+  for (unsigned short int t=0; t < threads.size(); t++)
+   threads[t].join();
+}
+
+/*---------------------------------------------------------------------------*/
+/* calcFilter_ps: perform gaussian filter operation with SIMD instructions   */
+/*  image         image data                                                 */
+/*  max_threads   maximum number of threads to use                           */
+/*---------------------------------------------------------------------------*/
+void ImageFilter::calcFilter_ps(float * const image,
+                                const unsigned short int max_threads) const
 { 
   if (filter.name == ALL_PASS) return;
-  if (xy_dir) filterXY_space_ps(image);
-  else filterZ_space_ps(image);
+  if (filter.name != GAUSS) calcFilter(image, max_threads);
+  else if (xy_dir)
+   parallel_blocks(z_samples, 1, max_threads,
+                   [this, image](unsigned long int first, unsigned long int last)
+                   { filterXY_space_ps(image, (unsigned short int)first,
+                                       (unsigned short int)last); });
+  else
+   parallel_blocks(image_slicesize, 4, max_threads,
+                   [this, image](unsigned long int first, unsigned long int last)
+                   { filterZ_space_ps(image, first, last); });
 }
 #endif
 
@@ -307,13 +355,15 @@ void ImageFilter::filterXY_space(float * const image) const
      }
  }
 #ifdef GSMOOTH
-void ImageFilter::filterXY_space_ps(float * const image) const
+void ImageFilter::filterXY_space_ps(float * const image,
+                                    const unsigned short int first_z,
+                                    const unsigned short int last_z) const
 {
   if (filter.name == GAUSS)
   {
     float *ip;
     unsigned  x, y, z;
-    for (ip=image, z=0; z < z_samples; z++, ip += image_slicesize)
+    for (ip=image+first_z*image_slicesize, z=first_z; z < last_z; z++, ip += image_slicesize)
     {
       // X direction smoothing
       for (y=0; y < xy_samples; y += 4)
@@ -681,11 +731,13 @@ void ImageFilter::filterZ_space(float * const image) const
     }
  }
 #ifdef GSMOOTH
-void ImageFilter::filterZ_space_ps(float * const image) const
+void ImageFilter::filterZ_space_ps(float * const image,
+                                   const unsigned long int first_xy,
+                                   const unsigned long int last_xy) const
 { 
   if (filter.name == GAUSS)
   {
-    for (unsigned xy=0; xy < image_slicesize; xy += 4)
+    for (unsigned long int xy=first_xy; xy < last_xy; xy += 4)
         gauss_space_ps(&image[xy], 1, image_slicesize, z_samples);
   } else filterZ_space(image);
 }
@@ -21,6 +21,7 @@
 /*
    Modification history: Merence Sibomana for HRRT Users Community
         25-may-2010: Use SIMD for gaussian smoothing 
+        19-oct-2026: Multi-threaded SIMD gaussian smoothing
 */
 
 # pragma once
@@ -108,11 +109,14 @@ class ImageFilter
                                                     // perform filter operation
     void calcFilter(float * const, const unsigned short int) const;
 #ifdef GSMOOTH
-                                                     // filter in x/y-direction
-    void filterXY_space_ps(float * const) const;
-    void filterZ_space_ps(float * const) const;
+                                   // filter slices [first_z,last_z) in x/y
+    void filterXY_space_ps(float * const, const unsigned short int,
+                           const unsigned short int) const;
+                              // filter columns [first_xy,last_xy) in z
+    void filterZ_space_ps(float * const, const unsigned long int,
+                          const unsigned long int) const;
     void gauss_space_ps(float *const,  int, const unsigned long int,
                      const unsigned short int) const;
-    void calcFilter_ps(float * const) const;
+    void calcFilter_ps(float * const, const unsigned short int) const;
 #endif
  };
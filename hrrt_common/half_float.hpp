@@ -0,0 +1,249 @@
+// half_float.hpp
+// 16-bit storage of float arrays: IEEE half precision (fp16) or bfloat16 (bf16).
+//
+// Read mostly volumes, such as the per subset normalization images of hrrt_osem3d, can be kept
+// in memory at half the size and converted back to float before use; arithmetic stays in float.
+// fp16 keeps 11 significant bits between 6.1e-5 and 65504, so values are multiplied by a power
+// of two scale (range_scale) before encoding.  bf16 is the upper half of a float: 8 significant
+// bits over the whole float range.  Both are rounded to nearest even.
+//
+// The fp16 array conversions use AVX-512F or F16C instructions when the CPU has them.  They are
+// compiled with target attributes and chosen at run time, so the build needs no -m flags.
+// Other CPUs and compilers use a portable loop with the same rounding.
+//
+// Header only, so that hrrt_osem3d and e7_tools need no extra library.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HALF_FLOAT_X86
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace half_float {
+
+enum Format { FP32 = 0, FP16 = 1, BF16 = 2 };
+
+// Format from its name "fp32", "fp16" or "bf16".  Returns false if t_name is none of these.
+inline bool parse_format(const char *t_name, Format &t_format) {
+  static const char *names[] = {"fp32", "fp16", "bf16"};
+  for (int i = 0; i < 3; i++) {
+    if (std::strcmp(t_name, names[i]) == 0) {
+      t_format = static_cast<Format>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+inline const char *format_name(Format t_format) {
+  return (t_format == FP16) ? "fp16" : (t_format == BF16) ? "bf16" : "fp32";
+}
+
+namespace detail {
+
+inline uint32_t float_bits(float t_val) {
+  uint32_t u;
+  std::memcpy(&u, &t_val, sizeof(u));
+  return u;
+}
+
+inline float bits_float(uint32_t t_bits) {
+  float f;
+  std::memcpy(&f, &t_bits, sizeof(f));
+  return f;
+}
+
+#ifdef HALF_FLOAT_X86
+enum Isa { ISA_NONE, ISA_F16C, ISA_AVX512F };
+
+// Conversion instructions of the CPU, looked up once
+inline Isa cpu_isa() {
+  static const Isa isa = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      return ISA_AVX512F;
+    if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c"))
+      return ISA_F16C;
+    return ISA_NONE;
+  }();
+  return isa;
+}
+
+// Vector loops of encode() and decode() for FP16.  Return the number of values converted.
+__attribute__((target("avx512f")))
+inline size_t encode_fp16_avx512f(const float *t_src, uint16_t *t_dst, size_t t_num, float t_scale) {
+  size_t i = 0;
+  __m512 s16 = _mm512_set1_ps(t_scale);
+  for (; i + 16 <= t_num; i += 16)
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(t_dst + i),
+                        _mm512_maskz_cvtps_ph(0xffff, _mm512_mul_ps(_mm512_loadu_ps(t_src + i), s16),
+                                              _MM_FROUND_TO_NEAREST_INT));
+  return i;
+}
+
+__attribute__((target("avx,f16c")))
+inline size_t encode_fp16_f16c(const float *t_src, uint16_t *t_dst, size_t t_num, float t_scale) {
+  size_t i = 0;
+  __m256 s8 = _mm256_set1_ps(t_scale);
+  for (; i + 8 <= t_num; i += 8)
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(t_dst + i),
+                     _mm256_cvtps_ph(_mm256_mul_ps(_mm256_loadu_ps(t_src + i), s8), _MM_FROUND_TO_NEAREST_INT));
+  return i;
+}
+
+__attribute__((target("avx512f")))
+inline size_t decode_fp16_avx512f(const uint16_t *t_src, float *t_dst, size_t t_num, float t_scale) {
+  size_t i = 0;
+  __m512 s16 = _mm512_set1_ps(t_scale);
+  for (; i + 16 <= t_num; i += 16)
+    _mm512_storeu_ps(t_dst + i, _mm512_mul_ps(_mm512_maskz_cvtph_ps(0xffff, _mm256_loadu_si256(
+                                                  reinterpret_cast<const __m256i *>(t_src + i))), s16));
+  return i;
+}
+
+__attribute__((target("avx,f16c")))
+inline size_t decode_fp16_f16c(const uint16_t *t_src, float *t_dst, size_t t_num, float t_scale) {
+  size_t i = 0;
+  __m256 s8 = _mm256_set1_ps(t_scale);
+  for (; i + 8 <= t_num; i += 8)
+    _mm256_storeu_ps(t_dst + i, _mm256_mul_ps(_mm256_cvtph_ps(_mm_loadu_si128(
+                                                  reinterpret_cast<const __m128i *>(t_src + i))), s8));
+  return i;
+}
+#endif
+
+}  // namespace detail
+
+inline uint16_t float_to_fp16(float t_val) {
+  uint32_t u = detail::float_bits(t_val);
+  uint16_t sign = static_cast<uint16_t>((u >> 16) & 0x8000);
+  u &= 0x7fffffff;
+  if (u >= 0x47800000)  // too large, inf or nan
+    return sign | ((u > 0x7f800000) ? 0x7e00 : 0x7c00);
+  if (u < 0x38800000) {
+    // Subnormal or zero: adding 0.5 aligns the half ulp (2^-24) on the float ulp and rounds
+    float f = detail::bits_float(u) + 0.5f;
+    return sign | static_cast<uint16_t>(detail::float_bits(f) - 0x3f000000);
+  }
+  // Rebias the exponent by 15-127 and round the 13 dropped bits to nearest even
+  u += 0xc8000fff + ((u >> 13) & 1);
+  return sign | static_cast<uint16_t>(u >> 13);
+}
+
+inline float fp16_to_float(uint16_t t_val) {
+  const uint32_t exp_mask = 0x7c00 << 13;
+  uint32_t u = (t_val & 0x7fff) << 13;
+  uint32_t exp = u & exp_mask;
+  u += (127 - 15) << 23;
+  if (exp == exp_mask) {  // inf or nan
+    u += (128 - 16) << 23;
+  } else if (exp == 0) {  // zero or subnormal: renormalize
+    u += 1 << 23;
+    u = detail::float_bits(detail::bits_float(u) - detail::bits_float(113 << 23));
+  }
+  return detail::bits_float(u | ((t_val & 0x8000u) << 16));
+}
+
+inline uint16_t float_to_bf16(float t_val) {
+  uint32_t u = detail::float_bits(t_val);
+  if ((u & 0x7fffffff) > 0x7f800000)  // nan: keep it quiet, rounding could make it inf
+    return static_cast<uint16_t>((u >> 16) | 0x40);
+  u += 0x7fff + ((u >> 16) & 1);
+  return static_cast<uint16_t>(u >> 16);
+}
+
+inline float bf16_to_float(uint16_t t_val) {
+  return detail::bits_float(static_cast<uint32_t>(t_val) << 16);
+}
+
+// Power of two scale that maps the largest magnitude of t_src to [2^14, 2^15[, where fp16 keeps
+// full precision over 9 decades below it.  The scaling is exact.  1 if t_src is all zero.
+inline float range_scale(const float *t_src, size_t t_num) {
+  float vmax = 0.0f;
+  for (size_t i = 0; i < t_num; i++)
+    vmax = std::fmax(vmax, std::fabs(t_src[i]));
+  if (vmax == 0.0f || !std::isfinite(vmax))
+    return 1.0f;
+  int exp;
+  std::frexp(vmax, &exp);
+  return std::ldexp(1.0f, 15 - exp);
+}
+
+// t_dst[i] = t_src[i] * t_scale in t_format (FP16 or BF16)
+inline void encode(const float *t_src, uint16_t *t_dst, size_t t_num, Format t_format, float t_scale = 1.0f) {
+  size_t i = 0;
+  if (t_format == FP16) {
+#ifdef HALF_FLOAT_X86
+    if (detail::cpu_isa() == detail::ISA_AVX512F)
+      i = detail::encode_fp16_avx512f(t_src, t_dst, t_num, t_scale);
+    else if (detail::cpu_isa() == detail::ISA_F16C)
+      i = detail::encode_fp16_f16c(t_src, t_dst, t_num, t_scale);
+#endif
+    for (; i < t_num; i++)
+      t_dst[i] = float_to_fp16(t_src[i] * t_scale);
+  } else {
+    for (; i < t_num; i++)
+      t_dst[i] = float_to_bf16(t_src[i] * t_scale);
+  }
+}
+
+// t_dst[i] = t_src[i] * t_scale, t_src in t_format (FP16 or BF16)
+inline void decode(const uint16_t *t_src, float *t_dst, size_t t_num, Format t_format, float t_scale = 1.0f) {
+  size_t i = 0;
+  if (t_format == FP16) {
+#ifdef HALF_FLOAT_X86
+    if (detail::cpu_isa() == detail::ISA_AVX512F)
+      i = detail::decode_fp16_avx512f(t_src, t_dst, t_num, t_scale);
+    else if (detail::cpu_isa() == detail::ISA_F16C)
+      i = detail::decode_fp16_f16c(t_src, t_dst, t_num, t_scale);
+#endif
+    for (; i < t_num; i++)
+      t_dst[i] = fp16_to_float(t_src[i]) * t_scale;
+  } else {
+#if defined(__SSE2__)
+    // bf16 to float is a 16 bit shift: interleave with zeros
+    __m128 s4 = _mm_set1_ps(t_scale);
+    __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= t_num; i += 8) {
+      __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(t_src + i));
+      _mm_storeu_ps(t_dst + i, _mm_mul_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(zero, h)), s4));
+      _mm_storeu_ps(t_dst + i + 4, _mm_mul_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(zero, h)), s4));
+    }
+#endif
+    for (; i < t_num; i++)
+      t_dst[i] = bf16_to_float(t_src[i]) * t_scale;
+  }
+}
+
+// Largest relative error of t_dec against t_src over the nonzero values of t_src
+inline double max_rel_error(const float *t_src, const float *t_dec, size_t t_num) {
+  double err = 0.0;
+  for (size_t i = 0; i < t_num; i++) {
+    if (t_src[i] != 0.0f)
+      err = std::fmax(err, std::fabs((static_cast<double>(t_dec[i]) - t_src[i]) / t_src[i]));
+  }
+  return err;
+}
+
+// Root mean square relative error of t_dec against t_src over the nonzero values of t_src
+inline double rms_rel_error(const float *t_src, const float *t_dec, size_t t_num) {
+  double sum = 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < t_num; i++) {
+    if (t_src[i] != 0.0f) {
+      double err = (static_cast<double>(t_dec[i]) - t_src[i]) / t_src[i];
+      sum += err * err;
+      count++;
+    }
+  }
+  return count ? std::sqrt(sum / count) : 0.0;
+}
+
+}  // namespace half_float
@@ -95,35 +95,48 @@ std::string time_string(void) {
 }
 
 
-// prog:    Program to run
-// args:    Argument string to program
-// outfile: Optional output file to check for
-// Check for existence of given program, then run with given args.
-// Returns: 0 on success, else 1
+// Remove the memory access pattern file ~/.ma_pattern.dat left by the e7 tools.
+// Returns: 0 if the file does not exist on exit, else 1
 
-int run_system_command( char *prog, char *args, FILE *log_fp ) {
-  char command_line[4096];
-  int ret = 0;
+int remove_ma_pattern(void) {
   char *ptr = NULL;
   char ma_pattern_name[FILENAME_MAX];
-  
-  ma_pattern_name[0] = '\0';
+  int ret = 0;
+
   if ((ptr=getenv("HOME")) != NULL) {
     sprintf(ma_pattern_name, "%s/.ma_pattern.dat", ptr);
     if (!access(ma_pattern_name, R_OK)) {
-      LOG_ERROR("*** ma_pattern file exists: '%s'\n", ma_pattern_name);      
+      LOG_ERROR("*** ma_pattern file exists: '{}'", ma_pattern_name);
       if (remove(ma_pattern_name) != 0) {
-        LOG_ERROR("*** ERROR: Removing ma_pattern file: '%s'\n", ma_pattern_name);
+        LOG_ERROR("*** ERROR: Removing ma_pattern file: '{}'", ma_pattern_name);
+        ret = 1;
       } else {
-        LOG_ERROR("*** Removed ma_pattern file OK: '%s'\n", ma_pattern_name);
+        LOG_ERROR("*** Removed ma_pattern file OK: '{}'", ma_pattern_name);
       }
     } else {
-      LOG_ERROR("*** ma_pattern file '%s' does not exist\n", ma_pattern_name);
+      LOG_ERROR("*** ma_pattern file '{}' does not exist", ma_pattern_name);
     }
   } else {
-    LOG_ERROR("*** Could not determine HOME envt var: Cannot remove ma_pattern.dat file\n");
+    LOG_ERROR("*** Could not determine HOME envt var: Cannot remove ma_pattern.dat file");
+    ret = 1;
   }
   fflush(stderr);
+  return(ret);
+}
+
+// prog:    Program to run
+// args:    Argument string to program
+// t_remove_ma_pattern: Remove ~/.ma_pattern.dat first.  Callers running
+//          commands concurrently pass false and call remove_ma_pattern() once.
+// Check for existence of given program, then run with given args.
+// Returns: 0 on success, else 1
+
+int run_system_command( char *prog, char *args, FILE *log_fp, bool t_remove_ma_pattern ) {
+  char command_line[4096];
+  int ret = 0;
+
+  if (t_remove_ma_pattern)
+    remove_ma_pattern();
 
   ret = access(prog, X_OK);
   if (ret) {
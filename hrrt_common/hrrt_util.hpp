@@ -36,7 +36,8 @@ int open_ostream(std::ofstream &ofstr, const boost::filesystem::path &name, std:
 void GetSystemInformation(void);
 template <typename T> int write_binary_file(T *t_data, int t_num_elems, boost::filesystem::path const &outpath, std::string const &msg);
 // bool parse_interfile_line(const std::string &line, std::string &key, std::string &value);
-extern int run_system_command( char *prog, char *args, FILE *log_fp );
+extern int remove_ma_pattern(void);
+extern int run_system_command( char *prog, char *args, FILE *log_fp, bool t_remove_ma_pattern = true );
 extern  bool file_exists (const std::string& name);
 std::string time_string(void);
 std::istream& safeGetline(std::istream& is, std::string& t);
@@ -0,0 +1,68 @@
+// lm_events.hpp
+// Time ordered prompt events of a frame, for listmode reconstruction.
+//
+// lmhistogram_mp writes the sinogram address of each prompt event of a frame, in the order of the
+// listmode stream, as given by its crystal pair to sinogram lookup table.  hrrt_osem3d reconstructs
+// low count frames from these events (-l option) instead of from every bin of the sinogram.
+//
+// File layout (native byte order):
+//   FileHeader
+//   num_events * uint32_t   sinogram address: (plane * nviews + view) * nprojs + proj
+//
+// Header only, so that lmhistogram_mp and hrrt_osem3d need no extra library.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace lm_events {
+
+constexpr char MAGIC[8] = "HRRTLME";
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t span;
+  uint32_t max_rd;
+  uint32_t nprojs;
+  uint32_t nviews;
+  uint32_t nplanes;
+  uint64_t num_events;
+  int32_t  start_time;  // frame start in seconds
+  int32_t  duration;    // frame duration in seconds
+};
+
+// Write t_events with header t_hdr; magic, version and num_events are filled in.
+// Returns 0 on success, 1 on error.
+inline int write(const char *t_filename, FileHeader t_hdr, std::vector<uint32_t> const &t_events) {
+  std::memcpy(t_hdr.magic, MAGIC, sizeof(t_hdr.magic));
+  t_hdr.version    = VERSION;
+  t_hdr.num_events = t_events.size();
+  FILE *fp = fopen(t_filename, "wb");
+  if (fp == nullptr)
+    return 1;
+  bool ok = (fwrite(&t_hdr, sizeof(t_hdr), 1, fp) == 1) &&
+            (fwrite(t_events.data(), sizeof(uint32_t), t_events.size(), fp) == t_events.size());
+  return (fclose(fp) == 0 && ok) ? 0 : 1;
+}
+
+// Read header and events.  Returns 0 on success, 1 on error or if t_filename is not an event file.
+inline int read(const char *t_filename, FileHeader &t_hdr, std::vector<uint32_t> &t_events) {
+  FILE *fp = fopen(t_filename, "rb");
+  if (fp == nullptr)
+    return 1;
+  bool ok = (fread(&t_hdr, sizeof(t_hdr), 1, fp) == 1) &&
+            (std::memcmp(t_hdr.magic, MAGIC, sizeof(t_hdr.magic)) == 0) && (t_hdr.version == VERSION);
+  if (ok) {
+    t_events.resize(t_hdr.num_events);
+    ok = (fread(t_events.data(), sizeof(uint32_t), t_events.size(), fp) == t_events.size());
+  }
+  fclose(fp);
+  return ok ? 0 : 1;
+}
+
+}  // namespace lm_events
@@ -0,0 +1,253 @@
+/*
+  lm_index.cpp
+  Time tag index of HRRT 64-bit listmode files, see lm_index.hpp.
+
+  Index file layout (native byte order):
+    IndexHeader
+    num_entries * LMIndex::Entry
+  The header holds the size and modification time of the listmode file; an index
+  that does not match its listmode file is rejected by read().
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "lm_index.hpp"
+#include "lm_pack.hpp"
+#include "hrrt_util.hpp"
+#include "my_spdlog.hpp"
+#include <gen_delays_lib/geometry_info.h>
+
+namespace bf = boost::filesystem;
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = "LM64IDX";
+constexpr size_t BUF_WORDS = 2 * 1024 * 1024;  // 1M 64-bit events
+constexpr int MAX_BLOCKS = 1 << 10;            // size of block field in singles tag
+
+struct IndexHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t interval;
+  uint64_t file_size;
+  int64_t  file_mtime;
+  uint64_t reset;
+  uint64_t num_entries;
+};
+
+}  // namespace
+
+constexpr uint32_t LMIndex::VERSION;
+constexpr uint32_t LMIndex::DEFAULT_INTERVAL;
+
+LMIndex::LMIndex() : interval_(DEFAULT_INTERVAL), file_size_(0), file_mtime_(0), reset_(0) {
+}
+
+bf::path LMIndex::index_path(bf::path const &t_l64_file) {
+  return bf::path(t_l64_file.string() + ".idx");
+}
+
+int LMIndex::file_stamp(bf::path const &t_l64_file, uint64_t &t_size, int64_t &t_mtime) const {
+  boost::system::error_code ec;
+  t_size = bf::file_size(t_l64_file, ec);
+  if (!ec)
+    t_mtime = bf::last_write_time(t_l64_file, ec);
+  if (ec) {
+    LOG_ERROR("Could not stat {}: {}", t_l64_file.string(), ec.message());
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * build:
+ * Read the listmode file in 1M event buffers and record the first time tag of each interval.
+ * Event words are decoded like in histogram_mp: sync words shift the stream by 32 bits,
+ * tag words carry time tags and block singles, other events are prompts or delayed.
+ * A time tag earlier than its predecessor is a clock reset and always starts a new entry.
+ * Packed listmode files (lm_pack.hpp) are unpacked while reading, offsets are listmode offsets.
+ */
+int LMIndex::build(bf::path const &t_l64_file, uint32_t t_interval) {
+  std::ifstream instream;
+  LMPackReader pack_reader;
+  bool packed = lm_pack::is_packed(t_l64_file);
+  if (packed ? pack_reader.open(t_l64_file) : hrrt_util::open_istream(instream, t_l64_file, std::ios::in | std::ios::binary))
+    return 1;
+  if (file_stamp(t_l64_file, file_size_, file_mtime_))
+    return 1;
+  interval_ = (t_interval > 0) ? t_interval : DEFAULT_INTERVAL;
+  entries_.clear();
+  reset_ = 0;
+
+  std::vector<uint32_t> buf(BUF_WORDS);
+  std::vector<uint32_t> block_singles(MAX_BLOCKS, 0);
+  // Block singles total and number of samples since the last entry, for the average rate
+  std::vector<uint64_t> block_total(MAX_BLOCKS, 0);
+  std::vector<uint32_t> block_samples(MAX_BLOCKS, 0);
+  uint64_t prompts = 0, delayed = 0, singles = 0;
+  uint64_t buf_offset = 0;  // file position of buf[0] in words
+  size_t nwords = 0, pos = 0;
+  int64_t last_time = -1;
+
+  size_t nread = BUF_WORDS;
+  while (nread > 0) {
+    // Keep the odd word left at the end of the buffer, refill the rest
+    size_t keep = nwords - pos;
+    if (keep > 0)
+      buf[0] = buf[pos];
+    buf_offset += pos;
+    size_t nbytes = (BUF_WORDS - keep) * sizeof(uint32_t);
+    if (packed) {
+      nread = pack_reader.read(reinterpret_cast<char *>(&buf[keep]), nbytes) / sizeof(uint32_t);
+    } else {
+      instream.read(reinterpret_cast<char *>(&buf[keep]), nbytes);
+      nread = instream.gcount() / sizeof(uint32_t);
+    }
+    nwords = keep + nread;
+    pos = 0;
+    while (pos + 1 < nwords) {
+      uint32_t ew1 = buf[pos];
+      uint32_t ew2 = buf[pos + 1];
+      int type = GeometryInfo::EWTYPES[(((ew2 & 0xc0000000) >> 30) | ((ew1 & 0xc0000000) >> 28))];
+      switch (type) {
+      case 3:  // sync
+        pos++;
+        continue;
+      case 2: {  // tag word
+        uint32_t tag = (ew1 & 0xffff) | ((ew2 & 0xffff) << 16);
+        if ((tag & 0xE0000000) == 0x80000000) {
+          int64_t time = tag & 0x3fffffff;
+          bool reset = (time < last_time);
+          if (reset || last_time < 0 || (time / interval_ != last_time / interval_)) {
+            if (reset)
+              reset_ = entries_.size();
+            uint64_t singles_rate = 0;
+            for (int block = 0; block < GeometryInfo::NBLOCKS; block++) {
+              if (block_samples[block] > 0)
+                singles_rate += block_total[block] / block_samples[block];
+              block_total[block] = 0;
+              block_samples[block] = 0;
+            }
+            entries_.push_back({time, (buf_offset + pos) * sizeof(uint32_t), prompts, delayed, singles, singles_rate});
+          }
+          last_time = time;
+        } else if ((tag & 0xE0000000) == 0xA0000000) {
+          uint32_t block = (tag & 0x1ff80000) >> 19;
+          uint32_t value = tag & 0x0007ffff;
+          if (block < GeometryInfo::NBLOCKS) {
+            singles = singles - block_singles[block] + value;
+            block_singles[block] = value;
+            block_total[block] += value;
+            block_samples[block]++;
+          }
+        }
+        break;
+      }
+      case 1:
+        delayed++;
+        break;
+      default:
+        prompts++;
+      }
+      pos += 2;
+    }
+  }
+  if (packed && pack_reader.fail())
+    return 1;
+  if (entries_.empty()) {
+    LOG_ERROR("No time tags in {}", t_l64_file.string());
+    return 1;
+  }
+  LOG_INFO("Indexed {}: {} entries, {} msec interval", t_l64_file.string(), entries_.size(), interval_);
+  return 0;
+}
+
+int LMIndex::write(bf::path const &t_index_file) const {
+  std::ofstream outstream;
+  if (hrrt_util::open_ostream(outstream, t_index_file, std::ios::out | std::ios::binary))
+    return 1;
+  IndexHeader hdr;
+  memcpy(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic));
+  hdr.version     = VERSION;
+  hdr.interval    = interval_;
+  hdr.file_size   = file_size_;
+  hdr.file_mtime  = file_mtime_;
+  hdr.reset       = reset_;
+  hdr.num_entries = entries_.size();
+  outstream.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  outstream.write(reinterpret_cast<const char *>(entries_.data()), entries_.size() * sizeof(Entry));
+  if (!outstream.good()) {
+    LOG_ERROR("Error writing index file {}", t_index_file.string());
+    return 1;
+  }
+  return 0;
+}
+
+int LMIndex::read(bf::path const &t_index_file, bf::path const &t_l64_file) {
+  std::ifstream instream;
+  if (hrrt_util::open_istream(instream, t_index_file, std::ios::in | std::ios::binary))
+    return 1;
+  IndexHeader hdr;
+  instream.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
+  if (!instream.good() || memcmp(hdr.magic, INDEX_MAGIC, sizeof(hdr.magic)) || hdr.version != VERSION) {
+    LOG_INFO("{} is not a version {} listmode index", t_index_file.string(), VERSION);
+    return 1;
+  }
+  uint64_t file_size;
+  int64_t file_mtime;
+  if (file_stamp(t_l64_file, file_size, file_mtime))
+    return 1;
+  if (file_size != hdr.file_size || file_mtime != hdr.file_mtime) {
+    LOG_INFO("{} is out of date", t_index_file.string());
+    return 1;
+  }
+  std::vector<Entry> entries(hdr.num_entries);
+  instream.read(reinterpret_cast<char *>(entries.data()), entries.size() * sizeof(Entry));
+  if (!instream.good() || entries.empty() || hdr.reset >= entries.size() || hdr.interval == 0) {
+    LOG_ERROR("Error reading index file {}", t_index_file.string());
+    return 1;
+  }
+  interval_   = hdr.interval;
+  file_size_  = file_size;
+  file_mtime_ = file_mtime;
+  reset_      = hdr.reset;
+  entries_.swap(entries);
+  return 0;
+}
+
+int LMIndex::read_or_build(bf::path const &t_l64_file, uint32_t t_interval) {
+  bf::path index_file = index_path(t_l64_file);
+  if (bf::is_regular_file(index_file) && (read(index_file, t_l64_file) == 0))
+    return 0;
+  LOG_INFO("Indexing listmode file {}", t_l64_file.string());
+  if (build(t_l64_file, t_interval))
+    return 1;
+  // An index that can't be stored is still good for this run
+  write(index_file);
+  return 0;
+}
+
+const LMIndex::Entry *LMIndex::find_time(int64_t t_msec) const {
+  auto it = std::upper_bound(entries_.begin() + reset_, entries_.end(), t_msec,
+                             [](int64_t t, Entry const &e) { return t < e.time; });
+  return (it == entries_.begin() + reset_) ? nullptr : &*(it - 1);
+}
+
+const LMIndex::Entry *LMIndex::find_end(int64_t t_msec) const {
+  auto it = std::lower_bound(entries_.begin() + reset_, entries_.end(), t_msec,
+                             [](Entry const &e, int64_t t) { return e.time < t; });
+  return (it == entries_.end()) ? nullptr : &*it;
+}
+
+const LMIndex::Entry *LMIndex::find_countrate(int64_t t_rate) const {
+  for (size_t i = reset_; i + 1 < entries_.size(); i++) {
+    Entry const &e0 = entries_[i], &e1 = entries_[i + 1];
+    int64_t trues = (int64_t)(e1.prompts - e0.prompts) - (int64_t)(e1.delayed - e0.delayed);
+    int64_t dt = e1.time - e0.time;
+    if (dt > 0 && trues * 1000 >= t_rate * dt)
+      return &e0;
+  }
+  return nullptr;
+}
@@ -0,0 +1,64 @@
+// lm_index.hpp
+// Time tag index of HRRT 64-bit listmode files.
+//
+// The index is a sidecar file (foo.l64 -> foo.l64.idx) written once per listmode file.
+// It holds one entry per time interval (default 1 sec): the first time tag of the interval,
+// its byte offset in the listmode file, the prompts, delayed and block singles counts
+// at that time tag and the singles rate of the preceding interval.  Frame starts, count
+// rate thresholds and head curves are looked up in the index instead of scanning the
+// listmode file from the start.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+class LMIndex {
+public:
+  static constexpr uint32_t VERSION = 2;
+  static constexpr uint32_t DEFAULT_INTERVAL = 1000;  // msec
+
+  struct Entry {
+    int64_t  time;          // time tag value in msec
+    uint64_t offset;        // byte offset of the time tag event in the listmode file
+    uint64_t prompts;       // prompts since start of file
+    uint64_t delayed;       // delayed since start of file
+    uint64_t singles;       // sum of last block singles samples at the time tag
+    uint64_t singles_rate;  // sum of block average singles since the previous entry, as singles_rate()
+  };
+
+  LMIndex();
+
+  // Sidecar file name of a listmode file
+  static boost::filesystem::path index_path(boost::filesystem::path const &t_l64_file);
+
+  // Scan listmode file and fill in entries.  Returns 0 on success.
+  int build(boost::filesystem::path const &t_l64_file, uint32_t t_interval = DEFAULT_INTERVAL);
+  // Write index file.  Returns 0 on success.
+  int write(boost::filesystem::path const &t_index_file) const;
+  // Read index file; fails if it is not the current version or does not match the listmode file.
+  int read(boost::filesystem::path const &t_index_file, boost::filesystem::path const &t_l64_file);
+  // Read the sidecar of a listmode file, or build and write it when missing or out of date.
+  int read_or_build(boost::filesystem::path const &t_l64_file, uint32_t t_interval = DEFAULT_INTERVAL);
+
+  // Last entry after the last clock reset with time <= t_msec, nullptr if none
+  const Entry *find_time(int64_t t_msec) const;
+  // First entry after the last clock reset with time >= t_msec, nullptr if none
+  const Entry *find_end(int64_t t_msec) const;
+  // First entry after the last clock reset starting an interval with trues/sec >= t_rate, nullptr if none
+  const Entry *find_countrate(int64_t t_rate) const;
+
+  bool empty() const { return entries_.empty(); }
+  uint32_t interval() const { return interval_; }
+  std::vector<Entry> const &entries() const { return entries_; }
+
+private:
+  int file_stamp(boost::filesystem::path const &t_l64_file, uint64_t &t_size, int64_t &t_mtime) const;
+
+  uint32_t interval_;
+  uint64_t file_size_;        // listmode file size and modification time when indexed
+  int64_t file_mtime_;
+  size_t reset_;              // first entry after the last clock reset
+  std::vector<Entry> entries_;
+};
@@ -0,0 +1,401 @@
+/*
+  lm_pack.cpp
+  Lossless packed format of HRRT 64-bit listmode files, see lm_pack.hpp.
+
+  Packed file layout (native byte order):
+    FileHeader
+    packed chunks
+    num_chunks * lm_pack::ChunkEntry    at table_offset
+  Chunk records, the first byte tells the record type:
+    bit 0 set   coincidence event, 40 bits: 1, prompt, crystal A, crystal B (13 bits each,
+                x * NYCRYS + y), module A, module B, DOI A, DOI B (3 bits each)
+    0x00        time tag, zigzag varint of the difference with the previous time tag
+    0x02        other tag word, 4 bytes tag value
+    0x04        other event, 8 bytes as in the listmode file
+    0x06        single word (sync or last word of the file), 4 bytes
+  Tag records are for tag words with the usual upper halves 0x4000 and 0x8000.  Coincidences with
+  crystals out of range or with bits outside the decoded fields are stored as other events.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "lm_pack.hpp"
+#include "hrrt_util.hpp"
+#include "my_spdlog.hpp"
+#include <gen_delays_lib/geometry_info.h>
+
+namespace bf = boost::filesystem;
+
+namespace {
+
+constexpr char PACK_MAGIC[8] = "LM64PAK";
+constexpr uint32_t FIELD_MASK = 0x01C7FFFF;    // x, y, module and DOI bits of an event word
+constexpr uint32_t TIME_TAG_INIT = 0x80000000; // previous time tag at chunk start
+enum Record : uint8_t {TIME_TAG = 0x00, TAG = 0x02, EVENT = 0x04, WORD = 0x06};
+
+struct FileHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t chunk_words;
+  uint64_t raw_size;
+  uint64_t num_chunks;
+  uint64_t table_offset;
+};
+
+void put_bytes(std::vector<char> &t_buf, uint64_t t_val, int t_nbytes) {
+  for (int i = 0; i < t_nbytes; i++, t_val >>= 8)
+    t_buf.push_back(static_cast<char>(t_val & 0xff));
+}
+
+bool get_bytes(const unsigned char *&t_ptr, const unsigned char *t_end, int t_nbytes, uint64_t &t_val) {
+  if (t_end - t_ptr < t_nbytes)
+    return false;
+  t_val = 0;
+  for (int i = 0; i < t_nbytes; i++)
+    t_val |= static_cast<uint64_t>(*t_ptr++) << (8 * i);
+  return true;
+}
+
+void put_varint(std::vector<char> &t_buf, uint32_t t_val) {
+  while (t_val >= 0x80) {
+    t_buf.push_back(static_cast<char>((t_val & 0x7f) | 0x80));
+    t_val >>= 7;
+  }
+  t_buf.push_back(static_cast<char>(t_val));
+}
+
+bool get_varint(const unsigned char *&t_ptr, const unsigned char *t_end, uint32_t &t_val) {
+  t_val = 0;
+  for (int shift = 0; t_ptr < t_end && shift < 35; shift += 7) {
+    unsigned char b = *t_ptr++;
+    t_val |= static_cast<uint32_t>(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Coincidence event packed in 40 bits, 0 if the event can't be packed
+uint64_t pack_event(uint32_t t_ew1, uint32_t t_ew2) {
+  if ((t_ew1 & 0xc0000000) || !(t_ew2 & 0x80000000) || ((t_ew1 | t_ew2) & 0x3fffffff & ~FIELD_MASK))
+    return 0;
+  uint32_t ax = t_ew1 & 0xff, ay = (t_ew1 >> 8) & 0xff;
+  uint32_t bx = t_ew2 & 0xff, by = (t_ew2 >> 8) & 0xff;
+  if (ax >= GeometryInfo::NXCRYS || bx >= GeometryInfo::NXCRYS || ay >= GeometryInfo::NYCRYS || by >= GeometryInfo::NYCRYS)
+    return 0;
+  uint64_t val = 1 | ((t_ew2 >> 30) & 1) << 1;
+  val |= static_cast<uint64_t>(ax * GeometryInfo::NYCRYS + ay) << 2;
+  val |= static_cast<uint64_t>(bx * GeometryInfo::NYCRYS + by) << 15;
+  val |= static_cast<uint64_t>((t_ew1 >> 16) & 7) << 28;
+  val |= static_cast<uint64_t>((t_ew2 >> 16) & 7) << 31;
+  val |= static_cast<uint64_t>((t_ew1 >> 22) & 7) << 34;
+  val |= static_cast<uint64_t>((t_ew2 >> 22) & 7) << 37;
+  return val;
+}
+
+void unpack_event(uint64_t t_val, uint32_t &t_ew1, uint32_t &t_ew2) {
+  uint32_t a = (t_val >> 2) & 0x1fff, b = (t_val >> 15) & 0x1fff;
+  t_ew1 = (a / GeometryInfo::NYCRYS) | (a % GeometryInfo::NYCRYS) << 8 |
+          ((t_val >> 28) & 7) << 16 | ((t_val >> 34) & 7) << 22;
+  t_ew2 = (b / GeometryInfo::NYCRYS) | (b % GeometryInfo::NYCRYS) << 8 |
+          ((t_val >> 31) & 7) << 16 | ((t_val >> 37) & 7) << 22 | 0x80000000 | ((t_val >> 1) & 1) << 30;
+}
+
+bool read_header(std::ifstream &t_instream, FileHeader &t_hdr) {
+  t_instream.read(reinterpret_cast<char *>(&t_hdr), sizeof(t_hdr));
+  return t_instream.good() && !memcmp(t_hdr.magic, PACK_MAGIC, sizeof(t_hdr.magic)) &&
+         (t_hdr.version == lm_pack::VERSION) && (t_hdr.chunk_words > 0);
+}
+
+unsigned num_threads() {
+  return std::max(2u, std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+/**
+ * pack_chunk:
+ * Events are decoded like in histogram_mp: a word pair with a sync type shifts the stream
+ * by one word, the type of other pairs tells tags from coincidences.
+ */
+std::vector<char> lm_pack::pack_chunk(const uint32_t *t_words, uint32_t t_nwords) {
+  std::vector<char> buf;
+  buf.reserve(t_nwords * 3);
+  uint32_t prev_time = TIME_TAG_INIT;
+  uint32_t pos = 0;
+  while (pos < t_nwords) {
+    if (pos + 1 == t_nwords) {
+      buf.push_back(WORD);
+      put_bytes(buf, t_words[pos++], 4);
+      break;
+    }
+    uint32_t ew1 = t_words[pos], ew2 = t_words[pos + 1];
+    int type = GeometryInfo::EWTYPES[(((ew2 & 0xc0000000) >> 30) | ((ew1 & 0xc0000000) >> 28))];
+    if (type == 3) {  // sync
+      buf.push_back(WORD);
+      put_bytes(buf, ew1, 4);
+      pos++;
+      continue;
+    }
+    uint64_t packed = (type == 2) ? 0 : pack_event(ew1, ew2);
+    if (packed) {
+      put_bytes(buf, packed, 5);
+    } else if ((type == 2) && ((ew1 >> 16) == 0x4000) && ((ew2 >> 16) == 0x8000)) {
+      uint32_t tag = (ew1 & 0xffff) | ((ew2 & 0xffff) << 16);
+      if ((tag & 0xE0000000) == 0x80000000) {
+        int32_t delta = static_cast<int32_t>(tag - prev_time);
+        buf.push_back(TIME_TAG);
+        put_varint(buf, (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+        prev_time = tag;
+      } else {
+        buf.push_back(TAG);
+        put_bytes(buf, tag, 4);
+      }
+    } else {
+      buf.push_back(EVENT);
+      put_bytes(buf, ew1, 4);
+      put_bytes(buf, ew2, 4);
+    }
+    pos += 2;
+  }
+  return buf;
+}
+
+int lm_pack::unpack_chunk(const char *t_data, size_t t_size, uint32_t *t_words, uint32_t t_nwords) {
+  const unsigned char *ptr = reinterpret_cast<const unsigned char *>(t_data);
+  const unsigned char *end = ptr + t_size;
+  uint32_t prev_time = TIME_TAG_INIT;
+  uint32_t pos = 0;
+  uint64_t val = 0;
+  uint32_t delta = 0;
+  while (ptr < end) {
+    uint8_t op = *ptr;
+    uint32_t nwords = (op & 1) ? 2 : (op == WORD) ? 1 : 2;
+    if (pos + nwords > t_nwords)
+      return 1;
+    if (op & 1) {
+      if (!get_bytes(ptr, end, 5, val))
+        return 1;
+      unpack_event(val, t_words[pos], t_words[pos + 1]);
+    } else {
+      ptr++;
+      switch (op) {
+      case TIME_TAG:
+        if (!get_varint(ptr, end, delta))
+          return 1;
+        prev_time += static_cast<uint32_t>(static_cast<int32_t>(delta >> 1) ^ -static_cast<int32_t>(delta & 1));
+        val = prev_time;
+        t_words[pos] = 0x40000000 | (val & 0xffff);
+        t_words[pos + 1] = 0x80000000 | (val >> 16);
+        break;
+      case TAG:
+        if (!get_bytes(ptr, end, 4, val))
+          return 1;
+        t_words[pos] = 0x40000000 | (val & 0xffff);
+        t_words[pos + 1] = 0x80000000 | (val >> 16);
+        break;
+      case EVENT:
+        if (!get_bytes(ptr, end, 4, val))
+          return 1;
+        t_words[pos] = static_cast<uint32_t>(val);
+        if (!get_bytes(ptr, end, 4, val))
+          return 1;
+        t_words[pos + 1] = static_cast<uint32_t>(val);
+        break;
+      case WORD:
+        if (!get_bytes(ptr, end, 4, val))
+          return 1;
+        t_words[pos] = static_cast<uint32_t>(val);
+        break;
+      default:
+        return 1;
+      }
+    }
+    pos += nwords;
+  }
+  return (pos == t_nwords) ? 0 : 1;
+}
+
+/**
+ * pack:
+ * Read the listmode file by groups of chunks, pack the chunks of a group in parallel and
+ * write them in order.  The header is written again with the chunk table offset at the end.
+ */
+int lm_pack::pack(bf::path const &t_l64_file, bf::path const &t_l64z_file, uint32_t t_chunk_words) {
+  std::ifstream instream;
+  std::ofstream outstream;
+  if (hrrt_util::open_istream(instream, t_l64_file, std::ios::in | std::ios::binary))
+    return 1;
+  if (hrrt_util::open_ostream(outstream, t_l64z_file, std::ios::out | std::ios::binary))
+    return 1;
+  FileHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, PACK_MAGIC, sizeof(hdr.magic));
+  hdr.version = VERSION;
+  hdr.chunk_words = (t_chunk_words > 0) ? t_chunk_words : DEFAULT_CHUNK_WORDS;
+  outstream.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+
+  std::vector<ChunkEntry> chunks;
+  uint64_t raw_size = 0;
+  unsigned nthreads = num_threads();
+  std::vector<std::vector<uint32_t>> group(nthreads, std::vector<uint32_t>(hdr.chunk_words));
+  while (instream) {
+    std::vector<std::future<std::vector<char>>> packed;
+    std::vector<uint32_t> nwords;
+    for (unsigned i = 0; i < nthreads && instream; i++) {
+      instream.read(reinterpret_cast<char *>(group[i].data()), hdr.chunk_words * sizeof(uint32_t));
+      std::streamsize nbytes = instream.gcount();
+      raw_size += nbytes;
+      if (nbytes % sizeof(uint32_t)) {
+        LOG_ERROR("{}: size is not a multiple of 4 bytes", t_l64_file.string());
+        return 1;
+      }
+      if (nbytes == 0)
+        break;
+      nwords.push_back(nbytes / sizeof(uint32_t));
+      packed.push_back(std::async(std::launch::async, pack_chunk, group[i].data(), nwords.back()));
+    }
+    for (size_t i = 0; i < packed.size(); i++) {
+      std::vector<char> buf = packed[i].get();
+      chunks.push_back({static_cast<uint64_t>(outstream.tellp()), static_cast<uint32_t>(buf.size()), nwords[i]});
+      outstream.write(buf.data(), buf.size());
+    }
+  }
+  hdr.raw_size = raw_size;
+  hdr.num_chunks = chunks.size();
+  hdr.table_offset = outstream.tellp();
+  outstream.write(reinterpret_cast<const char *>(chunks.data()), chunks.size() * sizeof(ChunkEntry));
+  outstream.seekp(0);
+  outstream.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  if (!outstream.good()) {
+    LOG_ERROR("Error writing packed listmode file {}", t_l64z_file.string());
+    return 1;
+  }
+  LOG_INFO("Packed {} to {}: {} bytes, listmode {} bytes", t_l64_file.string(), t_l64z_file.string(),
+           hdr.table_offset + chunks.size() * sizeof(ChunkEntry), raw_size);
+  return 0;
+}
+
+bool lm_pack::is_packed(bf::path const &t_file) {
+  std::ifstream instream(t_file.string(), std::ios::in | std::ios::binary);
+  FileHeader hdr;
+  return instream.is_open() && read_header(instream, hdr);
+}
+
+bf::path lm_pack::packed_path(bf::path const &t_l64_file) {
+  return bf::path(t_l64_file).replace_extension(".l64z");
+}
+
+LMPackReader::LMPackReader() : chunk_words_(0), raw_size_(0), next_chunk_(0), pos_(0), num_threads_(num_threads()), fail_(false) {
+}
+
+LMPackReader::~LMPackReader() {
+  drain_queue();
+}
+
+int LMPackReader::open(bf::path const &t_l64z_file) {
+  close();
+  if (hrrt_util::open_istream(instream_, t_l64z_file, std::ios::in | std::ios::binary))
+    return 1;
+  FileHeader hdr;
+  if (!read_header(instream_, hdr)) {
+    LOG_ERROR("{} is not a version {} packed listmode file", t_l64z_file.string(), lm_pack::VERSION);
+    instream_.close();
+    return 1;
+  }
+  chunks_.resize(hdr.num_chunks);
+  instream_.seekg(hdr.table_offset);
+  instream_.read(reinterpret_cast<char *>(chunks_.data()), chunks_.size() * sizeof(lm_pack::ChunkEntry));
+  if (!instream_.good()) {
+    LOG_ERROR("Error reading chunk table of {}", t_l64z_file.string());
+    instream_.close();
+    return 1;
+  }
+  chunk_words_ = hdr.chunk_words;
+  raw_size_ = hdr.raw_size;
+  return seek(0);
+}
+
+void LMPackReader::close() {
+  drain_queue();
+  if (instream_.is_open())
+    instream_.close();
+  chunks_.clear();
+  current_.clear();
+  next_chunk_ = pos_ = 0;
+  fail_ = false;
+}
+
+// Queue the next chunks for unpacking, one per thread.  Packed data is read here, sequentially.
+void LMPackReader::fill_queue() {
+  while (queue_.size() < num_threads_ && next_chunk_ < chunks_.size()) {
+    lm_pack::ChunkEntry const &chunk = chunks_[next_chunk_++];
+    std::vector<char> data(chunk.packed_size);
+    instream_.clear();
+    instream_.seekg(chunk.offset);
+    instream_.read(data.data(), data.size());
+    if (!instream_.good()) {
+      LOG_ERROR("Error reading packed listmode chunk at {}", chunk.offset);
+      data.clear();
+    }
+    uint32_t nwords = chunk.raw_words;
+    queue_.push_back(std::async(std::launch::async, [nwords](std::vector<char> t_data) {
+      std::vector<uint32_t> words(nwords);
+      if (t_data.empty() || lm_pack::unpack_chunk(t_data.data(), t_data.size(), words.data(), nwords))
+        words.clear();
+      return words;
+    }, std::move(data)));
+  }
+}
+
+void LMPackReader::drain_queue() {
+  for (auto &chunk : queue_)
+    chunk.wait();
+  queue_.clear();
+}
+
+size_t LMPackReader::read(char *t_buf, size_t t_nbytes) {
+  size_t nread = 0;
+  while (nread < t_nbytes && !fail_) {
+    size_t avail = current_.size() * sizeof(uint32_t) - pos_;
+    if (avail == 0) {
+      fill_queue();
+      if (queue_.empty())
+        break;
+      current_ = queue_.front().get();
+      queue_.pop_front();
+      fill_queue();
+      pos_ = 0;
+      if (current_.empty()) {
+        LOG_ERROR("Error unpacking listmode chunk {}", next_chunk_ - queue_.size() - 1);
+        fail_ = true;
+      }
+      continue;
+    }
+    size_t n = std::min(avail, t_nbytes - nread);
+    memcpy(t_buf + nread, reinterpret_cast<const char *>(current_.data()) + pos_, n);
+    pos_ += n;
+    nread += n;
+  }
+  return nread;
+}
+
+int LMPackReader::seek(uint64_t t_offset) {
+  uint64_t chunk_bytes = static_cast<uint64_t>(chunk_words_) * sizeof(uint32_t);
+  if (!is_open() || (t_offset > raw_size_) || (t_offset % sizeof(uint32_t)))
+    return 1;
+  drain_queue();
+  current_.clear();
+  pos_ = 0;
+  fail_ = false;
+  next_chunk_ = t_offset / chunk_bytes;
+  uint64_t skip = t_offset % chunk_bytes;
+  if (skip > 0) {
+    std::vector<char> buf(skip);
+    if (read(buf.data(), skip) != skip)
+      return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,81 @@
+// lm_pack.hpp
+// Lossless packed format of HRRT 64-bit listmode files (foo.l64 -> foo.l64z).
+//
+// The listmode words are cut in chunks of a fixed number of words that are packed independently,
+// so that chunks are packed and unpacked in parallel.  Coincidence events are packed to 5 bytes
+// (crystal indices, module pair, DOI and prompt flag), time tags are coded as the difference with
+// the previous time tag of the chunk, and other words are stored as they are.  Unpacking gives
+// the original file byte for byte, including sync words and invalid events.
+// A table of chunk offsets at the end of the file allows LMPackReader to start at any raw offset,
+// e.g. a time tag offset from the listmode time index.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+namespace lm_pack {
+
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t DEFAULT_CHUNK_WORDS = 2 * 1024 * 1024;  // 1M 64-bit events, one lmhistogram packet
+
+struct ChunkEntry {
+  uint64_t offset;       // byte offset of the packed chunk in the packed file
+  uint32_t packed_size;  // packed chunk size in bytes
+  uint32_t raw_words;    // 32-bit words in the chunk
+};
+
+// Pack t_nwords listmode words; the chunk is unpacked by unpack_chunk() on its own
+std::vector<char> pack_chunk(const uint32_t *t_words, uint32_t t_nwords);
+// Unpack a chunk into t_nwords words.  Returns 0 on success.
+int unpack_chunk(const char *t_data, size_t t_size, uint32_t *t_words, uint32_t t_nwords);
+
+// Pack a listmode file into t_l64z_file.  Returns 0 on success.
+int pack(boost::filesystem::path const &t_l64_file, boost::filesystem::path const &t_l64z_file,
+         uint32_t t_chunk_words = DEFAULT_CHUNK_WORDS);
+// True if t_file is a packed listmode file
+bool is_packed(boost::filesystem::path const &t_file);
+// Packed file name of a listmode file
+boost::filesystem::path packed_path(boost::filesystem::path const &t_l64_file);
+
+}  // namespace lm_pack
+
+// Sequential reader of packed listmode files with the interface of an istream read().
+// The next chunks are unpacked in background while the current one is consumed.
+class LMPackReader {
+public:
+  LMPackReader();
+  ~LMPackReader();
+
+  // Open packed file.  Returns 0 on success.
+  int open(boost::filesystem::path const &t_l64z_file);
+  void close();
+  bool is_open() const { return instream_.is_open(); }
+  // Read up to t_nbytes of listmode data; returns the number of bytes read, 0 at end of data or on error
+  size_t read(char *t_buf, size_t t_nbytes);
+  // Position at raw listmode byte offset t_offset, a multiple of 4.  Returns 0 on success.
+  int seek(uint64_t t_offset);
+  // Unpacking or reading error
+  bool fail() const { return fail_; }
+  // Size of the listmode data in bytes
+  uint64_t raw_size() const { return raw_size_; }
+
+private:
+  void fill_queue();
+  void drain_queue();
+
+  std::ifstream instream_;
+  uint32_t chunk_words_;
+  uint64_t raw_size_;
+  std::vector<lm_pack::ChunkEntry> chunks_;
+  size_t next_chunk_;                                     // next chunk to queue
+  std::deque<std::future<std::vector<uint32_t>>> queue_;  // chunks being unpacked
+  std::vector<uint32_t> current_;                         // current chunk
+  size_t pos_;                                            // byte position in current chunk
+  unsigned num_threads_;
+  bool fail_;
+};
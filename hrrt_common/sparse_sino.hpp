@@ -0,0 +1,244 @@
+// sparse_sino.hpp
+// Sparse container for integer sinograms.
+//
+// Low count dynamic frames are mostly zeros; the sparse container stores each sinogram plane
+// as runs of zero bins and runs of nonzero bins, with nonzero values as zigzag varints, so that
+// a typical count of 0..127 takes one byte.  A table of plane offsets after the file header
+// allows random access to planes.  Readers recognize the container from its magic number, so
+// sparse and dense sinograms can be given to the same programs.
+//
+// A file may hold several containers, one after the other, like frames appended to a dense
+// sinogram file.  It reads as the concatenation of their dense sinograms: bin t_first of
+// read_bins() counts from the first bin of the first container.
+//
+// Container layout (native byte order):
+//   FileHeader
+//   (num_planes + 1) * uint64_t   byte offset of each plane from the start of the container,
+//                                 last one is the end of the container
+//   plane data                    { varint zeros, varint count, count * zigzag varint } ...
+//
+// Header only, so that lmhistogram_mp, hrrt_osem3d and e7_tools need no extra library.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace sparse_sino {
+
+constexpr char MAGIC[8] = "HRRTSPS";
+constexpr uint32_t VERSION = 1;
+
+struct FileHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t elem_size;   // size in bytes of the dense sinogram elements
+  uint32_t plane_size;  // bins per plane
+  uint32_t num_planes;
+};
+
+namespace detail {
+
+inline void put_varint(std::vector<char> &t_buf, uint32_t t_val) {
+  while (t_val >= 0x80) {
+    t_buf.push_back(static_cast<char>((t_val & 0x7f) | 0x80));
+    t_val >>= 7;
+  }
+  t_buf.push_back(static_cast<char>(t_val));
+}
+
+inline uint32_t get_varint(const unsigned char *&t_ptr, const unsigned char *t_end) {
+  uint32_t val = 0;
+  for (int shift = 0; t_ptr < t_end && shift < 35; shift += 7) {
+    unsigned char b = *t_ptr++;
+    val |= static_cast<uint32_t>(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      break;
+  }
+  return val;
+}
+
+inline uint32_t zigzag(int32_t t_val) {
+  return (static_cast<uint32_t>(t_val) << 1) ^ static_cast<uint32_t>(t_val >> 31);
+}
+
+inline int32_t unzigzag(uint32_t t_val) {
+  return static_cast<int32_t>(t_val >> 1) ^ -static_cast<int32_t>(t_val & 1);
+}
+
+// Decode one plane into t_out; returns false if the plane data is inconsistent
+template <typename T>
+bool decode_plane(const unsigned char *t_ptr, const unsigned char *t_end, uint32_t t_plane_size, T *t_out) {
+  uint32_t pos = 0;
+  while (pos < t_plane_size && t_ptr < t_end) {
+    uint32_t zeros = get_varint(t_ptr, t_end);
+    uint32_t count = get_varint(t_ptr, t_end);
+    if (zeros > t_plane_size - pos || count > t_plane_size - pos - zeros)
+      return false;
+    std::memset(t_out + pos, 0, zeros * sizeof(T));
+    pos += zeros;
+    for (uint32_t i = 0; i < count; i++)
+      t_out[pos++] = static_cast<T>(unzigzag(get_varint(t_ptr, t_end)));
+  }
+  return pos == t_plane_size;
+}
+
+// Header of the container starting at byte t_pos and the byte position of its end.
+// Returns false if there is no valid container at t_pos.
+inline bool read_container(FILE *t_fp, uint64_t t_pos, FileHeader &t_hdr, uint64_t &t_end) {
+  uint64_t size;
+  if (fseeko(t_fp, t_pos, SEEK_SET) != 0 || fread(&t_hdr, sizeof(t_hdr), 1, t_fp) != 1 ||
+      std::memcmp(t_hdr.magic, MAGIC, sizeof(t_hdr.magic)) != 0 || t_hdr.version != VERSION ||
+      t_hdr.plane_size == 0)
+    return false;
+  if (fseeko(t_fp, t_pos + sizeof(FileHeader) + static_cast<uint64_t>(t_hdr.num_planes) * sizeof(uint64_t), SEEK_SET) != 0 ||
+      fread(&size, sizeof(size), 1, t_fp) != 1 || size <= sizeof(FileHeader))
+    return false;
+  t_end = t_pos + size;
+  return true;
+}
+
+// Decode t_count bins starting at bin t_first of the container at byte t_pos.  Returns 0 on success.
+template <typename T>
+int read_container_bins(FILE *t_fp, uint64_t t_pos, FileHeader const &t_hdr, uint64_t t_first, uint64_t t_count,
+                        T *t_out) {
+  uint64_t first_plane = t_first / t_hdr.plane_size;
+  uint64_t last_plane = (t_first + t_count + t_hdr.plane_size - 1) / t_hdr.plane_size;
+  if (last_plane > t_hdr.num_planes)
+    return 1;
+  std::vector<uint64_t> offsets(last_plane - first_plane + 1);
+  if (fseeko(t_fp, t_pos + sizeof(FileHeader) + first_plane * sizeof(uint64_t), SEEK_SET) != 0 ||
+      fread(offsets.data(), sizeof(uint64_t), offsets.size(), t_fp) != offsets.size())
+    return 1;
+  std::vector<unsigned char> data(offsets.back() - offsets.front());
+  if (fseeko(t_fp, t_pos + offsets.front(), SEEK_SET) != 0 || fread(data.data(), 1, data.size(), t_fp) != data.size())
+    return 1;
+
+  std::vector<T> plane_buf;
+  uint64_t pos = t_first;
+  for (uint64_t plane = first_plane; plane < last_plane; plane++) {
+    const unsigned char *ptr = data.data() + (offsets[plane - first_plane] - offsets.front());
+    const unsigned char *end = data.data() + (offsets[plane - first_plane + 1] - offsets.front());
+    uint64_t plane_start = plane * t_hdr.plane_size;
+    uint64_t skip = pos - plane_start;
+    uint64_t n = std::min<uint64_t>(t_hdr.plane_size - skip, t_first + t_count - pos);
+    if (skip == 0 && n == t_hdr.plane_size) {
+      if (!decode_plane(ptr, end, t_hdr.plane_size, t_out + (pos - t_first)))
+        return 1;
+    } else {
+      // Partial plane: decode into scratch buffer
+      plane_buf.resize(t_hdr.plane_size);
+      if (!decode_plane(ptr, end, t_hdr.plane_size, plane_buf.data()))
+        return 1;
+      std::memcpy(t_out + (pos - t_first), plane_buf.data() + skip, n * sizeof(T));
+    }
+    pos += n;
+  }
+  return 0;
+}
+
+}  // namespace detail
+
+// Encode a dense sinogram of t_num_planes planes; returns the container file contents
+template <typename T>
+std::vector<char> encode(const T *t_data, uint32_t t_plane_size, uint32_t t_num_planes) {
+  FileHeader hdr;
+  std::memcpy(hdr.magic, MAGIC, sizeof(hdr.magic));
+  hdr.version    = VERSION;
+  hdr.elem_size  = sizeof(T);
+  hdr.plane_size = t_plane_size;
+  hdr.num_planes = t_num_planes;
+
+  size_t table_pos = sizeof(FileHeader);
+  std::vector<char> buf(table_pos + (t_num_planes + 1) * sizeof(uint64_t));
+  std::memcpy(buf.data(), &hdr, sizeof(hdr));
+  std::vector<uint64_t> offsets(t_num_planes + 1);
+  for (uint32_t plane = 0; plane < t_num_planes; plane++) {
+    const T *p = t_data + static_cast<size_t>(plane) * t_plane_size;
+    offsets[plane] = buf.size();
+    uint32_t pos = 0;
+    while (pos < t_plane_size) {
+      uint32_t start = pos;
+      while (pos < t_plane_size && p[pos] == 0)
+        pos++;
+      uint32_t first = pos;
+      while (pos < t_plane_size && p[pos] != 0)
+        pos++;
+      detail::put_varint(buf, first - start);
+      detail::put_varint(buf, pos - first);
+      for (uint32_t i = first; i < pos; i++)
+        detail::put_varint(buf, detail::zigzag(static_cast<int32_t>(p[i])));
+    }
+  }
+  offsets[t_num_planes] = buf.size();
+  std::memcpy(buf.data() + table_pos, offsets.data(), offsets.size() * sizeof(uint64_t));
+  return buf;
+}
+
+// Read the header of a sparse sinogram; returns false if t_fp is not a sparse sinogram
+inline bool read_header(FILE *t_fp, FileHeader &t_hdr) {
+  if (t_fp == nullptr || fseeko(t_fp, 0, SEEK_SET) != 0)
+    return false;
+  bool ok = (fread(&t_hdr, sizeof(t_hdr), 1, t_fp) == 1) &&
+            (std::memcmp(t_hdr.magic, MAGIC, sizeof(t_hdr.magic)) == 0) && (t_hdr.version == VERSION);
+  fseeko(t_fp, 0, SEEK_SET);
+  return ok;
+}
+
+inline bool is_sparse(FILE *t_fp) {
+  FileHeader hdr;
+  return read_header(t_fp, hdr);
+}
+
+inline bool is_sparse(const char *t_filename) {
+  FILE *fp = fopen(t_filename, "rb");
+  if (fp == nullptr)
+    return false;
+  bool sparse = is_sparse(fp);
+  fclose(fp);
+  return sparse;
+}
+
+// Decode t_count bins starting at bin t_first of the dense sinogram into t_out.
+// The bins may span several containers of the file.  Returns 0 on success, 1 on error.
+template <typename T>
+int read_bins(FILE *t_fp, uint64_t t_first, uint64_t t_count, T *t_out) {
+  FileHeader hdr;
+  uint64_t pos = 0, end;
+  if (t_fp == nullptr || !detail::read_container(t_fp, pos, hdr, end))
+    return 1;
+  while (t_count > 0) {
+    uint64_t size = static_cast<uint64_t>(hdr.plane_size) * hdr.num_planes;
+    if (t_first < size) {
+      uint64_t n = std::min(t_count, size - t_first);
+      if (detail::read_container_bins(t_fp, pos, hdr, t_first, n, t_out))
+        return 1;
+      t_out += n;
+      t_count -= n;
+      t_first = 0;
+    } else {
+      t_first -= size;
+    }
+    pos = end;
+    if (t_count > 0 && !detail::read_container(t_fp, pos, hdr, end))
+      return 1;
+  }
+  return 0;
+}
+
+// Size of the dense sinogram in bins, summed over the containers of the file;
+// 0 if t_fp is not a sparse sinogram
+inline uint64_t dense_size(FILE *t_fp) {
+  FileHeader hdr;
+  uint64_t pos = 0, end, size = 0;
+  while (t_fp != nullptr && detail::read_container(t_fp, pos, hdr, end)) {
+    size += static_cast<uint64_t>(hdr.plane_size) * hdr.num_planes;
+    pos = end;
+  }
+  return size;
+}
+
+}  // namespace sparse_sino
@@ -6,6 +6,11 @@
 #include "my_spdlog.hpp"
 #include "hrrt_util.hpp"
 #include "date_time.hpp"
+#include "lm_index.hpp"
+#include "lm_pack.hpp"
+#include "sparse_sino.hpp"
+#include "lm_events.hpp"
+#include "half_float.hpp"
 #include "boost/date_time/gregorian/gregorian.hpp"
 #include "boost/date_time/posix_time/posix_time.hpp"
 #include "catch.hpp"
@@ -93,4 +98,356 @@ TEST_CASE("Extrema", "[classic]") {
     REQUIRE(hrrt_util::test_find_extrema(floats));
     REQUIRE(hrrt_util::test_find_extrema(chars));
   }
-}
\ No newline at end of file
+}
+
+// 64-bit listmode events: top bits of the two words select the event type
+void AddTag(std::vector<uint32_t> &t_words, uint32_t t_tag) {
+  t_words.push_back(0x40000000 | (t_tag & 0xffff));
+  t_words.push_back(0x80000000 | (t_tag >> 16));
+}
+
+void AddEvent(std::vector<uint32_t> &t_words, bool t_prompt) {
+  t_words.push_back(0);
+  t_words.push_back(t_prompt ? 0xc0000000 : 0x80000000);
+}
+
+// Time tag every msec with 3 prompts and 1 delayed, clock reset after t_reset msec
+std::vector<uint32_t> MakeListmode(int t_reset, int t_duration) {
+  std::vector<uint32_t> words;
+  for (int t = 0; t < t_duration; t++) {
+    AddTag(words, 0x80000000 | (t < t_reset ? t : t - t_reset));
+    if (t % 1000 == 200)
+      AddTag(words, 0xA0000000 | (5 << 19) | 300);
+    if (t % 1000 == 500) {
+      AddTag(words, 0xA0000000 | (5 << 19) | 100);
+      words.push_back(0);  // sync word
+    }
+    AddEvent(words, true);
+    AddEvent(words, true);
+    AddEvent(words, false);
+    AddEvent(words, true);
+  }
+  return words;
+}
+
+TEST_CASE("LMIndex", "[classic]") {
+  my_spdlog::init_logging("hrrt_common_tests");
+  boost::filesystem::path l64_file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%%%%%.l64");
+  std::vector<uint32_t> words = MakeListmode(3000, 5000);
+  std::ofstream outstream(l64_file.string(), std::ios::out | std::ios::binary);
+  outstream.write(reinterpret_cast<char *>(words.data()), words.size() * sizeof(uint32_t));
+  outstream.close();
+
+  SECTION("Build and look up") {
+    LMIndex index;
+    REQUIRE(index.build(l64_file) == 0);
+    REQUIRE(index.entries().size() == 5);
+    LMIndex::Entry const &e2 = index.entries()[2];
+    REQUIRE(e2.time == 2000);
+    REQUIRE(e2.prompts == 2000 * 3);
+    REQUIRE(e2.delayed == 2000);
+    REQUIRE(e2.singles == 100);
+    REQUIRE(e2.singles_rate == 200);
+    REQUIRE(words[e2.offset / sizeof(uint32_t)] == (0x40000000 | 2000));
+    // Lookups only see the data after the clock reset
+    REQUIRE(index.find_time(1500)->time == 1000);
+    REQUIRE(index.find_time(1500) == &index.entries()[4]);
+    REQUIRE(index.find_end(500)->time == 1000);
+    REQUIRE(index.find_end(1500) == nullptr);
+    REQUIRE(index.find_countrate(2000) == &index.entries()[3]);
+    REQUIRE(index.find_countrate(2001) == nullptr);
+  }
+
+  SECTION("Sidecar file") {
+    LMIndex index, copy;
+    REQUIRE(index.read_or_build(l64_file) == 0);
+    REQUIRE(copy.read(LMIndex::index_path(l64_file), l64_file) == 0);
+    REQUIRE(copy.entries().size() == index.entries().size());
+    REQUIRE(copy.entries()[4].offset == index.entries()[4].offset);
+    // Listmode file changed: index is out of date
+    outstream.open(l64_file.string(), std::ios::out | std::ios::app | std::ios::binary);
+    outstream.write(reinterpret_cast<char *>(words.data()), 2 * sizeof(uint32_t));
+    outstream.close();
+    REQUIRE(copy.read(LMIndex::index_path(l64_file), l64_file) != 0);
+    boost::filesystem::remove(LMIndex::index_path(l64_file));
+  }
+  boost::filesystem::remove(l64_file);
+}
+
+TEST_CASE("LMPack", "[classic]") {
+  my_spdlog::init_logging("hrrt_common_tests");
+  namespace bf = boost::filesystem;
+  bf::path l64_file = bf::temp_directory_path() / bf::unique_path("%%%%%%%%.l64");
+  bf::path l64z_file = lm_pack::packed_path(l64_file);
+  std::vector<uint32_t> words = MakeListmode(3000, 5000);
+  // Coincidences with crystals, modules and DOI, an out of range crystal and an odd last word
+  for (uint32_t i = 0; i < 1000; i++) {
+    words.push_back((i % 72) | ((i % 104) << 8) | ((i % 8) << 16) | ((i % 2) << 22));
+    words.push_back(0xc0000000 | ((i * 7) % 72) | (((i * 3) % 104) << 8) | (((i + 3) % 8) << 16) | (7 << 22));
+  }
+  words.push_back(200);
+  words.push_back(0xc0000000);
+  words.push_back(0x12345678);
+  std::ofstream outstream(l64_file.string(), std::ios::out | std::ios::binary);
+  outstream.write(reinterpret_cast<char *>(words.data()), words.size() * sizeof(uint32_t));
+  outstream.close();
+  // Odd chunk size: chunks start in the middle of events
+  REQUIRE(lm_pack::pack(l64_file, l64z_file, 1001) == 0);
+  REQUIRE(lm_pack::is_packed(l64z_file));
+  REQUIRE(!lm_pack::is_packed(l64_file));
+  REQUIRE(bf::file_size(l64z_file) < bf::file_size(l64_file) * 2 / 3);
+
+  SECTION("Read back") {
+    LMPackReader reader;
+    REQUIRE(reader.open(l64z_file) == 0);
+    REQUIRE(reader.raw_size() == words.size() * sizeof(uint32_t));
+    std::vector<uint32_t> unpacked(words.size() + 10);
+    size_t nbytes = 0, n = 0;
+    while ((n = reader.read(reinterpret_cast<char *>(unpacked.data()) + nbytes, 3000)) > 0)
+      nbytes += n;
+    REQUIRE(!reader.fail());
+    REQUIRE(nbytes == words.size() * sizeof(uint32_t));
+    unpacked.resize(words.size());
+    REQUIRE(unpacked == words);
+    REQUIRE(reader.seek(4 * 2500) == 0);
+    REQUIRE(reader.read(reinterpret_cast<char *>(unpacked.data()), 8) == 8);
+    REQUIRE(unpacked[0] == words[2500]);
+    REQUIRE(unpacked[1] == words[2501]);
+  }
+
+  SECTION("Index of packed file") {
+    LMIndex index, packed_index;
+    REQUIRE(index.build(l64_file) == 0);
+    REQUIRE(packed_index.build(l64z_file) == 0);
+    REQUIRE(packed_index.entries().size() == index.entries().size());
+    REQUIRE(packed_index.entries()[3].offset == index.entries()[3].offset);
+    REQUIRE(packed_index.entries()[3].prompts == index.entries()[3].prompts);
+  }
+  bf::remove(l64_file);
+  bf::remove(l64z_file);
+}
+
+TEST_CASE("SparseSino", "[classic]") {
+  const uint32_t plane_size = 1000, num_planes = 7;
+  std::vector<short> sino(plane_size * num_planes, 0);
+  for (size_t i = 0; i < sino.size(); i += 37)
+    sino[i] = static_cast<short>((i % 3 == 0) ? -(int)(i % 300) : i % 30000);
+  sino[2 * plane_size + 999] = 1;   // last bin of a plane
+  std::fill(sino.begin() + 4 * plane_size, sino.begin() + 5 * plane_size, 0);  // empty plane
+
+  std::vector<char> encoded = sparse_sino::encode(sino.data(), plane_size, num_planes);
+  REQUIRE(encoded.size() < sino.size() * sizeof(short) / 4);
+  FILE *fp = tmpfile();
+  REQUIRE(fp != nullptr);
+  fwrite(encoded.data(), 1, encoded.size(), fp);
+
+  SECTION("Whole sinogram") {
+    REQUIRE(sparse_sino::is_sparse(fp));
+    REQUIRE(sparse_sino::dense_size(fp) == sino.size());
+    std::vector<short> decoded(sino.size(), -1);
+    REQUIRE(sparse_sino::read_bins(fp, 0, decoded.size(), decoded.data()) == 0);
+    REQUIRE(decoded == sino);
+  }
+
+  SECTION("Plane range and partial planes") {
+    std::vector<float> decoded(2500);
+    REQUIRE(sparse_sino::read_bins(fp, 1700, decoded.size(), decoded.data()) == 0);
+    for (size_t i = 0; i < decoded.size(); i++)
+      REQUIRE(decoded[i] == static_cast<float>(sino[1700 + i]));
+    REQUIRE(sparse_sino::read_bins(fp, 6500, 501, decoded.data()) != 0);
+  }
+
+  SECTION("Dense file") {
+    FILE *dense = tmpfile();
+    fwrite(sino.data(), sizeof(short), sino.size(), dense);
+    REQUIRE(!sparse_sino::is_sparse(dense));
+    fclose(dense);
+  }
+
+  SECTION("Frames appended to one file") {
+    // As lmhistogram_mp writes the frames of a dynamic study
+    namespace bf = boost::filesystem;
+    bf::path sino_file = bf::temp_directory_path() / bf::unique_path("%%%%%%%%.s");
+    std::vector<short> frame2(sino.size());
+    for (size_t i = 0; i < frame2.size(); i++)
+      frame2[i] = static_cast<short>(sino[(i + 500) % sino.size()] / 2);
+    std::vector<char> encoded2 = sparse_sino::encode(frame2.data(), plane_size, num_planes);
+    for (std::vector<char> const *frame : {&encoded, &encoded2}) {
+      std::ofstream out(sino_file.string(), std::ios::out | std::ios::app | std::ios::binary);
+      out.write(frame->data(), frame->size());
+    }
+    FILE *appended = fopen(sino_file.string().c_str(), "rb");
+    REQUIRE(sparse_sino::is_sparse(appended));
+    REQUIRE(sparse_sino::dense_size(appended) == 2 * sino.size());
+    std::vector<short> decoded(sino.size(), -1);
+    REQUIRE(sparse_sino::read_bins(appended, 0, decoded.size(), decoded.data()) == 0);
+    REQUIRE(decoded == sino);
+    REQUIRE(sparse_sino::read_bins(appended, sino.size(), decoded.size(), decoded.data()) == 0);
+    REQUIRE(decoded == frame2);
+    // Bins across the end of the first frame
+    REQUIRE(sparse_sino::read_bins(appended, sino.size() - 300, 600, decoded.data()) == 0);
+    REQUIRE(std::equal(sino.end() - 300, sino.end(), decoded.begin()));
+    REQUIRE(std::equal(frame2.begin(), frame2.begin() + 300, decoded.begin() + 300));
+    REQUIRE(sparse_sino::read_bins(appended, 2 * sino.size() - 1, 2, decoded.data()) != 0);
+    fclose(appended);
+    bf::remove(sino_file);
+  }
+  fclose(fp);
+}
+
+TEST_CASE("LMEvents", "[classic]") {
+  namespace bf = boost::filesystem;
+  bf::path lme_file = bf::temp_directory_path() / bf::unique_path("%%%%%%%%.lme");
+  std::vector<uint32_t> events;
+  for (uint32_t i = 0; i < 10000; i++)
+    events.push_back((i * 7919) % 1000003);
+  lm_events::FileHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.nprojs = 256;
+  hdr.nviews = 288;
+  hdr.nplanes = 6367;
+  hdr.duration = 10;
+  REQUIRE(lm_events::write(lme_file.c_str(), hdr, events) == 0);
+
+  lm_events::FileHeader hdr2;
+  std::vector<uint32_t> events2;
+  REQUIRE(lm_events::read(lme_file.c_str(), hdr2, events2) == 0);
+  REQUIRE(hdr2.num_events == events.size());
+  REQUIRE(hdr2.nplanes == 6367);
+  REQUIRE(hdr2.duration == 10);
+  REQUIRE(events2 == events);
+  // Not an event file
+  FILE *fp = fopen(lme_file.c_str(), "r+b");
+  fputc('X', fp);
+  fclose(fp);
+  REQUIRE(lm_events::read(lme_file.c_str(), hdr2, events2) != 0);
+  bf::remove(lme_file);
+}
+
+TEST_CASE("HalfFloat", "[classic]") {
+  using namespace half_float;
+  REQUIRE(float_to_fp16(1.0f) == 0x3c00);
+  REQUIRE(float_to_fp16(-2.0f) == 0xc000);
+  REQUIRE(float_to_fp16(65504.0f) == 0x7bff);
+  REQUIRE(float_to_fp16(65520.0f) == 0x7c00);       // rounds to inf
+  REQUIRE(float_to_fp16(std::ldexp(1.0f, -24)) == 0x0001);  // smallest subnormal
+  REQUIRE(float_to_fp16(1.0f + std::ldexp(1.0f, -11)) == 0x3c00);  // tie to even
+  REQUIRE(float_to_bf16(1.0f) == 0x3f80);
+  REQUIRE(float_to_bf16(1.0f + std::ldexp(1.0f, -8)) == 0x3f80);   // tie to even
+  for (uint32_t h = 0; h < 0x7c00; h++) {
+    REQUIRE(float_to_fp16(fp16_to_float(h)) == h);
+    REQUIRE(float_to_bf16(bf16_to_float(h)) == h);
+  }
+
+  Format format;
+  REQUIRE(parse_format("bf16", format));
+  REQUIRE(format == BF16);
+  REQUIRE(!parse_format("fp8", format));
+
+  // Sensitivity like values over 5 decades, odd length for the scalar tail
+  std::vector<float> src(1003);
+  for (size_t i = 0; i < src.size(); i++)
+    src[i] = 1e-6f * std::pow(10.0f, 5.0f * i / src.size()) * ((i % 7 == 0) ? 0.0f : 1.0f);
+  std::vector<uint16_t> stored(src.size());
+  std::vector<float> dec(src.size());
+  float scale = range_scale(src.data(), src.size());
+  encode(src.data(), stored.data(), src.size(), FP16, scale);
+  decode(stored.data(), dec.data(), src.size(), FP16, 1.0f / scale);
+  REQUIRE(max_rel_error(src.data(), dec.data(), src.size()) <= std::ldexp(1.0, -11));
+  // The vector loops chosen for this CPU round like the scalar conversions
+  for (size_t i = 0; i < src.size(); i++) {
+    REQUIRE(stored[i] == float_to_fp16(src[i] * scale));
+    REQUIRE(dec[i] == fp16_to_float(stored[i]) * (1.0f / scale));
+  }
+  encode(src.data(), stored.data(), src.size(), BF16);
+  decode(stored.data(), dec.data(), src.size(), BF16);
+  REQUIRE(max_rel_error(src.data(), dec.data(), src.size()) <= std::ldexp(1.0, -8));
+  REQUIRE(dec[0] == 0.0f);
+}
+
+// One OSEM iteration of a 2D parallel beam toy scanner, nearest bin projector.
+// t_normfac[s] is the sensitivity image of subset s (angles s, s + nsubsets, ...).
+std::vector<float> OsemIteration(std::vector<float> const &t_image, std::vector<float> const &t_prompt,
+                                 std::vector<float> const &t_factor, std::vector<std::vector<float>> const &t_normfac,
+                                 std::vector<int> const &t_bin, int t_nbins) {
+  std::vector<float> image = t_image;
+  int nsubsets = t_normfac.size();
+  int nangles = t_bin.size() / image.size();
+  std::vector<float> ratio(t_nbins);
+  std::vector<float> back(image.size());
+  for (int s = 0; s < nsubsets; s++) {
+    std::fill(back.begin(), back.end(), 0.0f);
+    for (int a = s; a < nangles; a += nsubsets) {
+      const int *bin = &t_bin[a * image.size()];
+      const float *factor = &t_factor[a * t_nbins];
+      const float *prompt = &t_prompt[a * t_nbins];
+      std::fill(ratio.begin(), ratio.end(), 0.0f);
+      for (size_t v = 0; v < image.size(); v++)
+        ratio[bin[v]] += factor[bin[v]] * image[v];
+      for (int b = 0; b < t_nbins; b++)
+        ratio[b] = (ratio[b] > 0.0f) ? factor[b] * prompt[b] / ratio[b] : 0.0f;
+      for (size_t v = 0; v < image.size(); v++)
+        back[v] += ratio[bin[v]];
+    }
+    for (size_t v = 0; v < image.size(); v++)
+      image[v] = (t_normfac[s][v] > 0.0f) ? image[v] * back[v] / t_normfac[s][v] : 0.0f;
+  }
+  return image;
+}
+
+// Image of one iteration with the normfac stored as fp16 or bf16 (hrrt_osem3d -H) against fp32
+TEST_CASE("HalfFloatOsem", "[classic]") {
+  using namespace half_float;
+  const int nx = 64, nangles = 32, nsubsets = 8, nbins = 91;
+  const float pi = 3.14159265f;
+  std::vector<int> bin(nangles * nx * nx);
+  for (int a = 0; a < nangles; a++) {
+    float c = std::cos(pi * a / nangles), s = std::sin(pi * a / nangles);
+    for (int y = 0; y < nx; y++)
+      for (int x = 0; x < nx; x++)
+        bin[(a * nx + y) * nx + x] = nbins / 2 + std::lround((x - nx / 2 + 0.5f) * c + (y - nx / 2 + 0.5f) * s);
+  }
+  // Normalization times attenuation over 3 decades, phantom of two discs in a uniform disc
+  std::vector<float> factor(nangles * nbins);
+  for (size_t i = 0; i < factor.size(); i++)
+    factor[i] = std::pow(10.0f, -3.0f * ((i * 7919) % 1000) / 1000.0f);
+  std::vector<float> phantom(nx * nx), image(nx * nx);
+  for (int y = 0; y < nx; y++) {
+    for (int x = 0; x < nx; x++) {
+      float r = std::hypot(x - nx / 2 + 0.5f, y - nx / 2 + 0.5f);
+      float r1 = std::hypot(x - 20.0f, y - 28.0f), r2 = std::hypot(x - 42.0f, y - 36.0f);
+      phantom[y * nx + x] = (r < 28.0f) ? 1.0f + 4.0f * (r1 < 6.0f) + 0.8f * (r2 < 4.0f) : 0.0f;
+      image[y * nx + x] = (r < 30.0f) ? 1.0f : 0.0f;
+    }
+  }
+  std::vector<float> prompt(nangles * nbins, 0.0f);
+  for (int a = 0; a < nangles; a++)
+    for (int v = 0; v < nx * nx; v++)
+      prompt[a * nbins + bin[a * nx * nx + v]] += factor[a * nbins + bin[a * nx * nx + v]] * phantom[v];
+  std::vector<std::vector<float>> normfac(nsubsets, std::vector<float>(nx * nx, 0.0f));
+  for (int a = 0; a < nangles; a++)
+    for (int v = 0; v < nx * nx; v++)
+      normfac[a % nsubsets][v] += factor[a * nbins + bin[a * nx * nx + v]];
+
+  std::vector<float> ref = OsemIteration(image, prompt, factor, normfac, bin, nbins);
+  std::vector<uint16_t> stored(nx * nx);
+  for (Format format : {FP16, BF16}) {
+    std::vector<std::vector<float>> dec = normfac;
+    for (int s = 0; s < nsubsets; s++) {
+      // As StoreNormfac() and LoadNormfac() in hrrt_osem3d
+      float scale = (format == FP16) ? range_scale(normfac[s].data(), nx * nx) : 1.0f;
+      encode(normfac[s].data(), stored.data(), nx * nx, format, scale);
+      decode(stored.data(), dec[s].data(), nx * nx, format, 1.0f / scale);
+    }
+    std::vector<float> test = OsemIteration(image, prompt, factor, dec, bin, nbins);
+    double max_err = max_rel_error(ref.data(), test.data(), ref.size());
+    double rms_err = rms_rel_error(ref.data(), test.data(), ref.size());
+    WARN("Normfac as " << format_name(format) << ": image max relative difference " << max_err
+         << ", RMS " << rms_err);
+    // Each subset scales a voxel by its normfac error, at most half an ulp, and the next forward
+    // projection carries it along: allow one ulp per subset
+    double ulp = std::ldexp(1.0, (format == FP16) ? -10 : -7);
+    REQUIRE(max_err <= nsubsets * ulp);
+    REQUIRE(rms_err <= ulp);
+  }
+}
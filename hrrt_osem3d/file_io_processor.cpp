@@ -14,6 +14,7 @@ For commercial use, please contact zcho@gachon.ac.kr or isslhong@kpu.ac.kr
              writing volume for cluster nodes doesn't work (MS)
   12-May-09: Use same code for linux and WIN32
   09-DEC-2009: Restore -X 128 option (MS)
+  19-OCT-2026: Read true and prompt sinograms in sparse format (hrrt_common/sparse_sino.hpp)
 */
 
 #include <malloc.h>
@@ -24,6 +25,7 @@ For commercial use, please contact zcho@gachon.ac.kr or isslhong@kpu.ac.kr
 #include "scanner_model.h"
 #include "hrrt_osem3d.h"
 #include "nr_utils.h"
+#include "hrrt_common/sparse_sino.hpp"
 /* Rebin original sinogram to reconstruction size */
 template <typename T> 
 void sino_rebin(T *tmp_buf, T *out_buf, int planes, int norm_flag)
@@ -203,12 +205,20 @@ int read_flat_short_proj_ori_to_float_array_theta(FILE *fp, float *prj,int theta
 
 	//    if (verbose & 0x0010) LOG_INFO(" Read short projection 2 float at theta = %d\t offset =%d\n",theta,offset);
 
-	if( (fseek(fp,offset,SEEK_SET)) != 0) {
-		LOG_ERROR("  Read flat short projection 2 float: fseek problem \n");
-		return 0;
+	if (sparse_sino::is_sparse(fp)) {
+		if (sparse_sino::read_bins(fp, offset/sizeof(short), ds_size, ds_tmp)) {
+			LOG_ERROR("  Read flat short projection 2 float: sparse sinogram read problem \n");
+			free(ds_tmp);
+			return 0;
+		}
+	} else {
+		if( (fseek(fp,offset,SEEK_SET)) != 0) {
+			LOG_ERROR("  Read flat short projection 2 float: fseek problem \n");
+			return 0;
+		}
+		fread(ds_tmp,sizeof(short),ds_size,fp);
 	}
 	curptr=0;
-	fread(ds_tmp,sizeof(short),ds_size,fp);
 	if (x_rebin*v_rebin==1) for(i=0;i<ds_size;i++) prj[i]=ds_tmp[i];
   else sino_rebin_float(ds_tmp, prj, yr_top[theta]-yr_bottom[theta]+1);
 	//for(i=0;i<(yr_top[theta]-yr_bottom[theta]+1);i++, curptr+=views*xr_pixels){
@@ -234,6 +244,26 @@ int read_flat_short_proj_ori_to_short_array_theta(FILE *fp, short *prj,int theta
 	else if(theta%2==0) theta--;
 	offset = (seg_offset[theta])*sizeof(short)*x_rebin*v_rebin;
 	//    if (verbose & 0x0010) LOG_INFO(" Read short projection 2 short at theta = %d\t offset = %d\n",theta,offset);
+	if (sparse_sino::is_sparse(fp)) {
+		// decode all planes of the segment, then rebin
+		int nplanes=yr_top[theta]-yr_bottom[theta]+1;
+		int count=xr_pixels*x_rebin*views*v_rebin;
+		short *buf = (x_rebin*v_rebin == 1) ? prj : (short*)calloc((size_t)nplanes*count, sizeof(short));
+		if (buf==NULL) {
+			LOG_ERROR("  Read flat short projection: memory allocation failure \n");
+			return 0;
+		}
+		if (sparse_sino::read_bins(fp, offset/sizeof(short), (uint64_t)nplanes*count, buf)) {
+			LOG_ERROR("  Read flat short projection 2 short: sparse sinogram read problem \n");
+			if (buf != prj) free(buf);
+			return 0;
+		}
+		if (buf != prj) {
+			for(i=0;i<nplanes;i++) sino_rebin(buf+(size_t)i*count, &prj[i*views*xr_pixels], 1, 0);
+			free(buf);
+		}
+		return 1;
+	}
 	if( (fseek(fp,offset,SEEK_SET)) != 0) {
 		LOG_EXIT("  Read flat short projection 2 short: fseek problem \n");
 	}
@@ -127,6 +127,19 @@ Version Inki4 - 13 Oct 2006
 - 23-Nov-2009: Bug fix in CalculateNormfac()
 - 09-DEC-2009: Restore -X 128 option (MS)
                Enable -k option to skip segment end planes
+- 19-OCT-2026: Add -l option: listmode OSEM of low count frames from the prompt events
+               written by lmhistogram_mp --lm_events (lm_osem.cpp)
+- 19-OCT-2026: Add -r relaxed OSEM, -x momentum between iterations and -E stopping tolerance
+               on the relative image change of an iteration
+- 19-OCT-2026: Add -J option: dynamic frames reconstructed by forked worker processes that
+               share geometry and normfac, within a memory budget.  Attenuation and scatter
+               files are reopened for each frame.
+- 19-OCT-2026: -J workers share the normalization and attenuation files, read before the fork;
+               workers times -T threads limited to the number of processors
+- 19-OCT-2026: Add -H option: normfac kept in memory as fp16 or bf16 (hrrt_common/half_float.hpp),
+               decoded to float for the update of each subset.
+- 19-OCT-2026: -H: the OSEM update decodes the normfac row by row; fp16 conversions chosen at
+               run time (F16C, AVX-512F)
 */
 
 
@@ -158,6 +171,8 @@ For commercial use, please contact zcho@gachon.ac.kr or isslhong@kpu.ac.kr
 #include <time.h>
 #include <xmmintrin.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
 /* ahc */
 #include <linux/types.h>
 #include <linux/stat.h>
@@ -174,6 +189,8 @@ For commercial use, please contact zcho@gachon.ac.kr or isslhong@kpu.ac.kr
 #include <gen_delays_lib/segment_info.h>
 #include "my_spdlog.hpp"
 #include "hrrt_osem_utils.hpp"
+#include "lm_osem.h"
+#include "hrrt_common/half_float.hpp"
 
 #ifndef NO_ECAT_SUPPORT
 #include "write_ecat_image.h"
@@ -277,6 +294,15 @@ float rel_fov = (float) 0.95;
   bool o3Flag=0;      /* not does output scan(3D)     */
   bool tFlag=0;       /* not use true sinogram file   */
   bool pFlag=0;       /* not use prompt sinogram file */
+  char *lm_events_file=NULL;
+  bool lmFlag=0;      /* listmode reconstruction from prompt events */
+  float relax_lambda0=1.0f; /* relaxed OSEM: update of iteration k scaled by relax_lambda0/(1+relax_gamma*k) */
+  float relax_gamma=0.0f;
+  bool momentumFlag=0;      /* Nesterov momentum between iterations */
+  float stop_tol=0.0f;      /* stop when the relative image change of an iteration is below stop_tol */
+  int frame_workers=1;      /* processes reconstructing dynamic frames in parallel */
+  float frame_budget_mb=0;  /* memory budget of the frame workers in MB, 0 for none */
+  half_float::Format normfac_format=half_float::FP32; /* storage of the in memory normfac */
   bool chFlag=0;      /* smoothed randoms flag, true for .ch file */
   bool nFlag=0;       /* not use normalize file       */
   bool inflipFlag=0;  /* controls flipping of input image */
@@ -351,6 +377,9 @@ float    ***gradient=NULL;
 float    ***laplacian=NULL;
 float    sum_normfac=0;
 float    sum_image=0;
+float    ***image_prev=NULL;    /* image of the previous iteration, for -x and -E */
+float    relax_lambda=1.0f;     /* relaxation of the current iteration */
+int      iterations_done=0;     /* less than iterations when -E stopped the reconstruction */
 
 
 float    **unitprj=NULL;
@@ -361,6 +390,13 @@ float ****prjxyf_thread=NULL;
 float ****imagexyzf_thread=NULL;
 float   ****normfac_infile=NULL;
 float   ****normfac_infile_negml=NULL;
+uint16_t **normfac_infile_half=NULL;  /* normfac_infile in normfac_format, [subsets][image] */
+float   *normfac_half_scale=NULL;     /* power of two scale of each stored subset */
+float   ***normfac_half_store=NULL;   /* subset normfac before it is stored */
+float   ***normfac_half_load=NULL;    /* subset normfac decoded for the update */
+uint16_t *normfac_half_rows=NULL;     /* subset normfac decoded row by row in pt_cal_updateimage */
+float   normfac_half_rows_scale=1.0f; /* its scale */
+double  normfac_half_err=0;           /* largest relative error of the stored normfac */
 float   ***estimate_thread=NULL;
 char    ***imagemask=NULL;
 int globalview;
@@ -396,6 +432,15 @@ typedef struct {
   char *prompt_file;
   bool pFlag;
   char *delayed_file;
+  char *lm_events_file;
+  bool lmFlag;
+  float relax_lambda0;
+  float relax_gamma;
+  bool momentumFlag;
+  float stop_tol;
+  int frame_workers;
+  float frame_budget_mb;
+  half_float::Format normfac_format;
   char *norm_file;
   bool nFlag;
   char *atten_file;
@@ -470,6 +515,9 @@ void update_estimate_w3_swap2(float **estimate,float **prj,short **prjshort,floa
 void update_estimate_negml(float **estimate,int view,int nplanes,int xr_pixels,int nthreads);
 void update_estimate_logml(float **estimate,int view,int nplanes,int xr_pixels,int nthreads);
 void update_estimate_logml_ratio(float **estimate,int view,int nplanes,int xr_pixels,int nthreads);
+float ***NormfacStoreBuf(int isubset);
+void StoreNormfac(int isubset);
+float ***LoadNormfac(int isubset, bool t_rows=false);
 
 
 static void usage() {
@@ -485,11 +533,13 @@ static void usage() {
   fprintf (stdout,"  -p  3D_flat_integer_scan (prompt)\n");
   fprintf (stdout,"  -d  3D_flat_float_scan (smoothed un-normalized delayed)) or coinc_histogram (.ch)\n");
   fprintf (stdout,"  -D  Working directory for normfac.i (when applicable)\n");
+  fprintf (stdout,"  -l  listmode events (lmhistogram_mp --lm_events), requires -p -d and -W 3\n");
   LOG_ERROR(""  -P  Flag: input scan is pre-corrected (i.e. float rather than integer format) [not set]");
   LOG_ERROR(""  -Q  Flag: input scan is float but is not pre-corrected [not set]\n");
   LOG_ERROR(""  -R  Flag: input scan is 4-bytes integer [not set]\n");
   fprintf (stdout,"  -F  input_flip, output_flip flag, 0/1  no/yes, [0,0]");
   fprintf (stdout,"  -N  normfac.i will be in memory if there is enough memory. If it is slower with this option, don't use it\n");
+  fprintf (stdout,"  -H  fp16|bf16: normfac in memory (implies -N) with 16 bit values, half the memory of float [fp32]\n");
   fprintf (stdout,"  -n  3D_flat_normalisation");
   fprintf (stdout,"  -a  3D_flat_attenuation");
   fprintf (stdout,"  -i  initial image in flat format default is 1 in FOV specified by -f");
@@ -503,6 +553,9 @@ static void usage() {
   fprintf (stdout,"  -S  number of subsets; [16]");
   fprintf (stdout,"  -I  number of iterations; [1] ");
   fprintf (stdout,"  -W  weighting method (0=UWO3D, 1=AWO3D, 2=ANWO3D, 3=OPO3D) [2]\n");
+  fprintf (stdout,"  -r  relaxed OSEM lambda0[,gamma]: update of iteration k scaled by lambda0/(1+gamma*k) [1,0]\n");
+  fprintf (stdout,"  -x  Flag: Nesterov momentum between iterations [not set]\n");
+  fprintf (stdout,"  -E  stop when the relative image change of an iteration is below tolerance, -I is the maximum [0]\n");
   LOG_ERROR(""  -w  Flag: positivity in image space [sinogram space]\n");
   LOG_ERROR(""  -e  epsilon[3] %e,%e,%e\n",epsilon1,epsilon2,epsilon3);
   LOG_ERROR(""  -u  image upper threshold [%f]\n",image_max);
@@ -518,6 +571,7 @@ static void usage() {
   fprintf (stdout,"  -L logging_filename[,log_mode] [default is screen]\n");
   fprintf (stdout,"     log_mode:  1=console,2=file,3=file&console\n");    
   fprintf (stdout,"  -T  number of threads [# of CPU-core - 2 for linux]");    
+  fprintf (stdout,"  -J  workers[,memory_budget_MB]: dynamic frames reconstructed by workers processes of -T threads [1]\n");
   fprintf (stdout,"  -v  verbose_level [none = 0]");
   fprintf (stdout,"      1: Scanner info             4: Normalization info"); 
   fprintf (stdout,"      8: Reconstruction info     16: I/O info          ");
@@ -1839,8 +1893,9 @@ FUNCPTR pt_read_norm(void *ptarg)
     //  memcpy(&(arg->normfac[0][0][0]),&(normfac_infile[arg->isubset][0][0][0]),x_pixels*y_pixels*z_pixels_simd*sizeof(__m128));
   } else  {
     if (normfac_in_file_flag==2) {
-      if (!read_norm(normfac_infile[arg->isubset], arg->normfac_img, arg->isubset,arg->verbose) )
+      if (!read_norm(NormfacStoreBuf(arg->isubset), arg->normfac_img, arg->isubset,arg->verbose) )
         LOG_EXIT("  Error occurs in read_norm at subset {}", arg->isubset );
+      StoreNormfac(arg->isubset);
     } else if (normfac_in_file_flag==-1) {
       if (!read_norm(arg->normfac, arg->normfac_img, arg->isubset,arg->verbose) )
         LOG_EXIT("  Error occurs in read_norm at subset {}", arg->isubset );
@@ -1983,10 +2038,14 @@ BPFP_ptargs *arg;
   float *nptr1,*nptr2,*nptr3,*nptr4;
   float eps=0.0003f;
   __m128 mmeps;
+  __m128 ratio,cone,lambda;
+  bool relax=(relax_lambda!=1.0f);
 
   if (sum_image!=0) eps*=sum_normfac/sum_image;
   else eps=0;
   mmeps=_mm_set_ps1(eps);
+  cone=_mm_set_ps1(1.0f);
+  lambda=_mm_set_ps1(relax_lambda);
   amax=_mm_set_ps1(100.00);
   amin=_mm_set_ps1(0.1f);
   if (sum_image!=0) LOG_INFO("sumnormfac {} {} {}", sum_normfac, sum_image, eps);
@@ -2005,7 +2064,9 @@ BPFP_ptargs *arg;
       nptr3=(float *)mptr3;
       nptr4=(float *)mptr4;
       for (z = 0;z<z_pixels_simd;z++) {
-        mptr1[z]=_mm_mul_ps(mptr1[z],_mm_div_ps(_mm_sub_ps(mptr2[z],_mm_mul_ps(mmeps,_mm_sub_ps(mptr4[z],mptr1[z]))),_mm_add_ps(mptr3[z],_mm_mul_ps(mmeps,mptr1[z]))));
+        ratio=_mm_div_ps(_mm_sub_ps(mptr2[z],_mm_mul_ps(mmeps,_mm_sub_ps(mptr4[z],mptr1[z]))),_mm_add_ps(mptr3[z],_mm_mul_ps(mmeps,mptr1[z])));
+        if (relax) ratio=_mm_max_ps(czero,_mm_add_ps(cone,_mm_mul_ps(lambda,_mm_sub_ps(ratio,cone))));
+        mptr1[z]=_mm_mul_ps(mptr1[z],ratio);
 //        mptr1[z]=_mm_add_ps(mptr1[z],_mm_mul_ps(mptr1[z],_mm_mul_ps(mptr2[z],mptr3[z])));
 //        mptr1[z]=_mm_min_ps(coef,_mm_mul_ps(mptr1[z],_mm_mul_ps(mptr2[z],mptr3[z])));
         mptr2[z]=czero;
@@ -2024,6 +2085,9 @@ FUNCPTR pt_cal_updateimage(void *ptarg)
   __m128 *mptr1,*mptr2,*mptr3;
   __m128 amax,amin;
   float *nptr1,*nptr2,*nptr3;
+  __m128 ratio,cone,lambda;
+  __m128 *nrow=NULL;
+  bool relax=(relax_lambda!=1.0f);
 
 
   if (mapemflag) {
@@ -2032,28 +2096,42 @@ FUNCPTR pt_cal_updateimage(void *ptarg)
   }
   amax=_mm_set_ps1(100.00);
   amin=_mm_set_ps1(0.01f);
+  cone=_mm_set_ps1(1.0f);
+  lambda=_mm_set_ps1(relax_lambda);
 
   czero=_mm_set_ps1(0);
 
   arg=(BPFP_ptargs*) ptarg;
   coef=_mm_set_ps1(image_max);
+  if (normfac_half_rows!=NULL) nrow=(__m128 *) _mm_malloc(z_pixels_simd*sizeof(__m128),16);
   for(x=arg->start;x<arg->end;x++) {
     for( y=cylwiny[x][0]; y<cylwiny[x][1]; y++ ) {
       mptr1=(__m128 *)image[x][y];
       mptr2=(__m128 *)correction[x][y];
-      mptr3=(__m128 *)normfac[x][y];
+      if (nrow!=NULL) {
+        // -H: decode the normfac row while it stays in cache
+        half_float::decode(normfac_half_rows+((size_t) x*y_pixels+y)*z_pixels_simd*4, (float *) nrow,
+                           (size_t) z_pixels_simd*4, normfac_format, normfac_half_rows_scale);
+        mptr3=nrow;
+      } else {
+        mptr3=(__m128 *)normfac[x][y];
+      }
       nptr1=(float *)mptr1;
       nptr2=(float *)mptr2;
       nptr3=(float *)mptr3;
       for (z = 0;z<z_pixels_simd;z++) {
 //        mptr1[z]=_mm_add_ps(mptr1[z],_mm_mul_ps(mptr1[z],_mm_mul_ps(mptr2[z],mptr3[z])));
 //        mptr1[z]=_mm_min_ps(coef,_mm_mul_ps(mptr1[z],_mm_mul_ps(mptr2[z],mptr3[z])));
-        mptr1[z]=_mm_min_ps(coef,_mm_mul_ps(mptr1[z],_mm_mul_ps(_mm_min_ps(amax,_mm_max_ps(amin,mptr2[z])),mptr3[z])));
+        ratio=_mm_mul_ps(_mm_min_ps(amax,_mm_max_ps(amin,mptr2[z])),mptr3[z]);
+        // relaxed OSEM: x*(1+lambda*(ratio-1)), kept positive
+        if (relax) ratio=_mm_max_ps(czero,_mm_add_ps(cone,_mm_mul_ps(lambda,_mm_sub_ps(ratio,cone))));
+        mptr1[z]=_mm_min_ps(coef,_mm_mul_ps(mptr1[z],ratio));
         mptr2[z]=czero;
       }
 
     }
   }
+  if (nrow!=NULL) _mm_free(nrow);
 //  LOG_INFO("startend %d\t{}",arg->start,arg->end);
   return 0;
 }
@@ -2921,8 +2999,28 @@ void free_prjxyf()
 
 void alloc_normfac_infile(int weighting,int span) {
   int i,j;
+  size_t n=(size_t) x_pixels*y_pixels*z_pixels_simd*4;
   if (normfac_in_file_flag==-1) return ;
 
+  if (normfac_format!=half_float::FP32) {
+    normfac_infile_half=(uint16_t **) calloc(subsets,sizeof(uint16_t *));
+    normfac_half_scale=(float *) calloc(subsets,sizeof(float));
+    for(i=0;i<subsets;i++) {
+      normfac_infile_half[i]=(uint16_t *) _mm_malloc(n*sizeof(uint16_t),16);
+      if (normfac_infile_half[i]==NULL)
+        LOG_EXIT("  Error allocating {} normfac", half_float::format_name(normfac_format));
+    }
+    normfac_half_store=(float ***) matrix3dm128(0,x_pixels-1,0,y_pixels-1,0,z_pixels_simd-1);
+    normfac_half_load=(float ***) matrix3dm128(0,x_pixels-1,0,y_pixels-1,0,z_pixels_simd-1);
+    if (normfac_half_store==NULL || normfac_half_load==NULL)
+      LOG_EXIT("  Error allocating normfac buffers");
+    // only the cylinder is written
+    memset(&normfac_half_store[0][0][0], 0, n*sizeof(float));
+    LOG_DEBUG("  Allocate {} normfac: {} kbytes", half_float::format_name(normfac_format), subsets*n/512);
+    normfac_in_file_flag=1;
+    return;
+  }
+
   normfac_infile=(float ****) malloc(subsets*sizeof(float *));
   for(i=0;i<subsets;i++) {
     normfac_infile[i]=(float ***) matrix3dm128_check(0,x_pixels-1,0,y_pixels-1,0,z_pixels_simd-1);//x_pixels*y_pixels*z_pixels_simd*4*sizeof(float));
@@ -2942,6 +3040,55 @@ void alloc_normfac_infile(int weighting,int span) {
 
 }
 
+/*
+  -H: the subset normfacs are kept in normfac_infile_half instead of normfac_infile.
+  A subset normfac is computed or read in NormfacStoreBuf() and encoded by StoreNormfac(),
+  LoadNormfac() decodes it for the image update.  With t_rows, the OSEM update in
+  pt_cal_updateimage decodes each row just before it uses it: decoding the whole volume first
+  writes and reads back a float volume, which makes the update slower than with fp32.
+*/
+float ***NormfacStoreBuf(int isubset)
+{
+  if (normfac_format==half_float::FP32) return normfac_infile[isubset];
+  return normfac_half_store;
+}
+
+void StoreNormfac(int isubset)
+{
+  const size_t chunk=1024;
+  size_t n=(size_t) x_pixels*y_pixels*z_pixels_simd*4, i, m;
+  float *src, dec[chunk];
+  uint16_t *dst;
+  float scale;
+
+  if (normfac_format==half_float::FP32) return;
+  src=&normfac_half_store[0][0][0];
+  dst=normfac_infile_half[isubset];
+  scale=(normfac_format==half_float::FP16) ? half_float::range_scale(src,n) : 1.0f;
+  normfac_half_scale[isubset]=1.0f/scale;
+  half_float::encode(src, dst, n, normfac_format, scale);
+  // error against the float normfac
+  for (i=0; i<n; i+=chunk) {
+    m=std::min(chunk, n-i);
+    half_float::decode(dst+i, dec, m, normfac_format, normfac_half_scale[isubset]);
+    normfac_half_err=std::max(normfac_half_err, half_float::max_rel_error(src+i, dec, m));
+  }
+}
+
+float ***LoadNormfac(int isubset, bool t_rows)
+{
+  normfac_half_rows=NULL;
+  if (normfac_format==half_float::FP32) return normfac_infile[isubset];
+  if (t_rows) {
+    normfac_half_rows=normfac_infile_half[isubset];
+    normfac_half_rows_scale=normfac_half_scale[isubset];
+  } else {
+    half_float::decode(normfac_infile_half[isubset], &normfac_half_load[0][0][0],
+                       (size_t) x_pixels*y_pixels*z_pixels_simd*4, normfac_format, normfac_half_scale[isubset]);
+  }
+  return normfac_half_load;
+}
+
 //void swap_xr_yr(float ***largeprj3,float ***largeprj_swap)
 void swap_xr_yr()
 {
@@ -3048,6 +3195,15 @@ void InitParameter()
   p->prompt_file=prompt_file;
   p->pFlag=pFlag;
   p->delayed_file=delayed_file;
+  p->lm_events_file=lm_events_file;
+  p->lmFlag=lmFlag;
+  p->relax_lambda0=relax_lambda0;
+  p->relax_gamma=relax_gamma;
+  p->momentumFlag=momentumFlag;
+  p->stop_tol=stop_tol;
+  p->frame_workers=frame_workers;
+  p->frame_budget_mb=frame_budget_mb;
+  p->normfac_format=normfac_format;
   p->norm_file=norm_file;
   p->nFlag=nFlag;
   p->atten_file=atten_file;
@@ -3106,6 +3262,15 @@ void PutParameter()
   prompt_file=p->prompt_file;
   pFlag=p->pFlag;
   delayed_file=p->delayed_file;
+  lm_events_file=p->lm_events_file;
+  lmFlag=p->lmFlag;
+  relax_lambda0=p->relax_lambda0;
+  relax_gamma=p->relax_gamma;
+  momentumFlag=p->momentumFlag;
+  stop_tol=p->stop_tol;
+  frame_workers=p->frame_workers;
+  frame_budget_mb=p->frame_budget_mb;
+  normfac_format=p->normfac_format;
   norm_file=p->norm_file;
   nFlag=p->nFlag;
   atten_file=p->atten_file;
@@ -3211,6 +3376,25 @@ void GetParameter(int argc,char **argv)
        case 'D' :
          normfac_dir = optarg;
          break;
+       case 'l' :
+         osem3dpar->lm_events_file = optarg;
+         osem3dpar->lmFlag=1;
+         break;
+       case 'r' :
+         if (sscanf(optarg,"%f,%f",&osem3dpar->relax_lambda0,&osem3dpar->relax_gamma) < 1)
+           LOG_EXIT("error decoding -r {}",optarg);
+         break;
+       case 'x' :
+         osem3dpar->momentumFlag=1;
+         break;
+       case 'E' :
+         if (sscanf(optarg,"%f",&osem3dpar->stop_tol) != 1)
+           LOG_EXIT("error decoding -E {}",optarg);
+         break;
+       case 'J' :
+         if (sscanf(optarg,"%d,%f",&osem3dpar->frame_workers,&osem3dpar->frame_budget_mb) < 1)
+           LOG_EXIT("error decoding -J {}",optarg);
+         break;
        case 'n':
          osem3dpar->norm_file = optarg;
          osem3dpar->nFlag=1;
@@ -3313,6 +3497,11 @@ void GetParameter(int argc,char **argv)
        case 'N' :
          osem3dpar->normfac_in_file_flag=0;
          break;
+       case 'H' :
+         if (!half_float::parse_format(optarg,osem3dpar->normfac_format))
+           LOG_EXIT("error decoding -H {}",optarg);
+         osem3dpar->normfac_in_file_flag=0;
+         break;
        case 'M':
          if (sscanf(optarg,"%d",&osem3dpar->iModel) != 1)
            LOG_EXIT("error decoding -M {}",optarg);
@@ -3384,6 +3573,13 @@ void CheckParameterAndPrint() {
       usage();
     }
   }
+  if (lmFlag) {
+    LOG_INFO("  Input listmode events : {}", lm_events_file);
+    if (!pFlag || weighting != 3)
+      LOG_EXIT("Listmode reconstruction requires prompt and delayed scans and OP weighting (-W 3)");
+    if (CompressFlag || mapemflag || newzoom != 1 || floatFlag > 1)
+      LOG_EXIT("Listmode reconstruction does not support -C, -A, -Z or -R");
+  }
 
   if (floatFlag)
     LOG_INFO("  Input scan is in float format");
@@ -3429,6 +3625,20 @@ void CheckParameterAndPrint() {
   LOG_INFO("  Threshold for missing data : {}", epsilon2);
   LOG_INFO("  Threshold for image update : {}", epsilon3);
   LOG_INFO("  Maximum of image   : {}", image_max);
+  if (relax_lambda0 <= 0 || relax_lambda0 >= 2 || relax_gamma < 0)
+    LOG_EXIT("Relaxation lambda0 must be in ]0,2[ and gamma >= 0 (-r {},{})", relax_lambda0, relax_gamma);
+  if (relax_lambda0 != 1 || relax_gamma != 0)
+    LOG_INFO("  Relaxed OSEM       : {}/(1+{}*iteration)", relax_lambda0, relax_gamma);
+  if (momentumFlag)
+    LOG_INFO("  Nesterov momentum between iterations");
+  if (stop_tol < 0)
+    LOG_EXIT("Stopping tolerance must be >= 0 (-E {})", stop_tol);
+  if (stop_tol > 0)
+    LOG_INFO("  Stop when the relative image change is below {}", stop_tol);
+  if (frame_workers < 1 || frame_budget_mb < 0)
+    LOG_EXIT("error decoding -J {},{}", frame_workers, frame_budget_mb);
+  if (normfac_format != half_float::FP32)
+    LOG_INFO("  Normfac in memory  : {}", half_float::format_name(normfac_format));
 
   /* verbosity */
   if (verbose > 0) {
@@ -3550,11 +3760,43 @@ void CheckParameterAndPrint() {
   }
 }
 
-void CheckFileValidate() {
-  FILE *tmpfp;
+/*
+  Normalization and attenuation files of the -J frame workers: read once before the fork, the
+  pages are shared copy on write (never written) and each frame reads them through fmemopen.
+*/
+typedef struct {
+  char *data;
+  size_t size;
+} SharedFile;
+SharedFile shared_norm = {NULL, 0};
+SharedFile shared_atten = {NULL, 0};
+
+/* Read file fname into shared_file; returns 1 on success */
+int LoadSharedFile(const char *fname, SharedFile *shared_file)
+{
+  struct stat st;
+  FILE *fp;
+
+  if (stat(fname, &st) != 0 || (fp = fopen(fname, "rb")) == NULL) return 0;
+  shared_file->size = st.st_size;
+  shared_file->data = (char *) malloc(shared_file->size);
+  if (shared_file->data != NULL && fread(shared_file->data, 1, shared_file->size, fp) != shared_file->size) {
+    free(shared_file->data);
+    shared_file->data = NULL;
+  }
+  fclose(fp);
+  return shared_file->data != NULL;
+}
 
-  if ( iterations > 0 ) {// !sv  we need only image to generate fully corrected 3D scans by forward projection 
-    /* open input files  */
+/* Stream on the contents of a loaded file, or the file fname itself */
+FILE *OpenSharedFile(const char *fname, SharedFile *shared_file)
+{
+  if (shared_file->data != NULL) return fmemopen(shared_file->data, shared_file->size, "r");
+  return fopen(fname, "rb");
+}
+
+/* Open the input files of the current frame */
+void OpenFrameFiles() {
     if (tFlag) {            
       // char *true_file, FILEPTR tsinofp
       tsinofp = fopen(true_file,"rb");
@@ -3573,14 +3815,14 @@ void CheckFileValidate() {
     }
 
     if (nFlag) {            
-      normfp = fopen(norm_file,"rb");
+      normfp = OpenSharedFile(norm_file, &shared_norm);
       if (normfp == FOPEN_ERROR) LOG_INFO("  Error: cannot open normalization file {}",norm_file);
       if (normfp == FOPEN_ERROR)
         LOG_EXIT("  Error: cannot open normalization file {}",norm_file);
     }
 
     if (noattenFlag == 0) {            
-      attenfp = fopen(atten_file,"rb");
+      attenfp = OpenSharedFile(atten_file, &shared_atten);
       if (attenfp == FOPEN_ERROR) LOG_INFO("  Error: cannot open attenuation file {}",atten_file);    /* attenfp could be null */
       if (attenfp == FOPEN_ERROR)
       LOG_EXIT("  Error: cannot open attenuation file {}",atten_file);    /* attenfp could be null */
@@ -3592,7 +3834,25 @@ void CheckFileValidate() {
       if (ssinofp == FOPEN_ERROR)
         LOG_EXIT("  Error: cannot open input scatter sinogram file {}",scat_scan_file);
     }
-  }
+}
+
+/* Close the input files of the current frame */
+void CloseFrameFiles() {
+    if (tFlag) file_close(tsinofp);
+    else{
+      file_close(psinofp);
+      file_close(dsinofp);
+    }
+    if (nFlag) file_close(normfp);
+    if (noattenFlag == 0) file_close(attenfp);
+    if (sFlag) file_close(ssinofp);            
+}
+
+void CheckFileValidate() {
+  FILE *tmpfp;
+
+  if ( iterations > 0 ) // !sv  we need only image to generate fully corrected 3D scans by forward projection 
+    OpenFrameFiles();
   /* check initial image file existence */
   if (iFlag) {
     tmpfp=fopen(in_img_file,"rb");
@@ -3788,7 +4048,7 @@ void CalculateNormfac()
     if (verbose & 0x0004) LOG_INFO("  subset {}", isubset );
     memset( &normfac[0][0][0], 0, x_pixels*y_pixels*z_pixels_simd*sizeof(__m128));//(z_pixels+1)*sizeof(float) );
     ClockNormfacTheta = clock ();
-    if (normfac_in_file_flag!=-1) correction=normfac_infile[isubset];
+    if (normfac_in_file_flag!=-1) correction=NormfacStoreBuf(isubset);
 
     //must use 16 subsets, because of using 90 degree symmetry in this loop.
     // we should find a way to test if the 90 deg projection is in same subset.
@@ -3845,6 +4105,7 @@ void CalculateNormfac()
     }
 
     for(thr=0;thr<2;thr++)Wait_thread( threads[Cal1+thr]);
+    if (normfac_in_file_flag!=-1) StoreNormfac(isubset);
 
     normstructure.isubset=isubset;
     if (normfac_in_file_flag==-1) {
@@ -3937,16 +4198,8 @@ void PrepareOsem3dFiles()
   }
 
 
-  if ( iterations > 0 ) { // close input files  
-    if (tFlag) file_close(tsinofp);
-    else{
-      file_close(psinofp);
-      file_close(dsinofp);
-    }
-    if (nFlag) file_close(normfp);
-    if (noattenFlag == 0) file_close(attenfp);
-    if (sFlag) file_close(ssinofp);            
-  }
+  if ( iterations > 0 ) // close input files  
+    CloseFrameFiles();
     /*  read initial image or initialize it in a cylindrical window */
   /*---------------------------------------------------------------
   * initialize image 
@@ -4095,6 +4348,97 @@ void SaveImage(char *out_img_file,int iter, int frame)
 
 }
 
+/*
+Listmode sensitivity: time ordered subsets of events cover all views, so the sensitivity of
+a subset is the sum of the view subset sensitivities 1/normfac_k divided by the number of subsets.
+normfac = subsets / sum_k(1/normfac_k) is computed once, correction is used to read normfac_k.
+*/
+void CalculateLMNormfac()
+{
+  int x,y,z,isubset;
+  float ***nf;
+  float *fptr1,*fptr2;
+
+  memset(&normfac[0][0][0], 0, x_pixels*y_pixels*z_pixels_simd*sizeof(__m128));
+  for( isubset=0; isubset<subsets; isubset++ ) {
+    if (normfac_in_file_flag==1) {
+      nf=LoadNormfac(isubset);
+    } else {
+      nf=(normfac_in_file_flag==2) ? NormfacStoreBuf(isubset) : correction;
+      if (!read_norm(nf, normfac_img, isubset, verbose))
+        LOG_EXIT("  Error occurs in read_norm at subset {}", isubset);
+      if (normfac_in_file_flag==2) StoreNormfac(isubset);
+    }
+    for( x=0; x<x_pixels; x++ ) {
+      for( y=cylwiny[x][0]; y<cylwiny[x][1]; y++ ) {
+        fptr1=normfac[x][y];
+        fptr2=nf[x][y];
+        for( z=0; z<z_pixels; z++ )
+          if (fptr2[z]>0.0) fptr1[z]+=1.0f/fptr2[z];
+      }
+    }
+  }
+  for( x=0; x<x_pixels; x++ ) {
+    for( y=cylwiny[x][0]; y<cylwiny[x][1]; y++ ) {
+      fptr1=normfac[x][y];
+      for( z=0; z<z_pixels; z++ )
+        if (fptr1[z]>0.0) fptr1[z]=subsets/fptr1[z];
+    }
+  }
+  if (normfac_in_file_flag==2) normfac_in_file_flag=1;
+  memset(&correction[0][0][0], 0, x_pixels*y_pixels*z_pixels_simd*sizeof(__m128));
+}
+
+/* Relaxed OSEM update ratio 1+relax_lambda*(ratio-1), kept positive */
+static inline float relax_ratio(float ratio)
+{
+  if (relax_lambda==1.0f) return ratio;
+  return std::max(0.0f, 1.0f+relax_lambda*(ratio-1.0f));
+}
+
+/* Relative L1 change between image and image_prev in the FOV */
+float ImageChange()
+{
+  int x,y,z;
+  double diff=0, sum=0;
+  float *fptr1,*fptr2;
+
+  for( x=0; x<x_pixels; x++ ) {
+    for( y=cylwiny[x][0]; y<cylwiny[x][1]; y++ ) {
+      fptr1=image[x][y];
+      fptr2=image_prev[x][y];
+      for( z=z_min; z<z_max; z++) {
+        diff+=fabs(fptr1[z]-fptr2[z]);
+        sum+=fptr1[z];
+      }
+    }
+  }
+  return sum>0 ? (float)(diff/sum) : 0.0f;
+}
+
+/*
+  Nesterov momentum: image_prev is set to the current iterate x_k and the next iteration
+  starts from x_k + beta*(x_k - x_k-1), kept in [0,image_max].  beta=0 only copies x_k.
+*/
+void ExtrapolateImage(float beta)
+{
+  int x,y,z;
+  float *fptr1,*fptr2;
+  float xk;
+
+  for( x=0; x<x_pixels; x++ ) {
+    for( y=cylwiny[x][0]; y<cylwiny[x][1]; y++ ) {
+      fptr1=image[x][y];
+      fptr2=image_prev[x][y];
+      for( z=0; z<z_pixels; z++) {
+        xk=fptr1[z];
+        if (beta>0) fptr1[z]=std::min(image_max, std::max(0.0f, xk+beta*(xk-fptr2[z])));
+        fptr2[z]=xk;
+      }
+    }
+  }
+}
+
 void CalculateOsem3d(int frame)
 {
   char *iter_file=NULL, *pext=NULL;
@@ -4116,17 +4460,29 @@ void CalculateOsem3d(int frame)
     if ( !sequence(subsets, order) )
       LOG_EXIT("  Main(): error occurs in sequence()");
 
-    if (normfac_in_file_flag==-1) {
+    if (normfac_in_file_flag==-1 || lmFlag) {
       alloc_normfac();
     }
     alloc_correction();
     alloc_thread_buf();
+    if (lmFlag) {
+      if (lm_osem_init(lm_events_file, largeprjshort, floatFlag==1 ? largeprjfloat : NULL) == 0)
+        LOG_EXIT("  No listmode events in {}", lm_events_file);
+      CalculateLMNormfac();
+    }
 
     if (positFlag==1) {
       alloc_imagemask();
       memset(&imagemask[0][0][0],0,x_pixels*y_pixels*z_pixels_simd*4);
     }
+    if (momentumFlag || stop_tol>0) {
+      image_prev = (float ***) matrix3dm128(0,x_pixels-1, 0,y_pixels-1, 0,z_pixels_simd-1);
+      if ( image_prev == NULL )
+        LOG_EXIT("  Error allocating image_prev");
+    }
   }
+  if (image_prev != NULL)
+    memcpy(&image_prev[0][0][0], &image[0][0][0], x_pixels*y_pixels*z_pixels_simd*sizeof(__m128));
 
 //  swap_xr_yr(largeprj3,largeprj_swap);
 //  swap_xr_yr();
@@ -4147,6 +4503,9 @@ void CalculateOsem3d(int frame)
   }
   for( iter=0; iter<iterations; iter++ ) {  
     if ( verbose & 0x0008) LOG_INFO("  Starting iteration {}", iter+1);
+    iterations_done = iter+1;
+    relax_lambda = relax_lambda0/(1.0f+relax_gamma*iter);
+    if (relax_lambda != 1.0f && (verbose & 0x0008)) LOG_INFO("  Relaxation {}", relax_lambda);
     if ( saveFlag ) {         /* form the filename for intermediate images */
       if (iter+1<10) sprintf(pext,"i0%d.i",iter+1);
       else sprintf(pext,"i%d.i",iter+1);
@@ -4164,62 +4523,70 @@ void CalculateOsem3d(int frame)
       //read normfac.i file!!
       isubset = order[i];
       normstructure.isubset=isubset;
-      if (normfac_in_file_flag==-1 || normfac_in_file_flag==2) {
+      if (!lmFlag && (normfac_in_file_flag==-1 || normfac_in_file_flag==2)) {
         START_THREAD(threads[Rnormfact],pt_read_norm,normstructure,threadID);
       } 
       ClockNormfacTheta = clock ();                /* reuse previous timing variable */
 
       if (blur) convolve3d(image,image_psf,imagexyzf_thread[0]);
 
-      for(v=0;v<sviews/2-nthreads+1;v+=nthreads) {
-        for(thr=0;thr<nthreads;thr++) {
+      if (lmFlag) {
+        // time ordered subset of events, the sensitivity is the same for all subsets
+        lm_osem_subset(blur ? image_psf : image, correction, largeprj, i, subsets, imagexyzf_thread);
+      } else {
+        for(v=0;v<sviews/2-nthreads+1;v+=nthreads) {
+          for(thr=0;thr<nthreads;thr++) {
           
-          view=vieworder[isubset][v+thr];
-          bparg[thr].prj=estimate_thread[thr];
-          if (blur) bparg[thr].ima=image_psf;
-          else  bparg[thr].ima=image;
-          bparg[thr].imagepack=imagepack;
-          bparg[thr].view=view;
-          bparg[thr].numthread=1;
-          bparg[thr].imagebuf=imagexyzf_thread[thr];
-          bparg[thr].prjbuf=prjxyf_thread[thr];
-          bparg[thr].volumeprj=largeprj[view];
+            view=vieworder[isubset][v+thr];
+            bparg[thr].prj=estimate_thread[thr];
+            if (blur) bparg[thr].ima=image_psf;
+            else  bparg[thr].ima=image;
+            bparg[thr].imagepack=imagepack;
+            bparg[thr].view=view;
+            bparg[thr].numthread=1;
+            bparg[thr].imagebuf=imagexyzf_thread[thr];
+            bparg[thr].prjbuf=prjxyf_thread[thr];
+            bparg[thr].volumeprj=largeprj[view];
           
-            if (pFlag && (weighting == 3 || weighting==8) && floatFlag==0) {
-              bparg[thr].volumeprjshort=largeprjshort[view];
-            }
-            else if (pFlag && (weighting == 3 || weighting==8) && floatFlag==1) bparg[thr].volumeprjfloat=largeprjfloat[view];
-          bparg[thr].weighting=weighting;
-          START_THREAD(threads[Cal1+thr],pt_osem3d_proj_thread1,bparg[thr],threadID);
-        }
-        for(thr=0;thr<nthreads;thr++) Wait_thread( threads[Cal1+thr]);
-        rotate_image_buf(imagexyzf_thread,correction,nthreads,&vieworder[isubset][v]);
-      }     
-      if (((sviews/2)%nthreads)!=0) {
-        for(v=sviews/2-(sviews/2)%nthreads;v<sviews/2;v++) {
-          view=vieworder[isubset][v];
-          if (blur) {
-            if ( !forward_proj3d2(image_psf, estimate_thread[0], view,verbose,imagexyzf_thread[0],prjxyf_thread[0]))
-              LOG_EXIT("  Main(): error occurs in forward_proj3d at subset {}",isubset );        
-          } else {
-            if ( !forward_proj3d2(image, estimate_thread[0], view,verbose,imagexyzf_thread[0],prjxyf_thread[0]))
-              LOG_EXIT("  Main(): error occurs in forward_proj3d at subset {}",isubset );        
+              if (pFlag && (weighting == 3 || weighting==8) && floatFlag==0) {
+                bparg[thr].volumeprjshort=largeprjshort[view];
+              }
+              else if (pFlag && (weighting == 3 || weighting==8) && floatFlag==1) bparg[thr].volumeprjfloat=largeprjfloat[view];
+            bparg[thr].weighting=weighting;
+            START_THREAD(threads[Cal1+thr],pt_osem3d_proj_thread1,bparg[thr],threadID);
           }
-          // UW, AW, ANW scheme
-          if (weighting ==0 || weighting ==1 || weighting ==2 || weighting ==5 || weighting ==6 || weighting ==7 ) { 
-            update_estimate_w012(estimate_thread[0],largeprj[view],segmentsize*2,xr_pixels,nthreads);
-          }  else if (pFlag && (weighting == 3 || weighting==8)) {  
-            if (floatFlag==0) update_estimate_w3(estimate_thread[0],largeprj[view],largeprjshort[view],NULL,segmentsize*2,xr_pixels,nthreads);
-            else if (floatFlag==1) update_estimate_w3(estimate_thread[0],largeprj[view],NULL,largeprjfloat[view],segmentsize*2,xr_pixels,nthreads);
+          for(thr=0;thr<nthreads;thr++) Wait_thread( threads[Cal1+thr]);
+          rotate_image_buf(imagexyzf_thread,correction,nthreads,&vieworder[isubset][v]);
+        }     
+        if (((sviews/2)%nthreads)!=0) {
+          for(v=sviews/2-(sviews/2)%nthreads;v<sviews/2;v++) {
+            view=vieworder[isubset][v];
+            if (blur) {
+              if ( !forward_proj3d2(image_psf, estimate_thread[0], view,verbose,imagexyzf_thread[0],prjxyf_thread[0]))
+                LOG_EXIT("  Main(): error occurs in forward_proj3d at subset {}",isubset );        
+            } else {
+              if ( !forward_proj3d2(image, estimate_thread[0], view,verbose,imagexyzf_thread[0],prjxyf_thread[0]))
+                LOG_EXIT("  Main(): error occurs in forward_proj3d at subset {}",isubset );        
+            }
+            // UW, AW, ANW scheme
+            if (weighting ==0 || weighting ==1 || weighting ==2 || weighting ==5 || weighting ==6 || weighting ==7 ) { 
+              update_estimate_w012(estimate_thread[0],largeprj[view],segmentsize*2,xr_pixels,nthreads);
+            }  else if (pFlag && (weighting == 3 || weighting==8)) {  
+              if (floatFlag==0) update_estimate_w3(estimate_thread[0],largeprj[view],largeprjshort[view],NULL,segmentsize*2,xr_pixels,nthreads);
+              else if (floatFlag==1) update_estimate_w3(estimate_thread[0],largeprj[view],NULL,largeprjfloat[view],segmentsize*2,xr_pixels,nthreads);
+            }
+            if ( !back_proj3d2( estimate_thread[0], correction, view,verbose,imagexyzf_thread[0],prjxyf_thread[0])) 
+              LOG_EXIT("  Main(): error occurs in back_proj3d for subset {}", isubset);
           }
-          if ( !back_proj3d2( estimate_thread[0], correction, view,verbose,imagexyzf_thread[0],prjxyf_thread[0])) 
-            LOG_EXIT("  Main(): error occurs in back_proj3d for subset {}", isubset);
         }
       }
       if (verbose & 0x0008) LOG_INFO(" Calculating isubset = {}/{} in {:1.2f}s",isubset, subsets, 1.0 * ( clock () - ClockNormfacTheta  ) / CLOCKS_PER_SEC );        
 
-      if (normfac_in_file_flag==-1) {   Wait_thread(threads[Rnormfact]);}
-      else normfac=normfac_infile[order[i]];
+      if (!lmFlag) {
+        if (normfac_in_file_flag==-1 || normfac_in_file_flag==2) {   Wait_thread(threads[Rnormfact]);}
+        if (normfac_in_file_flag!=-1)
+          normfac=LoadNormfac(order[i], (positFlag==0 || positFlag==2) && !mapemflag);
+      }
 
       if (positFlag==0 || positFlag==2) {
         count=0;
@@ -4252,7 +4619,7 @@ void CalculateOsem3d(int frame)
             fptr3=normfac[x][y];
             if (iter>6) {
               for( z=0; z<z_pixels; z++ ) {
-                if (fptr2[z]>0.0) fptr1[z]*=fptr2[z]*fptr3[z];
+                if (fptr2[z]>0.0) fptr1[z]*=relax_ratio(fptr2[z]*fptr3[z]);
                 if ( fptr1[z]> image_max) {
                   count++;
                   fptr1[z] = image_max;   /* truncate - CJM Sept 2002 */
@@ -4261,7 +4628,7 @@ void CalculateOsem3d(int frame)
             } else {
               for( z=0; z<z_pixels; z++ ) {
                 if (fptr2[z]>0.0) {
-                  fptr1[z]*=fptr2[z]*fptr3[z];
+                  fptr1[z]*=relax_ratio(fptr2[z]*fptr3[z]);
                   imagemask[x][y][z]=1;
                 }
                 if ( fptr1[z]> image_max) {
@@ -4311,36 +4678,167 @@ void CalculateOsem3d(int frame)
       if (count != 0) LOG_INFO("  Number of un-updated pixels = {}",count);
     }
 
+    if (image_prev != NULL) {
+      float change = ImageChange();
+      LOG_INFO("  Iteration {} relative image change {}", iter+1, change);
+      if (change < stop_tol) {
+        LOG_INFO("  Stopping after iteration {}: image change below {}", iter+1, stop_tol);
+        break;
+      }
+    }
+
     //Use old output file name convention when intermediate image are requested
     /* save intermediate image as long as it is not the last iteration   */
     if ( saveFlag && (iter!=(iterations-1)) ) {    
       /* we need a temporary image, keep original untouched */
       free_correction();
-      if (normfac_in_file_flag==-1) free_normfac();
+      if (normfac_in_file_flag==-1 && !lmFlag) free_normfac();
 
       SaveImage(iter_file,iter+1,0);
       
       alloc_correction();
-      if (normfac_in_file_flag==-1) alloc_normfac();
+      if (normfac_in_file_flag==-1 && !lmFlag) alloc_normfac();
     } 
+    if (image_prev != NULL && iter != iterations-1)
+      ExtrapolateImage(momentumFlag ? iter/(iter+3.0f) : 0.0f);
   }  /* end iteration loop */
+  if (normfac_infile_half != NULL)
+    LOG_INFO("  Normfac stored as {}: largest relative error {} against float",
+             half_float::format_name(normfac_format), normfac_half_err);
   
   if (num_em_frames<2) {
     free_correction();
     free_normfac();
     free_thread_buf();
     free(order);
+    if (lmFlag) lm_osem_free();
+    if (image_prev != NULL)
+      free_matrix3dm128(image_prev, 0,x_pixels-1, 0,y_pixels-1, 0,z_pixels_simd-1);
+    image_prev=NULL;
   }
   
   /* save last image in old filename conventions   */
   if ( saveFlag ) 
   {
-      SaveImage(iter_file, iterations,0);
+      SaveImage(iter_file, iterations_done,0);
       free(iter_file);
   }
 }
 
 
+/* File names of dynamic frame em_frame */
+void SetFrameFiles(int em_frame)
+{
+  sprintf(true_file,"%s_frame%d%s.s",em_file_prefix,em_frame,em_file_postfix); 
+  if (!ecat_flag)
+    sprintf(out_img_file,"%s_frame%d%s.i",em_file_prefix,em_frame,em_file_postfix);
+}
+
+/*
+  Reconstruct frame em_frame from the open frame files; nframe is the number of frames
+  already reconstructed by this process, the first one allocates the reconstruction buffers.
+*/
+void ReconstructFrame(int em_frame, int nframe)
+{
+  if (nframe > 0) {
+    if (ecat_flag) {
+      LOG_INFO("  Osem3d {},{} reconstruction started", out_img_file,em_frame+1);
+    } else {
+      LOG_INFO("  Osem3d {} reconstruction started", out_img_file);
+    }
+  }
+
+  PrepareOsem3dFiles();
+  time(&t0);
+  if (nframe > 0) free_matrix3dm128(image, 0,x_pixels-1, 0,y_pixels-1, 0,z_pixels_simd-1);
+  Init_Image();
+  CalculateOsem3d(nframe);
+  // Save image if not already done as intermediate image
+  if (!saveFlag) SaveImage(out_img_file,iterations_done, em_frame);
+  if (ecat_flag) {
+    LOG_INFO("  Osem3d {},{} done in {} sec",out_img_file, em_frame+1, t1-t2);
+  } else {
+    LOG_INFO("  Osem3d {}  done in {} sec",out_img_file,t1-t2);
+  }
+  // clean ra_smo_file
+#ifndef WIN_X64
+  if (strlen(ra_smo_file) && access(ra_smo_file,0) == 0) unlink(ra_smo_file);
+#endif
+}
+
+/*
+  Number of frame worker processes for -J: limited by the number of frames, by the processors
+  (workers times -T threads) and by the memory budget.  Each worker writes its own sinogram, images
+  and thread buffers; geometry, lookup tables, normfac and the normalization and attenuation files
+  are loaded before the fork and stay shared (copy on write, never written).
+*/
+int FrameWorkers()
+{
+  double sino_bytes, image_bytes, worker_mb, shared_mb=0;
+  struct stat st;
+  int n, ncpus;
+
+  if (num_em_frames < 2 || frame_workers < 2) return 1;
+  if (ecat_flag) {
+    LOG_INFO("  ECAT frames are written by a single process, -J ignored");
+    return 1;
+  }
+  sino_bytes = (double) segmentsize*views*xr_pixels*sizeof(float);
+  if (weighting==3 || weighting==8) sino_bytes *= (floatFlag==0) ? 1.5 : 2.0;
+  image_bytes = (double) x_pixels*y_pixels*z_pixels_simd*sizeof(__m128);
+  // image, correction, psf image and per thread image buffers
+  worker_mb = (sino_bytes + (3+nthreads)*image_bytes)/(1024.0*1024.0);
+  if (nFlag && stat(norm_file, &st) == 0) shared_mb += st.st_size/(1024.0*1024.0);
+  if (noattenFlag == 0 && stat(atten_file, &st) == 0) shared_mb += st.st_size/(1024.0*1024.0);
+  n = std::min(frame_workers, num_em_frames);
+  ncpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncpus > 0 && n*std::max(nthreads, 1) > ncpus) {
+    n = std::max(ncpus/std::max(nthreads, 1), 1);
+    LOG_INFO("  {} frame workers of {} threads for {} processors", n, nthreads, ncpus);
+  }
+  if (frame_budget_mb > 0) n = std::min(n, (int) ((frame_budget_mb-shared_mb)/worker_mb));
+  return std::max(n, 1);
+}
+
+/* Reconstruct the dynamic frames with nworkers processes, worker w does frames w, w+nworkers, ... */
+void ReconstructFramesForked(int nworkers)
+{
+  pid_t pid[MAXTHREADS];
+  int w, em_frame, nframe, status, nfailed=0;
+
+  nworkers = std::min(nworkers, MAXTHREADS);
+  LOG_INFO("  Reconstructing {} frames with {} workers of {} threads", num_em_frames, nworkers, nthreads);
+  // workers open their own files, file offsets are shared across fork
+  if (iterations > 0) CloseFrameFiles();
+  if (nFlag && !LoadSharedFile(norm_file, &shared_norm))
+    LOG_EXIT("  Error: cannot read normalization file {}", norm_file);
+  if (noattenFlag == 0 && !LoadSharedFile(atten_file, &shared_atten))
+    LOG_EXIT("  Error: cannot read attenuation file {}", atten_file);
+  for (w=0; w<nworkers; w++) {
+    pid[w] = fork();
+    if (pid[w] < 0) {
+      LOG_EXIT("  Error: cannot start frame worker {}", w);
+    }
+    if (pid[w] == 0) {
+      for (em_frame=w, nframe=0; em_frame<num_em_frames; em_frame+=nworkers, nframe++) {
+        SetFrameFiles(em_frame);
+        OpenFrameFiles();
+        if (nframe == 0) LOG_INFO("  Osem3d {} reconstruction started", out_img_file);
+        ReconstructFrame(em_frame, nframe);
+      }
+      exit(EXIT_SUCCESS);
+    }
+  }
+  for (w=0; w<nworkers; w++) {
+    if (waitpid(pid[w], &status, 0) != pid[w] || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+      LOG_ERROR("  Frame worker {} failed", w);
+      nfailed++;
+    }
+  }
+  if (nfailed > 0)
+    LOG_EXIT("  {} of {} frame workers failed", nfailed, nworkers);
+}
+
 int main(int argc, char* argv[])
 {
   int nprojs=0,nviews=0;
@@ -4551,53 +5049,21 @@ int main(int argc, char* argv[])
     LOG_ERROR("  Reuse normfac (sensitivity) previously created ; Care should be taken that it contains the correct information");
   }
 
+  int nworkers = FrameWorkers();
+  if (nworkers > 1) {
+    ReconstructFramesForked(nworkers);
+    return 0;
+  }
+
   LOG_INFO("  Osem3d {} reconstruction started{}", out_img_file);
   // reconstruct single or first frame
-  PrepareOsem3dFiles();
-  time(&t0);
-  Init_Image();
-  CalculateOsem3d(0);
-  // Save image if not already done as intermediate image
-  if (!saveFlag) SaveImage(out_img_file,iterations, 0);
-  LOG_INFO("  Osem3d {} reconstruction done in {} sec", out_img_file, t1-t2);
-  // clean ra_smo_file
-#ifndef WIN_X64
-  if (strlen(ra_smo_file) && access(ra_smo_file,0) == 0) unlink(ra_smo_file);
-#endif
+  ReconstructFrame(0, 0);
 
    // reconstruct remaining frames
   for (int em_frame=1; em_frame<num_em_frames; em_frame++) {
-    sprintf(true_file,"%s_frame%d%s.s",em_file_prefix,em_frame,em_file_postfix); 
-    if (!ecat_flag)
-      sprintf(out_img_file,"%s_frame%d%s.i",em_file_prefix,em_frame,em_file_postfix);
-
-    if ((tsinofp = fopen(true_file,"rb")) == FOPEN_ERROR) 
-      LOG_EXIT("  Error: cannot open input true sinogram file {}",true_file);
-    
-    if (nFlag) {  // reopen normalization          
-      if ((normfp = fopen(norm_file,"rb")) == FOPEN_ERROR) 
-        LOG_EXIT("  Error: cannot open normalization file {}",norm_file);
-    }
-
-    if (ecat_flag) 
-      LOG_INFO("  Osem3d {},{} reconstruction started", out_img_file,em_frame+1);
-    else
-      LOG_INFO("  Osem3d {} reconstruction started", out_img_file);
-
-    PrepareOsem3dFiles();
-    time(&t0);
-    Init_Image();
-    CalculateOsem3d(em_frame);
-    // Save image if not already done as intermediate image
-    if (!saveFlag) SaveImage(out_img_file,iterations, em_frame);
-    if (ecat_flag)
-      LOG_INFO("  Osem3d {},{} done in {} sec",out_img_file, em_frame+1, t1-t2);
-    else
-      LOG_INFO("  Osem3d {}  done in {} sec",out_img_file,t1-t2);
-    // clean ra_smo_file
-#ifndef WIN_X64
-    if (strlen(ra_smo_file) && access(ra_smo_file,0) == 0) unlink(ra_smo_file);
-#endif
+    SetFrameFiles(em_frame);
+    OpenFrameFiles();
+    ReconstructFrame(em_frame, em_frame);
   }
 
   return 0;
@@ -20,9 +20,23 @@ For commercial use, please contact zcho@gachon.ac.kr or isslhong@kpu.ac.kr
 /* Modifications history:
    08-MAY-2008: Bug fix for low resolution mode (M. Sibomana)
  - 02-JUL-2009: Add dual logging to console and file
+ - 19-OCT-2026: Projector shared with je_hrrt_osem3d; forward_proj3d_view1_thread, back_proj3d_view_n1thread
+                and rotateimage2 specialized at compile time for the HRRT geometries
 */
 #include "compile.h"
 
+#define _REENTRANT
+#define _POSIX_SOURCE
+#define _P __P
+#include <pthread.h>
+#include <pmmintrin.h>
+#include <math.h>
+#include <alloca.h>
+#define _alloca alloca
+#include <stdarg.h>
+#ifndef _MAX_PATH
+#define _MAX_PATH 256
+#endif
 #include "mm_malloc.h"
 #include <time.h>
 
@@ -88,6 +102,20 @@ int forward_proj3d_view1_thread(float ***image,float ***prj,int view,int theta2,
 								int xr_start,int xr_end,float ***imagebuf);
 int back_proj3d_view_n1thread(float ***image,float ***prj, int view_90flag,int view,int verbose,int x_start,int x_end);
 
+/*
+*	The projector kernels are templates on the image geometry: ZP is z_pixels, XP is x_pixels (=y_pixels),
+*	0 for the runtime value.  Each kernel shadows the globals with these constants, so that the loops over
+*	z_pixels_simd and x_pixels have compile time bounds the compiler can unroll.  The segment and view
+*	bounds (span, views) come from lookup tables and stay runtime: span only sets the number of segments
+*	(th_pixels) and the yr_bottom/yr_top ranges of the outer loops, so there is no span specialization.
+*	PROJECTOR_DISPATCH calls the kernel of the HRRT normal (256x256x207) or low resolution (128x128x207)
+*	image, or the generic kernel for other geometries.
+*/
+#define PROJECTOR_DISPATCH(func, args) \
+	if (z_pixels==207 && x_pixels==256 && y_pixels==256) return func<207,256> args; \
+	if (z_pixels==207 && x_pixels==128 && y_pixels==128) return func<207,128> args; \
+	return func<0,0> args;
+
 typedef struct {
 	unsigned short z_start;
 	unsigned short yr_start;
@@ -1134,8 +1162,12 @@ void rotateimage2_bspline(float ***image,float ***outimage,int view,int xs,int x
 		}
 	}
 }
-void rotateimage2(float ***ima,float ***out,int view,int xs,int xe){
-	unsigned int x,y,z;
+template <int ZP, int XP>
+static void rotateimage2_geom(float ***ima,float ***out,int view,int xs,int xe){
+	const int z_pixels_simd = ZP ? (ZP+3)/4 : ::z_pixels_simd;
+	const int x_pixels = XP ? XP : ::x_pixels;
+	const int y_pixels = XP ? XP : ::y_pixels;
+	int x,y,z;
 	float cosv,sinv;
 	int xx,yy;
 	float xx0,yy0,xxx0,yyy0;
@@ -1185,6 +1217,10 @@ void rotateimage2(float ***ima,float ***out,int view,int xs,int xe){
 	}
 }
 
+void rotateimage2(float ***ima,float ***out,int view,int xs,int xe){
+	PROJECTOR_DISPATCH(rotateimage2_geom, (ima,out,view,xs,xe));
+}
+
 int rotate3d2(float ***ima,float ***out,int view, int xstart, int xend) {
 	rotateimage2(ima,out,view,xstart,xend);
 	return 1;
@@ -1725,9 +1761,14 @@ int	rotate_image_buf(float ****imagebuf,float ***ima,int numthread,int *view)
 }
 
 
-int forward_proj3d_view1_thread(float ***image,float ***prj,int view,int theta2,int verbose,
+template <int ZP, int XP>
+static int forward_proj3d_view1_thread_geom(float ***image,float ***prj,int view,int theta2,int verbose,
 								int xr_start,int xr_end,float ***imagebuf)
 {
+	const int z_pixels = ZP ? ZP : ::z_pixels;
+	const int z_pixels_simd = ZP ? (ZP+3)/4 : ::z_pixels_simd;
+	const int x_pixels = XP ? XP : ::x_pixels;
+	const int y_pixels = XP ? XP : ::y_pixels;
 
 	int x, y,i,z,yr,yri; /* integer voxel indices               */
 	int z2;      /* integer indices for 2D-projections  */
@@ -1977,6 +2018,12 @@ int forward_proj3d_view1_thread(float ***image,float ***prj,int view,int theta2,
 	return 1;
 } /* end of forward_proj3d_view() */
 
+int forward_proj3d_view1_thread(float ***image,float ***prj,int view,int theta2,int verbose,
+								int xr_start,int xr_end,float ***imagebuf)
+{
+	PROJECTOR_DISPATCH(forward_proj3d_view1_thread_geom, (image,prj,view,theta2,verbose,xr_start,xr_end,imagebuf));
+}
+
 int forward_proj3d_view1_thread_2d(float ***image,float ***prj,int view,int theta2,int verbose,
 								int xr_start,int xr_end,float ***imagebuf)
 {
@@ -4159,8 +4206,13 @@ return 1;
 //	return 1;
 //}
 
-int back_proj3d_view_n1thread(float ***image,float ***prj, int view_90flag,int view,int verbose,int x_start,int x_end)
+template <int ZP, int XP>
+static int back_proj3d_view_n1thread_geom(float ***image,float ***prj, int view_90flag,int view,int verbose,int x_start,int x_end)
 {
+	const int z_pixels = ZP ? ZP : ::z_pixels;
+	const int z_pixels_simd = ZP ? (ZP+3)/4 : ::z_pixels_simd;
+	const int x_pixels = XP ? XP : ::x_pixels;
+	const int y_pixels = XP ? XP : ::y_pixels;
 	Backprojection_lookup lptr1[MAXGROUP];
 	Backprojection_lookup lptr2[MAXGROUP];
 	short		th,th2;
@@ -4667,6 +4719,11 @@ norm_zero_mask_label:
 	return 1;
 }
 
+int back_proj3d_view_n1thread(float ***image,float ***prj, int view_90flag,int view,int verbose,int x_start,int x_end)
+{
+	PROJECTOR_DISPATCH(back_proj3d_view_n1thread_geom, (image,prj,view_90flag,view,verbose,x_start,x_end));
+}
+
 //int back_proj3d_view_n1thread_lor(float ***image,float ***prj, int view_90flag,int view,int verbose,int x_start,int x_end)
 //{
 //	Backprojection_lookup lptr1[MAXGROUP];
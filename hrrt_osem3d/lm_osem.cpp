@@ -0,0 +1,235 @@
+/*
+lm_osem.cpp
+Listmode OSEM projection of the prompt events of a frame, see lm_osem.h.
+Creation date: 19-OCT-2026
+
+The LOR of an event is traced with Joseph's method: one sample per image row (or column for views
+closer to 90 degrees), interpolated bilinearly in the transverse direction and the next row, linearly
+in z.  The geometry is that of the sbrt projector:
+  s = x*cos(psi) + y*sin(psi)   radial position, xr = s/sino_sampling + xr_pixels/2
+  t = -x*sin(psi) + y*cos(psi)  position along the LOR
+  z = yr - t*tan(theta)/z_size  image plane of sinogram plane yr of segment theta
+Each thread projects a contiguous part of the subset events and backprojects in its own image buffer,
+buffers are then summed into the correction image.
+*/
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "hrrt_osem3d.h"
+#include "lm_osem.h"
+#include "my_spdlog.hpp"
+#include "hrrt_common/lm_events.hpp"
+
+extern float epsilon3;
+
+typedef struct {
+  unsigned short view, xr, plane;
+} LMEvent;
+
+typedef struct {
+  float ***image, ***imagebuf, ***additive;
+  size_t start, end;
+} LMProject_ptargs;
+
+typedef struct {
+  float ***correction;
+  float ****imagebuf;
+  int start, end;
+} LMReduce_ptargs;
+
+static std::vector<LMEvent> lm_events_list;  // time ordered events
+static std::vector<short> plane_theta;       // segment of each sinogram plane
+static std::vector<short> plane_yr;          // image plane of each sinogram plane
+
+static inline bool in_fov(int x, int y)
+{
+  return y >= cylwiny[x][0] && y < cylwiny[x][1];
+}
+
+static float project_lor(float ***t_image, int t_view, int t_xr, int t_plane, bool t_back, float t_value)
+{
+  int theta = plane_theta[t_plane];
+  float cpsi = cos_psi[t_view], spsi = sin_psi[t_view];
+  float s = (t_xr - xr_pixels/2) * sino_sampling;
+  float dz = sin_theta[theta] / cos_theta[theta] / z_size;   // image planes per mm along the LOR
+  float z0 = (float) plane_yr[t_plane];
+  int x_off = x_pixels/2, y_off = y_pixels/2;
+  bool step_y = fabs(cpsi) >= fabs(spsi);
+  int nsteps = step_y ? y_pixels : x_pixels;
+  int nlines = step_y ? x_pixels : y_pixels;
+  float w = x_size / (step_y ? fabs(cpsi) : fabs(spsi)) / cos_theta[theta];
+  float sum = 0.0f;
+
+  for (int i = 0; i < nsteps; i++) {
+    float t, f;
+    if (step_y) {                   // y = i: x = s*cos - t*sin
+      t = ((i - y_off)*x_size - s*spsi) / cpsi;
+      f = (s*cpsi - t*spsi) / x_size + x_off;
+    } else {                        // x = i: y = s*sin + t*cos
+      t = (s*cpsi - (i - x_off)*x_size) / spsi;
+      f = (s*spsi + t*cpsi) / x_size + y_off;
+    }
+    if (f < 0 || f >= nlines - 1) continue;
+    float fz = z0 - t*dz;
+    if (fz < 0 || fz > z_pixels - 1) continue;
+    int j = (int) f, k = (int) fz;
+    if (k == z_pixels - 1) k--;
+    float a = f - j, az = fz - k;
+    float *v0, *v1;
+    bool in0, in1;
+    if (step_y) {
+      v0 = t_image[j][i];   in0 = in_fov(j, i);
+      v1 = t_image[j+1][i]; in1 = in_fov(j+1, i);
+    } else {
+      v0 = t_image[i][j];   in0 = in_fov(i, j);
+      v1 = t_image[i][j+1]; in1 = in_fov(i, j+1);
+    }
+    float w0 = in0 ? w*(1 - a) : 0.0f, w1 = in1 ? w*a : 0.0f;
+    if (t_back) {
+      float c0 = w0*t_value, c1 = w1*t_value;
+      v0[k] += c0*(1 - az); v0[k+1] += c0*az;
+      v1[k] += c1*(1 - az); v1[k+1] += c1*az;
+    } else {
+      sum += w0*(v0[k]*(1 - az) + v0[k+1]*az) + w1*(v1[k]*(1 - az) + v1[k+1]*az);
+    }
+  }
+  return sum;
+}
+
+static void decode_address(unsigned t_address, int &t_view, int &t_xr, int &t_plane)
+{
+  t_xr = t_address % xr_pixels;
+  t_view = (t_address / xr_pixels) % views;
+  t_plane = t_address / (xr_pixels*views);
+}
+
+/* Sinogram bin of view, plane, xr in the recon layout: views+90 are stored after segmentsize planes */
+template <typename T>
+static T &prj_bin(T ***t_prj, int t_view, int t_xr, int t_plane)
+{
+  if (t_view < views/2) return t_prj[t_view][t_plane][t_xr];
+  return t_prj[t_view - views/2][t_plane + segmentsize][t_xr];
+}
+
+static void init_plane_tables()
+{
+  plane_theta.assign(segmentsize, 0);
+  plane_yr.assign(segmentsize, 0);
+  for (int theta = 0; theta < th_pixels; theta++) {
+    for (int yr = yr_bottom[theta]; yr <= yr_top[theta]; yr++) {
+      plane_theta[segment_offset[theta] + yr - yr_bottom[theta]] = theta;
+      plane_yr[segment_offset[theta] + yr - yr_bottom[theta]] = yr;
+    }
+  }
+}
+
+size_t lm_osem_init(const char *t_filename, short ***t_prompts, float ***t_promptsf)
+{
+  lm_events::FileHeader hdr;
+  std::vector<uint32_t> addresses;
+  if (lm_events::read(t_filename, hdr, addresses)) {
+    LOG_EXIT("Error reading listmode events {}", t_filename);
+  }
+  if ((int)hdr.nprojs != xr_pixels || (int)hdr.nviews != views || (int)hdr.nplanes != segmentsize) {
+    LOG_EXIT("{}: {}x{}x{} sinogram does not match {}x{}x{}", t_filename, hdr.nprojs, hdr.nviews, hdr.nplanes,
+             xr_pixels, views, segmentsize);
+  }
+
+  init_plane_tables();
+  lm_events_list.clear();
+  lm_events_list.reserve(addresses.size());
+  size_t nmasked = 0;
+  for (uint32_t address : addresses) {
+    int view, xr, plane;
+    decode_address(address, view, xr, plane);
+    if (plane >= segmentsize) {
+      nmasked++;
+      continue;
+    }
+    bool masked = (t_promptsf != NULL) ? prj_bin(t_promptsf, view, xr, plane) == 0 : prj_bin(t_prompts, view, xr, plane) == 0;
+    if (masked) {
+      nmasked++;
+      continue;
+    }
+    LMEvent ev = {(unsigned short) view, (unsigned short) xr, (unsigned short) plane};
+    lm_events_list.push_back(ev);
+  }
+  LOG_INFO("{}: {} events, {} masked, start {} duration {}", t_filename, addresses.size(), nmasked,
+           hdr.start_time, hdr.duration);
+  return lm_events_list.size();
+}
+
+void lm_osem_free()
+{
+  std::vector<LMEvent>().swap(lm_events_list);
+}
+
+float lm_project_address(float ***t_image, unsigned t_address, bool t_back, float t_value)
+{
+  int view, xr, plane;
+  if ((int) plane_theta.size() != segmentsize) init_plane_tables();
+  decode_address(t_address, view, xr, plane);
+  return project_lor(t_image, view, xr, plane, t_back, t_value);
+}
+
+FUNCPTR pt_lm_project(void *ptarg)
+{
+  LMProject_ptargs *arg = (LMProject_ptargs *) ptarg;
+  for (int x = 0; x < x_pixels; x++)
+    for (int y = cylwiny[x][0]; y < cylwiny[x][1]; y++)
+      memset(arg->imagebuf[x][y], 0, z_pixels_simd*4*sizeof(float));
+
+  for (size_t i = arg->start; i < arg->end; i++) {
+    const LMEvent &ev = lm_events_list[i];
+    float den = project_lor(arg->image, ev.view, ev.xr, ev.plane, false, 0.0f) +
+                prj_bin(arg->additive, ev.view, ev.xr, ev.plane);
+    if (den > epsilon3)
+      project_lor(arg->imagebuf, ev.view, ev.xr, ev.plane, true, 1.0f/den);
+  }
+  return 0;
+}
+
+FUNCPTR pt_lm_reduce(void *ptarg)
+{
+  LMReduce_ptargs *arg = (LMReduce_ptargs *) ptarg;
+  for (int x = arg->start; x < arg->end; x++) {
+    for (int y = cylwiny[x][0]; y < cylwiny[x][1]; y++) {
+      float *cptr = arg->correction[x][y];
+      for (int thr = 0; thr < nthreads; thr++) {
+        float *bptr = arg->imagebuf[thr][x][y];
+        for (int z = 0; z < z_pixels; z++) cptr[z] += bptr[z];
+      }
+    }
+  }
+  return 0;
+}
+
+void lm_osem_subset(float ***t_image, float ***t_correction, float ***t_additive, int t_subset, int t_subsets,
+                    float ****t_imagebuf)
+{
+  pthread_t th[MAXTHREADS];
+  LMProject_ptargs parg[MAXTHREADS];
+  LMReduce_ptargs rarg[MAXTHREADS];
+  size_t nevents = lm_events_list.size();
+  size_t first = nevents*t_subset/t_subsets, last = nevents*(t_subset + 1)/t_subsets;
+  int thr;
+
+  for (thr = 0; thr < nthreads; thr++) {
+    parg[thr].image = t_image;
+    parg[thr].imagebuf = t_imagebuf[thr];
+    parg[thr].additive = t_additive;
+    parg[thr].start = first + (last - first)*thr/nthreads;
+    parg[thr].end = first + (last - first)*(thr + 1)/nthreads;
+    START_THREAD(th[thr], pt_lm_project, parg[thr], thr);
+  }
+  for (thr = 0; thr < nthreads; thr++) Wait_thread(th[thr]);
+
+  for (thr = 0; thr < nthreads; thr++) {
+    rarg[thr].correction = t_correction;
+    rarg[thr].imagebuf = t_imagebuf;
+    rarg[thr].start = x_pixels*thr/nthreads;
+    rarg[thr].end = x_pixels*(thr + 1)/nthreads;
+    START_THREAD(th[thr], pt_lm_reduce, rarg[thr], thr);
+  }
+  for (thr = 0; thr < nthreads; thr++) Wait_thread(th[thr]);
+}
@@ -0,0 +1,23 @@
+/*
+  lm_osem.h
+  Listmode OSEM of low count frames: only the lines of response of the prompt events of the frame
+  (hrrt_common/lm_events.hpp) are projected, so that the cost of an iteration scales with the counts
+  instead of the sinogram size.  Events are cut in time ordered subsets, each subset is shared by all threads.
+*/
+# pragma once
+
+/* Read the events of t_filename and keep the events of bins that are not masked (prompt sinogram
+   set to 0 where the normalization is 0); t_prompts or t_promptsf is the prompt sinogram largeprjshort or largeprjfloat.
+   Returns the number of events kept, exits on error. */
+size_t lm_osem_init(const char *t_filename, short ***t_prompts, float ***t_promptsf);
+void lm_osem_free();
+
+/* Add to t_correction the backprojection of 1/(forward projection + t_additive) over the LORs of
+   the events of subset t_subset of t_subsets; t_additive is the OP-OSEM additive sinogram (largeprj),
+   t_imagebuf are nthreads image buffers. */
+void lm_osem_subset(float ***t_image, float ***t_correction, float ***t_additive, int t_subset, int t_subsets,
+                    float ****t_imagebuf);
+
+/* Ray driven (Joseph) projection of the LOR of sinogram address t_address ((plane*views+view)*xr_pixels+xr):
+   returns the forward projection of t_image, or adds t_value along the LOR to t_image if t_back is set. */
+float lm_project_address(float ***t_image, unsigned t_address, bool t_back, float t_value);
@@ -4,7 +4,7 @@
 
 /** Program version. */
 
-#define PROG_VERSION "2.4.3"
+#define PROG_VERSION "2.5.0"
 
 /** Copyright. */
 
@@ -17,6 +17,10 @@
 #include <string.h>
 #include <time.h>
 #include <sys/stat.h>
+#include <pthread.h>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 #include "my_spdlog.hpp"
 
 #include <unistd.h>
@@ -296,6 +300,11 @@ HISTORY/VERSION:
 2010-09-21: Added data data rates (prompt, random, single) and scatter fraction
             to image header; and changed sw_version from 72 to 73 in main header
             (Merence sibomana) - changed version to 2.4.3
+2026-10-19: Frames are converted in parallel (-j threads) and written in frame
+            order. Headers are parsed once per frame and all corrections are
+            applied as one combined factor per plane.
+            Bug fix: slice sensitivity read past the last plane in the file.
+            - changed version to 2.5.0
 
      - to do: optons to include radiopharmaceutical, date in outfilename
 
@@ -331,7 +340,7 @@ void usage(char *cmd)
     printf("      [-g witdh] [-c calibfactor] [-s slicesensfile] [-u units]\n");
     printf("      [-r startplane endplane] [-p pixel x0 y0] [-w startframe endframe]\n");
     printf("      [-o outfile] [-e deadtimeExponent] [-q maxpixel]\n");
-    printf("      [-F FacilityName] [-D DuplicateDir] [-T pixel] [-l] \n");
+    printf("      [-F FacilityName] [-D DuplicateDir] [-T pixel] [-l] [-j threads]\n");
     printf("      interfile_image\n" );
     printf("\n");
     printf("The program converts interfile images to ECAT7 format.\n");
@@ -359,6 +368,8 @@ void usage(char *cmd)
     printf("-g gsmooth_width  width of blurring kernel in mm used by the gsmooth function.\n");
     printf("-i isotope     Obsolete as it can be taken from the header.\n");
     printf("               <isotope> can be 'C-11', 'O-15', 'F-18' 'Ga-68' or 'Ge-68' \n");
+    printf("-j threads     number of frames converted in parallel\n");
+    printf("               (default: number of processors).\n");
     printf("-m             multiplies matrix pixel values with <calibFactor>.\n");
     printf("               Obsolete as image tools (MEDx, Vinci, YaIT) and the conversion\n");
     printf("               program to Analyse format do the calibration internally.\n");
@@ -425,7 +436,7 @@ void usage(char *cmd)
     printf("      [-g witdh] [-c calibfactor] [-s slicesensfile] [-u units]\n");
     printf("      [-r startplane endplane] [-p pixel x0 y0] [-w startframe endframe]\n");
     printf("      [-o outfile] [-e deadtimeExponent] [-q maxpixel]\n");
-    printf("      [-F FacilityName] [-D DuplicateDir] [-T pixel] [-l] \n");
+    printf("      [-F FacilityName] [-D DuplicateDir] [-T pixel] [-l] [-j threads]\n");
     printf("      interfile_image\n" );
     printf("\n");
     exit(0);
@@ -524,7 +535,7 @@ unsigned char *CreateHRRTMuMask(const char *filename)
 int ecat7WriteImageMatrix(ecat_matrix::MatrixFile *fp, int mat_id, ecat_matrix::Image_subheader *imh, 
                           float *fdata, unsigned char *mask)
 {
-    int i, nvoxels;
+    int i, nvoxels, ret;
     float minval, maxval, scalef;
     ecat_matrix::MatrixData *matrix=NULL;
     short *sdata=NULL, smax=32766;  // not 32767 to avoid rounding problems
@@ -589,9 +600,9 @@ int ecat7WriteImageMatrix(ecat_matrix::MatrixFile *fp, int mat_id, ecat_matrix::
     matrix->shptr = (void *)calloc(sizeof(ecat_matrix::Image_subheader), 1);
     memcpy(matrix->shptr, imh, sizeof(ecat_matrix::Image_subheader));
 
-    
-    
-    return matrix_write(fp, mat_id, matrix);
+    ret = matrix_write(fp, mat_id, matrix);
+    free_matrix_data(matrix);
+    return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -912,6 +923,239 @@ static int read_sensitivity(const char *fname, float **pSliceSensitivity,
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+/*!
+ * One frame of the study: interfile image, correction factors and subheader,
+ * resolved in frame order by main(), converted by a frame worker.
+ */
+typedef struct {
+  short int frame;                                          /* frame number */
+  char      fname[256], fnameTail[256];            /* interfile image of frame */
+  char      smoothCommand[MAX_CMD_LEN];           /* gsmooth command, or "" */
+  short int dimx, dimy, dimz;                       /* interfile image size */
+  float     *planeScale;   /* combined correction factor per plane, or NULL */
+  float     pixelMax;                     /* maximum pixel value, 0 if none */
+  short int reduce;                   /* reduce the matrix to the following */
+  short int startPlane, endPlane, dimxOutfile, xCentre, yCentre;
+  ecat_matrix::Image_subheader image_header;
+  float     *data;               /* converted matrix, NULL if conversion failed */
+  short int done;                                    /* set by frame worker */
+} FrameJob;
+
+/*!
+ * Frame workers convert the frames in parallel; main() writes them in frame
+ * order. Workers stay at most 'window' frames ahead of the writer to bound
+ * memory use.
+ */
+typedef struct {
+  FrameJob  *jobs;
+  int       numJobs;
+  int       next;                                /* next frame to convert */
+  int       written;                           /* frames released by writer */
+  int       window;
+  int       stop;
+  int       numThreads;
+  pthread_t *threads;
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+} FramePool;
+
+///////////////////////////////////////////////////////////////////////////////
+/*!
+ * Multiply each plane of data with its factor and clip to maxval (if > 0).
+ */
+static void scale_planes(float *data, long int planeSize, int dimz, const float *planeScale,
+                         float maxval)
+{
+  int z;
+  long int j;
+
+  for (z=0; z<dimz; z++) {
+    float *p = data + z*planeSize;
+    float s = planeScale[z];
+    j = 0;
+#ifdef __SSE__
+    __m128 vs = _mm_set1_ps(s), vmax = _mm_set1_ps(maxval);
+    if (maxval > 0.0f) {
+      /* min(vmax, p*s) keeps NaN like the scalar comparison below */
+      for (; j+4<=planeSize; j+=4) 
+        _mm_storeu_ps(p+j, _mm_min_ps(vmax, _mm_mul_ps(_mm_loadu_ps(p+j), vs)));
+    } else {
+      for (; j+4<=planeSize; j+=4) 
+        _mm_storeu_ps(p+j, _mm_mul_ps(_mm_loadu_ps(p+j), vs));
+    }
+#endif
+    for (; j<planeSize; j++) {
+      p[j] *= s;
+      if (maxval > 0.0f && p[j] > maxval) p[j] = maxval;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/*!
+ * Cut planes startPlane..endPlane and a dimxOutfile^2 square around
+ * (xCentre,yCentre) out of the frame matrix. Returns NULL on error.
+ */
+static float *reduce_matrix(const FrameJob *job, const float *matrix_float)
+{
+  short int x, y, z;
+  long int j=0, size;
+  float *matrix_float_reduced;
+  short int dimx=job->dimx, dimy=job->dimy, dimz=job->dimz;
+  short int dimxOutfile=job->dimxOutfile;
+
+  size = (long int)dimxOutfile*dimxOutfile*(job->endPlane-job->startPlane+1);
+  matrix_float_reduced = (float *) malloc(size*sizeof(float));
+  for (z=0;z<dimz;z++) {
+    if (z < job->startPlane || z > job->endPlane) continue;
+    for (y=0;y<dimy;y++) {
+      if (dimy != dimxOutfile &&
+          (y<=floor(job->yCentre-(float)dimxOutfile/2) || 
+           y>floor(job->yCentre+(float)dimxOutfile/2))
+          ) 
+        continue;
+      for (x=0;x<dimx;x++) {
+        if (dimx != dimxOutfile &&
+            (x<=floor(job->xCentre-(float)dimxOutfile/2) ||
+             x>floor(job->xCentre+(float)dimxOutfile/2))
+            )
+          continue;
+        if (j >= size) {
+          LOG_ERROR( "error: seems to be a programming error while reducing matrix size. j = {} x={}, y={}, z={}", j, x, y, z);
+          free(matrix_float_reduced);
+          return NULL;
+        }
+        matrix_float_reduced[j] = matrix_float[x+y*dimx+(long int)z*dimx*dimy];
+        j ++;
+      }
+    }
+  }
+  return matrix_float_reduced;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/*!
+ * Smooth (if requested), read, correct and reduce the matrix of one frame.
+ * Sets job->data, which stays NULL on error.
+ */
+static void convert_frame(FrameJob *job)
+{
+  FILE *inputImage;
+  float *matrix_float, *matrix_float_reduced;
+  long int planeSize = (long int)job->dimx*job->dimy;
+  long int nvoxels = planeSize*job->dimz;
+
+  if (job->smoothCommand[0] != '\0') 
+    system(job->smoothCommand);
+                                                     /* ... and read the file */
+  LOG_INFO("  reading {}", job->fnameTail);
+  if ((inputImage = fopen(job->fname, "rb")) == NULL) {
+    LOG_ERROR( "ERROR opening image file {}", job->fname);
+    return;
+  }
+  matrix_float = (float *) malloc(nvoxels*sizeof(float));
+  if (fread(matrix_float, sizeof (float), nvoxels, inputImage) != (size_t)nvoxels) {
+    LOG_ERROR( "ERROR reading image file {}", job->fname);
+    fclose(inputImage);
+    free(matrix_float);
+    return;
+  }
+  fclose(inputImage);
+                                                 /* all corrections at once */
+  if (job->planeScale != NULL) 
+    scale_planes(matrix_float, planeSize, job->dimz, job->planeScale, job->pixelMax);
+
+  if (job->reduce) {
+    matrix_float_reduced = reduce_matrix(job, matrix_float);
+    free(matrix_float);
+    matrix_float = matrix_float_reduced;
+  }
+  job->data = matrix_float;
+}
+
+static void *frame_worker(void *arg)
+{
+  FramePool *pool = (FramePool *)arg;
+  FrameJob *job;
+
+  pthread_mutex_lock(&pool->mutex);
+  while (1) {
+    while (!pool->stop && pool->next < pool->numJobs && 
+           pool->next >= pool->written+pool->window) 
+      pthread_cond_wait(&pool->cond, &pool->mutex);
+    if (pool->stop || pool->next >= pool->numJobs) break;
+    job = &pool->jobs[pool->next++];
+    pthread_mutex_unlock(&pool->mutex);
+    convert_frame(job);
+    pthread_mutex_lock(&pool->mutex);
+    job->done = 1;
+    pthread_cond_broadcast(&pool->cond);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+static void frame_pool_start(FramePool *pool, FrameJob *jobs, int numJobs, int numThreads)
+{
+  int i;
+
+  pool->jobs = jobs;
+  pool->numJobs = numJobs;
+  pool->next = pool->written = pool->stop = 0;
+  pool->window = numThreads+1;           /* keep all workers busy while writing */
+  pool->threads = (pthread_t *)calloc(numThreads, sizeof(pthread_t));
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->cond, NULL);
+  for (i=0, pool->numThreads=0; i<numThreads; i++) {
+    if (pthread_create(&pool->threads[i], NULL, frame_worker, pool) != 0) break;
+    pool->numThreads++;
+  }
+}
+
+/*! Wait until frame i is converted */
+static FrameJob *frame_pool_wait(FramePool *pool, int i)
+{
+  FrameJob *job = &pool->jobs[i];
+
+  if (pool->numThreads == 0) {       /* no threads: convert in this thread */
+    convert_frame(job);
+    job->done = 1;
+    return job;
+  }
+  pthread_mutex_lock(&pool->mutex);
+  while (!job->done) pthread_cond_wait(&pool->cond, &pool->mutex);
+  pthread_mutex_unlock(&pool->mutex);
+  return job;
+}
+
+/*! Frame i is written: free its matrix and let the workers move on */
+static void frame_pool_release(FramePool *pool, int i)
+{
+  free(pool->jobs[i].data);
+  pool->jobs[i].data = NULL;
+  pthread_mutex_lock(&pool->mutex);
+  pool->written = i+1;
+  pthread_cond_broadcast(&pool->cond);
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+/*! Stop the workers and free the frames which were not written */
+static void frame_pool_stop(FramePool *pool)
+{
+  int i;
+
+  pthread_mutex_lock(&pool->mutex);
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->cond);
+  pthread_mutex_unlock(&pool->mutex);
+  for (i=0; i<pool->numThreads; i++) pthread_join(pool->threads[i], NULL);
+  for (i=0; i<pool->numJobs; i++) free(pool->jobs[i].data);
+  free(pool->threads);
+  pthread_mutex_destroy(&pool->mutex);
+  pthread_cond_destroy(&pool->cond);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 int main(int argc, char *argv[])
@@ -926,9 +1170,12 @@ int main(int argc, char *argv[])
   long int  j;
   float     *sliceSensitivity = NULL;
   double    decayInFrame, decayFrameStart, frac ; /* decay correction factors */
+  double    frameScale;                /* all corrections of the frame matrix */
+  short int sensPlanes;       /* planes with slice sensitivity correction */
   double    deadtimeCorFactor, deadtimeExponent;                /* dead time  correction factor */
   char      *str=NULL, chr, buffer[32], descr[128], ext[32];
   char      hdrName[256], fname[256], fnameTail[256]; 
+  char      loadedHdr[256]="";              /* interfile header in ifh */
   char      studyName[128];
   char      keyword[256], value[256], line[256];     /* interfile definitions */
                                 /* for splitting file name into max 10 pieces */
@@ -960,10 +1207,11 @@ int main(int argc, char *argv[])
 
                                                                     /* others */
   int       matrixId;
-  float     *matrix_float, *matrix_float_reduced = (float*) NULL; /* img matrix*/
+  FrameJob  *frameJobs=NULL, *job;
+  FramePool pool;
+  int       numJobs, numThreads=0;            /* 0: number of processors */
 
 
-  FILE      *inputImage=NULL;
   ecat_matrix::MatrixFile *ECAT7file=NULL;
   ecat_matrix::Main_header    main_header;
   ecat_matrix::Image_subheader   image_header;
@@ -1180,6 +1428,12 @@ int main(int argc, char *argv[])
         argv++;
        break;
 
+      case 'j':
+        numThreads = atoi(*(argv+1));
+        argc--;
+        argv++;
+        break;
+
       case 'l':
            menuFlag = 1;
            break;
@@ -1398,6 +1652,7 @@ int main(int argc, char *argv[])
 
       // default: file loaded
   }
+  strcpy(loadedHdr, hdrName);
 
 
                                     /* if scannerModel is still unknown try   */
@@ -1881,6 +2136,17 @@ int main(int argc, char *argv[])
 /******************************************************************************/
 /*                           do for each frame                                */
 /******************************************************************************/
+         /* Headers and correction factors are resolved here in frame order, */
+         /* the image data are converted afterwards by the frame workers.    */
+  frameJobs = (FrameJob*)calloc(endFrame-startFrame+1, sizeof(FrameJob));
+  if (gsmooth_width>0) {        /* smoothed frames go to <outFile>_<width>mm.v */
+    char *pext;
+    if ((pext = strrchr(outFile, '.')) == NULL) {
+      LOG_ERROR("ERROR locating file {} extension", outFile);
+      return 1;
+    }
+    sprintf(pext, "_%dmm.v", gsmooth_width);
+  }
   for (frame=startFrame;frame<=endFrame;frame++) {
     if (frame >= frameDurDim) {
         LOG_ERROR( "ERROR: frame %i of %i frames (check -f switch)\n", 
@@ -1888,6 +2154,8 @@ int main(int argc, char *argv[])
         return 1;
       }
     LOG_INFO("{}. frame{}", frame);
+    job = &frameJobs[frame-startFrame];
+    job->frame = frame;
     image_header.processing_code = 0;      /* reset list of corrections done */
 
                                       /* construct filename for HRRT data ... */
@@ -1954,19 +2222,23 @@ int main(int argc, char *argv[])
                                       /* now look for the relevant key words */
                                       /* number format (float, integer...) */
                                   /*Clean table and load header filename */
+                          /* (the header of the input file is already loaded) */
+      if (strcmp(hdrName, loadedHdr) != 0) {
         interfile_clear(&ifh);
         switch(interfile_load(hdrName, &ifh)) {
           case IFH_FILE_INVALID:            /* Not starting with '!INTERFILE' */
                LOG_ERROR( "%s: is not a valid interfile header\n", hdrName);
                return 1;
-             
+
           case IFH_FILE_OPEN_ERROR:    /* interfile header cold not be opened */
                LOG_ERROR( "%s: Can't open file\n", hdrName);
                return 1;
 
                // default: file loaded
         }
-          
+        strcpy(loadedHdr, hdrName);
+      }
+
         value[0]='\0';
         interfile_find(&ifh, "number format", value, sizeof(value));
         if (strcmp(value, "float") != 0) {
@@ -2107,45 +2379,36 @@ int main(int argc, char *argv[])
 
 
   /****************************************************************************/
-  /*                    read the image matrix from file                       */
+  /*                    image matrix file of this frame                       */
   /****************************************************************************/
                          /* don't know what to do, if input file is not float */
-    matrix_float = (float *) malloc(dimx*dimy*dimz*sizeof(float));
+    job->dimx = dimx;
+    job->dimy = dimy;
+    job->dimz = dimz;
 
                   // gaussian smooth image if requested
     if (gsmooth_width>0) {
       char *pext;
-      sprintf(command, "gsmooth %s %d", fname, gsmooth_width);
+      sprintf(job->smoothCommand, "gsmooth %s %d", fname, gsmooth_width);
       LOG_INFO("gsmooth width (default 0): {}", gsmooth_width);
-      LOG_INFO("command: {}", command);
+      LOG_INFO("command: {}", job->smoothCommand);
       if ((pext = strrchr(fname, '.')) == NULL) {
         LOG_ERROR( "ERROR locating file {} extension", fname);
         return 1;
       }
-      system(command);
       sprintf(pext, "_%dmm.%s", gsmooth_width, ext);  // update input file name
-      if ((pext = strrchr(outFile, '.')) != NULL) {
-        sprintf(pext, "_%dmm.v", gsmooth_width);
-      }
-      else {
-        LOG_ERROR( "ERROR locating file %s extension\n", outFile);
-        return 1;
-      }
-    }
-                                                     /* ... and read the file */
-    LOG_INFO("  reading {}", fnameTail);
-    if ((inputImage = fopen(fname, "rb")) == NULL) {
-      LOG_ERROR( "ERROR opening image file %s \n", fname);
-      free(matrix_float);
-      return 1;
     }
-    fread(&matrix_float[0], sizeof (float), dimx*dimy*dimz, inputImage);
-    fclose(inputImage);
+    strcpy(job->fname, fname);
+    strcpy(job->fnameTail, fnameTail);
 
   /****************************************************************************/
   /*               correction/manipulation of matrix data                     */
   /****************************************************************************/
 
+             /* All corrections are multiplications of the matrix; they are   */
+             /* combined into one factor per plane (job->planeScale) which    */
+             /* the frame workers apply in a single pass.                     */
+
                              /* don't make any corrections if the data are    */
                              /* already corrected or if the '-x' switch is on */
     if (toCalibrate == -2) {
@@ -2176,8 +2439,7 @@ int main(int argc, char *argv[])
     } else {
         /*** normalize for different acquisition times (counts -> counts/s) ***/
       LOG_INFO("  normalising for acquisition duration: {} s\n", frameDuration[frame]);
-      for (j=0;j<dimx*dimy*dimz;j++) 
-        matrix_float[j] = matrix_float[j] / frameDuration[frame];
+      frameScale = 1.0 / frameDuration[frame];
       strcpy(main_header.data_units, "counts/s");/* write units to main header */
       if (!strcmp(scannerModel, "HRRT")) 
         strcpy(main_header.data_units, "HRRT counts/s");
@@ -2187,7 +2449,6 @@ int main(int argc, char *argv[])
       if(main_header.isotope_halflife == 0) {
         LOG_ERROR( "\nERROR: Which isotope?? Which halflife time??"
                       "Can't do decay correction.\n");
-        free(matrix_float);
         return 1;
       }
                                                                   /* in frame */
@@ -2197,8 +2458,7 @@ int main(int argc, char *argv[])
       decayFrameStart = exp(frameStart/main_header.isotope_halflife*log(2));
       LOG_INFO("{} (in frame) and {} (frame start)", decayInFrame, decayFrameStart);
                                       /* apply decay correction to scan start */
-      for (j=0;j<dimx*dimy*dimz;j++) 
-        matrix_float[j] = (float)(matrix_float[j] * decayInFrame * decayFrameStart);
+      frameScale *= decayInFrame * decayFrameStart;
                                 /* write decay correction factor to subheader */
       image_header.decay_corr_fctr = (float)(decayInFrame * decayFrameStart);
       image_header.processing_code += E7_APPLIED_PROC_Decay_correction;                     /* decay corrected */
@@ -2206,6 +2466,7 @@ int main(int argc, char *argv[])
       fflush(stdout);
 
    /* rest of calibration only if scatter and attenuation correction are done */
+      sensPlanes = 0;
       if (toCalibrate != 1) { 
         main_header.calibration_factor = 1.0f;
         main_header.calibration_units = 0;    /* 0=uncalibrated, 1=calibrated */
@@ -2218,14 +2479,11 @@ int main(int argc, char *argv[])
           LOG_ERROR( "WARNING: no slice sensitivity values available");
         }
         else {
-          for (z=0;z<dimz;z++) {
-            if (z > sliceSensDim) {
-              LOG_ERROR( "WARNING: slice sensitivity values available only for {} planes out of {}!", sliceSensDim, dimz);
-              LOG_INFO("  slice sensitivity correction stoped after {} slices", sliceSensDim);
-              break;
-            }
-            for (j=0;j<dimx*dimy;j++) 
-              matrix_float[z*dimx*dimy+j] *= sliceSensitivity[z] ;
+          sensPlanes = dimz;
+          if (dimz > sliceSensDim) {
+            LOG_ERROR( "WARNING: slice sensitivity values available only for {} planes out of {}!", sliceSensDim, dimz);
+            LOG_INFO("  slice sensitivity correction stoped after {} slices", sliceSensDim);
+            sensPlanes = sliceSensDim;
           }
         }
       }
@@ -2244,19 +2502,15 @@ int main(int argc, char *argv[])
           LOG_ERROR( "error: branching fraction is unknown but needed for calibration.\n");
           LOG_ERROR( "       Try to use the '-i isotope' switch as this sets the"
                                   "branching factor.\n");
-          free(matrix_float);
-          if (ECAT7file != NULL) matrix_close(ECAT7file);
           return 1;
         }
         LOG_INFO("  dividing matrix by branching fraction {}", main_header.branching_fraction);
-        for (j=0;j<dimx*dimy*dimz;j++) 
-          matrix_float[j] = matrix_float[j] / main_header.branching_fraction;
+        frameScale /= main_header.branching_fraction;
 
                                                   /*** dead time correction ***/
         /* deadtime correction factor is taken from the HRRT-interfile-header */
        LOG_INFO("  applying deadtime correction: {}", deadtimeCorFactor);
-        for (j=0;j<dimx*dimy*dimz;j++) 
-          matrix_float[j] = (float)(matrix_float[j] * deadtimeCorFactor);
+        frameScale *= deadtimeCorFactor;
 
                   /*** multiply matrix with calibration factor if requested ***/
 
@@ -2267,8 +2521,7 @@ int main(int argc, char *argv[])
      
         if (multPixWithCalibFactor == 1) {
           LOG_INFO("  multiplying matrix with calibration factor {}", calibFactor);
-          for (j=0;j<dimx*dimy*dimz;j++) 
-            matrix_float[j] = matrix_float[j] * calibFactor;
+          frameScale *= calibFactor;
         }
      /* (fvv) Option to define a maximum pixel value. During ANW 3DOSEM, we   */
      /* obtained some image artifacts like overrepresentation of some pixel   */
@@ -2280,12 +2533,15 @@ int main(int argc, char *argv[])
         if (pixelMax > 0.0f) 
         {                                                                 
           LOG_INFO("  applying maximum pixel correction {}", pixelMax);
-          for (j = 0; j < dimx*dimy*dimz; j++)          {
-            if (matrix_float[j] > pixelMax)
-            {	
-        	  matrix_float[j] = pixelMax;
-            }
-          }
+          job->pixelMax = pixelMax;
+        }
+                                     /* combined correction factor per plane */
+        job->planeScale = (float *) malloc(dimz*sizeof(float));
+        for (z=0;z<dimz;z++) {
+          if (z < sensPlanes)
+            job->planeScale[z] = (float)(frameScale * sliceSensitivity[z]);
+          else
+            job->planeScale[z] = (float)frameScale;
         }
        	                          /* update main header for calibrated images */
         main_header.calibration_factor = calibFactor;
@@ -2316,81 +2572,69 @@ int main(int argc, char *argv[])
           yCentre-dimxOutfile/2 < 0 || yCentre+dimxOutfile/2 > dimy) {
         LOG_ERROR( "error: centre pixel coordiantes ({}/{}) out of range for a {} x {} matrix", xCentre, yCentre, dimxOutfile, dimxOutfile);
         LOG_ERROR( "       from a {} x {} image\n\n", dimx, dimy);
-        free(matrix_float);
-        if (ECAT7file != NULL) matrix_close(ECAT7file);
         return 1;
       }
-                              /* allocate memory for matrix with reduced size */
-      matrix_float_reduced = (float *) malloc(dimxOutfile*dimxOutfile*(endPlane-startPlane+1)*sizeof(float));
-      j=0;
-      for (z=0;z<dimz;z++) {
-        if (z < startPlane || z > endPlane) continue;
-        for (y=0;y<dimy;y++) {
-          if (dimy != dimxOutfile &&
-              (y<=floor(yCentre-(float)dimxOutfile/2) || 
-               y>floor(yCentre+(float)dimxOutfile/2))
-              ) 
-            continue;
-          for (x=0;x<dimx;x++) {
-            if (dimx != dimxOutfile &&
-                (x<=floor(xCentre-(float)dimxOutfile/2) ||
-                 x>floor(xCentre+(float)dimxOutfile/2))
-                )
-              continue;
-            if (j > dimxOutfile*dimxOutfile*(endPlane-startPlane+1)) {
-              LOG_ERROR( "error: seems to be a programming error while reducing matrix size.\n j = %li x=%i, y=%i, z=%i\n", j, x, y, z);
-              free(matrix_float);
-              free(matrix_float_reduced);
-              if (ECAT7file != NULL) matrix_close(ECAT7file);
-              return 1;
-            }
-            matrix_float_reduced[j] = matrix_float[x+y*dimx+z*dimx*dimy];
-            j ++;
-          }
-        }
-      }
+      job->reduce = 1;
+      job->startPlane = startPlane;
+      job->endPlane = endPlane;
+      job->dimxOutfile = dimxOutfile;
+      job->xCentre = xCentre;
+      job->yCentre = yCentre;
     }
+    job->image_header = image_header;
 
   /****************************************************************************/
-  /*     if frame == startFrame write mainheader and matrix to file           */
+  /*                          goto next frame                                 */
   /****************************************************************************/
 
-    if (frame == startFrame) {  
-      LOG_INFO("-> writing main header to {}", outFileTail);
-                                                 /* write main header to file */
-      ECAT7file=matrix_create(outFile, ecat_matrix::MatrixFileAccessMode::CREATE_NEW_FILE, &main_header);
-      if(ECAT7file == NULL) {
-        LOG_ERROR( "ERROR: cannot write main header %s.\n", outFile);
-        return 1;
-      }
-    }
-
-    fflush(stdout);
+    frameStart = frameStart + frameDuration[frame];
+  }
 
-  /****************************************************************************/
-  /*                 write subheader and matrix to file                       */
-  /****************************************************************************/
+/******************************************************************************/
+/*        convert the frames in parallel and write them in frame order        */
+/******************************************************************************/
 
+  LOG_INFO("-> writing main header to {}", outFileTail);
+                                                 /* write main header to file */
+  ECAT7file=matrix_create(outFile, ecat_matrix::MatrixFileAccessMode::CREATE_NEW_FILE, &main_header);
+  if(ECAT7file == NULL) {
+    LOG_ERROR( "ERROR: cannot write main header %s.\n", outFile);
+    return 1;
+  }
+  fflush(stdout);
 
-    LOG_INFO("  -> writing subheader and matrix to {}", outFileTail);
+  numJobs = endFrame-startFrame+1;
+  if (numThreads <= 0) numThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (numThreads > numJobs) numThreads = numJobs;
+  if (numThreads < 1) numThreads = 1;
+  LOG_INFO("converting {} frames with {} threads", numJobs, numThreads);
+  frame_pool_start(&pool, frameJobs, numJobs, numThreads);
+  ret = 0;
+  for (i=0; i<numJobs && ret==0; i++) {
+    job = frame_pool_wait(&pool, i);
+    if (job->data == NULL) {
+      ret = 1;
+      break;
+    }
+    LOG_INFO("  -> writing frame {} subheader and matrix to {}", job->frame, outFileTail);
                                                       /* Create new matrix id */
-    matrixId=ecat_matrix::mat_numcod(frame-startFrame+1, 1, 1, 0, 0);
+    matrixId=ecat_matrix::mat_numcod(job->frame-startFrame+1, 1, 1, 0, 0);
     /* write subheader and matrix to file */
                      /* data are scaled to short int by ecat7WriteImageMatrix */
-    if (matrix_float_reduced != NULL) {
-      ret=ecat7WriteImageMatrix(ECAT7file, matrixId, &image_header, matrix_float_reduced, NULL);
-      free(matrix_float_reduced);
-    } else {
-      ret=ecat7WriteImageMatrix(ECAT7file, matrixId, &image_header, matrix_float, muMask);
+    if (ecat7WriteImageMatrix(ECAT7file, matrixId, &job->image_header, job->data,
+                              job->reduce ? NULL : muMask) < 0) {
+      LOG_ERROR("ERROR: cannot write frame {} to {}", job->frame, outFile);
+      ret = 1;
     }
-    free(matrix_float);
+    frame_pool_release(&pool, i);
     fflush(stdout);
-
-  /****************************************************************************/
-  /*                          goto next frame                                 */
-  /****************************************************************************/
-
-    frameStart = frameStart + frameDuration[frame];
+  }
+  frame_pool_stop(&pool);
+  for (i=0; i<numJobs; i++) free(frameJobs[i].planeScale);
+  free(frameJobs);
+  if (ret != 0) {
+    matrix_close(ECAT7file);
+    return 1;
   }
 
                                            /* Close and duplicate output file*/
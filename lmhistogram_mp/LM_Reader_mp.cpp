@@ -26,6 +26,8 @@
         07-JAN-2009: Add new_frame_flag 
                     Remove start_countrate code
         20-MAY-2009: Use a single fast LUT rebinner
+        19-OCT-2026: Add seek_buffer_64(); accept a short last buffer at end of file
+        19-OCT-2026: Read packed listmode files, chunks unpacked in parallel by LMPackReader
 
       
                Copyright (C) CPS Innovations 2004 All Rights Reserved.
@@ -64,6 +66,7 @@ int verbose = 0;
 // FILE *L64EventPacket::in_fp = NULL;
 boost::filesystem::path L64EventPacket::in_fname;
 std::ifstream L64EventPacket::in_fp;
+LMPackReader L64EventPacket::in_pack;
 FILE *L64EventPacket::hc_out = NULL;
 
 unsigned L64EventPacket::packet_size = PACKET_SIZE;
@@ -106,6 +109,29 @@ L32EventPacket::~L32EventPacket() {
     free(events);
 }
 
+/*
+ *  unsigned read_events_64(unsigned *events)
+ *  Reads up to packet_size 64-bit events from the listmode file, unpacking packed files.
+ *  Returns the number of events read.
+ */
+static unsigned read_events_64(unsigned *events) {
+  size_t nbytes = sizeof(int64_t) * L64EventPacket::packet_size;
+  if (L64EventPacket::in_pack.is_open())
+    return L64EventPacket::in_pack.read((char *)events, nbytes) / sizeof(int64_t);
+  L64EventPacket::in_fp.read((char *)events, nbytes);
+  return L64EventPacket::in_fp.gcount() / sizeof(int64_t);
+}
+
+/*
+ *  bool read_error_64()
+ *  True if the last read_events_64() stopped on an error rather than end of file.
+ */
+static bool read_error_64() {
+  if (L64EventPacket::in_pack.is_open())
+    return L64EventPacket::in_pack.fail();
+  return !L64EventPacket::in_fp.eof();
+}
+
 /*
  *  void lm64_reader(void *arg = NULL): 
  *  lm64_reader is the function called to initialize the 64-bit listmode reader thread.
@@ -124,9 +150,11 @@ L32EventPacket::~L32EventPacket() {
 void lm64_reader (const fs::path &infile) {
   L64EventPacket::in_fname = infile;
   // L64EventPacket::in_fp = open_istream(L64EventPacket::in_fname, ios::in | ios::binary);
-  hrrt_util::open_istream(L64EventPacket::in_fp, L64EventPacket::in_fname, ios::in | ios::binary);
-  L64EventPacket::in_fp.read((char *)g_l64_container[0].events, sizeof(int64_t) * L64EventPacket::packet_size);
-  if (L64EventPacket::in_fp.good()) {
+  if (lm_pack::is_packed(infile))
+    L64EventPacket::in_pack.open(infile);
+  else
+    hrrt_util::open_istream(L64EventPacket::in_fp, L64EventPacket::in_fname, ios::in | ios::binary);
+  if (read_events_64(g_l64_container[0].events) == L64EventPacket::packet_size) {
     g_l64_container = new L64EventPacket[2];
     g_l32_container = new L32EventPacket;
     g_l64_container[0].num_events = L64EventPacket::packet_size;
@@ -174,17 +202,17 @@ L64EventPacket *load_buffer_64() {
       memcpy(g_l64_container[0].events, g_l64_container[1].events, g_l64_container[1].num_events * sizeof(int64_t));
       g_l64_container[1].status = L64EventPacket::empty;
     } else {
-      // Read in new buffer
-      L64EventPacket::in_fp.read((char *)g_l64_container[0].events, sizeof(int64_t) * L64EventPacket::packet_size);
-      if (L64EventPacket::in_fp.fail()) {
-        std::cerr << "lm64_reader: error reading " << L64EventPacket::in_fname.string() << std::endl;
-        exit(1);
-      }
-      if (L64EventPacket::in_fp.eof()) {
+      // Read in new buffer, the last buffer of the file may be short
+      unsigned num_events = read_events_64(g_l64_container[0].events);
+      if (num_events == 0) {
+        if (read_error_64()) {
+          std::cerr << "lm64_reader: error reading " << L64EventPacket::in_fname.string() << std::endl;
+          exit(1);
+        }
         std::cout << "lm64_reader: " << L64EventPacket::in_fname.string() << " file done" << std::endl;
         return NULL;
       }
-      g_l64_container[0].num_events = L64EventPacket::packet_size;
+      g_l64_container[0].num_events = num_events;
     }
   }
   if (g_l64_container[0].num_events < 1)
@@ -204,6 +232,31 @@ L64EventPacket *load_buffer_64() {
   return &g_l64_container[0];
 }
 
+/*
+ *  int seek_buffer_64(uint64_t offset)
+ *  Drops the loaded packets and positions the listmode file at byte offset,
+ *  the next load_buffer_64() reads from there.
+ *  offset must be the start of an event, e.g. a time tag offset from the listmode time index.
+ *  For packed files offset is the offset in the unpacked listmode data.
+ *  Returns 0 if success.
+ */
+int seek_buffer_64(uint64_t offset) {
+  if (L64EventPacket::in_pack.is_open()) {
+    if (L64EventPacket::in_pack.seek(offset))
+      return 1;
+  } else {
+    L64EventPacket::in_fp.clear();
+    L64EventPacket::in_fp.seekg(offset);
+    if (L64EventPacket::in_fp.fail())
+      return 1;
+  }
+  for (int i = 0; i < 2; i++) {
+    g_l64_container[i].status = L64EventPacket::empty;
+    g_l64_container[i].num_events = 0;
+  }
+  return 0;
+}
+
 /*
  *  L32EventPacket *load_buffer_32()
  *  Returns the first available L32EventPacket packet read by lm32_reader or sorted by
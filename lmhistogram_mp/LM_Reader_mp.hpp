@@ -21,6 +21,8 @@
   Modification history:
           12/07/2004: Increase MAX_FILEWRITE_WAIT from 10sec to 120sec
           20-MAY-2009: Use a single fast LUT rebinner
+          19-OCT-2026: Add seek_buffer_64 to position the reader with the listmode time index
+          19-OCT-2026: Read packed listmode files (.l64z)
             
                Copyright (C) CPS Innovations 2004 All Rights Reserved.
 
@@ -30,8 +32,10 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <cstdint>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/path.hpp>
+#include "lm_pack.hpp"
 // using namespace std;
 
 extern int verbose;
@@ -55,6 +59,7 @@ public:
   static boost::filesystem::path in_fname;
   // static FILE* in_fp;
   static std::ifstream in_fp;
+  static LMPackReader in_pack;   // open when the input file is packed
   static FILE *hc_out;
   static int current_frame;
   static std::vector<int> frame_duration;
@@ -92,4 +97,5 @@ extern void lm64_reader(const boost::filesystem::path &infile);
 extern void lm32_reader(const boost::filesystem::path &infile);
 
 extern L64EventPacket *load_buffer_64();
+extern int seek_buffer_64(uint64_t offset);
 extern L32EventPacket *load_buffer_32();
@@ -1,9 +1,11 @@
 /*
 Modification history:
           20-MAY-2009: Use a single fast LUT rebinner
+          19-OCT-2026: Add span9_plane_map for span 9 histogramming from span 3 addresses
 */
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 #include <gen_delays_lib/geometry_info.h>
 
 /*
@@ -153,3 +155,50 @@ int convert_span9(short *sino, int t_maxrd, int nrings) {
   free(move);
   return 1;
 }
+
+/*
+  std::vector<int> span9_plane_map(int t_maxrd, int nrings)
+  returns the span 9 plane of each span 3 plane, -1 for planes of span 3 segments
+  outside the span 9 segments.  Planes are combined like in convert_span9.
+*/
+std::vector<int> span9_plane_map(int t_maxrd, int nrings) {
+  int span3 = 3, span9 = 9;
+  int nseg = (2 * t_maxrd + 1) / span3;
+  int nseg_9 = (2 * t_maxrd + 1) / span9;
+  std::vector<int> nplns(nseg, 207), nplns_span9(nseg, 207), move(nseg, 0), start(nseg + 1, 0);
+
+  for (int iseg = 0; iseg < nseg; iseg++) {
+    int seg = (iseg + 1) / 2;
+    if (seg > 0)
+      nplns[iseg] = 2 * nrings - span3 * (2 * seg - 1) - 2;
+    if (seg > 1)
+      nplns_span9[iseg] = 2 * nrings - span9 * (2 * ((iseg + 3) / 6) - 1) - 2;
+    if (seg > 0)
+      move[iseg] = (nplns_span9[iseg] - nplns[iseg]) / 2;
+    start[iseg + 1] = start[iseg] + nplns[iseg];
+  }
+
+  std::vector<int> plane_map(start[nseg], -1);
+  // map all planes of span 3 segment iseg to span 9 planes from first
+  auto map_segment = [&](int iseg, int first) {
+    for (int plane = 0; plane < nplns[iseg]; plane++)
+      plane_map[start[iseg] + plane] = first + plane;
+  };
+
+  // segment 0 gets span 3 segments 0, -1 and +1
+  map_segment(0, 0);
+  map_segment(1, move[1]);
+  map_segment(2, move[2]);
+  int iseg = 3, span9_pos = nplns[0];
+  for (int iseg_9 = 1; iseg_9 < nseg_9; iseg_9 += 2) {
+    // span 9 segment pair (-seg,+seg) from three pairs of span 3 segments
+    int out_nplanes = nplns[iseg];
+    for (int i = 0; i < 6; i += 2) {
+      map_segment(iseg + i, span9_pos + move[iseg + i]);
+      map_segment(iseg + i + 1, span9_pos + out_nplanes + move[iseg + i + 1]);
+    }
+    iseg += 6;
+    span9_pos += 2 * out_nplanes;
+  }
+  return plane_map;
+}
@@ -1,6 +1,12 @@
 # pragma once
+#include <vector>
 /*
 	int convert_span9(short *sino, int t_maxrd) 
 	converts in place span3 to span 9 sinogram
 */
 extern int convert_span9(short *sino, int t_maxrd, int nrings);
+/*
+	std::vector<int> span9_plane_map(int t_maxrd, int nrings)
+	span 9 plane of each span 3 plane, -1 if the plane is not in span 9 segments
+*/
+extern std::vector<int> span9_plane_map(int t_maxrd, int nrings);
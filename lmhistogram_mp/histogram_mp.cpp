@@ -29,7 +29,11 @@
                                             Replace check_start_countrate() by
                                             find_start_countrate() to locate histogramming start time
                     20-MAY-2009: Use a single fast LUT rebinner
+                    19-OCT-2026: Use the listmode time index in goto_event, find_start_countrate and lmscan
+                    19-OCT-2026: Histogram span 9 sinogram from span 3 addresses in the same pass
+                    19-OCT-2026: Optionally collect prompt event addresses for listmode reconstruction
 */
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
@@ -96,6 +100,9 @@ int stop_count_ = 0;
 int frame_start_time = -1;      //First time extracted from time tag in sec
 int frame_duration = -1;        //First time extracted from time tag in sec
 
+LMIndex g_lm_index;             // Listmode time index, empty if not loaded
+std::vector<int> g_span9_map;   // Span 9 plane of each span 3 plane, empty if not histogramming span 9
+
 // crystal singles counters for prompts and delayed
 // different array for each rebinner
 unsigned *g_p_coinc_map = nullptr;
@@ -612,13 +619,33 @@ static int next_event_64(Event_32 &cew, int scan_flag)
   return 0;
 }
 
+/**
+ * seek_event:
+ * Positions the input stream at the last indexed time tag at or before target sec,
+ * so that goto_event_32 only scans the rest of one index interval.
+ * Leaves the stream unchanged when there is no index or no such entry.
+ */
+static void seek_event(int target)
+{
+  if (g_lm_index.empty())
+    return;
+  const LMIndex::Entry *entry = g_lm_index.find_time((int64_t)target * 1000);
+  if (entry == nullptr || seek_buffer_64(entry->offset))
+    return;
+  LOG_INFO("Time index: {} msec at offset {}", entry->time, entry->offset);
+  nevents = nsync = 0;
+  current_time = -1;
+}
+
 /**
  * goto_event:
- * Calls got_event_64 when l64_flag is set and  goto_event_32 otherwise
+ * Calls goto_event_32, after seeking close to the target with the time index if available
 */
 int goto_event(int target)
 {
   if (!timetag_processing && target == 0) return 1;
+  if (timetag_processing)
+    seek_event(target);
   return goto_event_32(target);
 }
 
@@ -901,6 +928,14 @@ bf::path &make_path(const bf::path &infile, FILE_TYPE file_type) {
  */
 
 int find_start_countrate(bf::path const &l64_file) {
+  if (!g_lm_index.empty()) {
+    const LMIndex::Entry *entry = g_lm_index.find_countrate(start_countrate_);
+    if (entry == nullptr) {
+      LOG_ERROR("Start countrate {} trues/sec not reached in {}", start_countrate_, l64_file.string());
+      return 0;
+    }
+    return (int)entry->time;
+  }
   const bf::path hc_file = make_path(l64_file, FILE_TYPE::HC);
   if (! bf::is_regular_file(hc_file)) {
     LOG_INFO("hc file {} not found; trying listmode file", hc_file.string());
@@ -1288,6 +1323,16 @@ void process_tagword(const L64EventPacket &src, std::ofstream out_hc)
 }
 
 
+/**
+ * span9_address:
+ * Span 9 sinogram address of a span 3 sinogram address, -1 if the span 3 plane is outside
+ * the span 9 segments.
+ */
+static inline int span9_address(int t_address, int t_npixels) {
+  int plane = g_span9_map[t_address / t_npixels];
+  return (plane < 0) ? -1 : plane * t_npixels + t_address % t_npixels;
+}
+
 /*
  * Histograms the input listmode stream to the output sinogram,
  * starting from the current input file position,
@@ -1296,11 +1341,20 @@ void process_tagword(const L64EventPacket &src, std::ofstream out_hc)
  *  Mode: 0="randoms substraction",
  *        1="separarate prompts and delayed",
  * Duration is filled back with the real histogrammed time.�
+ * When t_sino9 is not nullptr, events are also added to this span 9 sinogram, with
+ * delayed in its second half in prompts and randoms mode; see span9_address.
+ * When t_lm_events is not nullptr, the sinogram address of each prompt event is appended to it,
+ * in listmode order, for listmode reconstruction (lm_events.hpp).
  * Histogram returns: frame start time (>=0),  -1 when an error is encountered.
  */
-template <typename T> int histogram(T *t_sino, char *delayed, int sino_size, int &t_duration, std::ofstream &t_out_hc) {
-  int address = 0, tx_flag = 0;
+template <typename T> int histogram(T *t_sino, char *delayed, int sino_size, int &t_duration, std::ofstream &t_out_hc, T *t_sino9,
+                                        std::vector<uint32_t> *t_lm_events) {
+  int address = 0, tx_flag = 0, address9 = 0;
   T *sub_sino = t_sino + sino_size;
+  int npixels = GeometryInfo::nprojs_ * GeometryInfo::nviews_;
+  int sino9_size = 0;
+  if (t_sino9 != nullptr)
+    sino9_size = (*std::max_element(g_span9_map.begin(), g_span9_map.end()) + 1) * npixels;
 
   // int tx_sino_size = GeometryInfo::nprojs_ * GeometryInfo::nviews_ * (2 * GeometryInfo::NYCRYS - 1);
   fmt::print(t_out_hc, "Singles,Randoms,Prompts,Time(ms)\n");
@@ -1324,6 +1378,14 @@ template <typename T> int histogram(T *t_sino, char *delayed, int sino_size, int
             t_sino[cew.value]++;
           else
             t_sino[cew.value]--;
+          if (t_lm_events != nullptr && cew.type == Event_32::PROMPT)
+            t_lm_events->push_back(cew.value);
+          if (t_sino9 != nullptr && (address9 = span9_address(cew.value, npixels)) >= 0) {
+            if (cew.type == Event_32::PROMPT)
+              t_sino9[address9]++;
+            else
+              t_sino9[address9]--;
+          }
           //if (sinogram[cew.address] > overflow_size)
           //  cout << "Warning:  overflow sinogram, address=" << cew.address << endl;
         }
@@ -1344,6 +1406,8 @@ template <typename T> int histogram(T *t_sino, char *delayed, int sino_size, int
           address = cew.value;
           if (cew.type == Event_32::PROMPT) {
             t_sino[address]++;
+            if (t_lm_events != nullptr)
+              t_lm_events->push_back(address);
           } else {
             if (delayed == nullptr) {
               // delayed stored in same array as prompts
@@ -1354,6 +1418,12 @@ template <typename T> int histogram(T *t_sino, char *delayed, int sino_size, int
                 delayed[address]++; // truncated to byte max
             }
           }
+          if (t_sino9 != nullptr && (address9 = span9_address(address, npixels)) >= 0) {
+            if (cew.type == Event_32::PROMPT)
+              t_sino9[address9]++;
+            else
+              t_sino9[address9 + sino9_size]++;
+          }
         }
       }
       if (stop_count_ > 0 && event_counter >= stop_count_)
@@ -1397,8 +1467,10 @@ template <typename T> int histogram(T *t_sino, char *delayed, int sino_size, int
   return frame_start_time;
 }
 
-template int histogram(char *sino, char *delayed, int sino_size, int &duration,  std::ofstream &out_hc);
-template int histogram(short *sino, char *delayed, int sino_size, int &duration, std::ofstream &out_hc);
+template int histogram(char *sino, char *delayed, int sino_size, int &duration,  std::ofstream &out_hc, char *sino9,
+                       std::vector<uint32_t> *lm_events);
+template int histogram(short *sino, char *delayed, int sino_size, int &duration, std::ofstream &out_hc, short *sino9,
+                       std::vector<uint32_t> *lm_events);
 /*
 static void lmscan_32(std::ofstream &out, long *duration) {
   long prev_time = 0, time = 0;
@@ -1495,8 +1567,26 @@ static void lmscan_64(std::ofstream &out, long *duration) {
   *duration = time;
 }
 
+/*
+ * Head curve from the time index, one line per indexed second.
+ * Singles are the sum of the block average singles of the second, as in lmscan_64.
+ */
+static void lmscan_index(std::ofstream &out, long *duration) {
+  const std::vector<LMIndex::Entry> &entries = g_lm_index.entries();
+
+  out << "Singles,Randoms,Prompts,Time(ms)" << std::endl;
+  for (size_t i = 1; i < entries.size(); i++) {
+    out << fmt::format("{},{},{},{}", entries[i].singles_rate, entries[i].delayed - entries[i - 1].delayed,
+                       entries[i].prompts - entries[i - 1].prompts, entries[i].time) << std::endl;
+  }
+  *duration = entries.back().time;
+}
+
 void lmscan(std::ofstream &out, long *duration) {
-  lmscan_64(out, duration);
+  if (timetag_processing && !g_lm_index.empty() && g_lm_index.interval() == 1000)
+    lmscan_index(out, duration);
+  else
+    lmscan_64(out, duration);
 }
 
 head_curve *lmsplit(std::ofstream &out, long *duration) {
@@ -16,13 +16,18 @@
           01/09/2009: Replace check_start_countrate() by
                       find_start_countrate() to locate histogramming start time
           20-MAY-2009: Use a single fast LUT rebinner
+          19-OCT-2026: Locate frame starts and start countrate with the listmode time index
+          19-OCT-2026: Optional span 9 sinogram histogrammed with span 3 sinogram
+          19-OCT-2026: Optional list of prompt event addresses (lm_events.hpp)
 */
 #pragma once
 
 #include <map>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/path.hpp>
 #include "LM_Reader_mp.hpp"
+#include "lm_index.hpp"
 
 namespace bf = boost::filesystem;
 
@@ -72,7 +77,10 @@ extern long process_tagword(long tagword, long duration, std::ofstream &out_hc);
 int goto_event( int target_time);
 
 // Histogram input listmode stream to sinogram, fill duration with time extracted from time tags
-template <typename T> int histogram(T *out_sino, char *delayed_sino, int sino_size, int &duration, std::ofstream &out_hc);
+// Events are also added to the span 9 sinogram sino9 when not nullptr, using g_span9_map
+// Prompt event addresses are appended to lm_events when not nullptr
+template <typename T> int histogram(T *out_sino, char *delayed_sino, int sino_size, int &duration, std::ofstream &out_hc, T *sino9 = nullptr,
+                                    std::vector<uint32_t> *lm_events = nullptr);
 
 // Sort 64-bit events from src, decode event into 32-bit event, add event to dest until src is done or dest packet is full
 void rebin_packet(L64EventPacket &src,  L32EventPacket &dst);
@@ -126,6 +134,8 @@ extern void reset_coin_map();
 extern void log_message(const char *msg, int type = 0);
 
 extern int timetag_processing;
+extern LMIndex g_lm_index;             // listmode time index, empty if not loaded
+extern std::vector<int> g_span9_map;   // span 9 plane of each span 3 plane, empty if not histogramming span 9
 extern unsigned eg_rebinner_method;
 typedef enum {HW_REBINNER = 0x1, SW_REBINNER = 0x2, IGNORE_BORDER_CRYSTAL = 0x4, NODOI_PROCESSING = 0x8}
 RebinnerMethodMask;
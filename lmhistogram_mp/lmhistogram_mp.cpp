@@ -45,6 +45,21 @@
     Removed call to hrrt_rebinner_lut_path in LM_Rebinner_mp.cpp::init_rebinner()
     8/23/18
     Add Boost::ProgramOptions for cmd line arg parsing - remove home-made Flags.cpp
+    10/19/26
+    Add listmode time index (.l64.idx): 'index' option writes it, frame skips and
+    'start' use it and build it when missing, 'scan' creates the head curve from it.
+    Add 'osem' option: frames are staged in shared memory and reconstructed with
+    hrrt_osem3d while the next frame is histogrammed, 'keep_sino' copies them to disk.
+    With 'osem', the randoms, trues and head curve files are staged too and written
+    to disk by the reconstruction job.
+    Add 'sparse' option: frame sinograms written in the sparse container (sparse_sino.hpp);
+    randoms and trues, appended frame after frame, stay dense.
+    Add 'span9' option: with span 3, a span 9 sinogram (_span9.s) is histogrammed in the same
+    pass; in PR mode the span 9 trues and randoms come from it instead of convert_span9.
+    Add 'pack' option: write packed listmode file (.l64z, lm_pack.hpp) and exit; packed
+    files are accepted as input wherever a .l64 file is.
+    Add 'lm_events' option: write the prompt event sinogram addresses of each frame (.lme,
+    lm_events.hpp) for listmode reconstruction with hrrt_osem3d -l.
 */
 
 // #include "Flags.hpp"
@@ -52,6 +67,7 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <memory>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -66,6 +82,9 @@
 #include "LM_Reader_mp.hpp"
 #include "convert_span9.hpp"
 #include "hrrt_util.hpp"
+#include "sparse_sino.hpp"
+#include "lm_events.hpp"
+#include "recon_handoff.hpp"
 
 #include <gen_delays_lib/lor_sinogram_map.h>
 #include <gen_delays_lib/gen_delays_lib.hpp>
@@ -189,6 +208,19 @@ static int output_ra = 0;           // output randoms
 
 static bool g_span_override = false;       // Flag set span when span specified at command line
 bool g_do_scan = false;                // scan option , default=no
+bool g_do_index = false;               // write listmode time index, default=no
+bool g_do_pack = false;                // write packed listmode file, default=no
+static unsigned int g_index_interval = LMIndex::DEFAULT_INTERVAL;  // time index interval in msec
+static std::string g_osem;             // hrrt_osem3d executable for reconstruction of frames, default=none
+static std::string g_osem_args;        // hrrt_osem3d options
+static std::string g_shm_dir("/dev/shm");  // staging directory for frames to reconstruct
+static bool g_keep_sino = false;       // write reconstructed frame sinograms to disk, default=no
+static bool g_sparse = false;          // write emission sinograms in sparse container, default=no
+static bool g_span9 = false;           // also histogram span 9 sinogram in span 3, default=no
+static bf::path g_out_fname_span9;     // current frame span 9 sinogram file name
+static bool g_lm_events = false;       // write prompt events of each frame for listmode recon, default=no
+static std::unique_ptr<ReconHandoff> g_handoff;
+static std::vector<ReconHandoff::Output> g_staged_outputs;  // staged files of the current frame
 // static int out_l32 = 0;             // Output 32-bit listmode (output file extension .l32)
 // static int out_l64 = 0;             // Output 64-bit listmode (output file extension .l64)
 
@@ -274,6 +306,16 @@ template <typename T> int fill_prev_sino(T sino, const std::string &prev_sino) {
   }
 
   if (prev_sino.length() > 0) {
+    FILE *sparse_fp = fopen(prev_sino.c_str(), "rb");
+    if (sparse_sino::is_sparse(sparse_fp)) {
+      int err = sparse_sino::read_bins(sparse_fp, 0, g_sinogram_size, sino);
+      fclose(sparse_fp);
+      if (err)
+        LOG_ERROR("Error reading {}", prev_sino);
+      return err;
+    }
+    if (sparse_fp)
+      fclose(sparse_fp);
     std::ifstream prev_fp;
     if (hrrt_util::open_istream(prev_fp, prev_sino, std::ios::in | std::ios::binary)) {
       LOG_ERROR("Could not open prev_sino: {}", prev_sino);
@@ -441,6 +483,16 @@ void parse_boost(int argc, char **argv) {
     ("notimetag"    , po::bool_switch()->notifier(&on_notimetag)                     , "No timetag processing, use timetag count as time")
     ("nodoi"        , po::bool_switch()->notifier(&on_nodoi)                         , "No DoI processing, back layer events processed as front layer")
     ("scan"         , po::bool_switch(&g_do_scan)->default_value(false)                , "Scan file for prompts and randoms, print headcurve to g_logger")
+    ("index"        , po::bool_switch(&g_do_index)->default_value(false)               , "Write time index of listmode file (.l64.idx) and exit")
+    ("pack"         , po::bool_switch(&g_do_pack)->default_value(false)                , "Write packed listmode file (.l64z) and exit")
+    ("index_interval", po::value<unsigned int>(&g_index_interval)                    , "Time index interval in msec (default 1000)")
+    ("osem"         , po::value<std::string>(&g_osem)                                , "Reconstruct each frame with this hrrt_osem3d executable, frames staged in shared memory")
+    ("osem_args"    , po::value<std::string>(&g_osem_args)                           , "hrrt_osem3d options other than -t -p -d -o")
+    ("shm_dir"      , po::value<std::string>(&g_shm_dir)                             , "Staging directory for 'osem' (default /dev/shm)")
+    ("keep_sino"    , po::bool_switch(&g_keep_sino)->default_value(false)              , "With 'osem', also write frame sinograms to disk in the background")
+    ("sparse"       , po::bool_switch(&g_sparse)->default_value(false)                 , "Write frame sinograms in sparse format (low count frames), randoms and trues stay dense")
+    ("span9"        , po::bool_switch(&g_span9)->default_value(false)                  , "With span 3, also histogram a span 9 sinogram in the same pass")
+    ("lm_events"    , po::bool_switch(&g_lm_events)->default_value(false)              , "Also write the prompt events of each frame (.lme) for listmode reconstruction")
     ("model"        , po::value<int>(&model_number)->default_value(MODEL_HRRT)       , "Model: 328, 2393, 2395")
     ("verbosity,V"  , po::value<int>()->notifier(&on_verbosity)                      , "Logging verbosity: 0 off, 1 err, 2 info, 3 debug")
     ("add"          , po::value<std::string>(&g_prev_sino)                           , "Add to existing sinogram file")
@@ -513,14 +565,27 @@ int get_num_cpus() {
   return num_cpus;
 }
 
+/**
+ * output_file:
+ * Name of output file t_path of a frame.  When frames are reconstructed, the file is staged in
+ * shared memory and written to t_path by the reconstruction job.
+ */
+static bf::path output_file(bf::path const &t_path, int t_frame_no, bool t_sino, bool t_append) {
+  if (!g_handoff)
+    return t_path;
+  bf::path staged = g_handoff->stage(t_path, t_frame_no);
+  g_staged_outputs.push_back({staged, t_path, t_sino, t_append});
+  return staged;
+}
+
 /**
  * create_histogram_files:
  * Create/Open output files before starting histogramming.
  * Log error and exit if file creation fails
  */
-static void create_histogram_files() {
+static void create_histogram_files(int t_frame_no) {
   g_out_fname_hdr = make_file_name(FILE_TYPE::SINO_HDR);
-  g_out_fname_hc  = make_file_name(FILE_TYPE::LM_HC);
+  g_out_fname_hc  = output_file(make_file_name(FILE_TYPE::LM_HC), t_frame_no, false, false);
 
   hrrt_util::open_ostream(g_out_hc, g_out_fname_hc);
 
@@ -538,10 +603,10 @@ static void create_histogram_files() {
     // Keep original filename for prompts in prompts or prompts+delayed mode
     g_out_fname_pr = g_out_fname_sino;
     hrrt_util::open_ostream(g_out_true_prompt_sino, g_out_fname_pr, std::ios::out | std::ios::app | std::ios::binary);
-    g_out_fname_ra = make_file_name(FILE_TYPE::RA_S);
+    g_out_fname_ra = output_file(make_file_name(FILE_TYPE::RA_S), t_frame_no, true, true);
     hrrt_util::open_ostream(g_out_ran_sino, g_out_fname_ra, std::ios::out | std::ios::app | std::ios::binary);
     if (g_elem_size == ELEM_SIZE_SHORT) {
-      g_out_fname_tr = make_file_name(FILE_TYPE::TR_S);
+      g_out_fname_tr = output_file(make_file_name(FILE_TYPE::TR_S), t_frame_no, true, true);
       hrrt_util::open_ostream(g_out_true_sino, g_out_fname_tr, std::ios::out | std::ios::app | std::ios::binary);
     }
   } else {
@@ -564,20 +629,70 @@ static void close_files()
   g_out_hc.close();
 }
 
+/**
+ * write_data:
+ * Write t_count frame sinogram elements to t_out, in the sparse container if requested.
+ */
+static void write_data(std::ofstream &t_out, const char *t_data, int t_count) {
+  if (!g_sparse) {
+    t_out.write(t_data, t_count * g_elem_size);
+    return;
+  }
+  uint32_t plane_size = GeometryInfo::nprojs_ * GeometryInfo::nviews_;
+  std::vector<char> buf;
+  if (is_short())
+    buf = sparse_sino::encode(reinterpret_cast<const short *>(t_data), plane_size, t_count / plane_size);
+  else
+    buf = sparse_sino::encode(t_data, plane_size, t_count / plane_size);
+  LOG_INFO("Sparse sinogram: {:d} bytes, dense {:d} bytes", buf.size(), (size_t)t_count * g_elem_size);
+  t_out.write(buf.data(), buf.size());
+}
+
+/**
+ * write_span9:
+ * Write the span 9 sinogram histogrammed with the span 3 sinogram and its header.
+ * The header keeps the span 3 values.  Returns 0 on success.
+ */
+static int write_span9(char *t_sino9, CHeader &t_hdr) {
+  std::ofstream out;
+  if (hrrt_util::open_ostream(out, g_out_fname_span9, std::ios::out | std::ios::binary))
+    return 1;
+  LOG_INFO("Writing span 9 Sinogram: {}", g_out_fname_span9.string());
+  write_data(out, t_sino9, GeometryInfo::nprojs_ * GeometryInfo::nviews_ * NUM_SINOS[9]);
+  if (!out.good()) {
+    LOG_ERROR("Error writing {}", g_out_fname_span9.string());
+    return 1;
+  }
+  t_hdr.WritePath(CHeader::NAME_OF_DATA_FILE, g_out_fname_span9);
+  t_hdr.WriteInt(CHeader::AXIAL_COMPRESSION, 9);
+  t_hdr.WriteInt(CHeader::MATRIX_SIZE_3, NUM_SINOS[9]);
+  t_hdr.WriteFile(g_out_fname_span9.string() + ".hdr");
+  t_hdr.WriteInt(CHeader::AXIAL_COMPRESSION, 3);
+  t_hdr.WriteInt(CHeader::MATRIX_SIZE_3, NUM_SINOS[3]);
+  return 0;
+}
+
 /**
  * write_sino:
  * Write sinogram and header to file.
  * Reuse existing listmode header to create sinogram header.
  * Header file name is derived from data file name (data_fname.hdr).
+ * Span 9 sinogram t_sino9 (nullptr if none) is written after the first data file; in prompts
+ * and randoms mode its prompts and delayed give the span 9 trues and randoms.
  * Log error and exit when an I/O error is encountered.
  */
-static void write_sino(char *t_sino, int t_sino_size, CHeader &t_hdr, int t_frame) {
+static void write_sino(char *t_sino, int t_sino_size, CHeader &t_hdr, int t_frame, char *t_sino9) {
   // create the output header file
   // char *p = nullptr;
   short *ssino = (short *)t_sino;
   short *delayed = (short *)(t_sino + t_sino_size * g_elem_size);
   short *mock = (short *)(t_sino + t_sino_size * g_elem_size);
   int span9_sino_size = GeometryInfo::nprojs_ * GeometryInfo::nviews_ * NUM_SINOS[9];
+  if (t_sino9 != nullptr) {
+    // span 9 prompts and delayed histogrammed with span 3 sinogram
+    ssino = (short *)t_sino9;
+    delayed = ssino + span9_sino_size;
+  }
 
   t_hdr.WriteInt(CHeader::IMAGE_DURATION, g_prev_duration + g_frames_duration[t_frame]);
   t_hdr.WriteInt(CHeader::IMAGE_RELATIVE_START_TIME, relative_start);
@@ -619,7 +734,7 @@ static void write_sino(char *t_sino, int t_sino_size, CHeader &t_hdr, int t_fram
     LOG_INFO("Writing Trues Sinogram: {}", g_out_fname_sino);
     t_hdr.WritePath(CHeader::NAME_OF_DATA_FILE, g_out_fname_sino);
     t_hdr.WriteChar(CHeader::SINOGRAM_DATA_TYPE, "true");
-    g_out_true_prompt_sino.write(t_sino, t_sino_size * g_elem_size);
+    write_data(g_out_true_prompt_sino, t_sino, t_sino_size);
     break;
   case HISTOGRAM_MODE::PRO_RAN:
     // Prompts and delayed: prompts is first
@@ -628,7 +743,7 @@ static void write_sino(char *t_sino, int t_sino_size, CHeader &t_hdr, int t_fram
     t_hdr.WriteChar(CHeader::SINOGRAM_DATA_TYPE, "prompt");
     t_hdr.WritePath(CHeader::NAME_OF_TRUE_DATA_FILE, g_out_fname_tr);
     g_out_fname_hdr = fmt::format("{}.hdr", g_out_fname_pr);
-    g_out_true_prompt_sino.write(t_sino, t_sino_size * g_elem_size);
+    write_data(g_out_true_prompt_sino, t_sino, t_sino_size);
     break;
   case HISTOGRAM_MODE::PRO:
     // Prompts only
@@ -659,6 +774,8 @@ static void write_sino(char *t_sino, int t_sino_size, CHeader &t_hdr, int t_fram
   // Write data
   if (!write_error)
     t_hdr.WriteFile(g_out_fname_hdr);
+  if (!write_error && t_sino9 != nullptr)
+    write_error += write_span9(t_sino9, t_hdr);
 
   // Log message and write second data filename
   if (g_elem_size == ELEM_SIZE_SHORT && write_error == 0)
@@ -668,17 +785,25 @@ static void write_sino(char *t_sino, int t_sino_size, CHeader &t_hdr, int t_fram
       t_hdr.WritePath(CHeader::NAME_OF_DATA_FILE, g_out_fname_tr);
       t_hdr.WriteChar(CHeader::SINOGRAM_DATA_TYPE, "true");
       // convert span3 prompt sinogram to span9 and substract delayed
-
-      for (int i = 0; i < t_sino_size; i++)
-        ssino[i] =  ssino[i] - delayed[i];
+      // unless span 9 prompts and delayed have been histogrammed
+      if (t_sino9 != nullptr) {
+        for (int i = 0; i < span9_sino_size; i++)
+          ssino[i] =  ssino[i] - delayed[i];
+      } else {
+        for (int i = 0; i < t_sino_size; i++)
+          ssino[i] =  ssino[i] - delayed[i];
+      }
       if (g_span == 3) {
-        LOG_INFO("Converting true t_sino to span9");
-        convert_span9(ssino, g_max_rd, 104);
+        if (t_sino9 == nullptr) {
+          LOG_INFO("Converting true t_sino to span9");
+          convert_span9(ssino, g_max_rd, 104);
+        }
         t_hdr.WriteInt(CHeader::AXIAL_COMPRESSION, 9);
         t_hdr.WriteInt(CHeader::MATRIX_SIZE_3, NUM_SINOS[9]);
       }
       LOG_INFO("Writing Trues Sinogram: {}", g_out_fname_tr);
       // if (fwrite(ssino, g_span == 3 ? span9_sino_size : t_sino_size, g_elem_size, g_out_true_sino) == g_elem_size) {
+      // Trues and randoms files are appended frame after frame: keep them dense
       g_out_true_sino.write(reinterpret_cast<char *>(ssino), g_span == 3 ? span9_sino_size * g_elem_size : t_sino_size * g_elem_size);
       if (g_out_true_sino.good()) {
         t_hdr.WriteFile(g_out_fname_hdr);
@@ -722,12 +847,20 @@ static void write_sino(char *t_sino, int t_sino_size, CHeader &t_hdr, int t_fram
     // count = fwrite(delayed, span9_sino_size, g_elem_size, g_out_ran_sino);
     // if (count == (int)g_elem_size) {
     g_out_ran_sino.write(reinterpret_cast<char *>(delayed), span9_sino_size * g_elem_size);
+    if (t_sino9 != nullptr) {
+      t_hdr.WriteInt(CHeader::AXIAL_COMPRESSION, 9);
+      t_hdr.WriteInt(CHeader::MATRIX_SIZE_3, NUM_SINOS[9]);
+    }
     if (g_out_ran_sino.good()) {
       t_hdr.WriteFile(g_out_fname_hdr);
     } else {
       LOG_ERROR("Error writing {}", g_out_fname_ra);
       write_error++;
     }
+    if (t_sino9 != nullptr) {
+      t_hdr.WriteInt(CHeader::AXIAL_COMPRESSION, 3);
+      t_hdr.WriteInt(CHeader::MATRIX_SIZE_3, NUM_SINOS[3]);
+    }
   }
   if (write_error)
     exit(1);
@@ -772,6 +905,9 @@ int do_lmscan() {
   hrrt_util::open_ostream(outfile_hc, g_out_fname_hc);
   g_frames_duration.clear();
 
+  // The time index holds the head curve; building it is one pass like the scan itself
+  if (timetag_processing)
+    g_lm_index.read_or_build(g_fname_l64, g_index_interval);
   start_reader_thread();
   lmscan(outfile_hc, &scan_duration);
   outfile_hc.close();
@@ -925,6 +1061,25 @@ int make_output_filename(void) {
   return 0;
 }
 
+// Write the prompt events of the frame for listmode reconstruction; exit if fail
+
+static void write_lm_events(std::vector<uint32_t> const &t_events, bf::path const &t_fname, int t_duration) {
+  lm_events::FileHeader lm_hdr;
+  memset(&lm_hdr, 0, sizeof(lm_hdr));
+  lm_hdr.span       = g_span;
+  lm_hdr.max_rd     = g_max_rd;
+  lm_hdr.nprojs     = GeometryInfo::nprojs_;
+  lm_hdr.nviews     = GeometryInfo::nviews_;
+  lm_hdr.nplanes    = g_num_sino;
+  lm_hdr.start_time = relative_start;
+  lm_hdr.duration   = t_duration;
+  if (lm_events::write(t_fname.c_str(), lm_hdr, t_events)) {
+    LOG_ERROR("Error writing listmode events {}", t_fname.string());
+    exit(1);
+  }
+  LOG_INFO("{}: {} prompt events", t_fname.string(), t_events.size());
+}
+
 void do_histogram_frame(CHeader &hdr, const int t_frame_no, int &current_time, std::ofstream &t_outfile_dyn) {
   char *sinogram = nullptr, *bsino = nullptr, *delayed = nullptr;
   short *ssino = nullptr;
@@ -937,9 +1092,18 @@ void do_histogram_frame(CHeader &hdr, const int t_frame_no, int &current_time, s
   } else {
     g_out_fname_sino = make_file_name(FILE_TYPE::SINO);
   }
+  // Histogram into the staging directory when the frame is reconstructed
+  bf::path disk_sino = g_out_fname_sino;
+  g_staged_outputs.clear();
+  g_out_fname_sino = output_file(disk_sino, t_frame_no, true, false);
+
+  if (g_span9)
+    g_out_fname_span9 = bf::path(disk_sino).replace_extension().string() + "_span9.s";
 
   // Create output files; exit if fail
-  create_histogram_files();
+  create_histogram_files(t_frame_no);
+  if (g_handoff)
+    g_out_fname_hdr = g_out_fname_sino.string() + ".hdr";
 
   int init_sino_ok;
   if (is_short()) {
@@ -953,6 +1117,14 @@ void do_histogram_frame(CHeader &hdr, const int t_frame_no, int &current_time, s
     delete[](sinogram);
     exit(1);
   }
+  // span 9 sinogram, with delayed in second half in prompts and randoms mode
+  std::unique_ptr<char[]> sino9;
+  if (g_span9) {
+    size_t sino9_size = (size_t)GeometryInfo::nprojs_ * GeometryInfo::nviews_ * NUM_SINOS[9];
+    if (g_hist_mode == HISTOGRAM_MODE::PRO_RAN)
+      sino9_size *= 2;
+    sino9.reset(new char[sino9_size * g_elem_size]());
+  }
 
   // load previous scan if any
   if (g_prev_sino.length() > 0) {
@@ -994,10 +1166,14 @@ void do_histogram_frame(CHeader &hdr, const int t_frame_no, int &current_time, s
   }
 
   // Histogram the frame
+  std::vector<uint32_t> lm_events;
+  std::vector<uint32_t> *lm_events_ptr = g_lm_events ? &lm_events : nullptr;
   if (g_elem_size == ELEM_SIZE_SHORT) {
-    relative_start = histogram<short>(ssino, delayed, g_sinogram_size, g_frames_duration[t_frame_no], g_out_hc);
+    relative_start = histogram<short>(ssino, delayed, g_sinogram_size, g_frames_duration[t_frame_no], g_out_hc,
+                                      reinterpret_cast<short *>(sino9.get()), lm_events_ptr);
   } else {
-    relative_start = histogram<char>(bsino, delayed, g_sinogram_size, g_frames_duration[t_frame_no], g_out_hc);
+    relative_start = histogram<char>(bsino, delayed, g_sinogram_size, g_frames_duration[t_frame_no], g_out_hc, sino9.get(),
+                                     lm_events_ptr);
   }
 
   if (relative_start < 0) {
@@ -1016,10 +1192,18 @@ void do_histogram_frame(CHeader &hdr, const int t_frame_no, int &current_time, s
   scan_duration += g_frames_duration[t_frame_no];
 
   // Write sinogram and header files
-  write_sino(sinogram, g_sinogram_size, hdr, t_frame_no);
+  write_sino(sinogram, g_sinogram_size, hdr, t_frame_no, sino9.get());
+  if (g_lm_events)
+    write_lm_events(lm_events, bf::path(disk_sino).replace_extension("lme"), g_frames_duration[t_frame_no]);
   close_files();
   if (g_hist_mode != HISTOGRAM_MODE::TRA)
     write_coin_map(g_out_fname_sino);
+  if (g_handoff) {
+    bf::path ch = g_out_fname_sino;
+    ch.replace_extension("ch");
+    g_staged_outputs.push_back({ch, bf::path(disk_sino).replace_extension("ch"), true, false});
+    g_handoff->submit({g_out_fname_sino, ch, disk_sino, g_hist_mode == HISTOGRAM_MODE::TRU, g_staged_outputs});
+  }
   LOG_INFO("Frame time histogrammed = {:d} sec", g_frames_duration[t_frame_no]);
   delete[] sinogram;
 }  // do_histogram_frame
@@ -1057,6 +1241,35 @@ std::ofstream create_outfile_dyn(void) {
   return outfile_dyn;
 }
 
+// Write time index of listmode file
+
+int do_index(void) {
+  LMIndex index;
+  if (index.build(g_fname_l64, g_index_interval))
+    return 1;
+  return index.write(LMIndex::index_path(g_fname_l64));
+}
+
+// Write packed copy of listmode file
+
+int do_pack(void) {
+  return lm_pack::pack(g_fname_l64, lm_pack::packed_path(g_fname_l64));
+}
+
+// Load time index of listmode file if present.
+// Build it when it is missing and frames or start countrate have to be located in the file.
+
+void load_lm_index(void) {
+  if (!timetag_processing)
+    return;
+  bool seek = (start_countrate_ > 0) || std::any_of(g_skip.begin(), g_skip.end(), [](int skip) { return skip > 0; });
+  bf::path index_file = LMIndex::index_path(g_fname_l64);
+  if (seek)
+    g_lm_index.read_or_build(g_fname_l64, g_index_interval);
+  else if (bf::is_regular_file(index_file))
+    g_lm_index.read(index_file, g_fname_l64);
+}
+
 void do_find_start_countrate(void) {
   // Check start countrate and set first frame skip
   if (start_countrate_ > 0) {
@@ -1068,6 +1281,38 @@ void do_find_start_countrate(void) {
   }
 }
 
+// Set up reconstruction of frames from shared memory if requested.
+// Trues sinograms are reconstructed with -t, prompts with smoothed randoms from the .ch file.
+
+void init_handoff(void) {
+  if (g_osem.length() == 0)
+    return;
+  if ((g_hist_mode != HISTOGRAM_MODE::TRU) && (g_hist_mode != HISTOGRAM_MODE::PRO_RAN)) {
+    LOG_ERROR("Reconstruction of frames requires Trues or Prompts and Randoms mode");
+    exit(1);
+  }
+  if (g_prev_sino.length() > 0) {
+    LOG_ERROR("Reconstruction of frames not supported with 'add'");
+    exit(1);
+  }
+  g_handoff.reset(new ReconHandoff(g_shm_dir, g_osem, g_osem_args, g_keep_sino));
+  if (g_handoff->init())
+    exit(1);
+}
+
+// Set up span 9 histogramming with span 3 if requested
+
+void init_span9(void) {
+  if (!g_span9)
+    return;
+  if (g_span != 3 || g_hist_mode == HISTOGRAM_MODE::TRA || GeometryInfo::lr_type_ != GeometryInfo::LR_Type::LR_0) {
+    LOG_ERROR("Span 9 histogramming requires span 3 emission in high resolution mode");
+    exit(1);
+  }
+  g_span9_map = span9_plane_map(g_max_rd, GeometryInfo::NRINGS);
+  LOG_INFO("Histogramming span 9 sinogram with span 3 sinogram");
+}
+
 // Call init_rebinner, but retain values of g_span and g_max_rd
 
 void do_init_rebinner(CHeader &hdr) {
@@ -1088,8 +1333,15 @@ void do_histogramming(CHeader &hdr) {
   set_isotope_halflife(hdr);
   get_dose_delay(hdr, g_dose_delay);
   set_span(hdr);
+  init_handoff();
   create_hrrt_sinogram_header(hdr);
   do_init_rebinner(hdr);
+  init_span9();
+  if (g_lm_events && g_hist_mode == HISTOGRAM_MODE::TRA) {
+    LOG_ERROR("Listmode events require emission histogramming");
+    exit(1);
+  }
+  load_lm_index();
   do_find_start_countrate();
   std::ofstream outfile_dyn = create_outfile_dyn();
 
@@ -1109,6 +1361,14 @@ void do_histogramming(CHeader &hdr) {
     outfile_dyn.close();
     LOG_INFO("Total time histogrammed = {:d} secs", current_time);
   }
+  if (g_handoff) {
+    int failed = g_handoff->wait();
+    g_handoff.reset();
+    if (failed) {
+      LOG_ERROR("Reconstruction failed for {:d} frames", failed);
+      exit(1);
+    }
+  }
   // complete the main data files
   // free(sinogram);
   delete[] g_p_coinc_map;
@@ -1127,6 +1387,10 @@ int main(int argc, char *argv[]) {
   validate_arguments();
   if (check_input_files())
     exit(1);
+  if (g_do_index)
+    exit(do_index());
+  if (g_do_pack)
+    exit(do_pack());
   if (open_l64_hdr_file(hdr))
     exit(1);
   set_tx_source_speed(hdr);
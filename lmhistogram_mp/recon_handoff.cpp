@@ -0,0 +1,128 @@
+// recon_handoff.cpp
+// Reconstruction of histogrammed frames with hrrt_osem3d, see recon_handoff.hpp.
+
+#include <unistd.h>
+#include <stdio.h>
+#include <fstream>
+
+#include "recon_handoff.hpp"
+#include "CHeader.hpp"
+#include "hrrt_util.hpp"
+#include "my_spdlog.hpp"
+
+#include <fmt/format.h>
+
+namespace bf = boost::filesystem;
+
+ReconHandoff::ReconHandoff(bf::path const &t_shm_dir, std::string const &t_osem, std::string const &t_osem_args, bool t_keep)
+  : shm_dir_(t_shm_dir / fmt::format("lmhistogram_{:d}", getpid())), osem_(t_osem), osem_args_(t_osem_args),
+    keep_(t_keep), errors_(0) {
+}
+
+ReconHandoff::~ReconHandoff() {
+  wait();
+  boost::system::error_code ec;
+  bf::remove_all(shm_dir_, ec);
+}
+
+int ReconHandoff::init() {
+  boost::system::error_code ec;
+  bf::create_directories(shm_dir_, ec);
+  if (ec) {
+    LOG_ERROR("Could not create staging directory {}: {}", shm_dir_.string(), ec.message());
+    return 1;
+  }
+  if (access(osem_.c_str(), X_OK)) {
+    LOG_ERROR("Reconstruction program {} not found", osem_);
+    return 1;
+  }
+  LOG_INFO("Frames staged in {} for {}", shm_dir_.string(), osem_);
+  return 0;
+}
+
+bf::path ReconHandoff::stage(bf::path const &t_path, int t_frame) const {
+  bf::path dir = shm_dir_ / fmt::format("frame{:d}", t_frame);
+  boost::system::error_code ec;
+  bf::create_directories(dir, ec);
+  if (ec)
+    LOG_ERROR("Could not create staging directory {}: {}", dir.string(), ec.message());
+  return dir / t_path.filename();
+}
+
+void ReconHandoff::submit(Frame const &t_frame) {
+  wait();
+  job_ = std::thread(&ReconHandoff::run, this, t_frame);
+}
+
+int ReconHandoff::wait() {
+  if (job_.joinable())
+    job_.join();
+  return errors_;
+}
+
+/**
+ * run:
+ * Reconstruct one staged frame into <disk_sino>.i, then write the frame files to disk (sinograms
+ * only when requested) and release the staged files.
+ */
+void ReconHandoff::run(Frame t_frame) {
+  bf::path image = bf::path(t_frame.disk_sino).replace_extension("i");
+  std::string args = osem_args_;
+  if (t_frame.trues)
+    args += fmt::format(" -t \"{}\"", t_frame.sino.string());
+  else
+    args += fmt::format(" -p \"{}\" -d \"{}\"", t_frame.sino.string(), t_frame.ch.string());
+  args += fmt::format(" -o \"{}\"", image.string());
+
+  LOG_INFO("Reconstructing {}", image.string());
+  if (hrrt_util::run_system_command(const_cast<char *>(osem_.c_str()), &args[0], stdout)) {
+    LOG_ERROR("Reconstruction of {} failed", t_frame.sino.string());
+    errors_++;
+  }
+
+  for (Output const &out : t_frame.outputs)
+    if (keep_ || !out.sino)
+      write_output(out, t_frame);
+  boost::system::error_code ec;
+  bf::remove_all(t_frame.sino.parent_path(), ec);
+}
+
+/**
+ * write_output:
+ * Copy or append a staged file to its disk name.  The header of a sinogram is copied with the
+ * data file names of the frame changed to their disk names.  Returns 0 on success.
+ */
+int ReconHandoff::write_output(Output const &t_out, Frame const &t_frame) {
+  boost::system::error_code ec;
+  uintmax_t size = bf::file_size(t_out.staged, ec);
+  if (ec) {
+    LOG_ERROR("{}: {}", t_out.staged.string(), ec.message());
+    return 1;
+  }
+  std::ifstream in(t_out.staged.string(), std::ios::binary);
+  std::ofstream out(t_out.disk.string(), std::ios::binary | (t_out.append ? std::ios::app : std::ios::trunc));
+  if (size > 0)
+    out << in.rdbuf();
+  if (!in || !out) {
+    LOG_ERROR("Could not write {} to disk", t_out.disk.string());
+    return 1;
+  }
+
+  bf::path hdr_name = t_out.staged.string() + ".hdr";
+  CHeader hdr;
+  if (!t_out.sino || !bf::exists(hdr_name) || (hdr.OpenFile(hdr_name) != CHeaderError::OK))
+    return 0;
+  hdr.CloseFile();
+  hdr.WritePath(CHeader::NAME_OF_DATA_FILE, t_out.disk);
+  std::string true_file;
+  if (hdr.ReadChar(CHeader::NAME_OF_TRUE_DATA_FILE, true_file) == CHeaderError::OK) {
+    for (Output const &other : t_frame.outputs)
+      if (other.staged == true_file)
+        hdr.WritePath(CHeader::NAME_OF_TRUE_DATA_FILE, other.disk);
+  }
+  if (hdr.WriteFile(bf::path(t_out.disk.string() + ".hdr")) != CHeaderError::OK) {
+    LOG_ERROR("Could not write {}.hdr", t_out.disk.string());
+    return 1;
+  }
+  return 0;
+}
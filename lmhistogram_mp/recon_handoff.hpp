@@ -0,0 +1,57 @@
+// recon_handoff.hpp
+// Reconstruction of histogrammed frames with hrrt_osem3d without intermediate sinogram files on disk.
+//
+// All output files of a frame (sinograms and their headers, coincidence histogram .ch, head curve
+// .hc) are staged in a shared memory directory (tmpfs, default /dev/shm), one subdirectory per
+// frame, and hrrt_osem3d is run on the staged files, so the smoothed randoms are computed by
+// gen_delays from the in-memory crystal histogram.  The reconstruction of a frame runs in the
+// background while the next frame is histogrammed.  The same background job then writes the head
+// curve to disk, and the sinograms too if requested.
+
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+
+class ReconHandoff {
+public:
+  // Staged output file and its name on disk
+  struct Output {
+    boost::filesystem::path staged;
+    boost::filesystem::path disk;
+    bool sino;                          // sinogram, with a header staged + ".hdr"; copied if requested
+    bool append;                        // appended to the disk file, as the frames of .ra.s and .tr.s
+  };
+  struct Frame {
+    boost::filesystem::path sino;       // staged sinogram; its header is sino.hdr
+    boost::filesystem::path ch;         // staged coincidence histogram
+    boost::filesystem::path disk_sino;  // sinogram file name on disk
+    bool trues;                         // trues sinogram (-t), else prompts with delayed from ch (-p, -d)
+    std::vector<Output> outputs;        // all staged files of the frame, including sino and ch
+  };
+
+  ReconHandoff(boost::filesystem::path const &t_shm_dir, std::string const &t_osem, std::string const &t_osem_args, bool t_keep);
+  ~ReconHandoff();
+
+  // Create the staging directory.  Returns 0 on success.
+  int init();
+  // Staged location of an output file of a frame
+  boost::filesystem::path stage(boost::filesystem::path const &t_path, int t_frame) const;
+  // Start reconstruction of a frame once the previous frame is done
+  void submit(Frame const &t_frame);
+  // Wait for the last frame.  Returns the number of frames that failed.
+  int wait();
+
+private:
+  void run(Frame t_frame);
+  int write_output(Output const &t_out, Frame const &t_frame);
+
+  boost::filesystem::path shm_dir_;  // per process staging directory
+  std::string osem_;                 // hrrt_osem3d executable
+  std::string osem_args_;            // hrrt_osem3d options other than -t, -p, -d and -o
+  bool keep_;                        // copy frame files to disk
+  std::thread job_;
+  int errors_;
+};
@@ -0,0 +1,175 @@
+/*
+ mc_pipeline.cpp : Frame pipeline for motion_correct_recon
+ Creation date: 19-oct-2026
+*/
+#include "mc_pipeline.h"
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <thread>
+#include "AIR.h"
+#include <ecatx/ecat_matrix.hpp>
+#include <ecatx/matpkg.h>
+#include "hrrt_util.hpp"
+#include "my_spdlog.hpp"
+
+namespace mc_pipeline {
+
+JobScheduler::JobScheduler(int t_max_jobs, unsigned t_memory_budget_mb, FILE *t_log_fp)
+  : max_jobs_(t_max_jobs < 1 ? 1 : t_max_jobs), memory_budget_mb_(t_memory_budget_mb),
+    log_fp_(t_log_fp), next_job_(0), running_jobs_(0), running_memory_mb_(0), status_(0) {
+}
+
+void JobScheduler::add(const FrameJob &t_job) {
+  jobs_.push_back(t_job);
+}
+
+int JobScheduler::run_job(const FrameJob &t_job) {
+  for (const Step &step : t_job.steps) {
+    LOG_INFO("frame {}: {}", t_job.frame, step.name);
+    int ret = step.run();
+    if (ret) {
+      LOG_ERROR("frame {}: {} failed ({})", t_job.frame, step.name, ret);
+      return ret;
+    }
+  }
+  return 0;
+}
+
+void JobScheduler::worker() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    // Wait until the next job fits into the memory budget
+    cond_.wait(lock, [this] {
+      return status_ != 0 || next_job_ >= jobs_.size() || running_jobs_ == 0 ||
+             running_memory_mb_ + jobs_[next_job_].memory_mb <= memory_budget_mb_;
+    });
+    if (status_ != 0 || next_job_ >= jobs_.size())
+      break;
+    const FrameJob &job = jobs_[next_job_++];
+    running_jobs_++;
+    running_memory_mb_ += job.memory_mb;
+    lock.unlock();
+    int ret = run_job(job);
+    lock.lock();
+    running_jobs_--;
+    running_memory_mb_ -= job.memory_mb;
+    if (ret && status_ == 0)
+      status_ = ret;
+    cond_.notify_all();
+  }
+}
+
+int JobScheduler::run() {
+  int nworkers = std::min((size_t)max_jobs_, jobs_.size());
+  LOG_INFO("{} frame jobs, {} concurrent, memory budget {} MB", jobs_.size(), nworkers, memory_budget_mb_);
+  if (nworkers <= 1) {
+    for (next_job_ = 0; next_job_ < jobs_.size() && status_ == 0; next_job_++)
+      status_ = run_job(jobs_[next_job_]);
+  } else {
+    std::vector<std::thread> workers;
+    for (int i = 0; i < nworkers; i++)
+      workers.push_back(std::thread(&JobScheduler::worker, this));
+    for (std::thread &w : workers)
+      w.join();
+  }
+  if (log_fp_ != NULL)
+    fflush(log_fp_);
+  return status_;
+}
+
+Step command_step(const std::string &t_prog, const std::string &t_args, FILE *t_log_fp) {
+  Step step;
+  step.name = t_prog;
+  step.run = [t_prog, t_args, t_log_fp]() {
+    std::vector<char> prog(t_prog.begin(), t_prog.end());
+    std::vector<char> args(t_args.begin(), t_args.end());
+    prog.push_back('\0');
+    args.push_back('\0');
+    // ~/.ma_pattern.dat is removed once before the scheduler starts
+    return hrrt_util::run_system_command(&prog[0], &args[0], t_log_fp, false);
+  };
+  return step;
+}
+
+// Replaces the invert_air program
+Step invert_air_step(const std::string &t_in, const std::string &t_out) {
+  Step step;
+  step.name = "invert_air " + t_in;
+  step.run = [t_in, t_out]() {
+    return (int)AIR_do_invert_air("invert_air", t_in.c_str(), t_out.c_str(), TRUE);
+  };
+  return step;
+}
+
+Step rename_step(const std::string &t_from, const std::string &t_to) {
+  Step step;
+  step.name = "rename " + t_from;
+  step.run = [t_from, t_to]() {
+    if (access(t_from.c_str(), F_OK) != 0)
+      return 0;                 // nothing to rename
+    int ret = rename(t_from.c_str(), t_to.c_str());
+    if (ret)
+      perror(t_from.c_str());
+    return ret;
+  };
+  return step;
+}
+
+int motion_distance(const char *t_air_file, char *t_line, size_t t_size) {
+  int xdim = 256, ydim = 256, zdim = 207;
+  float pixel_size = 1.21875f, z_pixel_size = 1.21875f, c_size;
+  float x1[4], x2[4];
+  struct AIR_Air16 air_16;
+  char reslice_file[FILENAME_MAX];
+  int matnum = 0, frame_start_time = 0;
+
+  if (AIR_read_air16(t_air_file, &air_16) != 0) {
+    LOG_ERROR("Error reading {}", t_air_file);
+    return 1;
+  }
+  memset(reslice_file, 0, sizeof(reslice_file));
+  matspec(air_16.r_file, reslice_file, &matnum);
+  ecat_matrix::MatrixFile *mptr = matrix_open(reslice_file, ecat_matrix::MatrixFileAccessMode::READ_ONLY, ecat_matrix::MatrixFileType_64::UNKNOWN_FTYPE);
+  if (mptr != NULL) {
+    ecat_matrix::MatrixData *matrix = matrix_read(mptr, matnum, MatrixData::DataType::MAT_SUB_HEADER);
+    if (matrix != NULL) {
+      ecat_matrix::Image_subheader *imh = (ecat_matrix::Image_subheader*)matrix->shptr;
+      frame_start_time = imh->frame_start_time / 1000;
+      free_matrix_data(matrix);
+    }
+    matrix_close(mptr);
+  }
+
+  // point 10 cm from the center, w.r.t AIR convention
+  x1[0] = 0.5f * xdim * pixel_size;
+  x1[1] = 0.5f * ydim * pixel_size - 100.0f;
+  x1[2] = 0.5f * zdim * z_pixel_size;
+  x1[3] = 1.0f;
+  Matrix t = mat_alloc(4, 4);
+  for (int j = 0; j < t->nrows; j++)
+    for (int i = 0; i < t->ncols; i++)
+      t->data[i + j * t->ncols] = (float)air_16.e[i][j];
+  pixel_size = (float)air_16.r.x_size;
+  z_pixel_size = (float)air_16.r.z_size;
+  c_size = (pixel_size > z_pixel_size) ? z_pixel_size : pixel_size;
+  scale(t, pixel_size / c_size, pixel_size / c_size, z_pixel_size / c_size);
+  mat_apply(t, x1, x2);
+  mat_free(t);
+  float dx = (x2[0] - x1[0]) * c_size;
+  float dy = (x2[1] - x1[1]) * c_size;
+  float dz = (x2[2] - x1[2]) * c_size;
+  float d = sqrt(dx * dx + dy * dy + dz * dz);
+  snprintf(t_line, t_size, "%d %4.3g %4.3g %4.3g %4.3g \n", frame_start_time, dx, dy, dz, d);
+  return 0;
+}
+
+unsigned physical_memory_mb() {
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long page_size = sysconf(_SC_PAGE_SIZE);
+  if (pages <= 0 || page_size <= 0)
+    return 0;
+  return (unsigned)((unsigned long long)pages * (unsigned long long)page_size / (1024 * 1024));
+}
+
+}  // namespace mc_pipeline
@@ -0,0 +1,75 @@
+/*
+ mc_pipeline.h : Frame pipeline for motion_correct_recon
+ The u-map reslicing, attenuation, scatter and reconstruction of a frame
+ are a chain of steps. Frames are independent and run concurrently under a
+ job scheduler with a memory budget. Steps that exist as library code
+ (AIR inversion, motion distance, file renaming) run in-process.
+ The u-map reslicing (ecat_reslice), forward projection (e7_fwd), scatter
+ and sinogram correction (e7_sino) and reconstruction (je_hrrt_osem3d) are
+ still separate processes that hand their images and sinograms over in
+ files: they keep process-global state (MemCtrl, logging, parser), so an
+ in-memory hand-off between them needs these programs as libraries first.
+ Creation date: 19-oct-2026
+*/
+#pragma once
+
+#include <stdio.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mc_pipeline {
+
+// One step of a frame job; returns 0 on success
+struct Step {
+  std::string name;
+  std::function<int()> run;
+};
+
+// Steps of one frame, executed in order
+struct FrameJob {
+  int frame;
+  unsigned memory_mb;           // peak memory of the largest step
+  std::vector<Step> steps;
+};
+
+// Runs frame jobs on up to max_jobs workers. Jobs are started in the order
+// they were added, as long as the sum of the memory of the running jobs
+// stays within the budget. A job larger than the budget runs alone.
+class JobScheduler {
+public:
+  JobScheduler(int t_max_jobs, unsigned t_memory_budget_mb, FILE *t_log_fp);
+  void add(const FrameJob &t_job);
+  int run();                    // 0 or status of the first failed step
+
+private:
+  void worker();
+  int run_job(const FrameJob &t_job);
+
+  int max_jobs_;
+  unsigned memory_budget_mb_;
+  FILE *log_fp_;
+  std::vector<FrameJob> jobs_;
+  size_t next_job_;             // index of next job to start
+  int running_jobs_;
+  unsigned running_memory_mb_;
+  int status_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+// Steps
+Step command_step(const std::string &t_prog, const std::string &t_args, FILE *t_log_fp);
+Step invert_air_step(const std::string &t_in, const std::string &t_out);
+Step rename_step(const std::string &t_from, const std::string &t_to);
+
+// In-process equivalent of "motion_distance -a air_file": displacement of a
+// point 10 cm from the center. Writes "start_time dx dy dz d" into t_line.
+int motion_distance(const char *t_air_file, char *t_line, size_t t_size);
+
+// Physical memory of the host in MB
+unsigned physical_memory_mb();
+
+}  // namespace mc_pipeline
@@ -50,6 +50,8 @@
   Use -E for Uncorrected_ecat_file
   Use 0 start for frame numbering everywhere for consistency
   21-AUG-2010: Add -T option for AIR alignment threshold
+  19-OCT-2026: Run frames as concurrent jobs (-j, -m, -f), invert_air and
+  motion_distance as library calls
 */
 
 #include <stdio.h>
@@ -69,10 +71,15 @@
 #define NPLANES 207
 #define EM_ALIGN_THRESHOLD 1.0f
 #define POST_INJECTION_THRESHOLD 600
+// Frame job memory: e7_sino and je_hrrt_osem3d hold about FRAME_JOB_SINOGRAMS
+// span 9 float sinograms (256 bins x 288 views x 2209 planes) at once
+#define SPAN9_SINO_MB ((256*288*2209*sizeof(float))/(1024*1024))
+#define FRAME_JOB_SINOGRAMS 6
 
 #include "frame_info.h"
 #include "qmatrix.h"
 #include "hrrt_util.hpp"
+#include "mc_pipeline.h"
 
 // ahc
 #include <iostream>
@@ -83,6 +90,7 @@ static char cmd_line[2048];     // Args to program
 
 const char *data_dir = "D:\\SCS_SCANS";
 static char em_dir[FILENAME_MAX], log_dir[FILENAME_MAX], qc_dir[FILENAME_MAX]; 
+static char frame_qc_dir[FILENAME_MAX];
 static char reconjob_file[FILENAME_MAX], plt_fname[FILENAME_MAX];
 static char patient_dir[FILENAME_MAX];
 double max_trues=0;
@@ -108,9 +116,6 @@ static const char *prog_matcopy     = "matcopy";
 static const char *prog_recon       = "je_hrrt_osem3d";
 static const char *prog_reslice     = "ecat_reslice";
 static const char *prog_volume_reslice   = "volume_reslice";
-static const char *prog_motion_distance = "motion_distance";
-// AIR programs (compiled separately in AIR directory)
-static const char *prog_invert_air  = "invert_air";
 
 static void usage(const char *pgm){
   printf("%s Build %s %s \n", pgm, __DATE__, __TIME__);
@@ -133,6 +138,9 @@ static void usage(const char *pgm){
   printf("       -P Enable PSF (default yes)\n");
   printf("       -t test only, prints commands in motion_correct_pp.log\n");
   printf("       -v verbose (default off)\n");
+  printf("       -j jobs: number of frames processed concurrently (default 1)\n");
+  printf("       -m memory_mb: memory budget of concurrent frames (default physical memory)\n");
+  printf("       -f frame_memory_mb: memory of one frame (default %d)\n", (int)(FRAME_JOB_SINOGRAMS*SPAN9_SINO_MB));
   printf("    *   -p program_path: Path to HRRT executables (required)\n");
   printf("    *   -z gnuplot: FQ path of gnuplot program (required)\n");
   printf("    *   -b rebinner_lut_file: FQ path of rebinner LUT program (required)\n");
@@ -300,17 +308,20 @@ int main(int argc, char **argv)
   const char *vicra2scanner=NULL;
   char em_prefix[FILENAME_MAX], mu_prefix[FILENAME_MAX], fname[FILENAME_MAX];
   char im_prefix[FILENAME_MAX], mu_rsl[FILENAME_MAX], at_rsl[FILENAME_MAX];
-  char em_na[FILENAME_MAX];
+  char em_na[FILENAME_MAX], air_file[FILENAME_MAX];
   int ref_frame = -1;
   int frame=0, start_frame=-1, end_frame=-1, num_frames=0;
   float lber=-1.0f, user_time_constant = 0.0f;
-  FILE *fp=NULL, *pp=NULL;
+  FILE *fp=NULL;
   int c, exec=1, verbose = 0, overwrite=0, recon_flag=1;
   int default_smoothing=6; // default smoothing 6mm
   // ahc 9/8/16 psf_flag was set to 1
   int num_iterations=10, psf_flag=0;
   int ecat_reslice_flag = 1;
   int brand_new_final_align = 0;
+  int max_jobs = 1;
+  unsigned memory_mb = 0;
+  unsigned frame_memory_mb = FRAME_JOB_SINOGRAMS*SPAN9_SINO_MB;
   
   float AIR_threshold = 21.5f;
   int mu_width=128;
@@ -329,7 +340,7 @@ int main(int argc, char **argv)
   em_file = argv[1];
   memset(em_na, 0, sizeof(em_na));
   
-  while ((c = getopt (argc-1, argv+1, "n:F:s:S:u:r:c:q:C:a:I:L:M:A:E:T:K:R:PDOtvp:z:l:b:")) != EOF) {
+  while ((c = getopt (argc-1, argv+1, "n:F:s:S:u:r:c:q:C:a:I:L:M:A:E:T:K:R:PDOtvp:z:l:b:j:m:f:")) != EOF) {
     switch (c) {
       case 'u':
       mu_file = optarg;
@@ -431,6 +442,24 @@ int main(int argc, char **argv)
     case 'v' :
     verbose = 1;
     break;
+    case 'j' :
+    if (sscanf(optarg,"%d",&max_jobs) != 1 || max_jobs<1) {
+      printf("Invalid number of jobs : %s\n", optarg);
+      usage(argv[0]);
+    }
+    break;
+    case 'm' :
+    if (sscanf(optarg,"%u",&memory_mb) != 1 || memory_mb==0) {
+      printf("Invalid memory budget : %s\n", optarg);
+      usage(argv[0]);
+    }
+    break;
+    case 'f' :
+    if (sscanf(optarg,"%u",&frame_memory_mb) != 1 || frame_memory_mb==0) {
+      printf("Invalid frame memory : %s\n", optarg);
+      usage(argv[0]);
+    }
+    break;
     case 'p':
       // ahc program_path now a required argument.
     strcpy(program_path, optarg);
@@ -496,6 +525,9 @@ if (strcasecmp(ext,".v") ) {
     return 1;
   }
 }
+if (memory_mb == 0)
+  memory_mb = mc_pipeline::physical_memory_mb();
+
 if ((log_fp=fopen(log_file,"wt")) == NULL) {
   perror(log_file);
   return 1;
@@ -677,128 +709,111 @@ if (*ext == 'v') {
       sprintf(em_na,"%s", em_prefix);
 
     if (mu_file != NULL) {
-      // Reconstruct frames using corrected mu_maps
-      // Create individual frame mu-maps
-      for (frame=0; frame<num_frames; frame++) {
-        if (!frame_info[frame].tx_align_flag) {
-          LOG_INFO("Using original %s\n",mu_file);
-          fflush(log_fp);
-          continue; 
-        }
-        // Not reference frame: Create resliced mu file.
-        sprintf(mu_rsl, "%s_fr%d.i", mu_prefix,frame);
-        if (access(mu_rsl,R_OK) == 0 && overwrite==0) {
-          LOG_INFO("Reusing point 2: existing %s\n",mu_rsl); fflush(log_fp);
-        } else { 
-          if (vicra_file && frame_info[frame].tx_align_flag) {
-            /*
-            sprintf(program_name, "%s/%s", program_path, prog_volume_reslice);
-            sprintf(cmd_line,"-i %s -M ", mu_file);
-            vicra_align_txt(vicra_info.em[frame], vicra_info.tx,
-                            &cmd_line[strlen(cmd_line)]);
-            sprintf(&cmd_line[strlen(cmd_line)]," -o %s", mu_rsl);
-            if (run_system_command(program_name, cmd_line, log_fp)) {
-              exit(1);
-            }
-            */
-          } else {
-            // Create mu-map frame transfromer by inverting transformer
-            // that was computed using motion_qc program from uncorrected images 
-            //Create transformed mu_map using inverse transfomer
-
-            sprintf(program_name, "%s/%s", program_path, prog_invert_air);
-            sprintf(cmd_line,"%s_fr%d.air %s_fr%d.air y",
-              em_na, frame, mu_prefix, frame);
-            if (run_system_command(program_name, cmd_line, log_fp)) {
-              exit(1);
-            }
-            if (ecat_reslice_flag) {
-              // ahc yes.  e_r_f = 0 if using vicra.
-              sprintf(program_name, "%s/%s", program_path, prog_reslice);
-              sprintf(cmd_line,"%s_fr%d.air %s -a %s -o -k",
-                mu_prefix, frame, mu_rsl, mu_file);
-            } else {
-              /*
-              sprintf(program_name, "%s/%s", program_path, prog_volume_reslice);
-              sprintf(cmd_line,"-a %s_fr%d.air -o %s -i %s ",
-                      mu_prefix, frame, mu_rsl, mu_file);
-              */
-            }
-            // LOG_INFO("%s\n",cmd_line); fflush(log_fp);
-            printf("\nFrame: %d \n ", frame); fflush(stdout);
-            printf("%s %s\n", program_name, cmd_line); fflush(stdout);
-            if (run_system_command(program_name, cmd_line, log_fp)) {
-              exit(1);
-            }
+      // Frames without correction share the attenuation of the original
+      // mu-map: create it once, before the frame jobs
+      for (frame=0; frame<num_frames; frame++)
+        if (!frame_info[frame].tx_align_flag) break;
+      sprintf(at_rsl, "%s_temp_a.a", mu_prefix);
+      if (frame<num_frames) {
+        if (access(at_rsl,R_OK) == 0 && overwrite==0) {
+          LOG_INFO("Reusing point 3: existing {}", at_rsl);
+        } else {
+          sprintf(program_name, "%s/%s", program_path, prog_e7_fwd);
+          sprintf(cmd_line, "--model 328 -u %s -w %d --oa %s --span 9 "
+            "--mrd 67 --prj ifore --force -l 33,%s",
+            mu_file, mu_width, at_rsl, log_dir);
+          if (run_system_command(program_name, cmd_line, log_fp)) {
+            exit(1);
           }
         }
       }
     }
 
-    // Reconstruct frames 
+    // Reconstruct frames: one job per frame, independent frames run
+    // concurrently within the memory budget
+    mc_pipeline::JobScheduler scheduler(max_jobs, memory_mb, log_fp);
     for (frame=0; frame<num_frames; frame++)    {
+      mc_pipeline::FrameJob job;
+      job.frame = frame;
+      job.memory_mb = frame_memory_mb;
       if (mu_file != NULL)      {
         // ahc yes
         if (!frame_info[frame].tx_align_flag) {
           // no correction
+          LOG_INFO("Using original {}", mu_file);
           strcpy(mu_rsl, mu_file);
           sprintf(at_rsl, "%s_temp_a.a", mu_prefix);
         } else {
           sprintf(mu_rsl, "%s_fr%d.i", mu_prefix,frame);
           sprintf(at_rsl, "%s_fr%d_temp_a.a", mu_prefix,frame);
-        }
-
-        if (access(at_rsl,R_OK) == 0 && overwrite==0) {
-          LOG_INFO("Reusing point 3: existing %s\n",at_rsl);
-        } else { 
-          sprintf(program_name, "%s/%s", program_path, prog_e7_fwd);
-          sprintf(cmd_line, "--model 328 -u %s -w %d --oa %s --span 9 "
-            "--mrd 67 --prj ifore --force -l 33,%s",
-            mu_rsl, mu_width, at_rsl, log_dir);
-          if (run_system_command(program_name, cmd_line, log_fp)) {
-            exit(1);
+          // Not reference frame: Create resliced mu file.
+          if (access(mu_rsl,R_OK) == 0 && overwrite==0) {
+            LOG_INFO("Reusing point 2: existing {}", mu_rsl);
+          } else if (!vicra_file) {
+            // Create mu-map frame transfromer by inverting transformer
+            // that was computed using motion_qc program from uncorrected images
+            //Create transformed mu_map using inverse transfomer
+            sprintf(fname, "%s_fr%d.air", em_na, frame);
+            sprintf(cmd_line, "%s_fr%d.air", mu_prefix, frame);
+            job.steps.push_back(mc_pipeline::invert_air_step(fname, cmd_line));
+            if (ecat_reslice_flag) {
+              // ahc yes.  e_r_f = 0 if using vicra.
+              sprintf(program_name, "%s/%s", program_path, prog_reslice);
+              sprintf(cmd_line,"%s_fr%d.air %s -a %s -o -k",
+                mu_prefix, frame, mu_rsl, mu_file);
+              job.steps.push_back(mc_pipeline::command_step(program_name, cmd_line, log_fp));
+            }
           }
-        } // end attenuation
+
+          if (access(at_rsl,R_OK) == 0 && overwrite==0) {
+            LOG_INFO("Reusing point 3: existing {}", at_rsl);
+          } else {
+            sprintf(program_name, "%s/%s", program_path, prog_e7_fwd);
+            sprintf(cmd_line, "--model 328 -u %s -w %d --oa %s --span 9 "
+              "--mrd 67 --prj ifore --force -l 33,%s",
+              mu_rsl, mu_width, at_rsl, log_dir);
+            job.steps.push_back(mc_pipeline::command_step(program_name, cmd_line, log_fp));
+          } // end attenuation
+        }
 
         // Compute scatter
-        sprintf(fname, "%s_frame%d_sc_ATX.s ", em_prefix,frame);
+        sprintf(fname, "%s_frame%d_sc_ATX.s", em_prefix,frame);
         if (access(fname,R_OK) == 0 && overwrite==0) {
-          LOG_INFO("Reusing point 4: existing %s\n",fname);
+          LOG_INFO("Reusing point 4: existing {}", fname);
         } else {
+          // concurrent frames need their own scatter_qc_00 files
+          if (max_jobs > 1) {
+            sprintf(frame_qc_dir, "%s%cframe%d", qc_dir, DIR_SEPARATOR, frame);
+            if (make_directory(frame_qc_dir)) exit(1);
+          } else strcpy(frame_qc_dir, qc_dir);
           sprintf(program_name, "%s/%s", program_path, prog_e7_sino);
           sprintf(cmd_line, "-e %s_frame%d.tr.s -u %s  -w %d "
             "-a %s -n %s --force --os %s --os2d --gf --model 328 "
             "--skip 2 --mrd 67 --span 9 --ssf 0.25,2 -l 33,%s -q %s",
-            em_prefix, frame, mu_rsl, mu_width, at_rsl, norm_file, fname, log_dir, qc_dir);
+            em_prefix, frame, mu_rsl, mu_width, at_rsl, norm_file, fname, log_dir, frame_qc_dir);
           if (lber>0.0f)
             // ahc yes.  Option 'L' to motion_correct_recon
             sprintf(&cmd_line[strlen(cmd_line)]," --lber %g",lber);
           if (athr != NULL)
             // ahc yes.  Option 'a' to motion_correct_recon
             sprintf(&cmd_line[strlen(cmd_line)]," --athr %s",athr);
-          if (run_system_command(program_name, cmd_line, log_fp)) {
-            exit(1);
+          job.steps.push_back(mc_pipeline::command_step(program_name, cmd_line, log_fp));
+
+          if (exec) {
+            // scatter_qc_00.plt refers to its data files relative to the qc dir
+            sprintf(cmd_line, "cd %s; %s scatter_qc_00.plt", frame_qc_dir, prog_gnuplot);
+            std::string plot_cmd(cmd_line);
+            job.steps.push_back({"gnuplot", [plot_cmd]() { return system(plot_cmd.c_str()); }});
+            sprintf(cmd_line, "%s%cscatter_qc_00.ps", frame_qc_dir, DIR_SEPARATOR);
+            sprintf(fname, "%s%c%s_frame%d_sc_qc.ps", em_dir, DIR_SEPARATOR, em_prefix, frame);
+            job.steps.push_back(mc_pipeline::rename_step(cmd_line, fname));
           }
-
-          sprintf(cmd_line,"cd %s; %s %s/scatter_qc_00.plt", em_dir, prog_gnuplot, em_dir);
-          LOG_INFO("%s\n",cmd_line); fflush(log_fp);
-          if (exec)
-            system(cmd_line);
-          sprintf(cmd_line,"rename %s/scatter_qc_00.ps %s/%s_frame%d_sc_qc.ps ", em_dir, em_dir, em_prefix, frame);          
-          LOG_INFO("%s\n",cmd_line); fflush(log_fp);
-          if (exec)
-            system(cmd_line);
-          sprintf(cmd_line, "cd %s", em_dir);
-          LOG_INFO("%s\n",cmd_line); fflush(log_fp);
-          if (exec)
-            chdir(em_dir);
         } // end scatter
       } // end attenuation and scatter processing
-      
-      sprintf(fname, "%s_frame%d_3D_ATX.i ", em_prefix,frame);
+
+      sprintf(fname, "%s_frame%d_3D_ATX.i", em_prefix,frame);
       if (access(fname,R_OK) == 0 && overwrite==0) {
-        LOG_INFO("Reusing point 5: existing %s\n",fname);
-        fflush(log_fp);
+        LOG_INFO("Reusing point 5: existing {}", fname);
       } else {
         // host reconstruction
         sprintf(program_name, "%s/%s", program_path, prog_recon);
@@ -806,16 +821,22 @@ if (*ext == 'v') {
         if (mu_file != NULL) {
           sprintf(cmd_line, "-s %s_frame%d_sc_ATX.s -a %s ", em_prefix, frame, at_rsl);
         }
-        sprintf(cmd_line, "%s -p %s_frame%d.s -d %s_frame%d.ch  -o %s -n %s -W 3 -I %d -S 16 -m 9,67 -T 2 -X 256 -K %s -r %s",
-         cmd_line, em_prefix, frame, em_prefix, frame, fname, norm_file, num_iterations, normfac_img, rebinner_lut_file);
+        sprintf(&cmd_line[strlen(cmd_line)], " -p %s_frame%d.s -d %s_frame%d.ch  -o %s -n %s -W 3 -I %d -S 16 -m 9,67 -T 2 -X 256 -K %s -r %s",
+         em_prefix, frame, em_prefix, frame, fname, norm_file, num_iterations, normfac_img, rebinner_lut_file);
 
         if (psf_flag)
           strcat(cmd_line, " -B 0,0,0");
-        if (run_system_command(program_name, cmd_line, log_fp)) {
-          exit(1);
-        }
+        job.steps.push_back(mc_pipeline::command_step(program_name, cmd_line, log_fp));
       } // end reconstruction
+      if (!job.steps.empty())
+        scheduler.add(job);
     } // Frame processing
+    fflush(log_fp);
+    // Concurrent commands do not remove ~/.ma_pattern.dat, do it once here
+    hrrt_util::remove_ma_pattern();
+    if (scheduler.run()) {
+      exit(1);
+    }
 
     // Conversion to ECAT
     if (user_time_constant <= 0.0f)
@@ -932,18 +953,14 @@ if (*ext == 'v') {
         continue;
       }
       
-      sprintf(cmd_line,"%s/%s -a %s_fr%d.air",
-        program_path, prog_motion_distance,
-        im_prefix, frame);
-      LOG_INFO("%s\n",cmd_line);  fflush(log_fp);
+      sprintf(air_file,"%s_fr%d.air", im_prefix, frame);
+      LOG_INFO("motion_distance -a {}", air_file);  fflush(log_fp);
       if (exec) {
-        if ((pp = popen(cmd_line,"r")) != NULL) {
-          fgets(line, sizeof(line),pp);
+        if (mc_pipeline::motion_distance(air_file, line, sizeof(line)) == 0) {
           fprintf(fp,"%d %s",x0, line);
           fprintf(fp,"%d %s",x1, line);
-          pclose(pp);
         } else {
-          LOG_INFO("Error opening pipe %s\n", cmd_line);
+          LOG_ERROR("Error computing motion distance {}", air_file);
           return 1;
         }
       }
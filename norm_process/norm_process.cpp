@@ -30,6 +30,7 @@
   16-Oct-2009: Added fix_back_layer_ce() to solve ring artifact
   23-Nov-2009: Bug fix: potential crash in compute_fan_sum if end_of_file reached
   17-Jun-2010: Bug fixes in normalization header, e.g "number format := normalization "
+  19-Oct-2026: Use the listmode time index (.l64.idx), when present, to locate the end of frame
 */
 
 #define MAX_THREADS 8
@@ -76,6 +77,7 @@
 #include "scanner_params.h"
 #include "rotation_dwell_sino.h"
 #include "histogram_mp.hpp"
+#include "lm_index.hpp"
 
 extern float inter(float x1, float y1, float x2, float y2, float r, float *xi, float *yi);
 
@@ -604,6 +606,7 @@ static void compute_fan_sum(const char *l64_file, float *fan_sum) {
   int thread = 0, end_of_file = 0, end_of_frame = 0;
   int nthreads = 0; // Number of current threads may be less than NumberOfThreads
   int num_buf = 0;
+  uint64_t file_pos = 0, frame_end = 0;
 #ifdef __linux__
   pthread_t ThreadHandles[ MAX_THREADS ] ;
   pthread_attr_t  attr ;
@@ -627,6 +630,18 @@ static void compute_fan_sum(const char *l64_file, float *fan_sum) {
     FS_MP_args[thread].TNumber = thread;
   }
 
+  // With a time index the end of frame is known upfront: read up to the first time tag
+  // after duration instead of scanning every buffer for it.
+  if (duration > 0) {
+    LMIndex index;
+    int64_t end_time = (int64_t)(duration + 1) * 1000;
+    if (index.read(LMIndex::index_path(l64_file), l64_file) == 0 && (end_time % index.interval()) == 0) {
+      const LMIndex::Entry *entry = index.find_end(end_time);
+      frame_end = (entry != NULL) ? entry->offset : UINT64_MAX;
+      LOG_INFO("End of frame at listmode offset {} from time index", frame_end);
+    }
+  }
+
   //Feed the threads
 
   while (!end_of_file && !end_of_frame) {
@@ -637,12 +652,16 @@ static void compute_fan_sum(const char *l64_file, float *fan_sum) {
 #endif
     for (thread = 0; thread < NumberOfThreads && !end_of_file; thread++ )
     {
-      FS_L64_args[thread].count = fread(FS_L64_args[thread].in, 2 * sizeof(unsigned), EV_BUFSIZE, fp);
+      size_t count = EV_BUFSIZE;
+      if (frame_end > 0 && (frame_end - file_pos) / (2 * sizeof(unsigned)) < count)
+        count = (frame_end - file_pos) / (2 * sizeof(unsigned));
+      FS_L64_args[thread].count = fread(FS_L64_args[thread].in, 2 * sizeof(unsigned), count, fp);
       if (FS_L64_args[thread].count  <=  0) {
         end_of_file = 1;
         break;
       }
-      if (num_buf++ > NumberOfThreads && duration > 0) {
+      file_pos += FS_L64_args[thread].count * 2 * sizeof(unsigned);
+      if (num_buf++ > NumberOfThreads && duration > 0 && frame_end == 0) {
         end_of_frame = check_end_of_frame(FS_L64_args[thread]);
         if (end_of_frame > 0)
           FS_L64_args[thread].count = end_of_frame;
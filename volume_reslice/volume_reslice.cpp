@@ -9,6 +9,7 @@
                Add -M option for affine transformer from polaris tracking
                Reverse Y before and after applying Polaris transformer due
                to left/right handed differences between polaris and HRRT scanner
+  19-Oct-2026: Reslice planes on multiple threads (-T)
 */
 #include <malloc.h>
 #include <stdlib.h>
@@ -18,6 +19,8 @@
 #include "my_spdlog.hpp"
 
 #include <unistd.h>
+#include <thread>
+#include <vector>
 
 #include "matrix_resize.h"
 #include "Volume.h"
@@ -32,7 +35,8 @@ static void usage() {
   LOG_ERROR(
 	  "usage: volume_reslice -i in_matspec [-A | -C | -S] -o out_matspec \n"
     "       [-t transformer | -M affine_transformer | -a air_transformer] \n"
-    "       [-x xdim[,dx]] [-y ydim[,dy]] [-z zdim[,dz]] -Z zoom_factor [-R] [-v]\n");
+    "       [-x xdim[,dx]] [-y ydim[,dy]] [-z zdim[,dz]] -Z zoom_factor [-R] [-v]\n"
+    "       [-T threads]\n");
   LOG_ERROR("\n"
     "  Load volume specified by in_matspec, apply optional transformer and\n"
 	  "  save volume in out_matspec in the requested orientation.\n"
@@ -43,10 +47,24 @@ static void usage() {
   LOG_ERROR("\n  Orientation: -A(axial=default), -C(coronal), -S(sagittal)\n");
   LOG_ERROR("  Zoom  : applies a zoom factor within [1.0,10.0] range at volume center\n");
   LOG_ERROR("  -R Reverse transformer\n");
+  LOG_ERROR("  -T number of threads (default: number of processors)\n");
   LOG_ERROR("  -v set verbose mode on ( default is off)\n");
   exit(1);
 }
 
+// Runs plane_fn(plane) for planes [first,last), interleaved over nthreads threads
+template <typename F>
+static void for_each_plane(int first, int last, unsigned nthreads, F plane_fn) {
+  if (nthreads < 1) nthreads = 1;
+  std::vector<std::thread> threads;
+  for (unsigned t=1; t<nthreads; t++)
+    threads.push_back(std::thread([=]() {
+      for (int plane=first+t; plane<last; plane+=nthreads) plane_fn(plane);
+    }));
+  for (int plane=first; plane<last; plane+=nthreads) plane_fn(plane);
+  for (std::thread &t : threads) t.join();
+}
+
 static char line[FILENAME_MAX];
 static char fname[FILENAME_MAX], hdr_fname[FILENAME_MAX];
 
@@ -168,8 +186,9 @@ int main(int argc, char **argv) {
   float c_size=1.0f;
   int t_reverse=0;
   int t_flip=0;  // AIR (radiology) convention
+  unsigned nthreads = std::thread::hardware_concurrency();
 
-  while ((c = getopt (argc, argv, "i:o:x:y:z:t:M:a:Z:ACSRrv")) != EOF) {
+  while ((c = getopt (argc, argv, "i:o:x:y:z:t:M:a:Z:T:ACSRrv")) != EOF) {
     switch (c) {
     case 'i' :
       in_file = strdup(optarg);
@@ -217,6 +236,12 @@ int main(int argc, char **argv) {
         err_flag++;
       }
       break;
+    case 'T' :
+      if (sscanf(optarg,"%u", &nthreads) != 1 || nthreads < 1) {
+        LOG_ERROR( "invalid argument -T %s\n", optarg);
+        err_flag++;
+      }
+      break;
     case 'C' :
       orientation = Dimension_Y;
       break;
@@ -318,12 +343,12 @@ int main(int argc, char **argv) {
         imh->z_dimension = cdata->zdim;
         cdata->pixel_size = cdata->y_size = cdata->z_size = c_size;
         imh->x_pixel_size = imh->y_pixel_size = imh->z_pixel_size = c_size;
-        for (plane=0; plane<cdata->zdim; plane++)
-        {
-          slice = volume->get_slice(zoom_center, zoom_factor, Dimension_Z, plane*c_size,
+        for_each_plane(0, cdata->zdim, nthreads, [&](int plane) {
+          ecat_matrix::MatrixData *cslice = volume->get_slice(zoom_center, zoom_factor, Dimension_Z, plane*c_size,
 								area, c_size, interpolate);
-          memcpy( cdata->data_ptr + plane*slice->data_size, slice->data_ptr, slice->data_size);
-        }
+          memcpy( cdata->data_ptr + plane*cslice->data_size, cslice->data_ptr, cslice->data_size);
+          free_matrix_data(cslice);
+        });
         data->shptr = NULL;
         delete volume; 
         data = cdata;
@@ -401,15 +426,12 @@ int main(int argc, char **argv) {
   out_data->zdim = imh->z_dimension = num_planes;
   int plane_size = slice->data_size;
   memcpy(out_data->data_ptr, slice->data_ptr, slice->data_size);
-  void * dest = out_data->data_ptr + plane_size;
-  for (int plane=1; plane<num_planes; plane++, dest+=plane_size)
-  {
-    slice = volume->get_slice(zoom_center, zoom_factor, orientation, plane*dz,
+  for_each_plane(1, num_planes, nthreads, [&](int plane) {
+    ecat_matrix::MatrixData *pslice = volume->get_slice(zoom_center, zoom_factor, orientation, plane*dz,
       area, pixel_size, interpolate);
-    memcpy(dest, slice->data_ptr, plane_size);
-    free_matrix_data(slice);
-
-  }
+    memcpy(out_data->data_ptr + plane*plane_size, pslice->data_ptr, plane_size);
+    free_matrix_data(pslice);
+  });
   if (t_flip)  matrix_flip(out_data,0,1,1); 		/* AIR radiology convention */
   else  if (y_reverse) matrix_flip(out_data,0,1,0); /* Vicra */
 